@@ -1,6 +1,10 @@
 /*
  * Demonstration of very simple implementation of message deadlines
  * by using collector+performer idiom.
+ *
+ * The second part of the sample shows the cost of a deadline attached
+ * to a message by an envelope and the cost of the same deadline attached
+ * as inline message metadata.
  */
 
 #if defined( _MSC_VER )
@@ -14,6 +18,7 @@
 #include <ctime>
 #include <sstream>
 #include <queue>
+#include <chrono>
 
 #include <so_5/all.hpp>
 
@@ -324,6 +329,142 @@ private :
 	}
 };
 
+//
+// The cost of envelope vs inline metadata.
+//
+
+// A message to be sent in big quantities.
+struct msg_tick : public so_5::message_t
+{
+	unsigned int m_value;
+
+	msg_tick( unsigned int value ) : m_value( value ) {}
+};
+
+// An envelope which holds a deadline for the payload.
+// Every message requires a separate envelope object and every access
+// to the payload is a virtual call to access_hook().
+class deadline_envelope_t : public so_5::enveloped_msg::envelope_t
+{
+public :
+	deadline_envelope_t(
+		so_5::message_ref_t payload,
+		std::chrono::steady_clock::time_point deadline )
+		:	m_payload( std::move( payload ) )
+		,	m_deadline( deadline )
+	{}
+
+	virtual void access_hook(
+		access_context_t context,
+		handler_invoker_t & invoker ) SO_5_NOEXCEPT override
+	{
+		if( access_context_t::handler_found == context &&
+				std::chrono::steady_clock::now() >= m_deadline )
+			// Deadline passed, the message is ignored.
+			return;
+
+		invoker.invoke( payload_info_t{ m_payload } );
+	}
+
+private :
+	so_5::message_ref_t m_payload;
+	const std::chrono::steady_clock::time_point m_deadline;
+};
+
+// How a deadline is attached to a message.
+enum class deadline_mode_t { envelope, metadata };
+
+// Agent which receives ticks and counts them.
+class a_tick_receiver_t : public so_5::agent_t
+{
+public :
+	a_tick_receiver_t( context_t ctx, unsigned int total )
+		:	so_5::agent_t( ctx )
+		,	m_total( total )
+	{}
+
+	virtual void so_define_agent() override
+	{
+		so_default_state().event( &a_tick_receiver_t::evt_tick );
+	}
+
+private :
+	const unsigned int m_total;
+
+	void evt_tick( mhood_t< msg_tick > evt )
+	{
+		// Expired ticks are not delivered here: they are dropped by
+		// the envelope or by SObjectizer itself (if the deadline is
+		// set by send_with_deadline).
+		if( m_total == evt->m_value + 1 )
+			so_deregister_agent_coop_normally();
+	}
+};
+
+// Agent which sends ticks with a deadline.
+class a_tick_sender_t : public so_5::agent_t
+{
+public :
+	a_tick_sender_t(
+		context_t ctx,
+		so_5::mbox_t receiver,
+		deadline_mode_t mode,
+		unsigned int total )
+		:	so_5::agent_t( ctx )
+		,	m_receiver( std::move( receiver ) )
+		,	m_mode( mode )
+		,	m_total( total )
+	{}
+
+	virtual void so_evt_start() override
+	{
+		const auto deadline = std::chrono::steady_clock::now() +
+				std::chrono::seconds( 30 );
+
+		for( unsigned int i = 0; i != m_total; ++i )
+		{
+			if( deadline_mode_t::envelope == m_mode )
+				m_receiver->do_deliver_enveloped_msg(
+						typeid( msg_tick ),
+						so_5::message_ref_t{
+							new deadline_envelope_t{
+								so_5::message_ref_t{ new msg_tick{ i } },
+								deadline } },
+						1 );
+			else
+				so_5::send_with_deadline< msg_tick >( m_receiver, deadline, i );
+		}
+	}
+
+private :
+	const so_5::mbox_t m_receiver;
+	const deadline_mode_t m_mode;
+	const unsigned int m_total;
+};
+
+void measure_deadline_cost( deadline_mode_t mode, unsigned int total )
+{
+	const auto started_at = std::chrono::steady_clock::now();
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+		env.introduce_coop( [&]( so_5::coop_t & coop ) {
+			auto receiver = coop.make_agent< a_tick_receiver_t >( total );
+			coop.make_agent< a_tick_sender_t >(
+					receiver->so_direct_mbox(), mode, total );
+		} );
+	} );
+
+	const auto duration = std::chrono::duration_cast<
+			std::chrono::microseconds >(
+					std::chrono::steady_clock::now() - started_at );
+
+	std::cout << ( deadline_mode_t::envelope == mode ?
+				"deadline in envelope: " : "deadline in metadata: " )
+			<< total << " messages in " << duration.count() << "us ("
+			<< double(duration.count()) * 1000.0 / total << "ns per message)"
+			<< std::endl;
+}
+
 void init( so_5::environment_t & env )
 {
 	using namespace so_5::disp::thread_pool;
@@ -347,6 +488,10 @@ int main()
 	{
 		so_5::launch( &init );
 
+		const unsigned int total_ticks = 1000000;
+		measure_deadline_cost( deadline_mode_t::envelope, total_ticks );
+		measure_deadline_cost( deadline_mode_t::metadata, total_ticks );
+
 		return 0;
 	}
 	catch( const std::exception & x )
@@ -20,7 +20,9 @@
 #include <so_5/rt/h/enveloped_msg.hpp>
 
 #include <so_5/h/mchain_helper_functions.hpp>
+#include <so_5/h/keyed_mbox.hpp>
 #include <so_5/h/thread_helper_functions.hpp>
+#include <so_5/h/coroutine.hpp>
 
 #include <so_5/disp/one_thread/h/pub.hpp>
 #include <so_5/disp/active_obj/h/pub.hpp>
@@ -0,0 +1,400 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \since
+ * v.5.5.25
+ *
+ * \brief A type-erased callable with small buffer which doesn't
+ * allocate memory on copy.
+ */
+
+#pragma once
+
+#include <so_5/h/atomic_refcounted.hpp>
+#include <so_5/h/compiler_features.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <new>
+
+namespace so_5 {
+
+namespace details {
+
+template< typename Signature, std::size_t Buffer_Size = 3 * sizeof(void *) >
+class small_function_t;
+
+//
+// small_function_t
+//
+/*!
+ * \brief A replacement for std::function for event handlers.
+ *
+ * A callable object is stored inside a small buffer if it fits into
+ * that buffer. By default the buffer has room for three pointers. It is
+ * enough for handlers created by SObjectizer from pointers to agent's
+ * methods (a pointer to agent plus a pointer to method) and for lambdas
+ * which capture a couple of pointers.
+ *
+ * A bigger callable object is allocated in dynamic memory. If it can be
+ * called via a const reference then it is allocated only once and shared
+ * between all copies of small_function_t, so copying doesn't allocate.
+ * A bigger callable object which can be called only via a non-const
+ * reference (a mutable lambda, for example) is copied to a new block of
+ * dynamic memory for every copy of small_function_t. Because of that
+ * copies of small_function_t are always independent, as copies of
+ * std::function are.
+ *
+ * Invocation of stored callable object is a single indirect call.
+ *
+ * \note
+ * A shared callable object is invoked by several copies at the same time
+ * if they are used on different threads. Its const operator() must be
+ * thread safe (it is so for lambdas without mutable members).
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename R, typename... Args, std::size_t Buffer_Size >
+class small_function_t< R(Args...), Buffer_Size >
+	{
+		//! Operations for a stored callable object.
+		enum class operation_t { copy, move, destroy };
+
+		//! Type of pointer to function for invocation of callable object.
+		using invoker_t = R (*)( void *, Args... );
+
+		//! Type of pointer to function for copy/move/destroy operations.
+		using manager_t = void (*)( operation_t, void * dest, void * src );
+
+		//! Holder for a big callable object in dynamic memory.
+		template< typename F >
+		struct heap_holder_t final : public atomic_refcounted_t
+			{
+				F m_callable;
+
+				heap_holder_t( F && callable )
+					:	m_callable( std::move(callable) )
+					{}
+			};
+
+		//! Can callable object of type F be called with Args and
+		//! return a value convertible to R?
+		template< typename F >
+		class is_invocable_t
+			{
+				template<
+					typename U,
+					typename Result = decltype(
+							std::declval< U >()( std::declval< Args >()... ) ) >
+				static std::integral_constant< bool,
+						std::is_void< R >::value ||
+						std::is_convertible< Result, R >::value >
+				check( int );
+
+				template< typename U >
+				static std::false_type
+				check( ... );
+
+			public :
+				static const bool value = decltype( check< F >( 0 ) )::value;
+			};
+
+		//! Can callable object of type F be stored inside the buffer?
+		template< typename F >
+		struct fits_into_buffer
+			{
+				static const bool value =
+						sizeof(F) <= Buffer_Size &&
+						alignof(F) <= alignof(void *) &&
+						std::is_nothrow_move_constructible< F >::value;
+			};
+
+		//! Implementation of invoker and manager for type F.
+		template< typename F >
+		struct ops_t
+			{
+				static R
+				invoke( void * storage, Args... args )
+					{
+						return (*static_cast< F * >( storage ))(
+								std::forward< Args >(args)... );
+					}
+
+				static void
+				manage( operation_t op, void * dest, void * src )
+					{
+						switch( op )
+							{
+							case operation_t::copy :
+								new( dest ) F( *static_cast< const F * >( src ) );
+							break;
+
+							case operation_t::move :
+								new( dest ) F( std::move( *static_cast< F * >( src ) ) );
+								static_cast< F * >( src )->~F();
+							break;
+
+							case operation_t::destroy :
+								static_cast< F * >( dest )->~F();
+							break;
+							}
+					}
+			};
+
+		//! Implementation of invoker and manager for a callable object
+		//! in dynamic memory which is copied for every copy of small_function.
+		template< typename F >
+		struct unique_heap_ops_t
+			{
+				static R
+				invoke( void * storage, Args... args )
+					{
+						return (**static_cast< F ** >( storage ))(
+								std::forward< Args >(args)... );
+					}
+
+				static void
+				manage( operation_t op, void * dest, void * src )
+					{
+						switch( op )
+							{
+							case operation_t::copy :
+								new( dest ) F*( new F( **static_cast< F ** >( src ) ) );
+							break;
+
+							case operation_t::move :
+								new( dest ) F*( *static_cast< F ** >( src ) );
+							break;
+
+							case operation_t::destroy :
+								delete *static_cast< F ** >( dest );
+							break;
+							}
+					}
+			};
+
+		//! Invoker for a callable object in dynamic memory which is shared
+		//! between copies of small_function.
+		template< typename F >
+		struct heap_ops_t
+			{
+				using holder_ptr_t = intrusive_ptr_t< heap_holder_t< F > >;
+
+				static R
+				invoke( void * storage, Args... args )
+					{
+						return (*static_cast< holder_ptr_t * >( storage ))->m_callable(
+								std::forward< Args >(args)... );
+					}
+			};
+
+		typename std::aligned_storage<
+				Buffer_Size, alignof(void *) >::type m_storage;
+
+		invoker_t m_invoker = nullptr;
+		manager_t m_manager = nullptr;
+
+		template< typename F >
+		void
+		construct( F && callable, std::true_type /*fits_into_buffer*/ )
+			{
+				using actual_t = typename std::decay< F >::type;
+
+				new( &m_storage ) actual_t( std::forward< F >(callable) );
+				m_invoker = &ops_t< actual_t >::invoke;
+				m_manager = &ops_t< actual_t >::manage;
+			}
+
+		template< typename F >
+		void
+		construct( F && callable, std::false_type /*fits_into_buffer*/ )
+			{
+				using actual_t = typename std::decay< F >::type;
+
+				construct_in_heap( std::forward< F >(callable),
+						std::integral_constant< bool,
+								is_invocable_t< const actual_t & >::value >{} );
+			}
+
+		template< typename F >
+		void
+		construct_in_heap( F && callable, std::true_type /*const_invocable*/ )
+			{
+				using actual_t = typename std::decay< F >::type;
+				using holder_ptr_t = typename heap_ops_t< actual_t >::holder_ptr_t;
+
+				new( &m_storage ) holder_ptr_t(
+						new heap_holder_t< actual_t >( actual_t(
+								std::forward< F >(callable) ) ) );
+				m_invoker = &heap_ops_t< actual_t >::invoke;
+				m_manager = &ops_t< holder_ptr_t >::manage;
+			}
+
+		template< typename F >
+		void
+		construct_in_heap( F && callable, std::false_type /*const_invocable*/ )
+			{
+				using actual_t = typename std::decay< F >::type;
+
+				new( &m_storage ) actual_t*(
+						new actual_t( std::forward< F >(callable) ) );
+				m_invoker = &unique_heap_ops_t< actual_t >::invoke;
+				m_manager = &unique_heap_ops_t< actual_t >::manage;
+			}
+
+		void
+		reset() SO_5_NOEXCEPT
+			{
+				if( m_manager )
+					{
+						m_manager( operation_t::destroy, &m_storage, nullptr );
+						m_invoker = nullptr;
+						m_manager = nullptr;
+					}
+			}
+
+	public :
+		small_function_t() SO_5_NOEXCEPT {}
+
+		small_function_t( std::nullptr_t ) SO_5_NOEXCEPT {}
+
+		template<
+			typename F,
+			typename = typename std::enable_if<
+					!std::is_same<
+							typename std::decay< F >::type,
+							small_function_t >::value &&
+					is_invocable_t<
+							typename std::decay< F >::type & >::value >::type >
+		small_function_t( F && callable )
+			{
+				using actual_t = typename std::decay< F >::type;
+
+				construct( std::forward< F >(callable),
+						std::integral_constant< bool,
+								fits_into_buffer< actual_t >::value >{} );
+			}
+
+		small_function_t( const small_function_t & o )
+			{
+				if( o.m_manager )
+					{
+						o.m_manager( operation_t::copy, &m_storage,
+								const_cast< void * >(
+										static_cast< const void * >( &o.m_storage ) ) );
+						m_invoker = o.m_invoker;
+						m_manager = o.m_manager;
+					}
+			}
+
+		small_function_t( small_function_t && o ) SO_5_NOEXCEPT
+			{
+				if( o.m_manager )
+					{
+						o.m_manager( operation_t::move, &m_storage, &o.m_storage );
+						m_invoker = o.m_invoker;
+						m_manager = o.m_manager;
+						o.m_invoker = nullptr;
+						o.m_manager = nullptr;
+					}
+			}
+
+		~small_function_t() SO_5_NOEXCEPT
+			{
+				reset();
+			}
+
+		small_function_t &
+		operator=( const small_function_t & o )
+			{
+				small_function_t tmp{ o };
+				swap( tmp );
+				return *this;
+			}
+
+		small_function_t &
+		operator=( small_function_t && o ) SO_5_NOEXCEPT
+			{
+				small_function_t tmp{ std::move(o) };
+				swap( tmp );
+				return *this;
+			}
+
+		small_function_t &
+		operator=( std::nullptr_t ) SO_5_NOEXCEPT
+			{
+				reset();
+				return *this;
+			}
+
+		void
+		swap( small_function_t & o ) SO_5_NOEXCEPT
+			{
+				if( this == &o )
+					return;
+
+				small_function_t tmp;
+				if( o.m_manager )
+					{
+						o.m_manager( operation_t::move, &tmp.m_storage, &o.m_storage );
+						tmp.m_invoker = o.m_invoker;
+						tmp.m_manager = o.m_manager;
+						o.m_invoker = nullptr;
+						o.m_manager = nullptr;
+					}
+
+				if( m_manager )
+					{
+						m_manager( operation_t::move, &o.m_storage, &m_storage );
+						o.m_invoker = m_invoker;
+						o.m_manager = m_manager;
+						m_invoker = nullptr;
+						m_manager = nullptr;
+					}
+
+				if( tmp.m_manager )
+					{
+						tmp.m_manager( operation_t::move, &m_storage, &tmp.m_storage );
+						m_invoker = tmp.m_invoker;
+						m_manager = tmp.m_manager;
+						tmp.m_invoker = nullptr;
+						tmp.m_manager = nullptr;
+					}
+			}
+
+		friend void
+		swap( small_function_t & a, small_function_t & b ) SO_5_NOEXCEPT
+			{
+				a.swap( b );
+			}
+
+		//! Is there a callable object inside?
+		explicit operator bool() const SO_5_NOEXCEPT
+			{
+				return nullptr != m_invoker;
+			}
+
+		//! Call the stored callable object.
+		/*!
+		 * \attention
+		 * Must not be called for an empty object.
+		 */
+		R
+		operator()( Args... args ) const
+			{
+				return m_invoker(
+						const_cast< void * >(
+								static_cast< const void * >( &m_storage ) ),
+						std::forward< Args >(args)... );
+			}
+	};
+
+} /* namespace details */
+
+} /* namespace so_5 */
+
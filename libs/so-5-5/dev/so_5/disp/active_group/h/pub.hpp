@@ -19,6 +19,7 @@
 #include <so_5/disp/mpsc_queue_traits/h/pub.hpp>
 
 #include <so_5/disp/reuse/h/work_thread_activity_tracking.hpp>
+#include <so_5/disp/reuse/h/thread_affinity_mixin.hpp>
 
 namespace so_5
 {
@@ -48,9 +49,12 @@ namespace queue_traits = so_5::disp::mpsc_queue_traits;
  */
 class disp_params_t
 	:	public so_5::disp::reuse::work_thread_activity_tracking_flag_mixin_t< disp_params_t >
+	,	public so_5::disp::reuse::thread_affinity_mixin_t< disp_params_t >
 	{
 		using activity_tracking_mixin_t = so_5::disp::reuse::
 				work_thread_activity_tracking_flag_mixin_t< disp_params_t >;
+		using thread_affinity_mixin_t = so_5::disp::reuse::
+				thread_affinity_mixin_t< disp_params_t >;
 
 	public :
 		//! Default constructor.
@@ -58,11 +62,13 @@ class disp_params_t
 		//! Copy constructor.
 		disp_params_t( const disp_params_t & o )
 			:	activity_tracking_mixin_t{ o }
+			,	thread_affinity_mixin_t{ o }
 			,	m_queue_params{ o.m_queue_params }
 			{}
 		//! Move constructor.
 		disp_params_t( disp_params_t && o )
 			:	activity_tracking_mixin_t{ std::move(o) }
+			,	thread_affinity_mixin_t{ std::move(o) }
 			,	m_queue_params{ std::move(o.m_queue_params) }
 			{}
 
@@ -72,6 +78,9 @@ class disp_params_t
 				swap(
 						static_cast< activity_tracking_mixin_t & >(a),
 						static_cast< activity_tracking_mixin_t & >(b) );
+				swap(
+						static_cast< thread_affinity_mixin_t & >(a),
+						static_cast< thread_affinity_mixin_t & >(b) );
 				swap( a.m_queue_params, b.m_queue_params );
 			}
 
@@ -222,7 +222,9 @@ class dispatcher_template_t : public actual_disp_iface_t
 				auto thread = std::make_shared< Work_Thread >(
 						m_params.queue_params().lock_factory() );
 
-				thread->start();
+				// Threads are bound to CPUs in round-robin fashion.
+				thread->start( m_params.thread_affinity().cpus_for_thread(
+						m_groups.size() ) );
 
 				so_5::details::do_with_rollback_on_exception(
 						[&] {
@@ -210,7 +210,9 @@ class dispatcher_template_t : public actual_disp_iface_t
 				auto thread = std::make_shared< Work_Thread >(
 						std::move(lock_factory) );
 
-				thread->start();
+				// Threads are bound to CPUs in round-robin fashion.
+				thread->start( m_params.thread_affinity().cpus_for_thread(
+						m_agent_threads.size() ) );
 				so_5::details::do_with_rollback_on_exception(
 						[&] { m_agent_threads[ &agent ] = thread; },
 						[&thread] { shutdown_and_wait( *thread ); } );
@@ -19,8 +19,9 @@
 #include <map>
 #include <iostream>
 #include <forward_list>
+#include <atomic>
+#include <cstdint>
 
-#include <so_5/h/spinlocks.hpp>
 #include <so_5/h/atomic_refcounted.hpp>
 
 #include <so_5/rt/h/event_queue.hpp>
@@ -29,6 +30,7 @@
 #include <so_5/rt/stats/impl/h/activity_tracking.hpp>
 
 #include <so_5/disp/reuse/h/mpmc_ptr_queue.hpp>
+#include <so_5/disp/reuse/h/lock_free_demand_queue.hpp>
 
 #include <so_5/disp/thread_pool/impl/h/common_implementation.hpp>
 
@@ -56,8 +58,6 @@ namespace adv_thread_pool
 namespace impl
 {
 
-using spinlock_t = so_5::default_spinlock_t;
-
 class agent_queue_t;
 
 namespace stats = so_5::stats;
@@ -74,8 +74,20 @@ using dispatcher_queue_t = so_5::disp::reuse::mpmc_ptr_queue_t< agent_queue_t >;
 /*!
  * \brief Event queue for the agent (or cooperation).
  *
+ * The state of the queue is represented by one atomic word. It holds
+ * the activation flag, the flag of not-thread-safe worker, the count
+ * of thread-safe workers and the count of demands in the queue.
+ * All decisions about starting and finishing workers are made by
+ * compare-and-swap on that word. Because of that thread-safe demands
+ * can be claimed by several working threads without any lock.
+ *
+ * Demands are stored in an intrusive lock-free MPSC queue. The front
+ * demand can be accessed only by the owner of activation token: the
+ * working thread which has extracted this agent_queue from the
+ * dispatcher queue.
+ *
  * \since
- * v.5.4.0
+ * v.5.4.0, v.5.5.25
  */
 class agent_queue_t
 	:	public event_queue_t
@@ -83,28 +95,30 @@ class agent_queue_t
 	{
 		friend class so_5::intrusive_ptr_t< agent_queue_t >;
 
-	private :
-		//! Actual demand in event queue.
-		struct demand_t
-			{
-				//! Actual demand.
-				execution_demand_t m_demand;
-
-				//! Next item in queue.
-				demand_t * m_next;
-
-				demand_t()
-					:	m_next( nullptr )
-					{}
-				demand_t( execution_demand_t && original )
-					:	m_demand( std::move( original ) )
-					,	m_next( nullptr )
-					{}
-			};
-
 	public :
-		static const unsigned int thread_safe_worker = 2;
-		static const unsigned int not_thread_safe_worker = 1;
+		//! Type of queue state.
+		using state_t = std::uint64_t;
+
+		//! Actual demand in event queue.
+		using demand_t = so_5::disp::reuse::lock_free_demand_t;
+
+		//! Alias for unique_ptr to demand.
+		using demand_unique_ptr_t =
+				so_5::disp::reuse::lock_free_demand_unique_ptr_t;
+
+		//! Queue is scheduled to dispatcher queue.
+		static const state_t active_bit = 1u;
+		//! There is not-thread-safe worker.
+		static const state_t not_thread_safe_worker = 2u;
+		//! Increment for count of thread-safe workers.
+		static const state_t thread_safe_worker = 4u;
+		//! Mask for all kinds of workers.
+		static const state_t workers_mask = 0xfffffeu;
+		//! Increment for count of demands.
+		/*!
+		 * Count of demands occupies the highest 40 bits of the state.
+		 */
+		static const state_t one_demand = 0x1000000u;
 
 		//! Constructor.
 		agent_queue_t(
@@ -115,102 +129,125 @@ class agent_queue_t
 			//! adv-thread-pool dispatchers.
 			const params_t & )
 			:	m_disp_queue( disp_queue )
-			,	m_tail( &m_head )
-			,	m_active( false )
-			,	m_workers( 0 )
 			{}
 
 		~agent_queue_t()
 			{
-				while( m_head.m_next )
-					delete_head();
-			}
-
-		//! Access to the queue's lock.
-		spinlock_t &
-		lock()
-			{
-				return m_lock;
+				demand_unique_ptr_t front{ m_front };
 			}
 
 		//! Push next demand to queue.
 		virtual void
 		push( execution_demand_t demand )
 			{
+				m_demands.push(
+						demand_unique_ptr_t{ new demand_t( std::move( demand ) ) } );
+
 				bool need_schedule = false;
-				{
-					// Do memory allocation before spinlock locking.
-					auto new_demand = new demand_t( std::move( demand ) );
-
-					std::lock_guard< spinlock_t > lock( m_lock );
-
-					m_tail->m_next = new_demand;
-					m_tail = m_tail->m_next;
-
-					++m_size;
-
-					if( m_head.m_next == m_tail )
-						{
-							// Queue was empty. Need to detect
-							// necessity of queue activation.
-							if( !m_active )
-								if( !is_there_not_thread_safe_worker() )
-								{
-									need_schedule = true;
-									m_active = true;
-								}
-						}
-
-					SO_5_CHECK_INVARIANT( !empty(), this )
-					SO_5_CHECK_INVARIANT( m_active || is_there_any_worker(), this )
-					SO_5_CHECK_INVARIANT( !(need_schedule && !m_active), this )
-				}
+				state_t old = m_state.load( std::memory_order_acquire );
+				state_t updated;
+				do
+					{
+						updated = old + one_demand;
+
+						// Queue must be activated only if it was empty and
+						// there is no not-thread-safe worker.
+						need_schedule = ( 0 == demands_count( old ) &&
+								0 == ( old & ( active_bit | not_thread_safe_worker ) ) );
+						if( need_schedule )
+							updated |= active_bit;
+					}
+				while( !m_state.compare_exchange_weak(
+						old, updated,
+						std::memory_order_acq_rel,
+						std::memory_order_acquire ) );
+
+				SO_5_CHECK_INVARIANT( !empty(), this )
 
 				if( need_schedule )
 					m_disp_queue.schedule( this );
 			}
 
-		//! Get the information about the front demand.
+		//! Get the front demand.
 		/*!
-		 * \attention This method must be called only on non-empty queue.
+		 * \attention This method must be called only by the owner
+		 * of activation token.
 		 */
-		execution_demand_t
-		peek_front()
+		demand_t &
+		front()
 			{
 				SO_5_CHECK_INVARIANT( !empty(), this )
-				SO_5_CHECK_INVARIANT( m_active, this )
+				SO_5_CHECK_INVARIANT( active(), this )
 
-				m_active = false;
+				if( !m_front )
+					// Active queue can't be empty. But a producer of the
+					// front demand can be in the middle of push operation.
+					while( nullptr == ( m_front = m_demands.pop() ) )
+						std::this_thread::yield();
 
-				return m_head.m_next->m_demand;
+				return *m_front;
 			}
 
-		//! Remove the front demand.
+		//! An attempt to start a worker for the front demand.
 		/*!
-		 * \retval true queue must be activated.
-		 * \retval false queue must not be activated.
+		 * If worker can't be started the queue is deactivated. It will
+		 * be activated again when the last conflicting worker finishes.
+		 *
+		 * \attention This method must be called only by the owner
+		 * of activation token.
+		 *
+		 * \return the front demand extracted from the queue or nullptr
+		 * if the worker can't be started.
 		 */
-		bool
-		worker_started(
+		demand_unique_ptr_t
+		try_start_worker(
 			//! Type of worker.
 			//! Must be thread_safe_worker or not_thread_safe_worker.
-			unsigned int type_of_worker )
+			state_t type_of_worker,
+			//! Receiver for flag of necessity of queue scheduling.
+			bool & need_schedule )
 			{
-				SO_5_CHECK_INVARIANT( !empty(), this );
-				SO_5_CHECK_INVARIANT( !m_active, this );
-
-				delete_head();
-				if( !m_head.m_next )
-					m_tail = &m_head;
-
-				m_workers += type_of_worker;
+				// Front demand must be detached before the update of state
+				// because activation token can be lost after that.
+				demand_t * front_demand = m_front;
+				m_front = nullptr;
 
-				// Queue must be activated only if queue is not empty
-				// and current worker is a thread safe worker.
-				m_active = ( !empty() &&
-						thread_safe_worker == type_of_worker );
-
-				return m_active;
+				state_t old = m_state.load( std::memory_order_acquire );
+				for(;;)
+					{
+						const bool can_be_started =
+								not_thread_safe_worker == type_of_worker ?
+										0 == ( old & workers_mask ) :
+										0 == ( old & not_thread_safe_worker );
+
+						if( !can_be_started )
+							{
+								m_front = front_demand;
+								if( m_state.compare_exchange_weak(
+										old, old & ~active_bit,
+										std::memory_order_acq_rel,
+										std::memory_order_acquire ) )
+									return demand_unique_ptr_t{};
+
+								m_front = nullptr;
+								continue;
+							}
+
+						state_t updated = old - one_demand + type_of_worker;
+
+						// Queue must remain active only if it is not empty
+						// and current worker is a thread safe worker.
+						need_schedule = ( 0 != demands_count( updated ) &&
+								thread_safe_worker == type_of_worker );
+						if( !need_schedule )
+							updated &= ~active_bit;
+
+						if( m_state.compare_exchange_weak(
+								old, updated,
+								std::memory_order_acq_rel,
+								std::memory_order_acquire ) )
+							return demand_unique_ptr_t{ front_demand };
+					}
 			}
 
 		//! Signal about finishing of worker of the specified type.
@@ -222,42 +259,39 @@ class agent_queue_t
 		worker_finished(
 			//! Type of worker.
 			//! Must be thread_safe_worker or not_thread_safe_worker.
-			unsigned int type_of_worker )
+			state_t type_of_worker )
 			{
-				m_workers -= type_of_worker;
-
-				bool old_active = m_active;
-				if( !m_active )
-					m_active = !empty();
-
-				SO_5_CHECK_INVARIANT( !(m_active && empty()), this )
-				SO_5_CHECK_INVARIANT(
-						!old_active || m_active, this );
-
-				return old_active != m_active;
-			}
+				bool need_schedule = false;
+				state_t old = m_state.load( std::memory_order_acquire );
+				state_t updated;
+				do
+					{
+						updated = old - type_of_worker;
 
-		//! Check the presence of any worker at the moment.
-		bool
-		is_there_any_worker() const
-			{
-				return 0 != m_workers;
-			}
+						need_schedule = ( 0 == ( updated & active_bit ) &&
+								0 != demands_count( updated ) );
+						if( need_schedule )
+							updated |= active_bit;
+					}
+				while( !m_state.compare_exchange_weak(
+						old, updated,
+						std::memory_order_acq_rel,
+						std::memory_order_acquire ) );
 
-		//! Check the presence of thread unsafe worker.
-		bool
-		is_there_not_thread_safe_worker() const
-			{
-				return 0 != (m_workers & not_thread_safe_worker );
+				return need_schedule;
 			}
 
 		//! Is empty queue?
 		bool
-		empty() const { return nullptr == m_head.m_next; }
+		empty() const { return 0 == size(); }
 
 		//! Is active queue?
 		bool
-		active() const { return m_active; }
+		active() const
+			{
+				return 0 != ( m_state.load( std::memory_order_acquire ) &
+						active_bit );
+			}
 
 		/*!
 		 * \brief Get the current size of the queue.
@@ -268,7 +302,8 @@ class agent_queue_t
 		std::size_t
 		size() const
 			{
-				return m_size.load( std::memory_order_acquire );
+				return static_cast< std::size_t >(
+						demands_count( m_state.load( std::memory_order_acquire ) ) );
 			}
 
 	private :
@@ -276,48 +311,22 @@ class agent_queue_t
 		//! this queue.
 		dispatcher_queue_t & m_disp_queue;
 
-		//! Object's lock.
-		spinlock_t m_lock;
-
-		//! Head of the demand's queue.
-		/*!
-		 * Never contains actual demand. Only m_next field is used.
-		 */
-		demand_t m_head;
-		//! Tail of the demand's queue.
-		/*!
-		 * Must point to m_head if queue is empty or to the very
-		 * last queue item otherwise.
-		 */
-		demand_t * m_tail;
-
-		//! Is this queue activated?
-		/*!
-		 * Queue is activated if it is scheduled to dispatcher queue.
-		 */
-		bool m_active;
+		//! State of the queue.
+		std::atomic< state_t > m_state{ 0 };
 
-		//! Count of active workers.
-		unsigned int m_workers;
+		//! Demands of the queue.
+		so_5::disp::reuse::lock_free_demand_queue_t m_demands;
 
+		//! The front demand extracted from m_demands.
 		/*!
-		 * \brief Current size of the queue.
-		 *
-		 * \since
-		 * v.5.5.4
+		 * Is accessed only by the owner of activation token.
 		 */
-		std::atomic< std::size_t > m_size = { 0 };
+		demand_t * m_front{ nullptr };
 
-		//! Helper method for deleting queue's head object.
-		inline void
-		delete_head()
+		static state_t
+		demands_count( state_t state )
 			{
-				auto to_be_deleted = m_head.m_next;
-				m_head.m_next = m_head.m_next->m_next;
-
-				--m_size;
-
-				delete to_be_deleted;
+				return state / one_demand;
 			}
 	};
 
@@ -492,9 +501,33 @@ class work_thread_template_t : public Impl
 
 		//! Launch work thread.
 		void
-		start()
+		start(
+			//! CPUs for the working thread.
+			//! Empty set means that thread is not bound to any CPU.
+			thread_affinity::cpus_t cpus )
+			{
+				this->m_thread = std::thread( [this, cpus]() {
+						thread_affinity::apply_to_current_thread( cpus );
+						body();
+
+						m_finished.store( true, std::memory_order_release );
+					} );
+			}
+
+		/*!
+		 * \brief Is the body of work thread finished?
+		 *
+		 * The body can be finished before the shutdown of the dispatcher
+		 * if the thread is retired in elastic mode. Such thread should
+		 * be joined.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		bool
+		is_finished() const
 			{
-				this->m_thread = std::thread( [this]() { body(); } );
+				return m_finished.load( std::memory_order_acquire );
 			}
 
 		/*!
@@ -513,6 +546,14 @@ class work_thread_template_t : public Impl
 			}
 
 	private :
+		/*!
+		 * \brief Is the body of work thread finished?
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		std::atomic< bool > m_finished{ false };
+
 		//! Thread body method.
 		void
 		body()
@@ -557,40 +598,20 @@ class work_thread_template_t : public Impl
 		void
 		process_queue( agent_queue_t & queue )
 			{
-				std::unique_lock< spinlock_t > lock( queue.lock() );
+				auto & front = queue.front();
+				auto hint = front.m_receiver->so_create_execution_hint( front );
+				const auto type_of_worker = hint.is_thread_safe() ?
+						agent_queue_t::thread_safe_worker :
+						agent_queue_t::not_thread_safe_worker;
 
-				auto demand = queue.peek_front();
-				if( queue.is_there_not_thread_safe_worker() )
-					// We can't process any demand until thread unsafe
-					// worker is working.
+				bool need_schedule = false;
+				auto demand = queue.try_start_worker(
+						type_of_worker, need_schedule );
+				if( !demand )
+					// Demand can't be processed until conflicting
+					// workers are working.
 					return;
 
-				auto hint = demand.m_receiver->so_create_execution_hint( demand );
-
-				bool need_schedule = true;
-				if( !hint.is_thread_safe() )
-				{
-					if( queue.is_there_any_worker() )
-						// We can't process not thread safe demand until
-						// there are some other workers.
-						return;
-					else
-						need_schedule = queue.worker_started(
-								agent_queue_t::not_thread_safe_worker );
-				}
-				else
-					// Threa-safe worker can be started.
-					need_schedule = queue.worker_started(
-							agent_queue_t::thread_safe_worker );
-
-				SO_5_CHECK_INVARIANT( !(need_schedule && queue.empty()), &queue )
-				SO_5_CHECK_INVARIANT(
-						!need_schedule || hint.is_thread_safe(), &queue );
-				SO_5_CHECK_INVARIANT( !need_schedule || queue.active(), &queue );
-
-				// Next few actions must be done on unlocked queue.
-				lock.unlock();
-
 				if( need_schedule )
 					this->m_disp_queue->schedule( &queue );
 
@@ -598,24 +619,12 @@ class work_thread_template_t : public Impl
 				this->work_started();
 
 				// Processing of event.
+				// Note: hint refers to the demand extracted from the queue.
 				hint.exec( this->m_thread_id );
 
 				this->work_finished();
 
-				// Next actions must be done on locked queue.
-				lock.lock();
-
-				need_schedule = queue.worker_finished(
-						hint.is_thread_safe() ?
-								agent_queue_t::thread_safe_worker :
-								agent_queue_t::not_thread_safe_worker );
-
-				SO_5_CHECK_INVARIANT(
-						!need_schedule || queue.active(), &queue );
-
-				lock.unlock();
-
-				if( need_schedule )
+				if( queue.worker_finished( type_of_worker ) )
 					this->m_disp_queue->schedule( &queue );
 			}
 	};
@@ -32,6 +32,20 @@ namespace disp
 namespace adv_thread_pool
 {
 
+namespace impl
+{
+
+//
+// agent_queue_t
+//
+const agent_queue_t::state_t agent_queue_t::active_bit;
+const agent_queue_t::state_t agent_queue_t::not_thread_safe_worker;
+const agent_queue_t::state_t agent_queue_t::thread_safe_worker;
+const agent_queue_t::state_t agent_queue_t::workers_mask;
+const agent_queue_t::state_t agent_queue_t::one_demand;
+
+} /* namespace impl */
+
 namespace
 {
 
@@ -105,7 +119,8 @@ class proxy_dispatcher_t : public proxy_dispatcher_base_t
 							dispatcher_with_activity_tracking_t >(
 						env,
 						m_disp_params.thread_count(),
-						m_disp_params.queue_params() );
+						m_disp_params.queue_params(),
+						m_disp_params.thread_affinity() );
 			}
 	};
 
@@ -55,6 +55,46 @@ class SO_5_TYPE condition_t
 		virtual void
 		wait() SO_5_NOEXCEPT = 0;
 
+		/*!
+		 * \brief Waiting on condition with a timeout.
+		 *
+		 * \retval true if condition was notified.
+		 * \retval false if timeout elapsed.
+		 *
+		 * \attention This method will be called when parent lock object
+		 * is acquired by the current thread.
+		 *
+		 * \note Default implementation doesn't support timeouts. It just
+		 * calls wait() and returns true. Because of that
+		 * is_timed_wait_supported() returns false by default and
+		 * such a condition can't be used in elastic mode of a dispatcher.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		virtual bool
+		wait_for( std::chrono::steady_clock::duration timeout ) SO_5_NOEXCEPT
+			{
+				(void)timeout;
+				wait();
+				return true;
+			}
+
+		/*!
+		 * \brief Does wait_for() really support timeouts?
+		 *
+		 * A custom condition must override this method and return true
+		 * if it provides an actual implementation of wait_for().
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		virtual bool
+		is_timed_wait_supported() const SO_5_NOEXCEPT
+			{
+				return false;
+			}
+
 		/*!
 		 * \brief Notification for waiting customer.
 		 *
@@ -66,39 +66,8 @@ class actual_cond_t : public condition_t
 		virtual void
 		wait() SO_5_NOEXCEPT override
 			{
-				using hrc = std::chrono::high_resolution_clock;
-
-				/*
-				 * NOTE: spinlock of the parent lock object is already
-				 * acquired by the current thread.
-				 */
-				m_signaled = false;
-
-				//
-				// Busy waiting stage.
-				//
-
-				// Limitation for busy waiting stage.
-				const auto stop_point = hrc::now() + m_waiting_time;
-
-				do
-					{
-						m_spinlock.unlock();
-
-						std::this_thread::yield();
-
-						m_spinlock.lock();
-
-						if( m_signaled )
-							return;
-					}
-				while( stop_point > hrc::now() );
-
-				// If we are here then busy waiting stage failed (condition
-				// is not signaled yet) and we must go to long-time waiting.
-				//
-				// NOTE: spinlock of the parent lock object is acquired by
-				// the current thread.
+				if( busy_wait() )
+					return;
 
 				//
 				// Long-time waiting stage.
@@ -117,6 +86,36 @@ class actual_cond_t : public condition_t
 				m_spinlock.lock();
 			}
 
+		virtual bool
+		wait_for(
+			std::chrono::steady_clock::duration timeout ) SO_5_NOEXCEPT override
+			{
+				const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+				if( busy_wait() )
+					return true;
+
+				{
+					std::unique_lock< std::mutex > mutex_lock{ m_mutex };
+					m_spinlock.unlock();
+
+					m_condition.wait_until( mutex_lock, deadline,
+							[this]{ return m_signaled; } );
+				}
+
+				m_spinlock.lock();
+
+				// NOTE: condition can be notified after the timeout but
+				// before the reacquisition of the spinlock.
+				return m_signaled;
+			}
+
+		virtual bool
+		is_timed_wait_supported() const SO_5_NOEXCEPT override
+			{
+				return true;
+			}
+
 		virtual void
 		notify() SO_5_NOEXCEPT override
 			{
@@ -126,6 +125,49 @@ class actual_cond_t : public condition_t
 
 				m_condition.notify_one();
 			}
+
+	private :
+		/*!
+		 * \brief Busy waiting stage.
+		 *
+		 * \retval true if condition was signaled during busy waiting.
+		 *
+		 * \note Spinlock of the parent lock object is acquired on return.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		bool
+		busy_wait() SO_5_NOEXCEPT
+			{
+				using hrc = std::chrono::high_resolution_clock;
+
+				/*
+				 * NOTE: spinlock of the parent lock object is already
+				 * acquired by the current thread.
+				 */
+				m_signaled = false;
+
+				// Limitation for busy waiting stage.
+				const auto stop_point = hrc::now() + m_waiting_time;
+
+				do
+					{
+						m_spinlock.unlock();
+
+						std::this_thread::yield();
+
+						m_spinlock.lock();
+
+						if( m_signaled )
+							return true;
+					}
+				while( stop_point > hrc::now() );
+
+				// If we are here then busy waiting stage failed (condition
+				// is not signaled yet) and we must go to long-time waiting.
+				return false;
+			}
 	};
 
 //
@@ -218,6 +260,26 @@ class actual_cond_t : public condition_t
 				mutex_lock.release();
 			}
 
+		virtual bool
+		wait_for(
+			std::chrono::steady_clock::duration timeout ) SO_5_NOEXCEPT override
+			{
+				m_signaled = false;
+
+				std::unique_lock< std::mutex > mutex_lock{ m_mutex, std::adopt_lock };
+				m_condition.wait_for( mutex_lock, timeout,
+						[this]{ return m_signaled; } );
+				mutex_lock.release();
+
+				return m_signaled;
+			}
+
+		virtual bool
+		is_timed_wait_supported() const SO_5_NOEXCEPT override
+			{
+				return true;
+			}
+
 		virtual void
 		notify() SO_5_NOEXCEPT override
 			{
@@ -209,6 +209,7 @@ class actual_dispatcher_t : public actual_disp_iface_t
 	public:
 		actual_dispatcher_t( disp_params_t params )
 			:	m_work_thread{ params.queue_params().lock_factory() }
+			,	m_thread_cpus{ params.thread_affinity().cpus_for_thread( 0 ) }
 			,	m_data_source( m_work_thread, m_agents_bound )
 			{}
 
@@ -220,7 +221,7 @@ class actual_dispatcher_t : public actual_disp_iface_t
 				m_data_source.start( env );
 
 				so_5::details::do_with_rollback_on_exception(
-						[this] { m_work_thread.start(); },
+						[this] { m_work_thread.start( m_thread_cpus ); },
 						[this] { m_data_source.stop(); } );
 			}
 
@@ -270,6 +271,14 @@ class actual_dispatcher_t : public actual_disp_iface_t
 		//! Working thread for the dispatcher.
 		Work_Thread m_work_thread;
 
+		/*!
+		 * \brief CPUs for the working thread.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		const thread_affinity::cpus_t m_thread_cpus;
+
 		/*!
 		 * \since
 		 * v.5.5.4
@@ -25,6 +25,7 @@
 #include <so_5/disp/mpsc_queue_traits/h/pub.hpp>
 
 #include <so_5/disp/reuse/h/work_thread_activity_tracking.hpp>
+#include <so_5/disp/reuse/h/thread_affinity_mixin.hpp>
 
 namespace so_5 {
 
@@ -53,9 +54,12 @@ namespace queue_traits = so_5::disp::mpsc_queue_traits;
  */
 class disp_params_t
 	:	public so_5::disp::reuse::work_thread_activity_tracking_flag_mixin_t< disp_params_t >
+	,	public so_5::disp::reuse::thread_affinity_mixin_t< disp_params_t >
 	{
 		using activity_tracking_mixin_t = so_5::disp::reuse::
 				work_thread_activity_tracking_flag_mixin_t< disp_params_t >;
+		using thread_affinity_mixin_t = so_5::disp::reuse::
+				thread_affinity_mixin_t< disp_params_t >;
 
 	public :
 		//! Default constructor.
@@ -63,12 +67,16 @@ class disp_params_t
 		//! Copy constructor.
 		disp_params_t( const disp_params_t & o )
 			:	activity_tracking_mixin_t{ o }
+			,	thread_affinity_mixin_t{ o }
 			,	m_queue_params{ o.m_queue_params }
+			,	m_work_stealing{ o.m_work_stealing }
 			{}
 		//! Move constructor.
 		disp_params_t( disp_params_t && o )
 			:	activity_tracking_mixin_t{ std::move(o) }
+			,	thread_affinity_mixin_t{ std::move(o) }
 			,	m_queue_params{ std::move(o.m_queue_params) }
+			,	m_work_stealing{ o.m_work_stealing }
 			{}
 
 		friend inline void swap( disp_params_t & a, disp_params_t & b )
@@ -76,8 +84,12 @@ class disp_params_t
 				swap(
 						static_cast< activity_tracking_mixin_t & >(a),
 						static_cast< activity_tracking_mixin_t & >(b) );
+				swap(
+						static_cast< thread_affinity_mixin_t & >(a),
+						static_cast< thread_affinity_mixin_t & >(b) );
 
 				swap( a.m_queue_params, b.m_queue_params );
+				std::swap( a.m_work_stealing, b.m_work_stealing );
 			}
 
 		//! Copy operator.
@@ -132,9 +144,109 @@ class disp_params_t
 				return m_queue_params;
 			}
 
+		//! Setter for work stealing flag.
+		/*!
+		 * If work stealing is turned on then an idle working thread
+		 * can process demands from queues of higher priorities.
+		 * Only demands for agents bound with bind_params_t::steal_safe()
+		 * can be stolen.
+		 *
+		 * \note Working thread never steals demands of lower priorities.
+		 * It guarantees that processing of demands of higher priorities
+		 * won't be delayed by stolen work.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		disp_params_t &
+		work_stealing( bool v )
+			{
+				m_work_stealing = v;
+				return *this;
+			}
+
+		//! Helper for turning work stealing on.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		disp_params_t &
+		turn_work_stealing_on()
+			{
+				return work_stealing( true );
+			}
+
+		//! Getter for work stealing flag.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		bool
+		work_stealing() const
+			{
+				return m_work_stealing;
+			}
+
 	private :
 		//! Queue parameters.
 		queue_traits::queue_params_t m_queue_params;
+
+		//! Is work stealing turned on?
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		bool m_work_stealing{ false };
+	};
+
+//
+// bind_params_t
+//
+/*!
+ * \brief Parameters for binding agents to %one_per_prio dispatcher.
+ *
+ * \since
+ * v.5.5.25
+ */
+class bind_params_t
+	{
+	public :
+		//! Set steal-safe flag.
+		/*!
+		 * Demands for steal-safe agent can be processed by working
+		 * threads of lower priorities if work stealing is turned on for
+		 * the dispatcher (see disp_params_t::work_stealing()).
+		 *
+		 * Event handlers of a steal-safe agent are never called in
+		 * parallel. A demand is stolen only if there is no other demand
+		 * for the agent in processing and there is no earlier demand for
+		 * the agent in the queue. So the order of demands for the agent
+		 * is kept.
+		 *
+		 * \attention
+		 * Event handlers of a steal-safe agent can be called on
+		 * different working threads. An agent should be marked as
+		 * steal-safe only if it doesn't depend on the identity of
+		 * the working thread (for example it doesn't use thread local
+		 * variables).
+		 */
+		bind_params_t &
+		steal_safe( bool v )
+			{
+				m_steal_safe = v;
+				return *this;
+			}
+
+		//! Get steal-safe flag.
+		bool
+		query_steal_safe() const
+			{
+				return m_steal_safe;
+			}
+
+	private :
+		//! Is agent steal-safe?
+		bool m_steal_safe{ false };
 	};
 
 //
@@ -164,6 +276,16 @@ class SO_5_TYPE private_dispatcher_t : public so_5::atomic_refcounted_t
 		//! Create a binder for that private dispatcher.
 		virtual disp_binder_unique_ptr_t
 		binder() = 0;
+
+		//! Create a binder for that private dispatcher.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		virtual disp_binder_unique_ptr_t
+		binder(
+			//! Binding parameters for the agent.
+			const bind_params_t & params ) = 0;
 	};
 
 /*!
@@ -282,6 +404,27 @@ create_disp_binder(
 	//! Name of the dispatcher to be bound to.
 	const std::string & disp_name );
 
+/*!
+ * \brief Create a dispatcher binder object with binding parameters.
+ *
+ * \since
+ * v.5.5.25
+ *
+ * \par Usage sample
+\code
+using namespace so_5::disp::prio_dedicated_threads::one_per_prio;
+env.introduce_coop(
+	create_disp_binder( "prio", bind_params_t{}.steal_safe( true ) ),
+	[]( so_5::coop_t & coop ) {...} );
+\endcode
+ */
+SO_5_FUNC disp_binder_unique_ptr_t
+create_disp_binder(
+	//! Name of the dispatcher to be bound to.
+	const std::string & disp_name,
+	//! Binding parameters for the agent.
+	const bind_params_t & params );
+
 } /* namespace one_per_prio */
 
 } /* namespace prio_dedicated_threads */
@@ -0,0 +1,660 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Working threads with support of work stealing for
+ * dispatcher with dedicated threads per priority.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/rt/h/agent.hpp>
+#include <so_5/rt/h/event_queue.hpp>
+
+#include <so_5/h/priority.hpp>
+
+#include <so_5/disp/mpsc_queue_traits/h/pub.hpp>
+
+#include <so_5/disp/prio_one_thread/reuse/h/work_thread.hpp>
+
+#include <so_5/details/h/at_scope_exit.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace prio_dedicated_threads {
+
+namespace one_per_prio {
+
+namespace impl {
+
+namespace work_stealing {
+
+namespace queue_traits = so_5::disp::mpsc_queue_traits;
+
+class demand_queue_t;
+
+//
+// stealing_group_t
+//
+/*!
+ * \brief Data shared between all working threads of one dispatcher.
+ *
+ * \since
+ * v.5.5.25
+ */
+struct stealing_group_t
+	{
+		//! Queues of all working threads.
+		/*!
+		 * Index in that vector is a priority of working thread.
+		 */
+		std::vector< demand_queue_t * > m_queues;
+
+		//! Bitmap of idle working threads.
+		/*!
+		 * Bit N is set if working thread for priority N sleeps
+		 * on the empty queue.
+		 */
+		std::atomic< std::uint32_t > m_idle_threads{ 0 };
+
+		static_assert( so_5::prio::total_priorities_count <= 32,
+				"all priorities must fit into m_idle_threads" );
+
+		//! Wake up an idle thread with lower priority than \a priority.
+		/*!
+		 * Is called when demands for \a priority are accumulating.
+		 */
+		inline void
+		wake_thief_for( priority_t priority );
+	};
+
+//
+// extraction_result_t
+//
+/*!
+ * \brief Result of extraction of a demand by owner of the queue.
+ *
+ * \since
+ * v.5.5.25
+ */
+enum class extraction_result_t
+	{
+		//! Demand has been extracted.
+		demand_extracted,
+		//! Queue is shut down.
+		shutting_down,
+		//! Queue is empty and the owner is asked to steal some work.
+		steal_requested
+	};
+
+//
+// demand_queue_t
+//
+/*!
+ * \brief A demand queue for a working thread with support of
+ * work stealing.
+ *
+ * Every demand is marked as steal-safe or not. Only steal-safe
+ * demands can be extracted by working threads of other priorities.
+ *
+ * An agent of steal-safe demands is marked as being in work while
+ * its demand is processed (by the owner of the queue or by a thief).
+ * No other demand of that agent is extracted until the processing
+ * is finished. It guarantees that event handlers of an agent are
+ * never called in parallel and are called in the order of demands.
+ *
+ * \since
+ * v.5.5.25
+ */
+class demand_queue_t
+	{
+		//! Item of the queue.
+		struct item_t
+			{
+				execution_demand_t m_demand;
+				bool m_steal_safe;
+			};
+
+		//! An event_queue facade for agents of a particular kind.
+		class facade_t : public event_queue_t
+			{
+			public :
+				facade_t( demand_queue_t & owner, bool steal_safe )
+					:	m_owner( owner )
+					,	m_steal_safe( steal_safe )
+					{}
+
+				virtual void
+				push( execution_demand_t demand ) override
+					{
+						m_owner.push( std::move(demand), m_steal_safe );
+					}
+
+			private :
+				demand_queue_t & m_owner;
+				const bool m_steal_safe;
+			};
+
+	public :
+		demand_queue_t(
+			priority_t priority,
+			queue_traits::lock_unique_ptr_t lock )
+			:	m_priority( priority )
+			,	m_lock( std::move(lock) )
+			,	m_ordinary_facade( *this, false )
+			,	m_steal_safe_facade( *this, true )
+			{}
+
+		//! Set the group of sibling queues.
+		void
+		set_group( std::shared_ptr< stealing_group_t > group )
+			{
+				m_group = std::move(group);
+			}
+
+		//! Get the group of sibling queues.
+		const stealing_group_t &
+		group() const
+			{
+				return *m_group;
+			}
+
+		//! Get event_queue for binding an agent.
+		event_queue_t &
+		event_queue( bool steal_safe )
+			{
+				if( steal_safe )
+					return m_steal_safe_facade;
+				else
+					return m_ordinary_facade;
+			}
+
+		//! Start demands processing.
+		void
+		start_service()
+			{
+				queue_traits::lock_guard_t lock{ *m_lock };
+				m_in_service = true;
+			}
+
+		//! Stop demands processing.
+		void
+		stop_service()
+			{
+				queue_traits::lock_guard_t lock{ *m_lock };
+				m_in_service = false;
+				lock.notify_one();
+			}
+
+		//! Clear demands queue.
+		void
+		clear()
+			{
+				queue_traits::lock_guard_t lock{ *m_lock };
+				m_demands.clear();
+				m_demands_count.store( 0, std::memory_order_relaxed );
+			}
+
+		//! Get the count of demands in the queue.
+		std::size_t
+		demands_count() const
+			{
+				return m_demands_count.load( std::memory_order_relaxed );
+			}
+
+		//! Ask the owner of the queue to steal some work.
+		void
+		request_steal()
+			{
+				queue_traits::lock_guard_t lock{ *m_lock };
+				if( !m_steal_requested )
+					{
+						m_steal_requested = true;
+						lock.notify_one();
+					}
+			}
+
+		//! Extract a demand for the owner of the queue.
+		/*!
+		 * Sleeps if there is no demand to extract until a new demand,
+		 * a shutdown or a request for stealing.
+		 *
+		 * The first demand whose agent is not in work is extracted.
+		 * Demands of an agent which is processed by a thief are skipped.
+		 *
+		 * If \a in_work is set to true then the agent of the demand
+		 * is marked as being in work and finish_work() must be called
+		 * after the processing of the demand.
+		 */
+		extraction_result_t
+		pop( execution_demand_t & receiver, bool & in_work )
+			{
+				queue_traits::unique_lock_t lock{ *m_lock };
+				for(;;)
+					{
+						if( !m_in_service )
+							return extraction_result_t::shutting_down;
+
+						const auto it = find_demand_for_owner();
+						if( it != m_demands.end() )
+							{
+								in_work = it->m_steal_safe;
+								if( in_work )
+									m_agents_in_work.push_back( it->m_demand.m_receiver );
+
+								receiver = std::move( it->m_demand );
+								m_demands.erase( it );
+								m_demands_count.store(
+										m_demands.size(), std::memory_order_relaxed );
+
+								return extraction_result_t::demand_extracted;
+							}
+
+						if( m_steal_requested )
+							{
+								m_steal_requested = false;
+								return extraction_result_t::steal_requested;
+							}
+
+						m_owner_waiting = true;
+						m_group->m_idle_threads.fetch_or(
+								own_bit(), std::memory_order_acq_rel );
+						lock.wait_for_notify();
+						m_group->m_idle_threads.fetch_and(
+								~own_bit(), std::memory_order_acq_rel );
+						m_owner_waiting = false;
+					}
+			}
+
+		//! Try to extract a steal-safe demand by another working thread.
+		/*!
+		 * The first steal-safe demand whose agent is not in work is
+		 * extracted. All demands of an agent go through the same facade.
+		 * So all of them are steal-safe or not. It means that there is
+		 * no earlier demand for the agent of the found demand in the queue
+		 * and the order of demands for the agent is kept.
+		 *
+		 * The agent of the stolen demand is marked as being in work.
+		 * finish_work() must be called after the processing of the demand.
+		 *
+		 * \return true if demand has been extracted.
+		 */
+		bool
+		try_steal( execution_demand_t & receiver )
+			{
+				queue_traits::lock_guard_t lock{ *m_lock };
+
+				if( !m_in_service )
+					return false;
+
+				const auto it = std::find_if( m_demands.begin(), m_demands.end(),
+						[this]( const item_t & item ) {
+							return item.m_steal_safe &&
+									!is_in_work( item.m_demand.m_receiver );
+						} );
+				if( it == m_demands.end() )
+					return false;
+
+				m_agents_in_work.push_back( it->m_demand.m_receiver );
+
+				receiver = std::move( it->m_demand );
+				m_demands.erase( it );
+				m_demands_count.store(
+						m_demands.size(), std::memory_order_relaxed );
+
+				return true;
+			}
+
+		//! Processing of a demand for the agent is finished.
+		/*!
+		 * Must be called for every demand extracted by try_steal() and
+		 * for demands extracted by pop() with in_work set to true.
+		 */
+		void
+		finish_work( const agent_t * agent )
+			{
+				queue_traits::lock_guard_t lock{ *m_lock };
+
+				const auto it = std::find( m_agents_in_work.begin(),
+						m_agents_in_work.end(), agent );
+				if( it != m_agents_in_work.end() )
+					m_agents_in_work.erase( it );
+
+				// The owner can wait for the completion of that work.
+				if( m_owner_waiting && !m_demands.empty() )
+					lock.notify_one();
+			}
+
+	private :
+		//! Priority of the owner of the queue.
+		const priority_t m_priority;
+
+		//! Queue lock.
+		queue_traits::lock_unique_ptr_t m_lock;
+
+		//! Demands of the queue.
+		std::deque< item_t > m_demands;
+
+		//! Count of demands in the queue.
+		/*!
+		 * Is modified only under the queue lock.
+		 */
+		std::atomic< std::size_t > m_demands_count{ 0 };
+
+		//! Service flag.
+		bool m_in_service{ false };
+
+		//! Is there a request for stealing?
+		bool m_steal_requested{ false };
+
+		//! Is the owner of the queue waiting for a demand?
+		bool m_owner_waiting{ false };
+
+		//! Steal-safe agents whose demands are processed right now.
+		/*!
+		 * There can't be more than one demand in processing for an agent.
+		 * So the size of that container is limited by the count of
+		 * working threads.
+		 */
+		std::vector< const agent_t * > m_agents_in_work;
+
+		//! Group of sibling queues.
+		std::shared_ptr< stealing_group_t > m_group;
+
+		//! Event queue for ordinary agents.
+		facade_t m_ordinary_facade;
+
+		//! Event queue for steal-safe agents.
+		facade_t m_steal_safe_facade;
+
+		std::uint32_t
+		own_bit() const
+			{
+				return std::uint32_t{1} << to_size_t( m_priority );
+			}
+
+		bool
+		is_in_work( const agent_t * agent ) const
+			{
+				return m_agents_in_work.end() != std::find(
+						m_agents_in_work.begin(), m_agents_in_work.end(), agent );
+			}
+
+		//! Find the first demand which can be processed by the owner.
+		/*!
+		 * Demands of steal-safe agents in work are skipped. The order of
+		 * demands for every agent is kept because all demands of an agent
+		 * in work are skipped.
+		 */
+		std::deque< item_t >::iterator
+		find_demand_for_owner()
+			{
+				if( m_agents_in_work.empty() )
+					return m_demands.begin();
+
+				return std::find_if( m_demands.begin(), m_demands.end(),
+						[this]( const item_t & item ) {
+							return !item.m_steal_safe ||
+									!is_in_work( item.m_demand.m_receiver );
+						} );
+			}
+
+		void
+		push( execution_demand_t demand, bool steal_safe )
+			{
+				bool has_backlog = false;
+				{
+					queue_traits::lock_guard_t lock{ *m_lock };
+					if( !m_in_service )
+						return;
+
+					m_demands.push_back( item_t{ std::move(demand), steal_safe } );
+					m_demands_count.store(
+							m_demands.size(), std::memory_order_relaxed );
+
+					// NOTE: the owner can wait while the queue isn't empty if
+					// all demands in the queue are for agents in work.
+					if( m_owner_waiting )
+						lock.notify_one();
+					else
+						// The owner is busy, so demands are accumulating.
+						has_backlog = steal_safe;
+				}
+
+				if( has_backlog )
+					m_group->wake_thief_for( m_priority );
+			}
+	};
+
+inline void
+stealing_group_t::wake_thief_for( priority_t priority )
+	{
+		// Only threads with lower priority can steal the work.
+		// It guarantees that higher priorities won't be delayed
+		// by processing of stolen demands.
+		const auto lower_mask = ( std::uint32_t{1} << to_size_t( priority ) ) - 1u;
+		const auto idle = m_idle_threads.load( std::memory_order_acquire ) &
+				lower_mask;
+		if( idle )
+			{
+				// Idle thread with the lowest priority is preferred.
+				std::size_t index = 0;
+				while( !( idle & ( std::uint32_t{1} << index ) ) )
+					++index;
+
+				m_queues[ index ]->request_steal();
+			}
+	}
+
+//
+// work_thread_template_t
+//
+/*!
+ * \brief A working thread for one priority with ability to steal
+ * the work from threads of higher priorities.
+ *
+ * \since
+ * v.5.5.25
+ */
+template< template<class> class Work_Thread >
+class work_thread_template_t : public Work_Thread< demand_queue_t >
+	{
+		using base_type_t = Work_Thread< demand_queue_t >;
+
+	public :
+		work_thread_template_t(
+			priority_t priority,
+			queue_traits::lock_factory_t lock_factory )
+			// Note: base type only stores the reference to the queue.
+			:	base_type_t{ m_own_queue }
+			,	m_priority( priority )
+			,	m_own_queue{ priority, lock_factory() }
+			{}
+
+		//! Make threads of one dispatcher the members of one group.
+		template< typename Threads >
+		static void
+		link_together( Threads & threads )
+			{
+				auto group = std::make_shared< stealing_group_t >();
+				for( auto & t : threads )
+					group->m_queues.push_back( &(t->m_queue) );
+
+				for( auto & t : threads )
+					t->m_queue.set_group( group );
+			}
+
+		void
+		start(
+			//! CPUs for the working thread.
+			//! Empty set means that thread is not bound to any CPU.
+			thread_affinity::cpus_t cpus = thread_affinity::cpus_t{} )
+			{
+				this->m_queue.start_service();
+				this->m_thread = std::thread( [this, cpus]() {
+						thread_affinity::apply_to_current_thread( cpus );
+						body();
+					} );
+			}
+
+		void
+		shutdown()
+			{
+				this->m_queue.stop_service();
+			}
+
+		void
+		wait()
+			{
+				this->m_thread.join();
+				this->m_queue.clear();
+			}
+
+		event_queue_t *
+		get_agent_binding( bool steal_safe )
+			{
+				return &(this->m_queue.event_queue( steal_safe ));
+			}
+
+		std::size_t
+		demands_count()
+			{
+				return this->m_queue.demands_count();
+			}
+
+		so_5::current_thread_id_t
+		thread_id() const
+			{
+				return this->m_thread_id;
+			}
+
+	private :
+		//! Priority of that thread.
+		const priority_t m_priority;
+
+		//! Queue of demands for that thread.
+		demand_queue_t m_own_queue;
+
+		void
+		body()
+			{
+				this->m_thread_id = so_5::query_current_thread_id();
+
+				execution_demand_t demand;
+				bool in_work = false;
+				for(;;)
+					{
+						this->wait_started();
+						const auto r = this->m_queue.pop( demand, in_work );
+						this->wait_finished();
+
+						if( extraction_result_t::shutting_down == r )
+							break;
+						else if( extraction_result_t::demand_extracted == r )
+							{
+								this->work_started();
+								auto work_meter_stopper = so_5::details::at_scope_exit(
+										[this] { this->work_finished(); } );
+
+								const agent_t * agent = demand.m_receiver;
+								auto in_work_stopper = so_5::details::at_scope_exit(
+										[this, in_work, agent] {
+											if( in_work )
+												this->m_queue.finish_work( agent );
+										} );
+
+								demand.call_handler( this->m_thread_id );
+							}
+						else
+							steal_work();
+					}
+			}
+
+		//! Process demands stolen from threads of higher priorities.
+		/*!
+		 * Stealing is performed while the own queue is empty.
+		 */
+		void
+		steal_work()
+			{
+				execution_demand_t demand;
+				bool stolen = true;
+				while( stolen && !this->m_queue.demands_count() )
+					{
+						stolen = false;
+						auto index = so_5::prio::total_priorities_count - 1;
+						for( ; index > to_size_t( m_priority ); --index )
+							{
+								stolen = sibling_queue( index ).try_steal( demand );
+								if( stolen )
+									break;
+							}
+
+						if( stolen )
+							{
+								this->work_started();
+								auto work_meter_stopper = so_5::details::at_scope_exit(
+										[this] { this->work_finished(); } );
+
+								auto & victim = sibling_queue( index );
+								const agent_t * agent = demand.m_receiver;
+								auto in_work_stopper = so_5::details::at_scope_exit(
+										[&victim, agent] { victim.finish_work( agent ); } );
+
+								// NOTE: the event handler is searched only when
+								// the agent is marked as being in work. So there
+								// is no other thread which works with the agent.
+								demand.call_handler( this->m_thread_id );
+							}
+					}
+			}
+
+		demand_queue_t &
+		sibling_queue( std::size_t index )
+			{
+				return *(this->m_queue.group().m_queues[ index ]);
+			}
+	};
+
+//
+// work_thread_no_activity_tracking_t
+//
+using work_thread_no_activity_tracking_t =
+	work_thread_template_t<
+			so_5::disp::prio_one_thread::reuse::work_thread_details::
+					no_activity_tracking_impl_t >;
+
+//
+// work_thread_with_activity_tracking_t
+//
+using work_thread_with_activity_tracking_t =
+	work_thread_template_t<
+			so_5::disp::prio_one_thread::reuse::work_thread_details::
+					with_activity_tracking_impl_t >;
+
+} /* namespace work_stealing */
+
+} /* namespace impl */
+
+} /* namespace one_per_prio */
+
+} /* namespace prio_dedicated_threads */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
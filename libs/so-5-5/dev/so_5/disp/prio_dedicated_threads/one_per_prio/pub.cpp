@@ -13,6 +13,8 @@
 
 #include <so_5/disp/prio_dedicated_threads/one_per_prio/h/pub.hpp>
 
+#include <so_5/disp/prio_dedicated_threads/one_per_prio/impl/h/work_stealing.hpp>
+
 #include <so_5/disp/reuse/work_thread/h/work_thread.hpp>
 
 #include <so_5/disp/reuse/h/disp_binder_helpers.hpp>
@@ -68,6 +70,99 @@ send_thread_activity_stats(
 				wt.take_activity_stats() );
 	}
 
+void
+send_thread_activity_stats(
+	const so_5::mbox_t &,
+	const stats::prefix_t &,
+	work_stealing::work_thread_no_activity_tracking_t & )
+	{
+		/* Nothing to do */
+	}
+
+void
+send_thread_activity_stats(
+	const so_5::mbox_t & mbox,
+	const stats::prefix_t & prefix,
+	work_stealing::work_thread_with_activity_tracking_t & wt )
+	{
+		so_5::send< stats::messages::work_thread_activity >(
+				mbox,
+				prefix,
+				stats::suffixes::work_thread_activity(),
+				wt.thread_id(),
+				wt.take_activity_stats() );
+	}
+
+//
+// work_thread_traits_t
+//
+/*!
+ * \brief Helpers for handling ordinary working threads.
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename Work_Thread >
+struct work_thread_traits_t
+	{
+		static std::unique_ptr< Work_Thread >
+		make(
+			priority_t,
+			queue_traits::lock_factory_t lock_factory )
+			{
+				return so_5::stdcpp::make_unique< Work_Thread >(
+						std::move(lock_factory) );
+			}
+
+		static void
+		link_together( std::vector< std::unique_ptr< Work_Thread > > & )
+			{
+				/* Nothing to do for ordinary threads */
+			}
+
+		static event_queue_t *
+		agent_binding( Work_Thread & wt, bool /*steal_safe*/ )
+			{
+				return wt.get_agent_binding();
+			}
+	};
+
+/*!
+ * \brief Helpers for handling working threads with work stealing.
+ *
+ * \since
+ * v.5.5.25
+ */
+template< template<class> class Work_Thread_Impl >
+struct work_thread_traits_t<
+		work_stealing::work_thread_template_t< Work_Thread_Impl > >
+	{
+		using work_thread_t =
+				work_stealing::work_thread_template_t< Work_Thread_Impl >;
+
+		static std::unique_ptr< work_thread_t >
+		make(
+			priority_t priority,
+			queue_traits::lock_factory_t lock_factory )
+			{
+				return so_5::stdcpp::make_unique< work_thread_t >(
+						priority,
+						std::move(lock_factory) );
+			}
+
+		static void
+		link_together( std::vector< std::unique_ptr< work_thread_t > > & threads )
+			{
+				work_thread_t::link_together( threads );
+			}
+
+		static event_queue_t *
+		agent_binding( work_thread_t & wt, bool steal_safe )
+			{
+				return wt.get_agent_binding( steal_safe );
+			}
+	};
+
 } /* namespace anonymous */
 
 //
@@ -84,7 +179,10 @@ class actual_disp_iface_t : public so_5::dispatcher_t
 	public :
 		//! Get a binding information for an agent.
 		virtual event_queue_t *
-		get_agent_binding( priority_t priority ) = 0;
+		get_agent_binding(
+			priority_t priority,
+			//! Is agent steal-safe?
+			bool steal_safe ) = 0;
 
 		//! Notification about binding of yet another agent.
 		virtual void
@@ -108,19 +206,22 @@ class actual_disp_iface_t : public so_5::dispatcher_t
 template< typename Work_Thread >
 class dispatcher_template_t : public actual_disp_iface_t
 	{
+		using traits_t = work_thread_traits_t< Work_Thread >;
+
 	public:
 		dispatcher_template_t( disp_params_t params )
 			:	m_data_source{ self() }
+			,	m_thread_affinity{ params.thread_affinity() }
 			{
 				m_threads.reserve( so_5::prio::total_priorities_count );
-				so_5::prio::for_each_priority( [&]( so_5::priority_t ) {
+				so_5::prio::for_each_priority( [&]( so_5::priority_t p ) {
 						auto lock_factory = params.queue_params().lock_factory();
 
-						auto t = so_5::stdcpp::make_unique< Work_Thread >(
-								std::move(lock_factory) );
-
-						m_threads.push_back( std::move(t) );
+						m_threads.push_back(
+								traits_t::make( p, std::move(lock_factory) ) );
 					} );
+
+				traits_t::link_together( m_threads );
 			}
 
 		virtual void
@@ -161,9 +262,13 @@ class dispatcher_template_t : public actual_disp_iface_t
 			}
 
 		virtual event_queue_t *
-		get_agent_binding( priority_t priority ) override
+		get_agent_binding(
+			priority_t priority,
+			bool steal_safe ) override
 			{
-				return m_threads[ to_size_t( priority ) ]->get_agent_binding();
+				return traits_t::agent_binding(
+						*(m_threads[ to_size_t( priority ) ]),
+						steal_safe );
 			}
 
 		virtual void
@@ -273,6 +378,16 @@ class dispatcher_template_t : public actual_disp_iface_t
 		//! Working threads for every priority.
 		std::vector< std::unique_ptr< Work_Thread > > m_threads;
 
+		/*!
+		 * \brief Affinity for working threads.
+		 *
+		 * Index of the working thread is its priority.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		const thread_affinity::affinity_t m_thread_affinity;
+
 		//! Counters for agent count for every priority.
 		std::atomic< std::size_t > m_agents_per_priority[ so_5::prio::total_priorities_count ];
 
@@ -305,7 +420,8 @@ class dispatcher_template_t : public actual_disp_iface_t
 								m_agents_per_priority[ i ].store( 0,
 										std::memory_order_release );
 
-								m_threads[ i ]->start();
+								m_threads[ i ]->start(
+										m_thread_affinity.cpus_for_thread( i ) );
 
 								// Thread successfully started. Pointer to it
 								// must be used on rollback.
@@ -358,9 +474,11 @@ class proxy_dispatcher_t : public proxy_dispatcher_base_t
 			{}
 
 		virtual event_queue_t *
-		get_agent_binding( priority_t priority ) override
+		get_agent_binding(
+			priority_t priority,
+			bool steal_safe ) override
 			{
-				return m_disp->get_agent_binding( priority );
+				return m_disp->get_agent_binding( priority, steal_safe );
 			}
 
 		virtual void
@@ -379,20 +497,40 @@ class proxy_dispatcher_t : public proxy_dispatcher_base_t
 		virtual void
 		do_actual_start( environment_t & env ) override
 			{
-				using namespace so_5::disp::reuse::work_thread;
+				if( m_disp_params.work_stealing() )
+					{
+						using namespace work_stealing;
 
-				using dispatcher_no_activity_tracking_t =
-						dispatcher_template_t< work_thread_no_activity_tracking_t >;
+						using dispatcher_no_activity_tracking_t =
+								dispatcher_template_t< work_thread_no_activity_tracking_t >;
 
-				using dispatcher_with_activity_tracking_t =
-						dispatcher_template_t<
-								work_thread_with_activity_tracking_t >;
+						using dispatcher_with_activity_tracking_t =
+								dispatcher_template_t<
+										work_thread_with_activity_tracking_t >;
 
-				make_actual_dispatcher<
-							dispatcher_no_activity_tracking_t,
-							dispatcher_with_activity_tracking_t >(
-						env,
-						m_disp_params );
+						make_actual_dispatcher<
+									dispatcher_no_activity_tracking_t,
+									dispatcher_with_activity_tracking_t >(
+								env,
+								m_disp_params );
+					}
+				else
+					{
+						using namespace so_5::disp::reuse::work_thread;
+
+						using dispatcher_no_activity_tracking_t =
+								dispatcher_template_t< work_thread_no_activity_tracking_t >;
+
+						using dispatcher_with_activity_tracking_t =
+								dispatcher_template_t<
+										work_thread_with_activity_tracking_t >;
+
+						make_actual_dispatcher<
+									dispatcher_no_activity_tracking_t,
+									dispatcher_with_activity_tracking_t >(
+								env,
+								m_disp_params );
+					}
 			}
 	};
 
@@ -408,15 +546,24 @@ class proxy_dispatcher_t : public proxy_dispatcher_base_t
  */
 class binding_actions_mixin_t
 	{
+	public :
+		binding_actions_mixin_t() = default;
+
+		binding_actions_mixin_t( const bind_params_t & params )
+			:	m_params( params )
+			{}
+
 	protected :
 		disp_binding_activator_t
 		do_bind(
 			actual_disp_iface_t & disp,
 			agent_ref_t agent )
 			{
-				auto result = [agent, &disp]() {
+				const bool steal_safe = m_params.query_steal_safe();
+				auto result = [agent, &disp, steal_safe]() {
 					agent->so_bind_to_dispatcher(
-							*(disp.get_agent_binding( agent->so_priority() )) );
+							*(disp.get_agent_binding(
+									agent->so_priority(), steal_safe )) );
 				};
 
 				// Dispatcher must know about yet another agent bound.
@@ -433,6 +580,14 @@ class binding_actions_mixin_t
 				// Dispatcher must know about yet another agent unbound.
 				disp.agent_unbound( agent->so_priority() );
 			}
+
+	private :
+		//! Binding parameters.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		bind_params_t m_params;
 	};
 
 //
@@ -510,6 +665,16 @@ class real_private_dispatcher_t : public private_dispatcher_t
 								private_dispatcher_handle_t( this ), *m_disp ) );
 			}
 
+		virtual disp_binder_unique_ptr_t
+		binder( const bind_params_t & params ) override
+			{
+				return disp_binder_unique_ptr_t(
+						new private_dispatcher_binder_t(
+								private_dispatcher_handle_t( this ),
+								*m_disp,
+								params ) );
+			}
+
 	private :
 		std::unique_ptr< proxy_dispatcher_t > m_disp;
 	};
@@ -552,6 +717,15 @@ create_disp_binder(
 		return so_5::stdcpp::make_unique< impl::disp_binder_t >( disp_name );
 	}
 
+SO_5_FUNC disp_binder_unique_ptr_t
+create_disp_binder(
+	const std::string & disp_name,
+	const bind_params_t & params )
+	{
+		return so_5::stdcpp::make_unique< impl::disp_binder_t >(
+				disp_name, params );
+	}
+
 } /* namespace one_per_prio */
 
 } /* namespace prio_dedicated_threads */
@@ -24,6 +24,8 @@
 
 #include <so_5/disp/mpsc_queue_traits/h/pub.hpp>
 
+#include <so_5/disp/prio_one_thread/reuse/h/lock_free_subqueue.hpp>
+
 #include <so_5/disp/prio_one_thread/quoted_round_robin/h/quotes.hpp>
 
 namespace so_5 {
@@ -38,36 +40,9 @@ namespace impl {
 
 namespace queue_traits = so_5::disp::mpsc_queue_traits;
 
-//
-// demand_t
-//
-/*!
- * \since
- * v.5.5.8
- *
- * \brief A single execution demand.
- */
-struct demand_t : public execution_demand_t
-	{
-		//! Next demand in the queue.
-		demand_t * m_next = nullptr;
-
-		//! Initializing constructor.
-		demand_t( execution_demand_t && source )
-			:	execution_demand_t( std::move( source ) )
-			{}
-	};
-
-//
-// demand_unique_ptr_t
-//
-/*!
- * \since
- * v.5.5.8
- *
- * \brief An alias for unique_ptr to demand.
- */
-using demand_unique_ptr_t = std::unique_ptr< demand_t >;
+using demand_t = so_5::disp::prio_one_thread::reuse::demand_t;
+using demand_unique_ptr_t =
+		so_5::disp::prio_one_thread::reuse::demand_unique_ptr_t;
 
 //
 // demand_queue_t
@@ -79,6 +54,12 @@ using demand_unique_ptr_t = std::unique_ptr< demand_t >;
  * \brief A demand queue for dispatcher with one common working
  * thread and round-robin processing of prioritised demand on
  * quoted basic.
+ *
+ * \note
+ * Since v.5.5.25 every priority has its own lock-free subqueue.
+ * A bitmap of non-empty subqueues is used by the working thread
+ * for detection of the presence of demands. The queue lock is used only
+ * for sleeping of the working thread when all subqueues are empty.
  */
 class demand_queue_t
 	{
@@ -91,12 +72,15 @@ class demand_queue_t
 				//! Pointer to main demand queue.
 				demand_queue_t * m_demand_queue = nullptr;
 
-				//! Head of the queue.
-				/*! Null if queue is empty. */
-				demand_t * m_head = nullptr;
-				//! Tail of the queue.
-				/*! Null if queue is empty. */
-				demand_t * m_tail = nullptr;
+				//! Priority of this subqueue.
+				/*!
+				 * \note Actual value will be set later in the constructor
+				 * of demand_queue_t.
+				 */
+				priority_t m_priority = priority_t::p_min;
+
+				//! Demands of this priority.
+				so_5::disp::prio_one_thread::reuse::lock_free_subqueue_t m_queue;
 
 				//! A quote for this subqueue.
 				/*!
@@ -105,6 +89,9 @@ class demand_queue_t
 				 */
 				std::size_t m_quote = 0;
 				//! Count of processed demands on the current iterations.
+				/*!
+				 * \note Is accessed only by the working thread.
+				 */
 				std::size_t m_demands_processed = 0;
 
 				/*!
@@ -155,15 +142,11 @@ class demand_queue_t
 						// Every subqueue must have a valid pointer to main demand
 						// queue.
 						q.m_demand_queue = this;
+						q.m_priority = p;
 						// Quote for the subqueue must be defined.
 						q.m_quote = quotes.query( p );
 					} );
 			}
-		~demand_queue_t()
-			{
-				for( auto & q : m_priorities )
-					cleanup_queue( q );
-			}
 
 		//! Set the shutdown signal.
 		void
@@ -171,12 +154,11 @@ class demand_queue_t
 			{
 				queue_traits::lock_guard_t lock{ *m_lock };
 
-				m_shutdown = true;
+				m_shutdown.store( true, std::memory_order_release );
 
-				if( !m_total_demands_count )
-					// There could be a sleeping working thread.
-					// It must be notified.
-					lock.notify_one();
+				// There could be a sleeping working thread.
+				// It must be notified.
+				lock.notify_one();
 			}
 
 		//! Pop demand from the queue.
@@ -186,43 +168,44 @@ class demand_queue_t
 		demand_unique_ptr_t
 		pop()
 			{
-				queue_traits::unique_lock_t lock{ *m_lock };
-
-				while( !m_shutdown && !m_total_demands_count )
-					lock.wait_for_notify();
-
-				if( m_shutdown )
-					throw shutdown_ex_t();
-
-				// Note: this loop should not be infinitife because
-				// m_total_demands_count is not a zero. It means that
-				// there is at least one demand somewhere.
-				while( !m_current_priority->m_head )
-					switch_to_lower_priority();
-
-				// There is a demand to extract.
-				demand_unique_ptr_t result{ m_current_priority->m_head };
-
-				m_current_priority->m_head = result->m_next;
-				if( !m_current_priority->m_head )
-					m_current_priority->m_tail = nullptr;
-
-				result->m_next = nullptr;
-
-				--(m_current_priority->m_demands_count);
-				--m_total_demands_count;
-
-				++(m_current_priority->m_demands_processed);
-
-				if( m_current_priority->m_demands_processed >=
-						m_current_priority->m_quote )
+				for(;;)
 					{
-						// Processing of this priority on the current
-						// iteration is finished.
+						if( m_shutdown.load( std::memory_order_acquire ) )
+							throw shutdown_ex_t();
+
+						const auto mask = m_non_empty_subqueues.load();
+						if( !mask )
+							{
+								wait_for_demands();
+								continue;
+							}
+
+						auto & current = *m_current_priority;
+						if( mask_t::is_set( mask, current.m_priority ) )
+							{
+								demand_unique_ptr_t result{ try_pop( current ) };
+								if( result )
+									{
+										++(current.m_demands_processed);
+
+										if( current.m_demands_processed >=
+												current.m_quote )
+											{
+												// Processing of this priority on the current
+												// iteration is finished.
+												switch_to_lower_priority();
+											}
+
+										return result;
+									}
+							}
+
+						// There is no demand in the current subqueue.
+						// Note: this loop should not be infinitife because
+						// the mask is not a zero. It means that
+						// there is at least one demand somewhere.
 						switch_to_lower_priority();
 					}
-
-				return result;
 			}
 
 		//! Get queue for the priority specified.
@@ -262,35 +245,34 @@ class demand_queue_t
 			}
 
 	private :
+		using mask_t = so_5::disp::prio_one_thread::reuse::priority_mask_t;
+
 		//! Queue lock.
+		/*!
+		 * Is used only for waiting of the working thread on empty queue.
+		 */
 		queue_traits::lock_unique_ptr_t m_lock;
 
 		//! Shutdown flag.
-		bool m_shutdown = false;
+		std::atomic< bool > m_shutdown{ false };
 
-		//! Total count of demands in the queue.
-		std::size_t m_total_demands_count = 0;
+		//! Bitmap of non-empty subqueues.
+		mask_t m_non_empty_subqueues;
 
 		//! Subqueues for priorities.
 		queue_for_one_priority_t m_priorities[
 				static_cast< std::size_t >( priority_t::p_max ) + 1 ];
 
 		//! Pointer to the current subqueue.
+		/*!
+		 * \note Is accessed only by the working thread.
+		 */
 		queue_for_one_priority_t * m_current_priority = nullptr;
 
-		//! Destroy all demands in the queue specified.
-		void
-		cleanup_queue( queue_for_one_priority_t & queue_info )
-			{
-				auto h = queue_info.m_head;
-				while( h )
-					{
-						demand_unique_ptr_t t{ h };
-						h = h->m_next;
-					}
-			}
-
 		//! Push a new demand to the queue.
+		/*!
+		 * \note Can be called by any thread.
+		 */
 		void
 		push(
 			//! Subqueue for the demand.
@@ -298,37 +280,53 @@ class demand_queue_t
 			//! Demand to be pushed.
 			demand_unique_ptr_t demand )
 			{
-				queue_traits::lock_guard_t lock{ *m_lock };
-
-				add_demand_to_queue( *subqueue, std::move( demand ) );
-				++m_total_demands_count;
+				// The counter is incremented before the push. Otherwise
+				// the demand can be extracted and the counter decremented
+				// by the working thread before the increment.
+				++(subqueue->m_demands_count);
+				subqueue->m_queue.push( std::move( demand ) );
 
-				if( 1 == m_total_demands_count )
-					// Queue was empty. A sleeping working thread must
-					// be notified.
-					lock.notify_one();
+				if( !m_non_empty_subqueues.set( subqueue->m_priority ) )
+					{
+						// Queue was empty. A sleeping working thread must
+						// be notified.
+						queue_traits::lock_guard_t lock{ *m_lock };
+						lock.notify_one();
+					}
 			}
 
-		//! Add a new demand to the tail of the queue specified.
+		//! Wait while all subqueues are empty.
 		void
-		add_demand_to_queue(
-			queue_for_one_priority_t & queue,
-			demand_unique_ptr_t demand )
+		wait_for_demands()
 			{
-				if( queue.m_tail )
-					{
-						// Queue is not empty. Tail will be modified.
-						queue.m_tail->m_next = demand.release();
-						queue.m_tail = queue.m_tail->m_next;
-					}
-				else
+				queue_traits::unique_lock_t lock{ *m_lock };
+
+				while( !m_shutdown.load( std::memory_order_acquire ) &&
+						!m_non_empty_subqueues.load() )
+					lock.wait_for_notify();
+			}
+
+		//! Try to extract a demand from the subqueue.
+		/*!
+		 * Clears the bit for the subqueue if it is empty.
+		 *
+		 * \return nullptr if there is no available demand.
+		 */
+		demand_t *
+		try_pop( queue_for_one_priority_t & subqueue )
+			{
+				demand_t * result = subqueue.m_queue.pop();
+				if( result )
+					--(subqueue.m_demands_count);
+				else if( subqueue.m_queue.is_empty() )
 					{
-						// Queue is empty. The whole description will be modified.
-						queue.m_head = demand.release();
-						queue.m_tail = queue.m_head;
+						m_non_empty_subqueues.clear( subqueue.m_priority );
+						// A new demand could be pushed before the bit was cleared.
+						if( !subqueue.m_queue.is_empty() )
+							m_non_empty_subqueues.set( subqueue.m_priority );
 					}
 
-				++(queue.m_demands_count);
+				return result;
 			}
 
 		void
@@ -0,0 +1,151 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Lock-free building blocks for demand queues of dispatchers
+ * with one common working thread and support of demands priority.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/disp/reuse/h/lock_free_demand_queue.hpp>
+
+#include <so_5/h/priority.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace prio_one_thread {
+
+namespace reuse {
+
+//
+// demand_t
+//
+/*!
+ * \brief A single execution demand.
+ *
+ * \since
+ * v.5.5.8, v.5.5.25
+ */
+using demand_t = so_5::disp::reuse::lock_free_demand_t;
+
+//
+// demand_unique_ptr_t
+//
+/*!
+ * \brief An alias for unique_ptr to demand.
+ *
+ * \since
+ * v.5.5.8
+ */
+using demand_unique_ptr_t = so_5::disp::reuse::lock_free_demand_unique_ptr_t;
+
+//
+// lock_free_subqueue_t
+//
+/*!
+ * \brief An intrusive lock-free MPSC queue for demands of one priority.
+ *
+ * \note
+ * Pop operation can be performed only by the working thread of
+ * the dispatcher.
+ *
+ * \since
+ * v.5.5.25
+ */
+using lock_free_subqueue_t = so_5::disp::reuse::lock_free_demand_queue_t;
+
+//
+// priority_mask_t
+//
+/*!
+ * \brief A bitmap of non-empty subqueues.
+ *
+ * Every priority is represented by one bit in an atomic word.
+ * Bit is set by a producer after addition of a new demand to the
+ * subqueue and is cleared by the consumer when it detects that
+ * the subqueue is empty.
+ *
+ * \since
+ * v.5.5.25
+ */
+class priority_mask_t
+	{
+	public :
+		using mask_t = std::uint32_t;
+
+		static_assert( so_5::prio::total_priorities_count <= 32,
+				"all priorities must fit into one mask_t" );
+
+		//! Mark the subqueue for priority \a p as non-empty.
+		/*!
+		 * \return the value of the mask before modification.
+		 */
+		mask_t
+		set( priority_t p )
+			{
+				return m_mask.fetch_or( bit( p ), std::memory_order_acq_rel );
+			}
+
+		//! Mark the subqueue for priority \a p as empty.
+		void
+		clear( priority_t p )
+			{
+				m_mask.fetch_and(
+						static_cast< mask_t >( ~bit( p ) ),
+						std::memory_order_acq_rel );
+			}
+
+		//! Get the current value of the mask.
+		mask_t
+		load() const
+			{
+				return m_mask.load( std::memory_order_acquire );
+			}
+
+		//! Is there a non-empty subqueue for the priority \a p?
+		static bool
+		is_set( mask_t mask, priority_t p )
+			{
+				return 0 != ( mask & bit( p ) );
+			}
+
+		//! Find the highest priority in the non-empty mask.
+		static priority_t
+		highest( mask_t mask )
+			{
+				std::size_t index = so_5::prio::total_priorities_count - 1;
+				while( index && !( mask & ( mask_t{1} << index ) ) )
+					--index;
+
+				return static_cast< priority_t >( index );
+			}
+
+	private :
+		//! Bits for non-empty subqueues.
+		std::atomic< mask_t > m_mask{ 0 };
+
+		static mask_t
+		bit( priority_t p )
+			{
+				return mask_t{1} << to_size_t( p );
+			}
+	};
+
+} /* namespace reuse */
+
+} /* namespace prio_one_thread */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
@@ -20,6 +20,8 @@
 
 #include <so_5/details/h/at_scope_exit.hpp>
 
+#include <so_5/disp/thread_affinity/h/pub.hpp>
+
 #include <thread>
 
 namespace so_5 {
@@ -173,9 +175,15 @@ class work_thread_template_t : public Work_Thread< Demand_Queue >
 			{}
 
 		void
-		start()
+		start(
+			//! CPUs for the working thread.
+			//! Empty set means that thread is not bound to any CPU.
+			thread_affinity::cpus_t cpus = thread_affinity::cpus_t{} )
 			{
-				this->m_thread = std::thread( [this]() { body(); } );
+				this->m_thread = std::thread( [this, cpus]() {
+						thread_affinity::apply_to_current_thread( cpus );
+						body();
+					} );
 			}
 
 		void
@@ -23,6 +23,8 @@
 
 #include <so_5/disp/mpsc_queue_traits/h/pub.hpp>
 
+#include <so_5/disp/prio_one_thread/reuse/h/lock_free_subqueue.hpp>
+
 namespace so_5 {
 
 namespace disp {
@@ -35,36 +37,9 @@ namespace impl {
 
 namespace queue_traits = so_5::disp::mpsc_queue_traits;
 
-//
-// demand_t
-//
-/*!
- * \brief A single execution demand.
- *
- * \since
- * v.5.5.8
- */
-struct demand_t : public execution_demand_t
-	{
-		//! Next demand in the queue.
-		demand_t * m_next = nullptr;
-
-		//! Initializing constructor.
-		demand_t( execution_demand_t && source )
-			:	execution_demand_t( std::move( source ) )
-			{}
-	};
-
-//
-// demand_unique_ptr_t
-//
-/*!
- * \brief An alias for unique_ptr to demand.
- *
- * \since
- * v.5.5.8
- */
-using demand_unique_ptr_t = std::unique_ptr< demand_t >;
+using demand_t = so_5::disp::prio_one_thread::reuse::demand_t;
+using demand_unique_ptr_t =
+		so_5::disp::prio_one_thread::reuse::demand_unique_ptr_t;
 
 //
 // demand_queue_t
@@ -72,6 +47,13 @@ using demand_unique_ptr_t = std::unique_ptr< demand_t >;
 /*!
  * \brief A demand queue with support of demands priorities.
  *
+ * \note
+ * Since v.5.5.25 every priority has its own lock-free subqueue.
+ * A bitmap of non-empty subqueues is used by the working thread
+ * for searching the highest priority with demands. The queue lock
+ * is used only for sleeping of the working thread when all subqueues
+ * are empty.
+ *
  * \since
  * v.5.5.8
  */
@@ -86,12 +68,15 @@ class demand_queue_t
 				//! Pointer to main demand queue.
 				demand_queue_t * m_demand_queue = nullptr;
 
-				//! Head of the queue.
-				/*! Null if queue is empty. */
-				demand_t * m_head = nullptr;
-				//! Tail of the queue.
-				/*! Null if queue is empty. */
-				demand_t * m_tail = nullptr;
+				//! Priority of this subqueue.
+				/*!
+				 * \note Actual value will be set later in the constructor
+				 * of demand_queue_t.
+				 */
+				priority_t m_priority = priority_t::p_min;
+
+				//! Demands of this priority.
+				so_5::disp::prio_one_thread::reuse::lock_free_subqueue_t m_queue;
 
 				/*!
 				 * \name Information for run-time monitoring.
@@ -134,13 +119,11 @@ class demand_queue_t
 			:	m_lock{ std::move(lock) }
 			{
 				// Every subqueue must have a valid pointer to main demand queue.
-				for( auto & q : m_priorities )
-					q.m_demand_queue = this;
-			}
-		~demand_queue_t()
-			{
-				for( auto & q : m_priorities )
-					cleanup_queue( q );
+				so_5::prio::for_each_priority( [&]( priority_t p ) {
+						auto & q = m_priorities[ to_size_t(p) ];
+						q.m_demand_queue = this;
+						q.m_priority = p;
+					} );
 			}
 
 		//! Set the shutdown signal.
@@ -149,12 +132,11 @@ class demand_queue_t
 			{
 				queue_traits::lock_guard_t lock{ *m_lock };
 
-				m_shutdown = true;
+				m_shutdown.store( true, std::memory_order_release );
 
-				if( !m_current_priority )
-					// There could be a sleeping working thread.
-					// It must be notified.
-					lock.notify_one();
+				// There could be a sleeping working thread.
+				// It must be notified.
+				lock.notify_one();
 			}
 
 		//! Pop demand from the queue.
@@ -164,37 +146,27 @@ class demand_queue_t
 		demand_unique_ptr_t
 		pop()
 			{
-				queue_traits::unique_lock_t lock{ *m_lock };
-
-				while( !m_shutdown && !m_current_priority )
-					lock.wait_for_notify();
-
-				if( m_shutdown )
-					throw shutdown_ex_t();
-
-				demand_unique_ptr_t result{ m_current_priority->m_head };
-
-				m_current_priority->m_head = result->m_next;
-				result->m_next = nullptr;
-				--(m_current_priority->m_demands_count);
-
-				if( !m_current_priority->m_head )
+				for(;;)
 					{
-						// Queue become empty.
-						m_current_priority->m_tail = nullptr;
+						if( m_shutdown.load( std::memory_order_acquire ) )
+							throw shutdown_ex_t();
 
-						// A non-empty subqueue with lower priority needs to be found.
-						while( m_current_priority > m_priorities )
+						const auto mask = m_non_empty_subqueues.load();
+						if( !mask )
 							{
-								--m_current_priority;
-								if( m_current_priority->m_head )
-									return result;
+								wait_for_demands();
+								continue;
 							}
 
-						m_current_priority = nullptr;
+						// The highest non-empty subqueue must be used.
+						// If the demand isn't available yet then the mask
+						// will be rechecked on the next iteration.
+						auto & subqueue = m_priorities[
+								to_size_t( mask_t::highest( mask ) ) ];
+						demand_unique_ptr_t result{ try_pop( subqueue ) };
+						if( result )
+							return result;
 					}
-
-				return result;
 			}
 
 		//! Get queue for the priority specified.
@@ -233,36 +205,27 @@ class demand_queue_t
 			}
 
 	private :
+		using mask_t = so_5::disp::prio_one_thread::reuse::priority_mask_t;
+
 		//! Queue lock.
+		/*!
+		 * Is used only for waiting of the working thread on empty queue.
+		 */
 		queue_traits::lock_unique_ptr_t m_lock;
 
 		//! Shutdown flag.
-		bool m_shutdown = false;
+		std::atomic< bool > m_shutdown{ false };
 
-		//! Pointer to the current subqueue.
-		/*!
-		 * This pointer will point to the non-empty subqueue with the
-		 * highest priority demand. If there is no such demand then
-		 * this pointer will be nullptr.
-		 */
-		queue_for_one_priority_t * m_current_priority = nullptr;
+		//! Bitmap of non-empty subqueues.
+		mask_t m_non_empty_subqueues;
 
 		//! Subqueues for priorities.
 		queue_for_one_priority_t m_priorities[ so_5::prio::total_priorities_count ];
 
-		//! Destroy all demands in the queue specified.
-		void
-		cleanup_queue( queue_for_one_priority_t & queue_info )
-			{
-				auto h = queue_info.m_head;
-				while( h )
-					{
-						demand_unique_ptr_t t{ h };
-						h = h->m_next;
-					}
-			}
-
 		//! Push a new demand to the queue.
+		/*!
+		 * \note Can be called by any thread.
+		 */
 		void
 		push(
 			//! Subqueue for the demand.
@@ -270,42 +233,53 @@ class demand_queue_t
 			//! Demand to be pushed.
 			demand_unique_ptr_t demand )
 			{
-				queue_traits::lock_guard_t lock{ *m_lock };
+				// The counter is incremented before the push. Otherwise
+				// the demand can be extracted and the counter decremented
+				// by the working thread before the increment.
+				++(subqueue->m_demands_count);
+				subqueue->m_queue.push( std::move( demand ) );
 
-				add_demand_to_queue( *subqueue, std::move( demand ) );
-
-				if( !m_current_priority )
+				if( !m_non_empty_subqueues.set( subqueue->m_priority ) )
 					{
 						// Queue was empty. A sleeping working thread must
 						// be notified.
-						m_current_priority = subqueue;
+						queue_traits::lock_guard_t lock{ *m_lock };
 						lock.notify_one();
 					}
-				else if( m_current_priority < subqueue )
-					// New demand has greater priority than the previous.
-					m_current_priority = subqueue;
 			}
 
-		//! Add a new demand to the tail of the queue specified.
+		//! Wait while all subqueues are empty.
 		void
-		add_demand_to_queue(
-			queue_for_one_priority_t & queue,
-			demand_unique_ptr_t demand )
+		wait_for_demands()
 			{
-				if( queue.m_tail )
-					{
-						// Queue is not empty. Tail will be modified.
-						queue.m_tail->m_next = demand.release();
-						queue.m_tail = queue.m_tail->m_next;
-					}
-				else
+				queue_traits::unique_lock_t lock{ *m_lock };
+
+				while( !m_shutdown.load( std::memory_order_acquire ) &&
+						!m_non_empty_subqueues.load() )
+					lock.wait_for_notify();
+			}
+
+		//! Try to extract a demand from the subqueue.
+		/*!
+		 * Clears the bit for the subqueue if it is empty.
+		 *
+		 * \return nullptr if there is no available demand.
+		 */
+		demand_t *
+		try_pop( queue_for_one_priority_t & subqueue )
+			{
+				demand_t * result = subqueue.m_queue.pop();
+				if( result )
+					--(subqueue.m_demands_count);
+				else if( subqueue.m_queue.is_empty() )
 					{
-						// Queue is empty. The whole description will be modified.
-						queue.m_head = demand.release();
-						queue.m_tail = queue.m_head;
+						m_non_empty_subqueues.clear( subqueue.m_priority );
+						// A new demand could be pushed before the bit was cleared.
+						if( !subqueue.m_queue.is_empty() )
+							m_non_empty_subqueues.set( subqueue.m_priority );
 					}
 
-				++(queue.m_demands_count);
+				return result;
 			}
 	};
 
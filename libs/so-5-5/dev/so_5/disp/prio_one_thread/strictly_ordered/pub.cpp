@@ -113,6 +113,7 @@ class dispatcher_template_t : public actual_disp_iface_t
 		dispatcher_template_t( disp_params_t params )
 			:	m_demand_queue{ params.queue_params().lock_factory()() }
 			,	m_work_thread{ m_demand_queue }
+			,	m_thread_cpus{ params.thread_affinity().cpus_for_thread( 0 ) }
 			,	m_data_source{ self() }
 			{}
 
@@ -122,7 +123,7 @@ class dispatcher_template_t : public actual_disp_iface_t
 				m_data_source.start( outliving_mutable(env.stats_repository()) );
 
 				so_5::details::do_with_rollback_on_exception(
-						[this] { m_work_thread.start(); },
+						[this] { m_work_thread.start( m_thread_cpus ); },
 						[this] { m_data_source.stop(); } );
 			}
 
@@ -259,6 +260,14 @@ class dispatcher_template_t : public actual_disp_iface_t
 		//! Working thread for the dispatcher.
 		Work_Thread m_work_thread;
 
+		/*!
+		 * \brief CPUs for the working thread.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		const thread_affinity::cpus_t m_thread_cpus;
+
 		//! Data source for run-time monitoring.
 		stats::manually_registered_source_holder_t< disp_data_source_t >
 				m_data_source;
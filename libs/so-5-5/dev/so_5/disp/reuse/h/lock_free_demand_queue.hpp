@@ -0,0 +1,209 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Intrusive lock-free MPSC queue of execution demands.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/rt/h/execution_demand.hpp>
+
+#include <atomic>
+#include <memory>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace reuse {
+
+//
+// lock_free_demand_t
+//
+/*!
+ * \brief A single execution demand.
+ *
+ * \since
+ * v.5.5.25
+ */
+struct lock_free_demand_t : public execution_demand_t
+	{
+		//! Next demand in the queue.
+		std::atomic< lock_free_demand_t * > m_next{ nullptr };
+
+		//! Default constructor.
+		/*!
+		 * Is used for creation of stub items of lock-free queues.
+		 */
+		lock_free_demand_t() = default;
+
+		//! Initializing constructor.
+		lock_free_demand_t( execution_demand_t && source )
+			:	execution_demand_t( std::move( source ) )
+			{}
+	};
+
+//
+// lock_free_demand_unique_ptr_t
+//
+/*!
+ * \brief An alias for unique_ptr to demand.
+ *
+ * \since
+ * v.5.5.25
+ */
+using lock_free_demand_unique_ptr_t = std::unique_ptr< lock_free_demand_t >;
+
+//
+// lock_free_demand_queue_t
+//
+/*!
+ * \brief An intrusive lock-free MPSC queue for demands.
+ *
+ * This is an implementation of well known intrusive MPSC queue by
+ * Dmitry Vyukov. Push operation is wait-free and can be performed by
+ * any thread. Pop operation can be performed only by the single
+ * consumer at a time (for example, working thread of the dispatcher).
+ *
+ * \note
+ * There is a short moment when a producer has already occupied the tail
+ * of the queue but hasn't linked the new item to the previous one yet.
+ * A pop() made at this moment returns nullptr even if the queue isn't
+ * empty. is_empty() should be used by the consumer for distinguishing
+ * this case from the actually empty queue.
+ *
+ * \since
+ * v.5.5.25
+ */
+class lock_free_demand_queue_t
+	{
+	public :
+		lock_free_demand_queue_t()
+			:	m_head{ &m_stub }
+			,	m_tail{ &m_stub }
+			{}
+		~lock_free_demand_queue_t()
+			{
+				// All remaining demands must be destroyed.
+				while( lock_free_demand_t * d = pop() )
+					{
+						lock_free_demand_unique_ptr_t t{ d };
+					}
+			}
+
+		lock_free_demand_queue_t( const lock_free_demand_queue_t & ) = delete;
+		lock_free_demand_queue_t &
+		operator=( const lock_free_demand_queue_t & ) = delete;
+
+		//! Add a new demand to the tail of the queue.
+		/*!
+		 * \note Can be called by any thread.
+		 */
+		void
+		push( lock_free_demand_unique_ptr_t demand )
+			{
+				do_push( demand.release() );
+			}
+
+		//! Extract the demand from the head of the queue.
+		/*!
+		 * \note Must be called only by the consumer thread.
+		 *
+		 * \return nullptr if there is no available demand.
+		 */
+		lock_free_demand_t *
+		pop()
+			{
+				lock_free_demand_t * head = m_head;
+				lock_free_demand_t * next =
+						head->m_next.load( std::memory_order_acquire );
+
+				if( &m_stub == head )
+					{
+						if( !next )
+							// The queue is empty.
+							return nullptr;
+
+						// Stub must be skipped.
+						m_head = next;
+						head = next;
+						next = next->m_next.load( std::memory_order_acquire );
+					}
+
+				if( next )
+					{
+						m_head = next;
+						head->m_next.store( nullptr, std::memory_order_relaxed );
+						return head;
+					}
+
+				if( head != m_tail.load( std::memory_order_acquire ) )
+					// A producer is in the middle of push operation.
+					return nullptr;
+
+				// head is the last item in the queue. Stub must be returned
+				// to the queue to let head to be extracted.
+				do_push( &m_stub );
+
+				next = head->m_next.load( std::memory_order_acquire );
+				if( next )
+					{
+						m_head = next;
+						head->m_next.store( nullptr, std::memory_order_relaxed );
+						return head;
+					}
+
+				return nullptr;
+			}
+
+		//! Is queue empty?
+		/*!
+		 * \note Must be called only by the consumer thread.
+		 */
+		bool
+		is_empty() const
+			{
+				// The queue is empty only if there is just the stub in it
+				// and there is no push operation in progress.
+				return &m_stub == m_head &&
+						&m_stub == m_tail.load( std::memory_order_acquire ) &&
+						!m_stub.m_next.load( std::memory_order_acquire );
+			}
+
+	private :
+		//! A stub item for the queue.
+		lock_free_demand_t m_stub;
+
+		//! Head of the queue.
+		/*!
+		 * Is accessed only by the consumer thread.
+		 */
+		lock_free_demand_t * m_head;
+
+		//! Tail of the queue.
+		/*!
+		 * Is modified by producers.
+		 */
+		std::atomic< lock_free_demand_t * > m_tail;
+
+		void
+		do_push( lock_free_demand_t * demand )
+			{
+				demand->m_next.store( nullptr, std::memory_order_relaxed );
+				lock_free_demand_t * prev = m_tail.exchange(
+						demand, std::memory_order_acq_rel );
+				prev->m_next.store( demand, std::memory_order_release );
+			}
+	};
+
+} /* namespace reuse */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
@@ -15,6 +15,8 @@
 
 #include <deque>
 #include <vector>
+#include <functional>
+#include <algorithm>
 
 namespace so_5
 {
@@ -35,6 +37,12 @@ namespace reuse
  * - waiting on spinlock for the limited period of time;
  * - then waiting on heavy synchronization object.
  *
+ * Since v.5.5.25 the queue supports an elastic mode (see
+ * enable_elasticity()). In that mode the queue asks for a new working
+ * thread if there are too many non-empty queues and there is no free
+ * working threads. And a working thread is retired if it waits for
+ * work for too long.
+ *
  * \tparam T type of object.
  *
  * \since
@@ -49,6 +57,7 @@ class mpmc_ptr_queue_t
 			std::size_t thread_count )
 			:	m_lock{ queue_params.lock_factory()() }
 			,	m_max_thread_count{ thread_count }
+			,	m_thread_count{ thread_count }
 			,	m_next_thread_wakeup_threshold{
 					queue_params.next_thread_wakeup_threshold() }
 			{
@@ -57,6 +66,88 @@ class mpmc_ptr_queue_t
 				m_waiting_customers.reserve( thread_count );
 			}
 
+		/*!
+		 * \brief Turn elastic mode on.
+		 *
+		 * The count of working threads passed to the constructor is
+		 * treated as the max count of working threads. The initial count
+		 * of threads is \a min_thread_count.
+		 *
+		 * \attention Must be called before the start of working threads.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		enable_elasticity(
+			//! Min count of working threads.
+			std::size_t min_thread_count,
+			//! New thread is requested if there are more non-empty queues
+			//! than this value and there is no free working threads.
+			std::size_t backlog_threshold,
+			//! A working thread is retired if it waits for work
+			//! longer than this value.
+			std::chrono::steady_clock::duration idle_timeout,
+			//! Action for requesting a new working thread.
+			//! It is called on the sender's thread when the queue's lock
+			//! is not acquired. So it must only pass the request to
+			//! someone else and must not create a thread itself.
+			std::function< void() > new_thread_requester )
+			{
+				m_elastic = true;
+				m_min_thread_count = min_thread_count;
+				m_thread_count = min_thread_count;
+				m_backlog_threshold = backlog_threshold;
+				m_idle_timeout = idle_timeout;
+				m_new_thread_requester = std::move(new_thread_requester);
+			}
+
+		/*!
+		 * \brief Rollback of the changes made for a new working thread
+		 * which can't be created.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		new_thread_not_started()
+			{
+				std::lock_guard< so_5::disp::mpmc_queue_traits::lock_t > lock{ *m_lock };
+
+				--m_thread_count;
+				--m_threads_added;
+			}
+
+		/*!
+		 * \brief Information about the count of working threads.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		struct thread_count_info_t
+			{
+				//! The current count of working threads.
+				std::size_t m_thread_count;
+				//! Total count of threads added in elastic mode.
+				std::size_t m_threads_added;
+				//! Total count of threads retired in elastic mode.
+				std::size_t m_threads_retired;
+			};
+
+		/*!
+		 * \brief Get the information about the count of working threads.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		thread_count_info_t
+		query_thread_count_info()
+			{
+				std::lock_guard< so_5::disp::mpmc_queue_traits::lock_t > lock{ *m_lock };
+
+				return { m_thread_count, m_threads_added, m_threads_retired };
+			}
+
 		//! Initiate shutdown for working threads.
 		inline void
 		shutdown()
@@ -71,7 +162,9 @@ class mpmc_ptr_queue_t
 
 		//! Get next active queue.
 		/*!
-		 * \retval nullptr is the case of dispatcher shutdown.
+		 * \retval nullptr is the case of dispatcher shutdown or, since
+		 * v.5.5.25, the case of retirement of the current working thread
+		 * in elastic mode.
 		 */
 		inline T *
 		pop( so_5::disp::mpmc_queue_traits::condition_t & condition )
@@ -96,7 +189,21 @@ class mpmc_ptr_queue_t
 
 						m_waiting_customers.push_back( &condition );
 
-						condition.wait();
+						if( m_elastic && m_thread_count > m_min_thread_count )
+							{
+								if( !condition.wait_for( m_idle_timeout ) )
+									{
+										// The current thread was idle for too long.
+										remove_waiting_customer( condition );
+										if( try_retire_current_thread() )
+											break;
+										else
+											continue;
+									}
+							}
+						else
+							condition.wait();
+
 						// If we are here then the current wakeup procedure is
 						// finished.
 						m_wakeup_in_progress = false;
@@ -141,11 +248,22 @@ class mpmc_ptr_queue_t
 		void
 		schedule( T * queue )
 			{
-				std::lock_guard< so_5::disp::mpmc_queue_traits::lock_t > lock{ *m_lock };
+				bool new_thread_needed = false;
+				{
+					std::lock_guard< so_5::disp::mpmc_queue_traits::lock_t > lock{ *m_lock };
 
-				m_queue.push_back( queue );
+					m_queue.push_back( queue );
 
-				try_wakeup_someone_if_possible();
+					try_wakeup_someone_if_possible();
+
+					if( m_elastic )
+						new_thread_needed = try_reserve_new_thread();
+				}
+
+				// A new thread must be requested when the queue's lock is
+				// released.
+				if( new_thread_needed )
+					m_new_thread_requester();
 			}
 
 		so_5::disp::mpmc_queue_traits::condition_unique_ptr_t
@@ -181,6 +299,15 @@ class mpmc_ptr_queue_t
 		 */
 		const std::size_t m_max_thread_count;
 
+		//! The current count of working threads.
+		/*!
+		 * It is equal to m_max_thread_count if elastic mode is not used.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		std::size_t m_thread_count;
+
 		/*!
 		 * \brief Threshold for wake up next working thread if there are
 		 * non-empty agent queues.
@@ -193,6 +320,101 @@ class mpmc_ptr_queue_t
 		//! Waiting threads.
 		std::vector< so_5::disp::mpmc_queue_traits::condition_t * > m_waiting_customers;
 
+		/*!
+		 * \name Elastic mode related stuff.
+		 * \since
+		 * v.5.5.25
+		 * \{
+		 */
+		//! Is elastic mode turned on?
+		bool m_elastic{ false };
+
+		//! Min count of working threads.
+		std::size_t m_min_thread_count{ 0 };
+
+		//! Threshold for requesting a new working thread.
+		std::size_t m_backlog_threshold{ 0 };
+
+		//! Max idle time for a working thread.
+		std::chrono::steady_clock::duration m_idle_timeout{};
+
+		//! Action for requesting a new working thread.
+		std::function< void() > m_new_thread_requester;
+
+		//! Total count of added threads.
+		std::size_t m_threads_added{ 0 };
+
+		//! Total count of retired threads.
+		std::size_t m_threads_retired{ 0 };
+		/*!
+		 * \}
+		 */
+
+		/*!
+		 * \brief Remove the customer which wasn't notified.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		remove_waiting_customer(
+			so_5::disp::mpmc_queue_traits::condition_t & condition )
+			{
+				auto it = std::find( m_waiting_customers.begin(),
+						m_waiting_customers.end(),
+						&condition );
+				if( it != m_waiting_customers.end() )
+					m_waiting_customers.erase( it );
+			}
+
+		/*!
+		 * \brief An attempt to retire the current working thread after
+		 * idle timeout.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		bool
+		try_retire_current_thread()
+			{
+				if( !m_shutdown && m_queue.empty() &&
+						m_thread_count > m_min_thread_count )
+					{
+						--m_thread_count;
+						++m_threads_retired;
+						return true;
+					}
+
+				return false;
+			}
+
+		/*!
+		 * \brief Check the necessity of a new working thread.
+		 *
+		 * A new thread is necessary if there is no free working thread and
+		 * the count of non-empty queues is greater than m_backlog_threshold.
+		 *
+		 * \note The place for the new thread is reserved by this method.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		bool
+		try_reserve_new_thread()
+			{
+				if( !m_shutdown &&
+						m_waiting_customers.empty() &&
+						m_queue.size() > m_backlog_threshold &&
+						m_thread_count < m_max_thread_count )
+					{
+						++m_thread_count;
+						++m_threads_added;
+						return true;
+					}
+
+				return false;
+			}
+
 		void
 		pop_and_notify_one_waiting_customer()
 			{
@@ -217,6 +439,9 @@ class mpmc_ptr_queue_t
 		 * - count of items in m_queue is greater than
 		 *   m_next_thread_wakeup_threshold or there is no active customers at
 		 *   all.
+		 *
+		 * \note Since v.5.5.25 the current count of working threads is used
+		 * for detection of absence of active customers.
 		 */
 		void
 		try_wakeup_someone_if_possible()
@@ -225,7 +450,7 @@ class mpmc_ptr_queue_t
 						!m_waiting_customers.empty() &&
 						!m_wakeup_in_progress &&
 						( m_queue.size() > m_next_thread_wakeup_threshold ||
-						m_max_thread_count == m_waiting_customers.size() ) )
+						m_thread_count == m_waiting_customers.size() ) )
 					pop_and_notify_one_waiting_customer();
 			}
 	};
@@ -0,0 +1,64 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief Helpers to work with thread affinity of working threads.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/disp/thread_affinity/h/pub.hpp>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace reuse {
+
+/*!
+ * \brief Mixin with thread affinity for working threads.
+ *
+ * Indended to be used as mixin for various disp_params_t classes.
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename Params >
+class thread_affinity_mixin_t
+	{
+		thread_affinity::affinity_t m_affinity;
+
+	public :
+		//! Getter for thread affinity.
+		const thread_affinity::affinity_t &
+		thread_affinity() const
+			{
+				return m_affinity;
+			}
+
+		friend inline void swap(
+				thread_affinity_mixin_t & a,
+				thread_affinity_mixin_t & b ) SO_5_NOEXCEPT
+			{
+				swap( a.m_affinity, b.m_affinity );
+			}
+
+		//! Setter for thread affinity.
+		Params &
+		thread_affinity( thread_affinity::affinity_t v )
+			{
+				m_affinity = std::move(v);
+				return static_cast< Params & >(*this);
+			}
+	};
+
+} /* namespace reuse */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
@@ -166,6 +166,22 @@ class stats_consumer_t
 		virtual void
 		set_thread_count( std::size_t value ) = 0;
 
+		/*!
+		 * \brief Informs consumer about changes of thread count
+		 * in elastic mode.
+		 *
+		 * \note This method is called only if elastic mode is used.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		virtual void
+		set_thread_resize_counters(
+			//! Total count of started threads.
+			std::size_t threads_added,
+			//! Total count of retired threads.
+			std::size_t threads_retired ) = 0;
+
 		//! Informs counsumer about yet another event queue.
 		virtual void
 		add_queue(
@@ -254,6 +270,21 @@ class data_source_t : public stats::source_t
 						stats::suffixes::disp_thread_count(),
 						collector.thread_count() );
 
+				if( collector.is_elastic() )
+					{
+						so_5::send< stats::messages::quantity< std::size_t > >(
+								mbox,
+								m_prefix,
+								stats::suffixes::disp_threads_added_count(),
+								collector.threads_added() );
+
+						so_5::send< stats::messages::quantity< std::size_t > >(
+								mbox,
+								m_prefix,
+								stats::suffixes::disp_threads_retired_count(),
+								collector.threads_retired() );
+					}
+
 				so_5::send< stats::messages::quantity< std::size_t > >(
 						mbox,
 						m_prefix,
@@ -380,6 +411,16 @@ class data_source_t : public stats::source_t
 						m_thread_count = thread_count;
 					}
 
+				virtual void
+				set_thread_resize_counters(
+					std::size_t threads_added,
+					std::size_t threads_retired ) override
+					{
+						m_elastic = true;
+						m_threads_added = threads_added;
+						m_threads_retired = threads_retired;
+					}
+
 				virtual void
 				add_queue(
 					const intrusive_ptr_t< queue_description_holder_t > & info ) override
@@ -419,6 +460,24 @@ class data_source_t : public stats::source_t
 						return m_agent_count;
 					}
 
+				bool
+				is_elastic() const
+					{
+						return m_elastic;
+					}
+
+				std::size_t
+				threads_added() const
+					{
+						return m_threads_added;
+					}
+
+				std::size_t
+				threads_retired() const
+					{
+						return m_threads_retired;
+					}
+
 				template< typename Lambda >
 				void
 				for_each_queue( Lambda lambda ) const
@@ -446,6 +505,10 @@ class data_source_t : public stats::source_t
 				std::size_t m_thread_count = { 0 };
 				std::size_t m_agent_count = { 0 };
 
+				bool m_elastic = { false };
+				std::size_t m_threads_added = { 0 };
+				std::size_t m_threads_retired = { 0 };
+
 				wt_activity_info_container_t & m_wt_activity;
 
 				intrusive_ptr_t< queue_description_holder_t > m_queue_desc_head;
@@ -23,6 +23,7 @@
 #include <so_5/rt/h/event_queue.hpp>
 
 #include <so_5/disp/mpsc_queue_traits/h/pub.hpp>
+#include <so_5/disp/thread_affinity/h/pub.hpp>
 
 #include <so_5/rt/stats/h/work_thread_activity.hpp>
 #include <so_5/rt/stats/impl/h/activity_tracking.hpp>
@@ -555,12 +556,18 @@ public :
 
 	//! Start the working thread.
 	void
-	start()
+	start(
+		//! CPUs for the working thread.
+		//! Empty set means that thread is not bound to any CPU.
+		thread_affinity::cpus_t cpus = thread_affinity::cpus_t{} )
 	{
 		this->m_queue.start_service();
 		this->m_status = status_t::working;
 
-		this->m_thread = std::thread( [this]() { this->body(); } );
+		this->m_thread = std::thread( [this, cpus]() {
+				thread_affinity::apply_to_current_thread( cpus );
+				this->body();
+			} );
 	}
 
 	//! Send the shutdown signal to the working thread.
@@ -0,0 +1,207 @@
+/*
+ * SObjectizer 5
+ */
+
+/*!
+ * \file
+ * \brief Thread affinity for working threads of dispatchers.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/h/declspec.hpp>
+#include <so_5/h/compiler_features.hpp>
+
+#include <vector>
+#include <cstddef>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace thread_affinity {
+
+//
+// cpu_index_t
+//
+/*!
+ * \brief Type for index of a logical CPU.
+ *
+ * \since
+ * v.5.5.25
+ */
+using cpu_index_t = unsigned int;
+
+//
+// cpus_t
+//
+/*!
+ * \brief Set of logical CPUs a thread is allowed to run on.
+ *
+ * Empty set means that there is no restriction for the thread.
+ *
+ * \since
+ * v.5.5.25
+ */
+using cpus_t = std::vector< cpu_index_t >;
+
+//
+// affinity_t
+//
+/*!
+ * \brief Description of thread affinity for working threads
+ * of a dispatcher.
+ *
+ * Holds a list of CPU sets. Working thread with index N is bound to the
+ * set with index (N % count_of_sets). Default constructed object has
+ * no sets and working threads are not bound to any CPU.
+ *
+ * \note
+ * Binding of a working thread to CPUs is a hint only. If the binding
+ * can't be done by OS (for example, because of unknown CPU) the thread
+ * works without any binding.
+ *
+ * \par Usage sample
+\code
+using namespace so_5::disp;
+// Every thread from the pool is bound to its own CPU.
+auto disp = thread_pool::create_private_disp( env,
+	thread_pool::disp_params_t{}
+		.thread_count( 4 )
+		.thread_affinity(
+			thread_affinity::affinity_t::one_cpu_per_thread( { 0, 2, 4, 6 } ) ) );
+
+// All threads of active_obj dispatcher work on CPUs of NUMA node 1.
+auto disp2 = active_obj::create_private_disp( env,
+	active_obj::disp_params_t{}
+		.thread_affinity( thread_affinity::affinity_t::numa_node( 1 ) ) );
+\endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+class affinity_t
+	{
+	public :
+		//! Default constructor.
+		/*!
+		 * Working threads are not bound to any CPU.
+		 */
+		affinity_t() = default;
+
+		//! All working threads are bound to the same set of CPUs.
+		static affinity_t
+		same_cpus( cpus_t cpus )
+			{
+				affinity_t result;
+				if( !cpus.empty() )
+					result.m_sets.push_back( std::move(cpus) );
+				return result;
+			}
+
+		//! Every working thread is bound to the single CPU.
+		/*!
+		 * Thread with index N is bound to CPU cpus[N % cpus.size()].
+		 */
+		static affinity_t
+		one_cpu_per_thread( const cpus_t & cpus )
+			{
+				affinity_t result;
+				for( auto cpu : cpus )
+					result.m_sets.push_back( cpus_t{ cpu } );
+				return result;
+			}
+
+		//! Every working thread is bound to its own set of CPUs.
+		/*!
+		 * Thread with index N is bound to sets[N % sets.size()].
+		 */
+		static affinity_t
+		per_thread( std::vector< cpus_t > sets )
+			{
+				affinity_t result;
+				result.m_sets = std::move(sets);
+				return result;
+			}
+
+		//! All working threads are bound to CPUs of a NUMA node.
+		/*!
+		 * \throw so_5::exception_t if the list of CPUs for the node
+		 * can't be obtained.
+		 */
+		static inline affinity_t
+		numa_node( unsigned int node );
+
+		//! Are there any restrictions for working threads?
+		bool
+		empty() const
+			{
+				return m_sets.empty();
+			}
+
+		//! Get a set of CPUs for a working thread.
+		/*!
+		 * \return an empty set if there is no restrictions for the thread.
+		 */
+		cpus_t
+		cpus_for_thread( std::size_t thread_index ) const
+			{
+				if( m_sets.empty() )
+					return cpus_t{};
+
+				return m_sets[ thread_index % m_sets.size() ];
+			}
+
+		friend inline void
+		swap( affinity_t & a, affinity_t & b ) SO_5_NOEXCEPT
+			{
+				a.m_sets.swap( b.m_sets );
+			}
+
+	private :
+		//! Sets of CPUs for working threads.
+		std::vector< cpus_t > m_sets;
+	};
+
+/*!
+ * \brief Get the list of CPUs of a NUMA node.
+ *
+ * \throw so_5::exception_t if the list can't be obtained or is empty.
+ *
+ * \note
+ * This function is implemented only for Linux and Windows.
+ *
+ * \since
+ * v.5.5.25
+ */
+SO_5_FUNC cpus_t
+cpus_of_numa_node( unsigned int node );
+
+/*!
+ * \brief Bind the current thread to the set of CPUs.
+ *
+ * Does nothing if \a cpus is empty.
+ *
+ * \return false if OS can't bind the thread or there is no
+ * support for thread affinity for the current platform.
+ *
+ * \since
+ * v.5.5.25
+ */
+SO_5_FUNC bool
+apply_to_current_thread( const cpus_t & cpus ) SO_5_NOEXCEPT;
+
+inline affinity_t
+affinity_t::numa_node( unsigned int node )
+	{
+		return same_cpus( cpus_of_numa_node( node ) );
+	}
+
+} /* namespace thread_affinity */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
@@ -0,0 +1,189 @@
+/*
+ * SObjectizer 5
+ */
+
+/*!
+ * \file
+ * \brief Thread affinity for working threads of dispatchers.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#include <so_5/disp/thread_affinity/h/pub.hpp>
+
+#include <so_5/h/exception.hpp>
+#include <so_5/h/ret_code.hpp>
+
+#if defined( _WIN32 )
+	#if !defined( NOMINMAX )
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#elif defined( __linux__ )
+	#include <pthread.h>
+	#include <sched.h>
+
+	#include <fstream>
+	#include <sstream>
+#endif
+
+#include <string>
+#include <stdexcept>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace thread_affinity {
+
+namespace {
+
+#if defined( __linux__ )
+
+//! Parse the list of CPUs in form "0-3,8,10-11".
+cpus_t
+parse_cpu_list( const std::string & list )
+	{
+		cpus_t result;
+
+		std::istringstream ss{ list };
+		std::string range;
+		while( std::getline( ss, range, ',' ) )
+			{
+				if( range.empty() || '\n' == range[ 0 ] )
+					continue;
+
+				const auto dash = range.find( '-' );
+				const auto first = static_cast< cpu_index_t >(
+						std::stoul( range.substr( 0, dash ) ) );
+				const auto last = std::string::npos == dash ? first :
+						static_cast< cpu_index_t >(
+								std::stoul( range.substr( dash + 1 ) ) );
+
+				// The loop is stopped explicitly to avoid an overflow of
+				// cpu if last is the max value of cpu_index_t.
+				for( auto cpu = first; cpu <= last; ++cpu )
+					{
+						result.push_back( cpu );
+						if( cpu == last )
+							break;
+					}
+			}
+
+		return result;
+	}
+
+#endif
+
+[[noreturn]] void
+throw_unknown_numa_node( unsigned int node )
+	{
+		throw so_5::exception_t(
+				"unable to get list of CPUs for NUMA node: " +
+						std::to_string( node ),
+				rc_unknown_numa_node );
+	}
+
+} /* namespace anonymous */
+
+#if defined( _WIN32 )
+
+SO_5_FUNC cpus_t
+cpus_of_numa_node( unsigned int node )
+	{
+		ULONGLONG mask = 0;
+		if( node > 0xffu ||
+				!GetNumaNodeProcessorMask( static_cast< UCHAR >( node ), &mask ) ||
+				!mask )
+			throw_unknown_numa_node( node );
+
+		cpus_t result;
+		for( cpu_index_t cpu = 0; cpu != 64u; ++cpu )
+			if( mask & ( ULONGLONG{1} << cpu ) )
+				result.push_back( cpu );
+
+		return result;
+	}
+
+SO_5_FUNC bool
+apply_to_current_thread( const cpus_t & cpus ) SO_5_NOEXCEPT
+	{
+		if( cpus.empty() )
+			return true;
+
+		DWORD_PTR mask = 0;
+		for( auto cpu : cpus )
+			if( cpu < sizeof( mask ) * 8u )
+				mask |= DWORD_PTR{1} << cpu;
+
+		return 0 != mask &&
+				0 != SetThreadAffinityMask( GetCurrentThread(), mask );
+	}
+
+#elif defined( __linux__ )
+
+SO_5_FUNC cpus_t
+cpus_of_numa_node( unsigned int node )
+	{
+		std::ifstream file{ "/sys/devices/system/node/node" +
+				std::to_string( node ) + "/cpulist" };
+
+		std::string list;
+		if( !file || !std::getline( file, list ) )
+			throw_unknown_numa_node( node );
+
+		cpus_t result;
+		try
+			{
+				result = parse_cpu_list( list );
+			}
+		catch( const std::logic_error & )
+			{
+				// Format of the list isn't recognized.
+			}
+
+		if( result.empty() )
+			throw_unknown_numa_node( node );
+
+		return result;
+	}
+
+SO_5_FUNC bool
+apply_to_current_thread( const cpus_t & cpus ) SO_5_NOEXCEPT
+	{
+		if( cpus.empty() )
+			return true;
+
+		::cpu_set_t set;
+		CPU_ZERO( &set );
+		for( auto cpu : cpus )
+			if( cpu < CPU_SETSIZE )
+				CPU_SET( cpu, &set );
+
+		return 0 != CPU_COUNT( &set ) &&
+				0 == pthread_setaffinity_np( pthread_self(), sizeof( set ), &set );
+	}
+
+#else
+
+SO_5_FUNC cpus_t
+cpus_of_numa_node( unsigned int node )
+	{
+		throw_unknown_numa_node( node );
+	}
+
+SO_5_FUNC bool
+apply_to_current_thread( const cpus_t & cpus ) SO_5_NOEXCEPT
+	{
+		// Thread affinity isn't supported on that platform.
+		return cpus.empty();
+	}
+
+#endif
+
+} /* namespace thread_affinity */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
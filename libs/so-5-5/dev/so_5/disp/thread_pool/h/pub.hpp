@@ -18,8 +18,10 @@
 #include <so_5/disp/mpmc_queue_traits/h/pub.hpp>
 
 #include <so_5/disp/reuse/h/work_thread_activity_tracking.hpp>
+#include <so_5/disp/reuse/h/thread_affinity_mixin.hpp>
 
 #include <utility>
+#include <chrono>
 
 namespace so_5
 {
@@ -37,6 +39,129 @@ namespace thread_pool
  */
 namespace queue_traits = so_5::disp::mpmc_queue_traits;
 
+//
+// elastic_params_t
+//
+/*!
+ * \brief Parameters for elastic mode of %thread_pool dispatcher.
+ *
+ * In elastic mode the dispatcher starts with min_thread_count working
+ * threads. A new working thread is started if there are more than
+ * backlog_threshold non-empty event queues and there is no free working
+ * thread (but the count of threads never exceeds max_thread_count).
+ * A working thread is stopped if it has no work for idle_timeout (but
+ * there are always at least min_thread_count threads).
+ *
+ * \par Usage sample
+\code
+using namespace so_5::disp::thread_pool;
+auto disp = create_private_disp( env,
+	"workers",
+	disp_params_t{}.elastic(
+		elastic_params_t{ 2, 16 }
+			.idle_timeout( std::chrono::seconds(5) ) ) );
+\endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+class elastic_params_t
+	{
+	public :
+		//! Default constructor.
+		/*!
+		 * Elastic mode is turned off.
+		 */
+		elastic_params_t() {}
+
+		//! Initializing constructor.
+		/*!
+		 * \note Value of \a min_thread_count must be greater than 0.
+		 * Value of \a max_thread_count must not be less than
+		 * \a min_thread_count.
+		 */
+		elastic_params_t(
+			std::size_t min_thread_count,
+			std::size_t max_thread_count )
+			:	m_min_thread_count{ min_thread_count ? min_thread_count : 1u }
+			,	m_max_thread_count{ max_thread_count < m_min_thread_count ?
+					m_min_thread_count : max_thread_count }
+			{}
+
+		//! Is elastic mode turned on?
+		bool
+		enabled() const
+			{
+				return 0 != m_max_thread_count;
+			}
+
+		//! Getter for min count of working threads.
+		std::size_t
+		min_thread_count() const
+			{
+				return m_min_thread_count;
+			}
+
+		//! Getter for max count of working threads.
+		std::size_t
+		max_thread_count() const
+			{
+				return m_max_thread_count;
+			}
+
+		//! Setter for backlog threshold.
+		/*!
+		 * A new working thread is started if the count of non-empty
+		 * event queues waiting for a working thread is greater than
+		 * this value.
+		 */
+		elastic_params_t &
+		backlog_threshold( std::size_t v )
+			{
+				m_backlog_threshold = v;
+				return *this;
+			}
+
+		//! Getter for backlog threshold.
+		std::size_t
+		backlog_threshold() const
+			{
+				return m_backlog_threshold;
+			}
+
+		//! Setter for idle timeout.
+		elastic_params_t &
+		idle_timeout( std::chrono::steady_clock::duration v )
+			{
+				m_idle_timeout = v;
+				return *this;
+			}
+
+		//! Getter for idle timeout.
+		std::chrono::steady_clock::duration
+		idle_timeout() const
+			{
+				return m_idle_timeout;
+			}
+
+	private :
+		//! Min count of working threads.
+		std::size_t m_min_thread_count = { 1 };
+
+		//! Max count of working threads.
+		/*!
+		 * Value 0 means that elastic mode is turned off.
+		 */
+		std::size_t m_max_thread_count = { 0 };
+
+		//! Threshold for starting a new working thread.
+		std::size_t m_backlog_threshold = { 0 };
+
+		//! Max idle time for a working thread.
+		std::chrono::steady_clock::duration m_idle_timeout =
+				std::chrono::seconds( 1 );
+	};
+
 //
 // disp_params_t
 //
@@ -47,9 +172,12 @@ namespace queue_traits = so_5::disp::mpmc_queue_traits;
  */
 class disp_params_t
 	:	public so_5::disp::reuse::work_thread_activity_tracking_flag_mixin_t< disp_params_t >
+	,	public so_5::disp::reuse::thread_affinity_mixin_t< disp_params_t >
 	{
 		using activity_tracking_mixin_t = so_5::disp::reuse::
 				work_thread_activity_tracking_flag_mixin_t< disp_params_t >;
+		using thread_affinity_mixin_t = so_5::disp::reuse::
+				thread_affinity_mixin_t< disp_params_t >;
 
 	public :
 		//! Default constructor.
@@ -57,14 +185,18 @@ class disp_params_t
 		//! Copy constructor.
 		disp_params_t( const disp_params_t & o )
 			:	activity_tracking_mixin_t( o )
+			,	thread_affinity_mixin_t( o )
 			,	m_thread_count{ o.m_thread_count }
 			,	m_queue_params{ o.m_queue_params }
+			,	m_elastic_params{ o.m_elastic_params }
 			{}
 		//! Move constructor.
 		disp_params_t( disp_params_t && o )
 			:	activity_tracking_mixin_t( std::move(o) )
+			,	thread_affinity_mixin_t( std::move(o) )
 			,	m_thread_count{ std::move(o.m_thread_count) }
 			,	m_queue_params{ std::move(o.m_queue_params) }
+			,	m_elastic_params{ std::move(o.m_elastic_params) }
 			{}
 
 		friend inline void
@@ -74,9 +206,13 @@ class disp_params_t
 				swap(
 						static_cast< activity_tracking_mixin_t & >(a),
 						static_cast< activity_tracking_mixin_t & >(b) );
+				swap(
+						static_cast< thread_affinity_mixin_t & >(a),
+						static_cast< thread_affinity_mixin_t & >(b) );
 
 				std::swap( a.m_thread_count, b.m_thread_count );
 				swap( a.m_queue_params, b.m_queue_params );
+				std::swap( a.m_elastic_params, b.m_elastic_params );
 			}
 
 		//! Copy operator.
@@ -148,6 +284,41 @@ class disp_params_t
 				return m_queue_params;
 			}
 
+		/*!
+		 * \brief Setter for parameters of elastic mode.
+		 *
+		 * \note The value of thread_count is ignored if elastic mode
+		 * is turned on.
+		 *
+		 * \attention Elastic mode requires a queue lock with the support
+		 * of waiting with a timeout (see
+		 * queue_traits::condition_t::is_timed_wait_supported()).
+		 * An exception with rc_timed_wait_not_supported error code is
+		 * thrown during the creation of the dispatcher if a custom lock
+		 * factory doesn't provide such support.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		disp_params_t &
+		elastic( elastic_params_t p )
+			{
+				m_elastic_params = std::move(p);
+				return *this;
+			}
+
+		/*!
+		 * \brief Getter for parameters of elastic mode.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		const elastic_params_t &
+		elastic_params() const
+			{
+				return m_elastic_params;
+			}
+
 	private :
 		//! Count of working threads.
 		/*!
@@ -156,6 +327,13 @@ class disp_params_t
 		std::size_t m_thread_count = { 0 };
 		//! Queue parameters.
 		queue_traits::queue_params_t m_queue_params;
+		/*!
+		 * \brief Parameters of elastic mode.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		elastic_params_t m_elastic_params;
 	};
 
 //
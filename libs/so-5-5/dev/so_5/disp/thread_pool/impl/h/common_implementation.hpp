@@ -12,15 +12,24 @@
 
 #pragma once
 
+#include <so_5/h/exception.hpp>
+
 #include <so_5/rt/h/event_queue.hpp>
 #include <so_5/rt/h/disp.hpp>
 
 #include <so_5/disp/reuse/h/mpmc_ptr_queue.hpp>
 #include <so_5/disp/reuse/h/thread_pool_stats.hpp>
 
+#include <so_5/disp/thread_affinity/h/pub.hpp>
+
+#include <so_5/disp/thread_pool/h/pub.hpp>
+
 #include <so_5/details/h/rollback_on_exception.hpp>
 
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
 
 namespace so_5 {
 
@@ -210,12 +219,55 @@ class dispatcher_t
 		//! Constructor.
 		dispatcher_t(
 			std::size_t thread_count,
-			const so_5::disp::mpmc_queue_traits::queue_params_t & queue_params )
-			:	m_queue{ queue_params, thread_count }
-			,	m_thread_count( thread_count )
+			const so_5::disp::mpmc_queue_traits::queue_params_t & queue_params,
+			//! Affinity for working threads.
+			//! \since v.5.5.25
+			thread_affinity::affinity_t thread_affinity )
+			:	dispatcher_t(
+					thread_count,
+					queue_params,
+					std::move(thread_affinity),
+					elastic_params_t{} )
+			{}
+
+		/*!
+		 * \brief Constructor with parameters for elastic mode.
+		 *
+		 * \note The \a thread_count is ignored if elastic mode is
+		 * turned on.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		dispatcher_t(
+			std::size_t thread_count,
+			const so_5::disp::mpmc_queue_traits::queue_params_t & queue_params,
+			thread_affinity::affinity_t thread_affinity,
+			const elastic_params_t & elastic )
+			:	m_queue{ queue_params,
+					elastic.enabled() ? elastic.max_thread_count() : thread_count }
+			,	m_thread_count( elastic.enabled() ?
+					elastic.min_thread_count() : thread_count )
+			,	m_thread_affinity( std::move(thread_affinity) )
 			,	m_data_source( stats_supplier() )
 			{
-				m_threads.reserve( thread_count );
+				if( elastic.enabled() )
+					{
+						ensure_timed_wait_supported();
+
+						m_elastic = true;
+						m_queue.enable_elasticity(
+								elastic.min_thread_count(),
+								elastic.backlog_threshold(),
+								elastic.idle_timeout(),
+								[this] { request_new_thread(); } );
+					}
+
+				// NOTE: there must be enough space for max count of threads.
+				// It guarantees that start_new_thread() won't reallocate
+				// the container.
+				m_threads.reserve( elastic.enabled() ?
+						elastic.max_thread_count() : thread_count );
 
 				for( std::size_t i = 0; i != m_thread_count; ++i )
 					m_threads.emplace_back( std::unique_ptr< Work_Thread >(
@@ -227,19 +279,49 @@ class dispatcher_t
 			{
 				m_data_source.start( outliving_mutable(env.stats_repository()) );
 
-				for( auto & t : m_threads )
-					t->start();
+				std::lock_guard< std::mutex > lock( m_threads_lock );
+
+				for( std::size_t i = 0; i != m_threads.size(); ++i )
+					m_threads[ i ]->start( m_thread_affinity.cpus_for_thread( i ) );
+
+				if( m_elastic )
+					m_thread_starter = std::thread{ [this] { thread_starter_body(); } };
 			}
 
 		virtual void
 		shutdown() override
 			{
+				{
+					// No more threads can be started after that.
+					std::lock_guard< std::mutex > lock( m_threads_lock );
+					m_shutdown_started = true;
+				}
+
+				if( m_elastic )
+					{
+						{
+							std::lock_guard< std::mutex > lock( m_starter_lock );
+							m_starter_shutdown = true;
+						}
+						m_starter_wakeup.notify_one();
+					}
+
 				m_queue.shutdown();
 			}
 
 		virtual void
 		wait() override
 			{
+				// NOTE: m_threads_lock is not acquired here because the
+				// content of m_threads can't be changed after shutdown().
+				// And a working thread can try to acquire m_threads_lock
+				// in start_new_thread().
+				//
+				// The starter thread is joined first because it can
+				// modify m_threads until it is finished.
+				if( m_thread_starter.joinable() )
+					m_thread_starter.join();
+
 				for( auto & t : m_threads )
 					t->join();
 
@@ -309,11 +391,86 @@ class dispatcher_t
 		Dispatcher_Queue m_queue;
 
 		//! Count of working threads.
+		/*!
+		 * \note Since v.5.5.25 it is the initial count of working threads.
+		 */
 		const std::size_t m_thread_count;
 
+		/*!
+		 * \brief Affinity for working threads.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		const thread_affinity::affinity_t m_thread_affinity;
+
 		//! Pool of work threads.
+		/*!
+		 * \note Since v.5.5.25 there can be finished (retired) threads in
+		 * elastic mode. They are joined and replaced by new threads.
+		 */
 		std::vector< std::unique_ptr< Work_Thread > > m_threads;
 
+		/*!
+		 * \brief Lock for m_threads.
+		 *
+		 * It is a separate lock because a new thread can be started
+		 * when m_lock is acquired (for example a working thread sends a
+		 * message when unbind_agent() waits for an empty queue).
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		std::mutex m_threads_lock;
+
+		/*!
+		 * \brief Is elastic mode turned on?
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		bool m_elastic{ false };
+
+		/*!
+		 * \brief Is shutdown started?
+		 *
+		 * \note Is protected by m_threads_lock.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		bool m_shutdown_started{ false };
+
+		/*!
+		 * \name Starter of new working threads in elastic mode.
+		 *
+		 * New working threads are started by a dedicated thread.
+		 * It is because the necessity of a new thread is detected
+		 * on the sender's thread and the sender must not be blocked
+		 * by the creation of a thread.
+		 *
+		 * \since
+		 * v.5.5.25
+		 * \{
+		 */
+		//! Thread for starting new working threads.
+		std::thread m_thread_starter;
+
+		//! Lock for the starter's data.
+		std::mutex m_starter_lock;
+
+		//! Notification for the starter.
+		std::condition_variable m_starter_wakeup;
+
+		//! Count of requests for new working threads.
+		std::size_t m_start_requests{ 0 };
+
+		//! Should the starter finish its work?
+		bool m_starter_shutdown{ false };
+		/*!
+		 * \}
+		 */
+
 		//! Object's lock.
 		std::mutex m_lock;
 
@@ -392,6 +549,131 @@ class dispatcher_t
 				return it->second.m_queue.get();
 			}
 
+		/*!
+		 * \brief Ensure that the queue's lock supports waiting with
+		 * a timeout.
+		 *
+		 * \throw so_5::exception_t with rc_timed_wait_not_supported error
+		 * code if a custom lock factory doesn't support timed waiting.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		ensure_timed_wait_supported()
+			{
+				if( !m_queue.allocate_condition()->is_timed_wait_supported() )
+					SO_5_THROW_EXCEPTION( rc_timed_wait_not_supported,
+							"elastic mode requires a queue lock with the support "
+							"of waiting with a timeout" );
+			}
+
+		/*!
+		 * \brief Request a new working thread in elastic mode.
+		 *
+		 * Is called by the dispatcher queue on the sender's thread when
+		 * a new thread is necessary. The request is passed to the starter
+		 * thread.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		request_new_thread()
+			{
+				{
+					std::lock_guard< std::mutex > lock( m_starter_lock );
+					++m_start_requests;
+				}
+
+				m_starter_wakeup.notify_one();
+			}
+
+		/*!
+		 * \brief Main loop of the starter thread.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		thread_starter_body() SO_5_NOEXCEPT
+			{
+				std::unique_lock< std::mutex > lock( m_starter_lock );
+
+				for(;;)
+					{
+						m_starter_wakeup.wait( lock, [this] {
+								return m_starter_shutdown || 0 != m_start_requests;
+							} );
+
+						if( m_starter_shutdown )
+							break;
+
+						auto requests = m_start_requests;
+						m_start_requests = 0;
+
+						lock.unlock();
+						for(; requests; --requests )
+							start_new_thread();
+						lock.lock();
+					}
+
+				// Places reserved for threads which won't be started
+				// must be released.
+				for(; m_start_requests; --m_start_requests )
+					m_queue.new_thread_not_started();
+			}
+
+		/*!
+		 * \brief Start a new working thread in elastic mode.
+		 *
+		 * Is called by the starter thread when a new thread is necessary.
+		 * A place for a retired thread is reused if there is such place.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		start_new_thread() SO_5_NOEXCEPT
+			{
+				std::lock_guard< std::mutex > lock( m_threads_lock );
+
+				if( m_shutdown_started )
+					{
+						m_queue.new_thread_not_started();
+						return;
+					}
+
+				try
+					{
+						auto it = std::find_if( m_threads.begin(), m_threads.end(),
+								[]( const std::unique_ptr< Work_Thread > & t ) {
+									return t->is_finished();
+								} );
+
+						const std::size_t index = static_cast< std::size_t >(
+								it - m_threads.begin() );
+
+						std::unique_ptr< Work_Thread > thread{
+								new Work_Thread( m_queue ) };
+						thread->start( m_thread_affinity.cpus_for_thread( index ) );
+
+						if( it != m_threads.end() )
+							{
+								(*it)->join();
+								*it = std::move(thread);
+							}
+						else
+							// There is enough space in m_threads.
+							// So this action can't throw.
+							m_threads.emplace_back( std::move(thread) );
+					}
+				catch( ... )
+					{
+						m_queue.new_thread_not_started();
+					}
+			}
+
 		//! Helper method for creating event queue for agents/cooperations.
 		agent_queue_ref_t
 		make_new_agent_queue(
@@ -424,14 +706,27 @@ class dispatcher_t
 			{
 				// Statics must be collected on locked object.
 				std::lock_guard< std::mutex > lock( m_lock );
+				std::lock_guard< std::mutex > threads_lock( m_threads_lock );
 
-				consumer.set_thread_count( m_threads.size() );
+				if( m_elastic )
+					{
+						const auto info = m_queue.query_thread_count_info();
+						consumer.set_thread_count( info.m_thread_count );
+						consumer.set_thread_resize_counters(
+								info.m_threads_added,
+								info.m_threads_retired );
+					}
+				else
+					consumer.set_thread_count( m_threads.size() );
 
 				for( auto & t : m_threads )
 					{
 						using stats_t = so_5::stats::work_thread_activity_stats_t;
 
 						Work_Thread & wt = *t;
+						if( wt.is_finished() )
+							continue;
+
 						wt.take_activity_stats(
 							[&wt, &consumer]( const stats_t & st ) {
 								consumer.add_work_thread_activity( wt.thread_id(), st );
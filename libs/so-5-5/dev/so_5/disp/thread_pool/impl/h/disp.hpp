@@ -453,9 +453,33 @@ class work_thread_template_t : public Impl
 
 		//! Launch work thread.
 		void
-		start()
+		start(
+			//! CPUs for the working thread.
+			//! Empty set means that thread is not bound to any CPU.
+			thread_affinity::cpus_t cpus )
 			{
-				this->m_thread = std::thread( [this]() { body(); } );
+				this->m_thread = std::thread( [this, cpus]() {
+						thread_affinity::apply_to_current_thread( cpus );
+						body();
+
+						m_finished.store( true, std::memory_order_release );
+					} );
+			}
+
+		/*!
+		 * \brief Is the body of work thread finished?
+		 *
+		 * The body can be finished before the shutdown of the dispatcher
+		 * if the thread is retired in elastic mode. Such thread should
+		 * be joined.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		bool
+		is_finished() const
+			{
+				return m_finished.load( std::memory_order_acquire );
 			}
 
 		/*!
@@ -474,6 +498,14 @@ class work_thread_template_t : public Impl
 			}
 
 	private :
+		/*!
+		 * \brief Is the body of work thread finished?
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		std::atomic< bool > m_finished{ false };
+
 		//! Thread body method.
 		void
 		body()
@@ -97,7 +97,9 @@ class proxy_dispatcher_t : public proxy_dispatcher_base_t
 							dispatcher_with_activity_tracking_t >(
 						env,
 						m_disp_params.thread_count(),
-						m_disp_params.queue_params() );
+						m_disp_params.queue_params(),
+						m_disp_params.thread_affinity(),
+						m_disp_params.elastic_params() );
 			}
 	};
 
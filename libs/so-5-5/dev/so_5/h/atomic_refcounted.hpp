@@ -79,6 +79,28 @@ class SO_5_TYPE atomic_refcounted_t
 			return --m_ref_counter;
 		}
 
+		//! Increment reference count only if it isn't zero.
+		/*!
+		 * It is necessary for the cases where a raw pointer to
+		 * an object is stored in some container and the object can
+		 * be in the middle of destruction.
+		 *
+		 * \return true if reference count was incremented.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		inline bool
+		inc_ref_count_if_not_zero() SO_5_NOEXCEPT
+		{
+			auto current = m_ref_counter.load( std::memory_order_acquire );
+			while( 0 != current )
+				if( m_ref_counter.compare_exchange_weak( current, current + 1 ) )
+					return true;
+
+			return false;
+		}
+
 	private:
 		//! Object reference count.
 		atomic_counter_t m_ref_counter;
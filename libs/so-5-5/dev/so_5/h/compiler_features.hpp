@@ -111,3 +111,15 @@
 	#define SO_5_INLINE_NS inline
 #endif	
 
+// Since v.5.5.25 C++20 coroutines can be used in event handlers.
+// SO_5_HAVE_COROUTINES is defined if the compiler and the standard library
+// support coroutines. The support can be switched off by definition of
+// SO_5_DISABLE_COROUTINES.
+#if !defined( SO_5_DISABLE_COROUTINES ) && defined( __cpp_impl_coroutine )
+	#if defined( __has_include )
+		#if __has_include( <coroutine> )
+			#define SO_5_HAVE_COROUTINES 1
+		#endif
+	#endif
+#endif
+
@@ -0,0 +1,763 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief Support of C++20 coroutines in event handlers.
+ *
+ * This stuff is available only if SO_5_HAVE_COROUTINES is defined.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/h/compiler_features.hpp>
+
+#if defined( SO_5_HAVE_COROUTINES )
+
+#include <so_5/rt/h/suspension_point.hpp>
+#include <so_5/rt/h/environment.hpp>
+#include <so_5/rt/h/mchain_select.hpp>
+
+#include <so_5/details/h/rollback_on_exception.hpp>
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace so_5 {
+
+namespace coro {
+
+//
+// task_t
+//
+/*!
+ * \brief Type of result for an event handler implemented as a coroutine.
+ *
+ * An event handler which returns task_t can use `co_await` with
+ * so_5::coro::receive() and so_5::coro::sleep_for(). The handler doesn't
+ * block the working thread while it waits: the coroutine is suspended and
+ * is resumed later as an ordinary demand on the agent's event queue.
+ * Because of that the coroutine works with the same guarantees as an
+ * ordinary not-thread-safe event handler of the agent.
+ *
+ * \par Usage example:
+	\code
+	class a_client_t final : public so_5::agent_t
+	{
+	public :
+		...
+		virtual void so_define_agent() override
+		{
+			so_subscribe_self().event( &a_client_t::on_start );
+		}
+
+	private :
+		so_5::coro::task_t
+		on_start( mhood_t< start > )
+		{
+			auto ch = so_5::create_mchain( so_environment() );
+			so_5::send< request >( m_server, ch->as_mbox() );
+
+			auto r = co_await so_5::coro::receive( ch, std::chrono::seconds(1),
+					[this]( const reply & r ) { ... } );
+			if( !r.handled() )
+				... // There is no reply.
+
+			co_await so_5::coro::sleep_for( std::chrono::milliseconds(250) );
+			...
+		}
+	};
+	\endcode
+ *
+ * \note The coroutine should be a method of an agent or a function
+ * with a reference to an agent as the first argument. The body of
+ * the coroutine is executed right inside the event handler until
+ * the first suspension. The message is guaranteed to be alive only
+ * until that suspension. Use mhood_t::make_reference() if the message
+ * is necessary after a `co_await`.
+ *
+ * \note If an exception goes out of the coroutine then it is handled
+ * the same way as an exception from an ordinary event handler. It is
+ * true for the part of the coroutine before the first suspension too:
+ * the exception is rethrown before the return to the dispatcher.
+ *
+ * \note An instance of task_t is intended to be used only by
+ * SObjectizer as a result of the event handler. It should not be stored
+ * by a user.
+ *
+ * \note A suspended coroutine is destroyed at the end of the agent's
+ * work (after so_evt_finish()). It is also not resumed while the agent
+ * is in the awaiting_deregistration state.
+ *
+ * \attention task_t can't be used for service requests.
+ *
+ * \since
+ * v.5.5.25
+ */
+class task_t
+	{
+	public :
+		class promise_type;
+
+		task_t( const task_t & ) = delete;
+		task_t & operator=( const task_t & ) = delete;
+
+		task_t( task_t && other ) SO_5_NOEXCEPT
+			:	m_handle( std::exchange( other.m_handle, nullptr ) )
+			{}
+
+		~task_t();
+
+		//! Completion of the event handler implemented as a coroutine.
+		/*!
+		 * Is called by SObjectizer when the event handler returns.
+		 */
+		friend void
+		process_event_handler_result( task_t && task )
+			{
+				task.complete_start();
+			}
+
+	private :
+		explicit task_t(
+			std::coroutine_handle< promise_type > handle ) SO_5_NOEXCEPT
+			:	m_handle( handle )
+			{}
+
+		//! Coroutine started by the event handler.
+		/*!
+		 * \note A suspended coroutine is owned by its suspension point.
+		 * The coroutine is owned by task_t only if it is finished before
+		 * the first suspension.
+		 */
+		std::coroutine_handle< promise_type > m_handle;
+
+		//! Finish the part of the coroutine before the first suspension.
+		/*!
+		 * If the coroutine is already finished then it is destroyed and
+		 * an exception from it (if any) is rethrown.
+		 */
+		void
+		complete_start();
+	};
+
+namespace impl {
+
+//! Type of a handle for a coroutine of an agent.
+using task_handle_t = std::coroutine_handle< task_t::promise_type >;
+
+//
+// coroutine_point_t
+//
+/*!
+ * \brief A suspension point for a coroutine of an agent.
+ *
+ * \since
+ * v.5.5.25
+ */
+class coroutine_point_t final : public so_5::impl::suspension_point_t
+	{
+	public :
+		coroutine_point_t(
+			agent_t & owner,
+			task_handle_t handle ) SO_5_NOEXCEPT
+			:	suspension_point_t( owner )
+			,	m_handle( handle )
+			{}
+
+	protected :
+		virtual void
+		resume() override;
+
+		virtual void
+		cancel() SO_5_NOEXCEPT override;
+
+	private :
+		//! Suspended coroutine.
+		task_handle_t m_handle;
+	};
+
+//
+// awaiter_base_t
+//
+/*!
+ * \brief A base class for awaitable objects.
+ *
+ * Holds a suspension point and an optional timer for it.
+ *
+ * \since
+ * v.5.5.25
+ */
+class awaiter_base_t
+	{
+	public :
+		awaiter_base_t( const awaiter_base_t & ) = delete;
+		awaiter_base_t & operator=( const awaiter_base_t & ) = delete;
+
+	protected :
+		awaiter_base_t() = default;
+
+		~awaiter_base_t()
+			{
+				m_timer.release();
+			}
+
+		//! Create and arm a suspension point for the coroutine.
+		void
+		make_point( task_handle_t handle );
+
+		//! Disarm and destroy the suspension point.
+		void
+		drop_point() SO_5_NOEXCEPT
+			{
+				m_point->disarm();
+				m_point.reset();
+			}
+
+		//! Start a timer which triggers the suspension point.
+		void
+		start_timer( std::chrono::steady_clock::duration pause );
+
+		//! Suspension point for the coroutine.
+		/*!
+		 * \note Is empty if the coroutine isn't suspended.
+		 */
+		intrusive_ptr_t< coroutine_point_t > m_point;
+
+		//! Timer for the suspension point.
+		timer_id_t m_timer;
+	};
+
+} /* namespace impl */
+
+//
+// task_t::promise_type
+//
+/*!
+ * \brief Promise type for coroutines of agents.
+ *
+ * \since
+ * v.5.5.25
+ */
+class task_t::promise_type
+	{
+	public :
+		template< typename Agent, typename... Args >
+		promise_type( Agent & agent, Args &... ) SO_5_NOEXCEPT
+			:	m_agent( agent )
+			{
+				static_assert( std::is_base_of< agent_t,
+								typename std::decay< Agent >::type >::value,
+						"so_5::coro::task_t can be used only for methods of agents "
+						"or for functions with an agent as the first argument" );
+			}
+
+		task_t
+		get_return_object() SO_5_NOEXCEPT
+			{
+				return task_t{ impl::task_handle_t::from_promise( *this ) };
+			}
+
+		//! The body of the coroutine is started inside the event handler.
+		std::suspend_never
+		initial_suspend() const SO_5_NOEXCEPT
+			{
+				return {};
+			}
+
+		std::suspend_always
+		final_suspend() const SO_5_NOEXCEPT
+			{
+				return {};
+			}
+
+		void
+		return_void() const SO_5_NOEXCEPT
+			{}
+
+		void
+		unhandled_exception() SO_5_NOEXCEPT
+			{
+				m_exception = std::current_exception();
+			}
+
+		//! Agent for that the coroutine is working.
+		agent_t &
+		agent() const SO_5_NOEXCEPT
+			{
+				return m_agent;
+			}
+
+		//! Get an exception which went out of the coroutine.
+		std::exception_ptr
+		extract_exception() SO_5_NOEXCEPT
+			{
+				return std::move( m_exception );
+			}
+
+	private :
+		agent_t & m_agent;
+
+		std::exception_ptr m_exception;
+	};
+
+//
+// task_t implementation
+//
+inline
+task_t::~task_t()
+	{
+		if( m_handle && m_handle.done() )
+			m_handle.destroy();
+	}
+
+inline void
+task_t::complete_start()
+	{
+		const auto handle = std::exchange( m_handle, nullptr );
+		if( handle && handle.done() )
+			{
+				auto exception = handle.promise().extract_exception();
+				handle.destroy();
+
+				if( exception )
+					std::rethrow_exception( exception );
+			}
+	}
+
+namespace impl {
+
+//
+// coroutine_point_t implementation
+//
+inline void
+coroutine_point_t::resume()
+	{
+		const auto handle = std::exchange( m_handle, nullptr );
+		if( !handle )
+			return;
+
+		handle.resume();
+
+		if( handle.done() )
+			{
+				auto exception = handle.promise().extract_exception();
+				handle.destroy();
+
+				if( exception )
+					std::rethrow_exception( exception );
+			}
+	}
+
+inline void
+coroutine_point_t::cancel() SO_5_NOEXCEPT
+	{
+		const auto handle = std::exchange( m_handle, nullptr );
+		if( handle )
+			handle.destroy();
+	}
+
+//
+// timeout_mbox_t
+//
+/*!
+ * \brief A special mbox which triggers a suspension point when a timer
+ * message is delivered to it.
+ *
+ * \since
+ * v.5.5.25
+ */
+class timeout_mbox_t final : public abstract_message_box_t
+	{
+	public :
+		timeout_mbox_t(
+			mbox_id_t id,
+			intrusive_ptr_t< coroutine_point_t > point )
+			:	m_id( id )
+			,	m_point( std::move(point) )
+			{}
+
+		virtual mbox_id_t
+		id() const override
+			{
+				return m_id;
+			}
+
+		virtual void
+		subscribe_event_handler(
+			const std::type_index & /*type_index*/,
+			const message_limit::control_block_t * /*limit*/,
+			agent_t * /*subscriber*/ ) override
+			{
+				SO_5_THROW_EXCEPTION( rc_not_implemented,
+						"timeout mbox of a coroutine doesn't support "
+						"subscriptions" );
+			}
+
+		virtual void
+		unsubscribe_event_handlers(
+			const std::type_index & /*type_index*/,
+			agent_t * /*subscriber*/ ) override
+			{}
+
+		virtual std::string
+		query_name() const override
+			{
+				return "<mbox:type=CORO_TIMEOUT:id=" + std::to_string( m_id ) + ">";
+			}
+
+		virtual mbox_type_t
+		type() const override
+			{
+				return mbox_type_t::multi_producer_single_consumer;
+			}
+
+		virtual void
+		do_deliver_message(
+			const std::type_index & /*msg_type*/,
+			const message_ref_t & /*message*/,
+			unsigned int /*overlimit_reaction_deep*/ ) const override
+			{
+				m_point->trigger();
+			}
+
+		virtual void
+		do_deliver_service_request(
+			const std::type_index & /*msg_type*/,
+			const message_ref_t & /*message*/,
+			unsigned int /*overlimit_reaction_deep*/ ) const override
+			{
+				SO_5_THROW_EXCEPTION( rc_not_implemented,
+						"timeout mbox of a coroutine doesn't support "
+						"service requests" );
+			}
+
+		virtual void
+		set_delivery_filter(
+			const std::type_index & /*msg_type*/,
+			const delivery_filter_t & /*filter*/,
+			agent_t & /*subscriber*/ ) override
+			{
+				SO_5_THROW_EXCEPTION( rc_not_implemented,
+						"timeout mbox of a coroutine doesn't support "
+						"delivery filters" );
+			}
+
+		virtual void
+		drop_delivery_filter(
+			const std::type_index & /*msg_type*/,
+			agent_t & /*subscriber*/ ) SO_5_NOEXCEPT override
+			{}
+
+	private :
+		const mbox_id_t m_id;
+		const intrusive_ptr_t< coroutine_point_t > m_point;
+	};
+
+//! A signal to be sent to timeout_mbox_t.
+struct timeout_signal_t final : public signal_t {};
+
+//
+// awaiter_base_t implementation
+//
+inline void
+awaiter_base_t::make_point( task_handle_t handle )
+	{
+		m_point = intrusive_ptr_t< coroutine_point_t >{
+				new coroutine_point_t{ handle.promise().agent(), handle } };
+		m_point->arm();
+	}
+
+inline void
+awaiter_base_t::start_timer( std::chrono::steady_clock::duration pause )
+	{
+		auto & env = m_point->owner().so_environment();
+
+		const auto mbox = env.make_custom_mbox(
+				[this]( const mbox_creation_data_t & data ) {
+					return mbox_t{ new timeout_mbox_t{ data.m_id, m_point } };
+				} );
+
+		m_timer = env.schedule_timer(
+				typeid(timeout_signal_t),
+				message_ref_t{},
+				mbox,
+				pause,
+				std::chrono::steady_clock::duration::zero() );
+	}
+
+//
+// receive_case_t
+//
+/*!
+ * \brief A select_case which allows to handle extracted message directly.
+ *
+ * \since
+ * v.5.5.25
+ */
+template< std::size_t Handlers_Count >
+class receive_case_t final
+	:	public mchain_props::details::actual_select_case_t< Handlers_Count >
+	{
+		using base_type_t =
+				mchain_props::details::actual_select_case_t< Handlers_Count >;
+
+	public :
+		using mchain_props::details::actual_select_case_t<
+				Handlers_Count >::actual_select_case_t;
+
+		using base_type_t::try_handle_extracted_message;
+	};
+
+//
+// receive_awaiter_t
+//
+/*!
+ * \brief An awaitable object for receiving a message from a mchain.
+ *
+ * \since
+ * v.5.5.25
+ */
+template< std::size_t Handlers_Count >
+class receive_awaiter_t final
+	:	private awaiter_base_t
+	,	private mchain_props::select_notificator_t
+	{
+	public :
+		template< typename... Handlers >
+		receive_awaiter_t(
+			mchain_t chain,
+			mchain_props::duration_t waiting_time,
+			Handlers &&... handlers )
+			:	m_case{ std::move(chain), std::forward< Handlers >(handlers)... }
+			,	m_waiting_time{ waiting_time }
+			{}
+
+		~receive_awaiter_t()
+			{
+				m_case.on_select_finish();
+			}
+
+		bool
+		await_ready()
+			{
+				using namespace mchain_props;
+
+				try_extract();
+
+				return extraction_status_t::no_messages != m_result.status() ||
+						mchain_props::details::is_no_wait_timevalue( m_waiting_time );
+			}
+
+		bool
+		await_suspend( task_handle_t handle )
+			{
+				using namespace mchain_props;
+
+				make_point( handle );
+
+				return so_5::details::do_with_rollback_on_exception(
+					[&] {
+						// A message could be stored to the chain after
+						// the check in await_ready(). There is no need
+						// to suspend in that case.
+						m_result = m_case.try_receive( *this );
+						if( extraction_status_t::no_messages != m_result.status() )
+							{
+								drop_point();
+								return false;
+							}
+
+						if( !mchain_props::details::is_infinite_wait_timevalue( m_waiting_time ) )
+							start_timer(
+									std::chrono::duration_cast<
+											std::chrono::steady_clock::duration >(
+										m_waiting_time ) );
+
+						return true;
+					},
+					[this] {
+						m_case.on_select_finish();
+						if( m_point )
+							drop_point();
+					} );
+			}
+
+		mchain_receive_result_t
+		await_resume()
+			{
+				if( m_point )
+					{
+						// The coroutine is resumed by the chain or by the timer.
+						m_timer.release();
+
+						// The point must live until the chain can use
+						// this object as a notificator.
+						m_case.on_select_finish();
+						m_point.reset();
+
+						try_extract();
+					}
+
+				return m_result;
+			}
+
+	private :
+		receive_case_t< Handlers_Count > m_case;
+
+		const mchain_props::duration_t m_waiting_time;
+
+		mchain_receive_result_t m_result;
+
+		//! Extract and handle a message without waiting.
+		void
+		try_extract()
+			{
+				using namespace mchain_props;
+
+				demand_t demand;
+				const auto status = m_case.chain()->extract(
+						demand, mchain_props::details::no_wait_special_timevalue() );
+
+				if( extraction_status_t::msg_extracted == status )
+					m_result = m_case.try_handle_extracted_message( demand );
+				else
+					m_result = mchain_receive_result_t{ 0u, 0u, status };
+			}
+
+		virtual void
+		notify( mchain_props::select_case_t & ) SO_5_NOEXCEPT override
+			{
+				m_point->trigger();
+			}
+	};
+
+//
+// sleep_awaiter_t
+//
+/*!
+ * \brief An awaitable object for a pause in a coroutine.
+ *
+ * \since
+ * v.5.5.25
+ */
+class sleep_awaiter_t final : private awaiter_base_t
+	{
+	public :
+		explicit sleep_awaiter_t(
+			std::chrono::steady_clock::duration pause )
+			:	m_pause{ pause }
+			{}
+
+		bool
+		await_ready() const SO_5_NOEXCEPT
+			{
+				return m_pause <= std::chrono::steady_clock::duration::zero();
+			}
+
+		void
+		await_suspend( task_handle_t handle )
+			{
+				make_point( handle );
+
+				so_5::details::do_with_rollback_on_exception(
+					[&] { start_timer( m_pause ); },
+					[this] { drop_point(); } );
+			}
+
+		void
+		await_resume() SO_5_NOEXCEPT
+			{
+				m_point.reset();
+			}
+
+	private :
+		const std::chrono::steady_clock::duration m_pause;
+	};
+
+} /* namespace impl */
+
+//
+// receive
+//
+/*!
+ * \brief Receive and handle one message from a mchain inside a coroutine.
+ *
+ * This is an analog of so_5::receive() for a single message. But instead
+ * of blocking the working thread the coroutine is suspended until a
+ * message arrives, the chain is closed or \a waiting_time elapses.
+ * Message handlers are called on the agent's working context.
+ *
+ * A mchain can be used as a reply mbox via abstract_message_chain_t::as_mbox().
+ * It allows to wait for a reply to a request.
+ *
+ * \par Usage example:
+	\code
+	so_5::coro::task_t
+	my_agent::on_request( mhood_t< request > cmd )
+	{
+		auto r = co_await so_5::coro::receive( m_replies, so_5::infinite_wait,
+				[]( const reply & r ) {...},
+				[]( so_5::mhood_t< failure > ) {...} );
+		if( so_5::mchain_props::extraction_status_t::chain_closed == r.status() )
+			...
+	}
+	\endcode
+ *
+ * \note \a waiting_time can be so_5::infinite_wait or so_5::no_wait.
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename Timeout, typename... Handlers >
+impl::receive_awaiter_t< sizeof...(Handlers) >
+receive(
+	//! Chain from which a message must be extracted.
+	const mchain_t & chain,
+	//! Maximum waiting time for a message.
+	Timeout waiting_time,
+	//! Handlers for message processing.
+	Handlers &&... handlers )
+	{
+		return impl::receive_awaiter_t< sizeof...(Handlers) >{
+				chain,
+				mchain_props::details::actual_timeout( waiting_time ),
+				std::forward< Handlers >(handlers)... };
+	}
+
+//
+// sleep_for
+//
+/*!
+ * \brief Suspend a coroutine for the specified time.
+ *
+ * The working thread isn't blocked and can handle events of other agents.
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename Rep, typename Period >
+impl::sleep_awaiter_t
+sleep_for(
+	//! Time to sleep.
+	std::chrono::duration< Rep, Period > pause )
+	{
+		return impl::sleep_awaiter_t{
+				std::chrono::duration_cast< std::chrono::steady_clock::duration >(
+						pause ) };
+	}
+
+} /* namespace coro */
+
+} /* namespace so_5 */
+
+#endif /* SO_5_HAVE_COROUTINES */
+
@@ -0,0 +1,687 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief Keyed mbox with content-based routing of messages.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/rt/h/environment.hpp>
+
+#include <so_5/h/spinlocks.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace so_5 {
+
+namespace keyed_mbox {
+
+//
+// keyed_mbox_t
+//
+/*!
+ * \brief An MPMC mbox which routes messages by a key extracted from
+ * a message.
+ *
+ * A delivery filter (see agent_t::so_set_delivery_filter()) is checked
+ * for every subscriber of an ordinary MPMC mbox. It means that the price
+ * of a send is O(N) where N is the count of subscribers even if only one
+ * of them is interested in the message.
+ *
+ * A keyed mbox uses another approach. A key extractor is registered for
+ * a message type. A subscriber receives a separate mbox for a key it is
+ * interested in (see key_mbox()) and makes ordinary subscriptions to that
+ * mbox. When a message is sent to the keyed mbox the key is extracted from
+ * the message and the message is delivered only to the subscribers of
+ * the corresponding key mbox. It is a single hash table lookup.
+ *
+ * A subscription can also be made to the keyed mbox itself (see as_mbox()).
+ * Such a subscriber receives all messages of that type regardless of
+ * their keys.
+ *
+ * A message of a type without a registered key extractor is delivered
+ * only to subscribers of the keyed mbox itself. The same is true for
+ * an enveloped message which payload can't be inspected.
+ *
+ * A service request is delivered to the corresponding key mbox if it
+ * exists. Otherwise the request goes to the subscribers of the keyed
+ * mbox itself.
+ *
+ * Key mboxes are ordinary MPMC mboxes. It means that message limits,
+ * delivery filters and message delivery tracing work as usual.
+ * Key mboxes are created on demand. A key mbox is removed when the last
+ * reference to it is released (subscriptions also hold references).
+ * A subsequent call to key_mbox() for the same key creates a new mbox.
+ *
+ * Sends to a keyed mbox can be performed from different threads in
+ * parallel. Only the registration of a new key extractor and the creation
+ * of a new key mbox require exclusive access. Neither a key extractor
+ * nor the delivery of a message is called under the lock of the keyed
+ * mbox. It means that a key extractor can be called from several threads
+ * at the same time.
+ *
+ * Usage example:
+ * \code
+	struct quote { std::string m_instrument; double m_price; };
+
+	auto quotes = so_5::keyed_mbox::make_keyed_mbox< std::string >( env );
+	quotes->set_key_extractor< quote >(
+		[]( const quote & q ) { return q.m_instrument; } );
+
+	// A subscriber for just one instrument.
+	class trader : public so_5::agent_t {
+	...
+		virtual void so_define_agent() override {
+			so_subscribe( m_quotes->key_mbox( "ABC" ) ).event( &trader::on_quote );
+		}
+	};
+
+	// A publisher.
+	so_5::send< quote >( quotes->as_mbox(), "ABC", 42.0 );
+ * \endcode
+ *
+ * \tparam Key type of the key.
+ * \tparam Hash type of hash function for the key.
+ * \tparam Key_Equal type of equality predicate for the key.
+ *
+ * \note
+ * Mutable messages can't be sent to a keyed mbox because it is an MPMC mbox.
+ *
+ * \since
+ * v.5.5.25
+ */
+template<
+	typename Key,
+	typename Hash = std::hash< Key >,
+	typename Key_Equal = std::equal_to< Key > >
+class keyed_mbox_t final : public abstract_message_box_t
+	{
+		friend class intrusive_ptr_t< keyed_mbox_t >;
+
+		//! Type of key extractor in the type-erased form.
+		/*!
+		 * Receives a reference to message envelope (an instance of
+		 * message_t or user_type_message_t<T>).
+		 */
+		using extractor_t = std::function< Key( message_t & ) >;
+
+		//! Key extractor for a message type.
+		struct extractor_entry_t
+			{
+				std::type_index m_msg_type;
+				std::shared_ptr< const extractor_t > m_extractor;
+			};
+
+		//! Type of container for key extractors.
+		/*!
+		 * There are usually very few types of messages with keys.
+		 * Because of that a linear search with comparison of type_index
+		 * objects is used. It doesn't require a lookup of msg_type_id
+		 * on every send.
+		 */
+		using extractors_t = std::vector< extractor_entry_t >;
+
+		//! Mbox for subscribers of one key.
+		/*!
+		 * It is a proxy for an ordinary MPMC mbox. The destructor of
+		 * that proxy removes the key from the keyed mbox. The map of
+		 * key mboxes holds only raw pointers to these proxies.
+		 */
+		class key_mbox_t final : public abstract_message_box_t
+			{
+			public :
+				key_mbox_t(
+					intrusive_ptr_t< keyed_mbox_t > owner,
+					Key key,
+					mbox_t actual_mbox )
+					:	m_owner( std::move(owner) )
+					,	m_key( std::move(key) )
+					,	m_actual_mbox( std::move(actual_mbox) )
+					{}
+
+				virtual ~key_mbox_t() override
+					{
+						m_owner->remove_key_mbox( m_key, this );
+					}
+
+				//! Make a new reference to that mbox.
+				/*!
+				 * eturn empty mbox_t if the mbox is in the middle of
+				 * destruction.
+				 *
+				 * ttention
+				 * Must be called when the owner is locked.
+				 */
+				mbox_t
+				try_make_reference()
+					{
+						if( !inc_ref_count_if_not_zero() )
+							return mbox_t{};
+
+						mbox_t result{ this };
+						// The extra reference made by inc_ref_count_if_not_zero()
+						// must be removed. The count can't become zero here.
+						dec_ref_count();
+
+						return result;
+					}
+
+				virtual mbox_id_t
+				id() const override
+					{
+						return m_actual_mbox->id();
+					}
+
+				virtual void
+				subscribe_event_handler(
+					const std::type_index & type_index,
+					const message_limit::control_block_t * limit,
+					agent_t * subscriber ) override
+					{
+						m_actual_mbox->subscribe_event_handler(
+								type_index, limit, subscriber );
+					}
+
+				virtual void
+				unsubscribe_event_handlers(
+					const std::type_index & type_index,
+					agent_t * subscriber ) override
+					{
+						m_actual_mbox->unsubscribe_event_handlers(
+								type_index, subscriber );
+					}
+
+				virtual std::string
+				query_name() const override
+					{
+						return m_actual_mbox->query_name();
+					}
+
+				virtual mbox_type_t
+				type() const override
+					{
+						return m_actual_mbox->type();
+					}
+
+				virtual void
+				do_deliver_message(
+					const std::type_index & msg_type,
+					const message_ref_t & message,
+					unsigned int overlimit_reaction_deep ) const override
+					{
+						m_actual_mbox->do_deliver_message(
+								msg_type, message, overlimit_reaction_deep );
+					}
+
+				virtual void
+				do_deliver_service_request(
+					const std::type_index & msg_type,
+					const message_ref_t & message,
+					unsigned int overlimit_reaction_deep ) const override
+					{
+						m_actual_mbox->do_deliver_service_request(
+								msg_type, message, overlimit_reaction_deep );
+					}
+
+				virtual void
+				do_deliver_enveloped_msg(
+					const std::type_index & msg_type,
+					const message_ref_t & message,
+					unsigned int overlimit_reaction_deep ) override
+					{
+						m_actual_mbox->do_deliver_enveloped_msg(
+								msg_type, message, overlimit_reaction_deep );
+					}
+
+				virtual void
+				set_delivery_filter(
+					const std::type_index & msg_type,
+					const delivery_filter_t & filter,
+					agent_t & subscriber ) override
+					{
+						m_actual_mbox->set_delivery_filter(
+								msg_type, filter, subscriber );
+					}
+
+				virtual void
+				drop_delivery_filter(
+					const std::type_index & msg_type,
+					agent_t & subscriber ) SO_5_NOEXCEPT override
+					{
+						m_actual_mbox->drop_delivery_filter( msg_type, subscriber );
+					}
+
+			protected :
+				virtual void
+				do_deliver_message_from_timer(
+					const std::type_index & msg_type,
+					const message_ref_t & message ) override
+					{
+						delegate_deliver_message_from_timer(
+								*m_actual_mbox, msg_type, message );
+					}
+
+			private :
+				//! Keyed mbox which owns that key mbox.
+				const intrusive_ptr_t< keyed_mbox_t > m_owner;
+
+				//! Key of that mbox.
+				const Key m_key;
+
+				//! Actual mbox for subscribers.
+				const mbox_t m_actual_mbox;
+			};
+
+		//! Type of map from key to key mbox.
+		/*!
+		 * Key mboxes aren't owned by the map. A key mbox removes itself
+		 * from the map in its destructor.
+		 */
+		using key_mboxes_map_t =
+				std::unordered_map< Key, key_mbox_t *, Hash, Key_Equal >;
+
+		//! Environment for creation of key mboxes.
+		environment_t & m_env;
+
+		//! Mbox for subscribers without a key.
+		/*!
+		 * Keyed mbox uses the ID of that mbox as its own ID. It is
+		 * necessary because messages for subscribers of the keyed mbox
+		 * are delivered via that mbox.
+		 */
+		const mbox_t m_wildcard_mbox;
+
+		//! Object lock.
+		mutable default_rw_spinlock_t m_lock;
+
+		//! Registered key extractors.
+		extractors_t m_extractors;
+
+		//! Already created key mboxes.
+		key_mboxes_map_t m_key_mboxes;
+
+		//! Find a key extractor for the message type.
+		/*!
+		 * \attention
+		 * Must be called when object is locked.
+		 */
+		typename extractors_t::const_iterator
+		find_extractor( const std::type_index & msg_type ) const
+			{
+				return std::find_if( m_extractors.begin(), m_extractors.end(),
+						[&msg_type]( const extractor_entry_t & e ) {
+							return e.m_msg_type == msg_type;
+						} );
+			}
+
+		/*!
+		 * \brief Find a key mbox for the message.
+		 *
+		 * The object is locked only for lookups in the containers.
+		 * Key extractor is called without the lock.
+		 *
+		 * \tparam Envelope_Getter type of lambda which returns a reference
+		 * to message envelope. It is called only if there is a key extractor
+		 * for \a msg_type.
+		 *
+		 * \return empty mbox_t if there is no key extractor for the message
+		 * type or there is no key mbox for the key.
+		 */
+		template< typename Envelope_Getter >
+		mbox_t
+		find_key_mbox(
+			const std::type_index & msg_type,
+			Envelope_Getter envelope_getter ) const
+			{
+				std::shared_ptr< const extractor_t > extractor;
+				{
+					read_lock_guard_t< default_rw_spinlock_t > lock( m_lock );
+
+					const auto it = find_extractor( msg_type );
+					if( it == m_extractors.end() )
+						return mbox_t{};
+
+					extractor = it->m_extractor;
+				}
+
+				message_t * envelope = envelope_getter();
+				if( !envelope )
+					return mbox_t{};
+
+				const Key key = (*extractor)( *envelope );
+
+				read_lock_guard_t< default_rw_spinlock_t > lock( m_lock );
+
+				const auto it_mbox = m_key_mboxes.find( key );
+				if( it_mbox == m_key_mboxes.end() )
+					return mbox_t{};
+
+				// The result holds a reference to the key mbox. So the mbox
+				// can be used after the release of the lock.
+				return it_mbox->second->try_make_reference();
+			}
+
+		//! Remove a key mbox which is being destroyed.
+		/*!
+		 * The map can already contain another mbox for the same key.
+		 * It happens if key_mbox() is called when the reference count
+		 * of the old mbox is already zero but its destructor isn't
+		 * finished yet. The new mbox must be kept in that case.
+		 */
+		void
+		remove_key_mbox( const Key & key, const key_mbox_t * key_mbox )
+			SO_5_NOEXCEPT
+			{
+				std::lock_guard< default_rw_spinlock_t > lock( m_lock );
+
+				const auto it = m_key_mboxes.find( key );
+				if( it != m_key_mboxes.end() && it->second == key_mbox )
+					m_key_mboxes.erase( it );
+			}
+
+		//! Find a key mbox for the message or an envelope with message.
+		mbox_t
+		find_key_mbox_for_message(
+			const std::type_index & msg_type,
+			const message_ref_t & message ) const
+			{
+				return find_key_mbox( msg_type,
+					[&message]() -> message_t * {
+						const auto payload =
+								so_5::enveloped_msg::message_to_be_inspected( message );
+						return payload ? payload->get() : nullptr;
+					} );
+			}
+
+	public :
+		//! Initializing constructor.
+		keyed_mbox_t(
+			//! Environment for creation of key mboxes.
+			environment_t & env )
+			:	m_env( env )
+			,	m_wildcard_mbox( env.create_mbox() )
+			{}
+
+		/*!
+		 * \brief Register a key extractor for a message type.
+		 *
+		 * The \a extractor must be a callable object which receives
+		 * a const reference to the message and returns the key:
+		 * \code
+		 * Key extractor(const Msg &);
+		 * \endcode
+		 *
+		 * If there already is an extractor for \a Msg it will be replaced.
+		 *
+		 * \tparam Msg type of the message. It can't be a signal.
+		 */
+		template< typename Msg, typename Extractor >
+		void
+		set_key_extractor( Extractor && extractor )
+			{
+				using payload_traits = message_payload_type< Msg >;
+
+				static_assert( !payload_traits::is_signal,
+						"key can't be extracted from a signal" );
+
+				auto type_erased = std::make_shared< const extractor_t >(
+					[extractor]( message_t & envelope ) -> Key {
+						return extractor(
+								payload_traits::payload_reference( envelope ) );
+					} );
+
+				const auto msg_type = payload_traits::subscription_type_index();
+
+				std::lock_guard< default_rw_spinlock_t > lock( m_lock );
+
+				for( auto & e : m_extractors )
+					if( e.m_msg_type == msg_type )
+						{
+							// A call to extractor which is in progress will
+							// use the old extractor.
+							e.m_extractor = std::move( type_erased );
+							return;
+						}
+
+				m_extractors.push_back(
+						extractor_entry_t{ msg_type, std::move( type_erased ) } );
+			}
+
+		/*!
+		 * \brief Get the mbox for subscription to messages with a key.
+		 *
+		 * A new key mbox is created at the first call for \a key.
+		 * All subsequent calls for the same \a key return the same mbox
+		 * while there is at least one reference to it (including
+		 * subscriptions to that mbox).
+		 */
+		mbox_t
+		key_mbox( const Key & key )
+			{
+				{
+					read_lock_guard_t< default_rw_spinlock_t > lock( m_lock );
+
+					const auto it = m_key_mboxes.find( key );
+					if( it != m_key_mboxes.end() )
+						{
+							auto existing = it->second->try_make_reference();
+							if( existing )
+								return existing;
+						}
+				}
+
+				// Mbox is created outside of the lock.
+				// It can be thrown out if another thread created a mbox
+				// for the same key at the same time.
+				// NOTE: the candidate must be destroyed when the lock is
+				// released because the destructor of key_mbox_t acquires it.
+				auto * raw_candidate = new key_mbox_t{
+						intrusive_ptr_t< keyed_mbox_t >{ this },
+						key,
+						m_env.create_mbox() };
+				mbox_t candidate{ raw_candidate };
+
+				{
+					std::lock_guard< default_rw_spinlock_t > lock( m_lock );
+
+					auto r = m_key_mboxes.emplace( key, raw_candidate );
+					if( !r.second )
+						{
+							auto existing = r.first->second->try_make_reference();
+							if( existing )
+								return existing;
+
+							// The old mbox is in the middle of destruction.
+							r.first->second = raw_candidate;
+						}
+				}
+
+				return candidate;
+			}
+
+		//! Get the keyed mbox as an ordinary mbox.
+		/*!
+		 * This mbox should be used for sending messages and for
+		 * subscription to all messages regardless of their keys.
+		 */
+		mbox_t
+		as_mbox()
+			{
+				return mbox_t{ this };
+			}
+
+		virtual mbox_id_t
+		id() const override
+			{
+				return m_wildcard_mbox->id();
+			}
+
+		virtual void
+		subscribe_event_handler(
+			const std::type_index & type_index,
+			const message_limit::control_block_t * limit,
+			agent_t * subscriber ) override
+			{
+				m_wildcard_mbox->subscribe_event_handler(
+						type_index, limit, subscriber );
+			}
+
+		virtual void
+		unsubscribe_event_handlers(
+			const std::type_index & type_index,
+			agent_t * subscriber ) override
+			{
+				m_wildcard_mbox->unsubscribe_event_handlers(
+						type_index, subscriber );
+			}
+
+		virtual std::string
+		query_name() const override
+			{
+				std::ostringstream s;
+				s << "<mbox:type=KEYED:id=" << id() << ">";
+
+				return s.str();
+			}
+
+		virtual mbox_type_t
+		type() const override
+			{
+				return mbox_type_t::multi_producer_multi_consumer;
+			}
+
+		virtual void
+		do_deliver_message(
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			unsigned int overlimit_reaction_deep ) const override
+			{
+				m_wildcard_mbox->do_deliver_message(
+						msg_type, message, overlimit_reaction_deep );
+
+				const auto key_mbox = find_key_mbox_for_message( msg_type, message );
+				if( key_mbox )
+					key_mbox->do_deliver_message(
+							msg_type, message, overlimit_reaction_deep );
+			}
+
+		virtual void
+		do_deliver_service_request(
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			unsigned int overlimit_reaction_deep ) const override
+			{
+				const auto key_mbox = find_key_mbox( msg_type,
+					[&message]() -> message_t * {
+						return &( dynamic_cast< msg_service_request_base_t & >(
+								*message ).query_param() );
+					} );
+
+				( key_mbox ? key_mbox : m_wildcard_mbox )->
+						do_deliver_service_request(
+								msg_type, message, overlimit_reaction_deep );
+			}
+
+		virtual void
+		do_deliver_enveloped_msg(
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			unsigned int overlimit_reaction_deep ) override
+			{
+				m_wildcard_mbox->do_deliver_enveloped_msg(
+						msg_type, message, overlimit_reaction_deep );
+
+				const auto key_mbox = find_key_mbox_for_message( msg_type, message );
+				if( key_mbox )
+					key_mbox->do_deliver_enveloped_msg(
+							msg_type, message, overlimit_reaction_deep );
+			}
+
+		virtual void
+		set_delivery_filter(
+			const std::type_index & msg_type,
+			const delivery_filter_t & filter,
+			agent_t & subscriber ) override
+			{
+				m_wildcard_mbox->set_delivery_filter( msg_type, filter, subscriber );
+			}
+
+		virtual void
+		drop_delivery_filter(
+			const std::type_index & msg_type,
+			agent_t & subscriber ) SO_5_NOEXCEPT override
+			{
+				m_wildcard_mbox->drop_delivery_filter( msg_type, subscriber );
+			}
+
+	protected :
+		virtual void
+		do_deliver_message_from_timer(
+			const std::type_index & msg_type,
+			const message_ref_t & message ) override
+			{
+				delegate_deliver_message_from_timer(
+						*m_wildcard_mbox, msg_type, message );
+
+				const auto key_mbox = find_key_mbox_for_message( msg_type, message );
+				if( key_mbox )
+					delegate_deliver_message_from_timer(
+							*key_mbox, msg_type, message );
+			}
+	};
+
+//
+// keyed_mbox_ref_t
+//
+/*!
+ * \brief Type of smart pointer to keyed mbox.
+ *
+ * \since
+ * v.5.5.25
+ */
+template<
+	typename Key,
+	typename Hash = std::hash< Key >,
+	typename Key_Equal = std::equal_to< Key > >
+using keyed_mbox_ref_t =
+		intrusive_ptr_t< keyed_mbox_t< Key, Hash, Key_Equal > >;
+
+//
+// make_keyed_mbox
+//
+/*!
+ * \brief Create a new keyed mbox.
+ *
+ * \code
+	auto quotes = so_5::keyed_mbox::make_keyed_mbox< std::string >( env );
+ * \endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+template<
+	typename Key,
+	typename Hash = std::hash< Key >,
+	typename Key_Equal = std::equal_to< Key > >
+keyed_mbox_ref_t< Key, Hash, Key_Equal >
+make_keyed_mbox( environment_t & env )
+	{
+		return keyed_mbox_ref_t< Key, Hash, Key_Equal >{
+				new keyed_mbox_t< Key, Hash, Key_Equal >{ env } };
+	}
+
+} /* namespace keyed_mbox */
+
+} /* namespace so_5 */
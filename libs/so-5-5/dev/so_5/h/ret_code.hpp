@@ -155,6 +155,14 @@ const int rc_disp_type_mismatch = 32;
  */
 const int rc_disp_cannot_be_added = 34;
 
+/*!
+ * \brief List of CPUs for a NUMA node can't be obtained.
+ *
+ * \since
+ * v.5.5.25
+ */
+const int rc_unknown_numa_node = 35;
+
 //! \}
 
 //! \name Error codes for event handlers and message interceptors registration.
@@ -561,6 +569,59 @@ const int rc_scenario_must_be_completed = 182;
  */
 const int rc_stored_state_name_not_found = 183;
 
+/*!
+ * \brief A system call of epoll-based environment infrastructure failed.
+ *
+ * \since
+ * v.5.5.25
+ */
+const int rc_epoll_operation_failed = 184;
+
+/*!
+ * \brief Environment infrastructure doesn't provide an I/O controller.
+ *
+ * For example, an attempt to get epoll_mtsafe's I/O controller for
+ * an environment which uses another environment infrastructure.
+ *
+ * \since
+ * v.5.5.25
+ */
+const int rc_no_io_controller = 185;
+
+/*!
+ * \brief An attempt to wait for free space in the receiver's queue
+ * on a working thread of an agent.
+ *
+ * Such waiting can lead to a deadlock because the receiver can use
+ * the same working thread and can't handle its messages while
+ * the sender is blocked.
+ *
+ * \since
+ * v.5.5.25
+ */
+const int rc_message_limit_wait_on_receiver_thread = 186;
+
+/*!
+ * \brief Elastic mode of a dispatcher can't be used because
+ * the MPMC queue lock doesn't support waiting with a timeout.
+ *
+ * \since
+ * v.5.5.25
+ */
+const int rc_timed_wait_not_supported = 187;
+
+/*!
+ * \brief An attempt to subscribe to a load-balancing mbox with
+ * least_loaded policy without a message limit.
+ *
+ * The load of a subscriber is known only if there is a message limit
+ * for the message type.
+ *
+ * \since
+ * v.5.5.25
+ */
+const int rc_message_limit_required_for_least_loaded = 188;
+
 //! \name Common error codes.
 //! \{
 
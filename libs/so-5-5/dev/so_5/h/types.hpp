@@ -41,6 +41,30 @@ null_mbox_id()
 		return 0ull;
 	}
 
+/*!
+ * \brief A type for process-wide numeric identifier of message type.
+ *
+ * \sa so_5::msg_type_id().
+ *
+ * \since
+ * v.5.5.25
+ */
+typedef std::uint32_t msg_type_id_t;
+
+/*!
+ * \brief Default value for null msg_type_id.
+ *
+ * This value is never assigned to any message type.
+ *
+ * \since
+ * v.5.5.25
+ */
+inline msg_type_id_t
+null_msg_type_id()
+	{
+		return 0u;
+	}
+
 /*!
  * \brief Thread safety indicator.
  * \since
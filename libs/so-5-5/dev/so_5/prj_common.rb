@@ -50,6 +50,7 @@ class Prj < MxxRu::Cpp::LibOrDllTarget
 		sources_root( 'rt' ) {
 
 			cpp_source 'message.cpp'
+			cpp_source 'msg_type_id.cpp'
 			cpp_source 'enveloped_msg.cpp'
 			cpp_source 'handler_makers.cpp'
 
@@ -64,6 +65,7 @@ class Prj < MxxRu::Cpp::LibOrDllTarget
 
 			cpp_source 'agent.cpp'
 
+			cpp_source 'agent_arena.cpp'
 			cpp_source 'agent_coop.cpp'
 			cpp_source 'agent_coop_notifications.cpp'
 
@@ -82,6 +84,7 @@ class Prj < MxxRu::Cpp::LibOrDllTarget
 				cpp_source 'subscr_storage_vector_based.cpp'
 				cpp_source 'subscr_storage_map_based.cpp'
 				cpp_source 'subscr_storage_hash_table_based.cpp'
+				cpp_source 'subscr_storage_flat_hash_based.cpp'
 				cpp_source 'subscr_storage_adaptive.cpp'
 
 				cpp_source 'process_unhandled_exception.cpp'
@@ -98,6 +101,8 @@ class Prj < MxxRu::Cpp::LibOrDllTarget
 				cpp_source 'mt_env_infrastructure.cpp'
 				cpp_source 'simple_mtsafe_st_env_infrastructure.cpp'
 				cpp_source 'simple_not_mtsafe_st_env_infrastructure.cpp'
+				cpp_source 'hybrid_mtsafe_st_env_infrastructure.cpp'
+				cpp_source 'epoll_mtsafe_st_env_infrastructure.cpp'
 			}
 
 			sources_root( 'stats' ) {
@@ -110,6 +115,7 @@ class Prj < MxxRu::Cpp::LibOrDllTarget
 					cpp_source 'ds_agent_core_stats.cpp'
 					cpp_source 'ds_mbox_core_stats.cpp'
 					cpp_source 'ds_timer_thread_stats.cpp'
+					cpp_source 'ds_message_delivery_stats.cpp'
 				}
 			}
 		}
@@ -123,6 +129,10 @@ class Prj < MxxRu::Cpp::LibOrDllTarget
 				cpp_source 'pub.cpp'
 			}
 
+			sources_root( 'thread_affinity' ) {
+				cpp_source 'pub.cpp'
+			}
+
 			sources_root( 'one_thread' ) {
 				cpp_source 'pub.cpp'
 			}
@@ -6,6 +6,8 @@
 #include <so_5/rt/h/mbox.hpp>
 #include <so_5/rt/h/enveloped_msg.hpp>
 #include <so_5/rt/h/environment.hpp>
+#include <so_5/rt/h/agent_arena.hpp>
+#include <so_5/rt/h/suspension_point.hpp>
 
 #include <so_5/rt/impl/h/internal_env_iface.hpp>
 
@@ -15,6 +17,7 @@
 #include <so_5/rt/impl/h/message_limit_internals.hpp>
 #include <so_5/rt/impl/h/delivery_filter_storage.hpp>
 #include <so_5/rt/impl/h/msg_tracing_helpers.hpp>
+#include <so_5/rt/impl/h/state_transitions_cache.hpp>
 
 #include <so_5/rt/impl/h/enveloped_msg_details.hpp>
 
@@ -27,6 +30,7 @@
 #include <algorithm>
 #include <sstream>
 #include <cstdlib>
+#include <cstdint>
 
 namespace so_5
 {
@@ -34,6 +38,17 @@ namespace so_5
 namespace
 {
 
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief An agent whose event is being handled on the current thread.
+ *
+ * Is used for detection of the case when a sender works on the
+ * working thread of a receiver (see limit_then_wait).
+ */
+thread_local const agent_t * current_thread_agent = nullptr;
+
 /*!
  * \since
  * v.5.4.0
@@ -43,23 +58,33 @@ namespace
  *
  * \note New working thread_id is set only if it is not an
  * null thread_id.
+ *
+ * \note Since v.5.5.25 it also sets the agent whose event is being
+ * handled on the current thread. The agent is set only if it is not
+ * a nullptr. The previous value is restored in the destructor.
  */
 struct working_thread_id_sentinel_t
 	{
 		so_5::current_thread_id_t & m_id;
+		const agent_t * m_previous_agent;
 
 		working_thread_id_sentinel_t(
 			so_5::current_thread_id_t & id_var,
-			so_5::current_thread_id_t value_to_set )
+			so_5::current_thread_id_t value_to_set,
+			const agent_t * agent )
 			:	m_id( id_var )
+			,	m_previous_agent( current_thread_agent )
 			{
 				if( value_to_set != null_current_thread_id() )
 					m_id = value_to_set;
+				if( agent )
+					current_thread_agent = agent;
 			}
 		~working_thread_id_sentinel_t()
 			{
 				if( m_id != null_current_thread_id() )
 					m_id = null_current_thread_id();
+				current_thread_agent = m_previous_agent;
 			}
 	};
 
@@ -83,9 +108,28 @@ create_anonymous_state_name( const agent_t * agent, const state_t * st )
 //
 // state_t::time_limit_t
 //
+/*!
+ * \note Since v.5.5.25 a timer isn't created on every enter to the state.
+ * The time of enter is stored and the timer is created only if there is
+ * no active timer already. When the timer fires the stored time is
+ * checked. If the time limit isn't exceeded (the state was reentered)
+ * the timer is created again for the rest of time. There is nothing
+ * to do on exit from the state. A timeout signal which is delivered
+ * when the state isn't active is ignored.
+ */
 struct state_t::time_limit_t
 {
-	struct timeout : public signal_t {};
+	using clock_t = std::chrono::steady_clock;
+
+	//! Timeout message with the number of the timer.
+	struct timeout : public message_t
+	{
+		std::uint_fast64_t m_timer_number;
+
+		timeout( std::uint_fast64_t timer_number )
+			:	m_timer_number( timer_number )
+		{}
+	};
 
 	duration_t m_limit;
 	const state_t & m_state_to_switch;
@@ -93,6 +137,21 @@ struct state_t::time_limit_t
 	mbox_t m_unique_mbox;
 	timer_id_t m_timer;
 
+	//! Time when the limit will be exceeded.
+	clock_t::time_point m_deadline;
+
+	//! Time when the current timer should fire.
+	clock_t::time_point m_timer_fires_at;
+
+	//! Number of the current timer.
+	/*!
+	 * Timeouts from the previous timers are ignored.
+	 */
+	std::uint_fast64_t m_timer_number = 0;
+
+	//! Is there a timer which isn't handled yet?
+	bool m_timer_active = false;
+
 	time_limit_t(
 		duration_t limit,
 		const state_t & state_to_switch )
@@ -109,28 +168,18 @@ struct state_t::time_limit_t
 		// throw exceptions. Any exception will lead to abort of the application.
 		// So we don't care about exception safety.
 		so_5::details::invoke_noexcept_code( [&] {
-
-			// New unique mbox is necessary for time limit.
-			m_unique_mbox = impl::internal_env_iface_t{ agent.so_environment() }
-					// A new MPSC mbox will be used for that.
-					.create_mpsc_mbox(
-							// New MPSC mbox will be directly connected to target agent.
-							&agent,
-							// Message limits will not be used.
-							nullptr );
-
-			// A subscription must be created for timeout signal.
-			agent.so_subscribe( m_unique_mbox )
-					.in( current_state )
-					.event< timeout >( [&agent, this] {
-						agent.so_change_state( m_state_to_switch );
-					} );
-
-			// Delayed timeout signal must be sent.
-			m_timer = agent.so_environment().schedule_timer< timeout >(
-					m_unique_mbox,
-					m_limit,
-					duration_t::zero() );
+			const auto now = clock_t::now();
+			m_deadline = now + std::chrono::duration_cast< clock_t::duration >(
+					m_limit );
+
+			if( !m_unique_mbox )
+				make_subscription( agent, current_state );
+
+			// A new timer is necessary if there is no timer or the
+			// timeout from the current timer was ignored because the
+			// state wasn't active.
+			if( !m_timer_active || m_timer_fires_at <= now )
+				start_timer( agent, m_deadline - now );
 		} );
 	}
 
@@ -139,11 +188,12 @@ struct state_t::time_limit_t
 		agent_t & agent,
 		const state_t & current_state ) SO_5_NOEXCEPT
 	{
-		// Because this method is called from on_exit handler it can't
-		// throw exceptions. Any exception will lead to abort of the application.
+		// Because this method is called when time limit is dropped
+		// it can't throw exceptions.
 		// So we don't care about exception safety.
 		so_5::details::invoke_noexcept_code( [&] {
 			m_timer.release();
+			m_timer_active = false;
 
 			if( m_unique_mbox )
 			{
@@ -154,6 +204,66 @@ struct state_t::time_limit_t
 			}
 		} );
 	}
+
+	void
+	make_subscription(
+		agent_t & agent,
+		const state_t & current_state )
+	{
+		// New unique mbox is necessary for time limit.
+		m_unique_mbox = impl::internal_env_iface_t{ agent.so_environment() }
+				// A new MPSC mbox will be used for that.
+				.create_mpsc_mbox(
+						// New MPSC mbox will be directly connected to target agent.
+						&agent,
+						// Message limits will not be used.
+						nullptr );
+
+		// A subscription must be created for timeout message.
+		// The subscription lives until the time limit is dropped.
+		agent.so_subscribe( m_unique_mbox )
+				.in( current_state )
+				.event( [&agent, this]( mhood_t< timeout > cmd ) {
+					on_timeout( agent, cmd->m_timer_number );
+				} );
+	}
+
+	void
+	start_timer(
+		agent_t & agent,
+		clock_t::duration pause )
+	{
+		// Delayed timeout must be sent.
+		// NOTE: the previous timer is released by that assignment.
+		m_timer = agent.so_environment().schedule_timer(
+				std::unique_ptr< timeout >( new timeout( ++m_timer_number ) ),
+				m_unique_mbox,
+				pause,
+				clock_t::duration::zero() );
+
+		m_timer_fires_at = clock_t::now() + pause;
+		m_timer_active = true;
+	}
+
+	void
+	on_timeout(
+		agent_t & agent,
+		std::uint_fast64_t timer_number )
+	{
+		// Timeout from an old timer must be ignored.
+		if( timer_number != m_timer_number )
+			return;
+
+		m_timer_active = false;
+
+		const auto now = clock_t::now();
+		if( now >= m_deadline )
+			agent.so_change_state( m_state_to_switch );
+		else
+			// The state was reentered. A new timer is necessary for
+			// the rest of time.
+			start_timer( agent, m_deadline - now );
+	}
 };
 
 //
@@ -278,8 +388,7 @@ state_t::state_t(
 	,	m_last_active_substate{ other.m_last_active_substate }
 	,	m_nested_level{ other.m_nested_level }
 	,	m_substate_count{ other.m_substate_count }
-	,	m_on_enter{ std::move(other.m_on_enter) }
-	,	m_on_exit{ std::move(other.m_on_exit) }
+	,	m_enter_exit_handlers{ std::move(other.m_enter_exit_handlers) }
 {
 	if( m_parent_state && m_parent_state->m_initial_substate == &other )
 		m_parent_state->m_initial_substate = this;
@@ -289,6 +398,33 @@ state_t::~state_t()
 {
 }
 
+const state_t::on_enter_handler_t &
+state_t::on_enter() const
+{
+	static const on_enter_handler_t empty_handler;
+
+	return m_enter_exit_handlers ?
+			m_enter_exit_handlers->m_on_enter : empty_handler;
+}
+
+const state_t::on_exit_handler_t &
+state_t::on_exit() const
+{
+	static const on_exit_handler_t empty_handler;
+
+	return m_enter_exit_handlers ?
+			m_enter_exit_handlers->m_on_exit : empty_handler;
+}
+
+state_t::enter_exit_handlers_t &
+state_t::enter_exit_handlers()
+{
+	if( !m_enter_exit_handlers )
+		m_enter_exit_handlers.reset( new enter_exit_handlers_t() );
+
+	return *m_enter_exit_handlers;
+}
+
 bool
 state_t::operator == ( const state_t & state ) const
 {
@@ -462,12 +598,6 @@ state_t::handle_time_limit_on_enter() const
 	m_time_limit->set_up_limit_for_agent( *m_target_agent, *this );
 }
 
-void
-state_t::handle_time_limit_on_exit() const
-{
-	m_time_limit->drop_limit_for_agent( *m_target_agent, *this );
-}
-
 //
 // agent_t
 //
@@ -488,8 +618,6 @@ agent_t::agent_t(
 agent_t::agent_t(
 	context_t ctx )
 	:	m_current_state_ptr( &st_default )
-	,	m_current_status( agent_status_t::not_defined_yet )
-	,	m_state_listener_controller( new impl::state_listener_controller_t )
 	,	m_handler_finder(
 			// Actual handler finder is dependent on msg_tracing status.
 			impl::internal_env_iface_t( ctx.env() ).is_msg_tracing_enabled() ?
@@ -497,20 +625,18 @@ agent_t::agent_t(
 				&agent_t::handler_finder_msg_tracing_disabled )
 	,	m_subscriptions(
 			ctx.options().query_subscription_storage_factory()( self_ptr() ) )
-	,	m_message_limits(
-			message_limit::impl::info_storage_t::create_if_necessary(
-				ctx.options().giveout_message_limits() ) )
-	,	m_env( ctx.env() )
 	,	m_event_queue( nullptr )
-	,	m_direct_mbox(
-			impl::internal_env_iface_t( ctx.env() ).create_mpsc_mbox(
-				self_ptr(),
-				m_message_limits.get() ) )
+	,	m_current_status( agent_status_t::not_defined_yet )
+	,	m_priority( ctx.options().query_priority() )
+	,	m_direct_mbox_created( false )
 		// It is necessary to enable agent subscription in the
 		// constructor of derived class.
 	,	m_working_thread_id( so_5::query_current_thread_id() )
+	,	m_message_limits(
+			message_limit::impl::info_storage_t::create_if_necessary(
+				ctx.options().giveout_message_limits() ) )
+	,	m_env( ctx.env() )
 	,	m_agent_coop( nullptr )
-	,	m_priority( ctx.options().query_priority() )
 {
 }
 
@@ -561,6 +687,10 @@ void
 agent_t::so_add_nondestroyable_listener(
 	agent_state_listener_t & state_listener )
 {
+	if( !m_state_listener_controller )
+		m_state_listener_controller.reset(
+				new impl::state_listener_controller_t );
+
 	m_state_listener_controller->so_add_nondestroyable_listener(
 		state_listener );
 }
@@ -569,6 +699,10 @@ void
 agent_t::so_add_destroyable_listener(
 	agent_state_listener_unique_ptr_t state_listener )
 {
+	if( !m_state_listener_controller )
+		m_state_listener_controller.reset(
+				new impl::state_listener_controller_t );
+
 	m_state_listener_controller->so_add_destroyable_listener(
 		std::move( state_listener ) );
 }
@@ -592,9 +726,27 @@ agent_t::so_switch_to_awaiting_deregistration_state()
 const mbox_t &
 agent_t::so_direct_mbox() const
 {
+	if( !m_direct_mbox_created.load( std::memory_order_acquire ) )
+		create_direct_mbox();
+
 	return m_direct_mbox;
 }
 
+void
+agent_t::create_direct_mbox() const
+{
+	std::lock_guard< default_spinlock_t > lock{ m_direct_mbox_lock };
+
+	if( !m_direct_mbox )
+	{
+		m_direct_mbox = impl::internal_env_iface_t( m_env ).create_mpsc_mbox(
+				const_cast< agent_t * >( this ),
+				m_message_limits.get() );
+
+		m_direct_mbox_created.store( true, std::memory_order_release );
+	}
+}
+
 const state_t &
 agent_t::so_default_state() const
 {
@@ -651,9 +803,10 @@ agent_t::so_change_state(
 			do_state_switch( *actual_new_state );
 
 			// State listener should be informed.
-			m_state_listener_controller->changed(
-				*this,
-				*m_current_state_ptr );
+			if( m_state_listener_controller )
+				m_state_listener_controller->changed(
+					*this,
+					*m_current_state_ptr );
 		}
 	}
 	else
@@ -666,9 +819,12 @@ agent_t::so_change_state(
 void
 agent_t::so_initiate_agent_definition()
 {
+	// NOTE: the agent is not bound to the current thread yet.
+	// Because of that the agent isn't set as the current thread agent.
 	working_thread_id_sentinel_t sentinel(
 			m_working_thread_id,
-			so_5::query_current_thread_id() );
+			so_5::query_current_thread_id(),
+			nullptr );
 
 	so_define_agent();
 
@@ -758,10 +914,11 @@ agent_t::so_create_execution_hint(
 								[handler](
 										execution_demand_t & demand,
 										current_thread_id_t thread_id ) {
-									process_message(
-											thread_id,
-											demand,
-											handler->m_method );
+									if( !drop_if_expired( demand, "execution_hint" ) )
+										process_message(
+												thread_id,
+												demand,
+												handler->m_method );
 								},
 								handler->m_thread_safety );
 					else
@@ -798,10 +955,11 @@ agent_t::so_create_execution_hint(
 							[handler](
 									execution_demand_t & demand,
 									current_thread_id_t thread_id ) {
-								process_enveloped_msg(
-										thread_id,
-										demand,
-										handler );
+								if( !drop_if_expired( demand, "execution_hint" ) )
+									process_enveloped_msg(
+											thread_id,
+											demand,
+											handler );
 							},
 							handler ? handler->m_thread_safety :
 								// If there is no real handler then
@@ -812,7 +970,8 @@ agent_t::so_create_execution_hint(
 				}
 		}
 	else
-		// This is demand_handler_on_start or demand_handler_on_finish.
+		// This is demand_handler_on_start, demand_handler_on_finish or
+		// demand_handler_on_resumption.
 		return execution_hint_t(
 				d,
 				[]( execution_demand_t & demand,
@@ -1014,7 +1173,7 @@ agent_t::do_check_subscription_presence(
 	const state_t & target_state ) const SO_5_NOEXCEPT
 {
 	return nullptr != m_subscriptions->find_handler(
-			mbox->id(), msg_type, target_state );
+			mbox->id(), so_5::msg_type_id( msg_type ), target_state );
 }
 
 bool
@@ -1023,7 +1182,7 @@ agent_t::do_check_deadletter_presence(
 	const std::type_index & msg_type ) const SO_5_NOEXCEPT
 {
 	return nullptr != m_subscriptions->find_handler(
-			mbox->id(), msg_type, deadletter_state );
+			mbox->id(), so_5::msg_type_id( msg_type ), deadletter_state );
 }
 
 namespace {
@@ -1082,6 +1241,7 @@ agent_t::push_event(
 	const message_limit::control_block_t * limit,
 	mbox_id_t mbox_id,
 	std::type_index msg_type,
+	msg_type_id_t msg_type_id,
 	const message_ref_t & message )
 {
 	const auto handler = select_demand_handler_for_message( *this, message );
@@ -1095,10 +1255,66 @@ agent_t::push_event(
 					limit,
 					mbox_id,
 					msg_type,
+					msg_type_id,
 					message,
 					handler ) );
 }
 
+void
+agent_t::push_resumption(
+	const message_ref_t & point )
+{
+	read_lock_guard_t< default_rw_spinlock_t > queue_lock{ m_event_queue_lock };
+
+	if( m_event_queue )
+		m_event_queue->push(
+				execution_demand_t(
+					this,
+					message_limit::control_block_t::none(),
+					0,
+					typeid(impl::suspension_point_t),
+					point,
+					&agent_t::demand_handler_on_resumption ) );
+}
+
+void
+agent_t::destroy_agent( agent_t * agent ) SO_5_NOEXCEPT
+{
+	if( agent->m_allocated_in_arena )
+	{
+		// The agent_t part can be placed not at the beginning of
+		// the whole agent object.
+		void * memory = dynamic_cast< void * >( agent );
+		agent->~agent_t();
+		agent_arena_t::deallocate_agent( memory );
+	}
+	else
+		delete agent;
+}
+
+void
+agent_t::cancel_suspension_points() SO_5_NOEXCEPT
+{
+	while( m_suspension_points )
+	{
+		// The point must live until the end of the cancellation.
+		const message_ref_t point_holder{ m_suspension_points };
+		auto & point = *m_suspension_points;
+
+		point.disarm();
+		point.cancel();
+	}
+}
+
+bool
+agent_t::is_agent_event_handled_on_current_thread() SO_5_NOEXCEPT
+{
+	// NOTE: event queues can't be compared here. Several event queues
+	// can be served by one working thread (for example in prio_one_thread
+	// dispatchers or in thread_pool dispatchers with individual FIFO).
+	return nullptr != current_thread_agent;
+}
+
 void
 agent_t::demand_handler_on_start(
 	current_thread_id_t working_thread_id,
@@ -1108,7 +1324,8 @@ agent_t::demand_handler_on_start(
 
 	working_thread_id_sentinel_t sentinel(
 			d.m_receiver->m_working_thread_id,
-			working_thread_id );
+			working_thread_id,
+			d.m_receiver );
 
 	try
 	{
@@ -1151,7 +1368,8 @@ agent_t::demand_handler_on_finish(
 		// reference count to cooperation.
 		working_thread_id_sentinel_t sentinel(
 				d.m_receiver->m_working_thread_id,
-				working_thread_id );
+				working_thread_id,
+				d.m_receiver );
 
 		try
 		{
@@ -1168,6 +1386,10 @@ agent_t::demand_handler_on_finish(
 					working_thread_id, *(d.m_receiver) );
 		}
 
+		// Since v.5.5.25 suspended activities should be canceled
+		// because they can't be resumed anymore.
+		d.m_receiver->cancel_suspension_points();
+
 		// Since v.5.5.15 agent should be returned in default state.
 		d.m_receiver->return_to_default_state_if_possible();
 	}
@@ -1189,6 +1411,9 @@ agent_t::demand_handler_on_message(
 {
 	message_limit::control_block_t::decrement( d.m_limit );
 
+	if( drop_if_expired( d, "demand_handler_on_message" ) )
+		return;
+
 	auto handler = d.m_receiver->m_handler_finder(
 			d, "demand_handler_on_message" );
 	if( handler )
@@ -1229,6 +1454,9 @@ agent_t::demand_handler_on_enveloped_msg(
 {
 	message_limit::control_block_t::decrement( d.m_limit );
 
+	if( drop_if_expired( d, "demand_handler_on_enveloped_msg" ) )
+		return;
+
 	auto handler = d.m_receiver->m_handler_finder(
 			d, "demand_handler_on_enveloped_msg" );
 	process_enveloped_msg( working_thread_id, d, handler );
@@ -1240,6 +1468,50 @@ agent_t::get_demand_handler_on_enveloped_msg_ptr() SO_5_NOEXCEPT
 	return &agent_t::demand_handler_on_enveloped_msg;
 }
 
+void
+agent_t::demand_handler_on_resumption(
+	current_thread_id_t working_thread_id,
+	execution_demand_t & d )
+{
+	auto & point = *static_cast< impl::suspension_point_t * >(
+			d.m_message_ref.get() );
+
+	// An agent in awaiting_deregistration_state doesn't handle any events.
+	// The point remains armed and will be canceled at the end of
+	// the agent's work.
+	if( !point.armed() ||
+			awaiting_deregistration_state == d.m_receiver->so_current_state() )
+		return;
+
+	point.disarm();
+
+	working_thread_id_sentinel_t sentinel(
+			d.m_receiver->m_working_thread_id,
+			working_thread_id,
+			d.m_receiver );
+
+	try
+	{
+		point.resume();
+	}
+	catch( const std::exception & x )
+	{
+		impl::process_unhandled_exception(
+				working_thread_id, x, *(d.m_receiver) );
+	}
+	catch( ... )
+	{
+		impl::process_unhandled_unknown_exception(
+				working_thread_id, *(d.m_receiver) );
+	}
+}
+
+demand_handler_pfn_t
+agent_t::get_demand_handler_on_resumption_ptr() SO_5_NOEXCEPT
+{
+	return &agent_t::demand_handler_on_resumption;
+}
+
 void
 agent_t::process_message(
 	current_thread_id_t working_thread_id,
@@ -1248,7 +1520,8 @@ agent_t::process_message(
 {
 	working_thread_id_sentinel_t sentinel(
 			d.m_receiver->m_working_thread_id,
-			working_thread_id );
+			working_thread_id,
+			d.m_receiver );
 
 	try
 	{
@@ -1284,7 +1557,8 @@ agent_t::process_service_request(
 			{
 				working_thread_id_sentinel_t sentinel(
 						d.m_receiver->m_working_thread_id,
-						working_thread_id );
+						working_thread_id,
+						d.m_receiver );
 
 				// This copy is necessary to prevent deallocation of
 				// event-handler if it is implemented as lambda-function.
@@ -1336,6 +1610,32 @@ agent_t::process_enveloped_msg(
 	} );
 }
 
+bool
+agent_t::drop_if_expired(
+	execution_demand_t & d,
+	const char * context_marker ) SO_5_NOEXCEPT
+{
+	const auto metadata = message_metadata( d.m_message_ref );
+	if( metadata.empty() || !metadata.query_deadline() )
+		return false;
+
+	if( !metadata.is_expired( std::chrono::steady_clock::now() ) )
+		return false;
+
+	impl::internal_env_iface_t{ d.m_receiver->m_env }.expired_message_dropped();
+	// Tracing requires memory allocations. An exception from it
+	// is ignored because the message must be dropped anyway.
+	try
+	{
+		impl::msg_tracing_helpers::safe_trace_expired_message_dropped(
+				d, context_marker );
+	}
+	catch( ... )
+	{}
+
+	return true;
+}
+
 void
 agent_t::ensure_operation_is_on_working_thread(
 	const char * operation_name ) const
@@ -1451,7 +1751,7 @@ agent_t::find_event_handler_for_current_state(
 	do {
 		search_result = d.m_receiver->m_subscriptions->find_handler(
 				d.m_mbox_id,
-				d.m_msg_type, 
+				d.m_msg_type_id,
 				*s );
 
 		if( !search_result )
@@ -1468,7 +1768,7 @@ agent_t::find_deadletter_handler(
 {
 	return demand.m_receiver->m_subscriptions->find_handler(
 			demand.m_mbox_id,
-			demand.m_msg_type,
+			demand.m_msg_type_id,
 			deadletter_state );
 }
 
@@ -1476,24 +1776,35 @@ void
 agent_t::do_state_switch(
 	const state_t & state_to_be_set ) SO_5_NOEXCEPT
 {
-	state_t::path_t old_path;
-	state_t::path_t new_path;
-
 	// Since v.5.5.22 we will change the value of m_current_state_ptr
 	// during state change procedure.
 	auto current_st = m_current_state_ptr;
 
-	current_st->fill_path( old_path );
-	state_to_be_set.fill_path( new_path );
+	// Since v.5.5.25 transitions between nested states are calculated
+	// only once and then are taken from the cache.
+	// A transition between top-level states is trivial and isn't cached.
+	impl::state_transition_t local_transition;
+	const impl::state_transition_t * transition = &local_transition;
+	if( current_st->nested_level() || state_to_be_set.nested_level() )
+	{
+		try
+		{
+			if( !m_state_transitions_cache )
+				m_state_transitions_cache.reset(
+						new impl::state_transitions_cache_t() );
 
-	// Find the first item which is different in the paths.
-	std::size_t first_diff = 0;
-	for(; first_diff < std::min(
-				current_st->nested_level(),
-				state_to_be_set.nested_level() );
-			++first_diff )
-		if( old_path[ first_diff ] != new_path[ first_diff ] )
-			break;
+			transition = &m_state_transitions_cache->find_or_create(
+					*current_st, state_to_be_set );
+		}
+		catch( ... )
+		{
+			// The cache can't be used. Transition will be calculated
+			// without it.
+			local_transition.calculate( *current_st, state_to_be_set );
+		}
+	}
+	else
+		local_transition.calculate( *current_st, state_to_be_set );
 
 	// Do call for on_exit and on_enter for states.
 	// on_exit and on_enter should not throw exceptions.
@@ -1502,31 +1813,25 @@ agent_t::do_state_switch(
 		impl::msg_tracing_helpers::safe_trace_state_leaving(
 				*this, *current_st );
 
-		for( std::size_t i = current_st->nested_level();
-				i >= first_diff; )
+		for( std::size_t i = 0; i != transition->m_exits_count; ++i )
 			{
+				const state_t * st = transition->m_exits[ i ];
 				// Modify current state before calling on_exit handler.
-				m_current_state_ptr = old_path[ i ];
+				m_current_state_ptr = st;
 				// Perform on_exit actions.
-				old_path[ i ]->call_on_exit();
-				if( i )
-					--i;
-				else
-					break;
+				st->call_on_exit();
 			}
 
 		impl::msg_tracing_helpers::safe_trace_state_entering(
 				*this, state_to_be_set );
 
-		for( std::size_t i = first_diff;
-				i <= state_to_be_set.nested_level();
-				++i )
+		for( std::size_t i = 0; i != transition->m_enters_count; ++i )
 			{
-				// Modify current state before calling on_exit handler.
-				m_current_state_ptr = new_path[ i ];
-
+				const state_t * st = transition->m_enters[ i ];
+				// Modify current state before calling on_enter handler.
+				m_current_state_ptr = st;
 				// Perform on_enter actions.
-				new_path[ i ]->call_on_enter();
+				st->call_on_enter();
 			}
 	} );
 
@@ -1547,5 +1852,22 @@ agent_t::return_to_default_state_if_possible() SO_5_NOEXCEPT
 	}
 }
 
+//
+// intrusive_ptr_t< agent_t >
+//
+template<>
+SO_5_FUNC void
+intrusive_ptr_t< agent_t >::dismiss_object() SO_5_NOEXCEPT
+{
+	if( m_obj )
+	{
+		if( 0 == m_obj->dec_ref_count() )
+		{
+			agent_t::destroy_agent( m_obj );
+		}
+		m_obj = nullptr;
+	}
+}
+
 } /* namespace so_5 */
 
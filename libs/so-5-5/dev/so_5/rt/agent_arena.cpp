@@ -0,0 +1,113 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief A monotonic arena for allocation of agents of a cooperation.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#include <so_5/rt/h/agent_arena.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace so_5
+{
+
+namespace
+{
+
+//! Alignment of all blocks allocated for agents.
+const std::size_t block_alignment = alignof( std::max_align_t );
+
+//! Round size up to block_alignment.
+inline std::size_t
+aligned_size( std::size_t size )
+{
+	return ( size + block_alignment - 1u ) & ~( block_alignment - 1u );
+}
+
+//! Get a pointer to the place of arena pointer before an agent.
+inline agent_arena_t **
+arena_ptr_place( void * agent )
+{
+	return reinterpret_cast< agent_arena_t ** >( agent ) - 1;
+}
+
+} /* namespace anonymous */
+
+//
+// agent_arena_t
+//
+agent_arena_t::agent_arena_t(
+	std::size_t chunk_size )
+	:	m_chunk_size( aligned_size( chunk_size ? chunk_size : 1u ) )
+{}
+
+agent_arena_t::~agent_arena_t()
+{}
+
+void *
+agent_arena_t::allocate_agent(
+	std::size_t size,
+	std::size_t alignment )
+{
+	const std::size_t actual_alignment = (std::max)( alignment, block_alignment );
+
+	// Every block is aligned to block_alignment. Extra actual_alignment
+	// bytes are enough for the pointer to the arena and for the alignment
+	// of the agent.
+	char * block = static_cast< char * >(
+			allocate( actual_alignment + size ) );
+
+	const auto agent_addr =
+			( reinterpret_cast< std::uintptr_t >( block ) +
+					sizeof( agent_arena_t * ) + actual_alignment - 1u ) &
+			~static_cast< std::uintptr_t >( actual_alignment - 1u );
+	void * agent = block + ( agent_addr -
+			reinterpret_cast< std::uintptr_t >( block ) );
+
+	*arena_ptr_place( agent ) = this;
+	// Every agent holds a reference to the arena.
+	inc_ref_count();
+
+	return agent;
+}
+
+void
+agent_arena_t::deallocate_agent( void * p ) SO_5_NOEXCEPT
+{
+	agent_arena_t * arena = *arena_ptr_place( p );
+	if( 0u == arena->dec_ref_count() )
+		delete arena;
+}
+
+void *
+agent_arena_t::allocate( std::size_t size )
+{
+	size = aligned_size( size );
+
+	if( size > m_available )
+		{
+			// A new chunk is necessary. A big block gets its own chunk.
+			const std::size_t chunk_size = (std::max)( size, m_chunk_size );
+			m_chunks.emplace_back( new char[ chunk_size ] );
+			m_current = m_chunks.back().get();
+			m_available = chunk_size;
+			m_allocated_bytes += chunk_size;
+		}
+
+	void * result = m_current;
+	m_current += size;
+	m_available -= size;
+	m_used_bytes += size;
+
+	return result;
+}
+
+} /* namespace so_5 */
+
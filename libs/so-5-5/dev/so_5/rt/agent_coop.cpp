@@ -4,6 +4,8 @@
 
 #include <exception>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <so_5/h/exception.hpp>
 
@@ -183,6 +185,23 @@ coop_t::set_exception_reaction(
 	m_exception_reaction = value;
 }
 
+void
+coop_t::set_parallel_agent_definition(
+	std::size_t max_threads,
+	std::size_t min_agents_per_thread )
+{
+	m_max_definition_threads = max_threads ? max_threads : 1u;
+	m_min_agents_per_definition_thread =
+			min_agents_per_thread ? min_agents_per_thread : 1u;
+}
+
+void
+coop_t::use_agent_arena(
+	std::size_t chunk_size )
+{
+	m_agent_arena = agent_arena_ref_t( new agent_arena_t( chunk_size ) );
+}
+
 exception_reaction_t
 coop_t::exception_reaction() const
 {
@@ -291,6 +310,15 @@ coop_t::bind_agents_to_coop()
 void
 coop_t::define_all_agents()
 {
+	const std::size_t threads = std::min(
+			m_max_definition_threads,
+			m_agent_array.size() / m_min_agents_per_definition_thread );
+	if( threads > 1u )
+	{
+		define_all_agents_in_parallel( threads );
+		return;
+	}
+
 	agent_array_t::iterator it = m_agent_array.begin();
 	agent_array_t::iterator it_end = m_agent_array.end();
 
@@ -300,6 +328,68 @@ coop_t::define_all_agents()
 	}
 }
 
+void
+coop_t::define_all_agents_in_parallel(
+	std::size_t threads )
+{
+	const std::size_t batch_size =
+			( m_agent_array.size() + threads - 1u ) / threads;
+
+	// The first exception will be stored here.
+	// All other threads will finish their work as soon as possible.
+	std::mutex error_lock;
+	std::exception_ptr first_error;
+	std::atomic< bool > failed{ false };
+
+	auto define_batch = [&]( std::size_t first ) {
+		const std::size_t last = std::min(
+				first + batch_size, m_agent_array.size() );
+		try
+		{
+			for( std::size_t i = first;
+					i < last && !failed.load( std::memory_order_relaxed );
+					++i )
+				m_agent_array[ i ].m_agent_ref->so_initiate_agent_definition();
+		}
+		catch( ... )
+		{
+			std::lock_guard< std::mutex > lock{ error_lock };
+			if( !first_error )
+				first_error = std::current_exception();
+			failed.store( true, std::memory_order_relaxed );
+		}
+	};
+
+	std::vector< std::thread > workers;
+	workers.reserve( threads - 1u );
+
+	// All the started threads must be joined even if an exception
+	// is thrown during creation of a new thread.
+	auto join_workers = [&workers] {
+		for( auto & t : workers )
+			t.join();
+	};
+
+	try
+	{
+		// The first batch will be defined on the current thread.
+		for( std::size_t i = 1u; i != threads; ++i )
+			workers.emplace_back( define_batch, i * batch_size );
+	}
+	catch( ... )
+	{
+		failed.store( true, std::memory_order_relaxed );
+		join_workers();
+		throw;
+	}
+
+	define_batch( 0u );
+	join_workers();
+
+	if( first_error )
+		std::rethrow_exception( first_error );
+}
+
 void
 coop_t::bind_agents_to_disp()
 {
@@ -20,6 +20,7 @@
 #include <so_5/rt/stats/impl/h/ds_mbox_core_stats.hpp>
 #include <so_5/rt/stats/impl/h/ds_agent_core_stats.hpp>
 #include <so_5/rt/stats/impl/h/ds_timer_thread_stats.hpp>
+#include <so_5/rt/stats/impl/h/ds_message_delivery_stats.hpp>
 
 #include <so_5/rt/h/env_infrastructures.hpp>
 
@@ -163,10 +164,14 @@ class core_data_sources_t
 		core_data_sources_t(
 			outliving_reference_t< stats::repository_t > ds_repository,
 			impl::mbox_core_t & mbox_repository,
-			so_5::environment_infrastructure_t & infrastructure )
+			so_5::environment_infrastructure_t & infrastructure,
+			const std::atomic< std::size_t > & expired_messages,
+			const std::atomic< std::size_t > & conflated_messages )
 			:	m_mbox_repository( ds_repository, mbox_repository )
 			,	m_coop_repository( ds_repository, infrastructure )
 			,	m_timer_thread( ds_repository, infrastructure )
+			,	m_message_delivery(
+					ds_repository, expired_messages, conflated_messages )
 			{}
 
 	private :
@@ -184,6 +189,15 @@ class core_data_sources_t
 		stats::auto_registered_source_holder_t<
 						stats::impl::ds_timer_thread_stats_t >
 				m_timer_thread;
+
+		//! Data source for message delivery.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		stats::auto_registered_source_holder_t<
+						stats::impl::ds_message_delivery_stats_t >
+				m_message_delivery;
 	};
 
 /*!
@@ -348,6 +362,31 @@ struct environment_t::internals_t
 	 */
 	std::atomic_uint_fast64_t m_autoname_counter = { 0 }; 
 
+	/*!
+	 * \brief A counter of messages dropped because their deadlines passed.
+	 *
+	 * \attention
+	 * Must be declared before m_core_data_sources because a reference
+	 * to it is passed to m_core_data_sources.
+	 *
+	 * \since
+	 * v.5.5.25
+	 */
+	std::atomic< std::size_t > m_expired_messages = { 0u };
+
+	/*!
+	 * \brief Counter of messages replaced by newer messages with
+	 * the same conflation key.
+	 *
+	 * \attention
+	 * Must be declared before m_core_data_sources because a reference
+	 * to it is passed to m_core_data_sources.
+	 *
+	 * \since
+	 * v.5.5.25
+	 */
+	std::atomic< std::size_t > m_conflated_messages = { 0u };
+
 	/*!
 	 * \brief Data sources for core objects.
 	 *
@@ -420,7 +459,9 @@ struct environment_t::internals_t
 		,	m_core_data_sources(
 				outliving_mutable(m_infrastructure->stats_repository()),
 				*m_mbox_core,
-				*m_infrastructure )
+				*m_infrastructure,
+				m_expired_messages,
+				m_conflated_messages )
 		,	m_work_thread_activity_tracking(
 				params.work_thread_activity_tracking() )
 		,	m_queue_locks_defaults_manager(
@@ -466,6 +507,13 @@ environment_t::create_mbox(
 	return m_impl->m_mbox_core->create_mbox( std::move(nonempty_name) );
 }
 
+mbox_t
+environment_t::create_load_balancing_mbox(
+	load_balancing_policy_t policy )
+{
+	return m_impl->m_mbox_core->create_load_balancing_mbox( policy );
+}
+
 mchain_t
 environment_t::create_mchain(
 	const mchain_params_t & params )
@@ -933,6 +981,25 @@ internal_env_iface_t::default_mpmc_queue_lock_factory() const
 			mpmc_queue_lock_factory();
 }
 
+environment_infrastructure_t &
+internal_env_iface_t::infrastructure() const
+{
+	return *(m_env.m_impl->m_infrastructure);
+}
+
+void
+internal_env_iface_t::expired_message_dropped() SO_5_NOEXCEPT
+{
+	m_env.m_impl->m_expired_messages.fetch_add( 1u, std::memory_order_relaxed );
+}
+
+void
+internal_env_iface_t::message_conflated() SO_5_NOEXCEPT
+{
+	m_env.m_impl->m_conflated_messages.fetch_add(
+			1u, std::memory_order_relaxed );
+}
+
 SO_5_NODISCARD
 event_queue_t *
 internal_env_iface_t::event_queue_on_bind(
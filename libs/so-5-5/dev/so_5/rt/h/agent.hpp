@@ -801,6 +801,7 @@ class SO_5_TYPE agent_t
 
 		friend class so_5::impl::mpsc_mbox_t;
 		friend class so_5::impl::state_switch_guard_t;
+		friend class so_5::impl::suspension_point_t;
 
 		friend class so_5::enveloped_msg::impl::agent_demand_handler_invoker_t;
 
@@ -1177,9 +1178,46 @@ class SO_5_TYPE agent_t
 			std::type_index msg_type,
 			const message_ref_t & message )
 		{
-			agent.push_event( limit, mbox_id, msg_type, message );
+			agent.push_event(
+					limit, mbox_id, msg_type, so_5::msg_type_id( msg_type ), message );
 		}
 
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief Push an event to the agent's event queue when ID of
+		 * the message type is already known.
+		 *
+		 * It allows to avoid the repeated lookup of the ID.
+		 */
+		static inline void
+		call_push_event(
+			agent_t & agent,
+			const message_limit::control_block_t * limit,
+			mbox_id_t mbox_id,
+			std::type_index msg_type,
+			msg_type_id_t msg_type_id,
+			const message_ref_t & message )
+		{
+			agent.push_event( limit, mbox_id, msg_type, msg_type_id, message );
+		}
+
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief Is an event of some agent handled on the current thread?
+		 *
+		 * It is impossible to check that the current thread is not
+		 * a working thread of a particular agent. So any agent's
+		 * working thread is treated as a potential receiver's thread.
+		 *
+		 * \note Is used for prevention of deadlocks in limit_then_wait.
+		 */
+		static bool
+		is_agent_event_handled_on_current_thread() SO_5_NOEXCEPT;
+
 		/*!
 		 * \since
 		 * v.5.3.0
@@ -1198,7 +1236,8 @@ class SO_5_TYPE agent_t
 			std::type_index msg_type,
 			const message_ref_t & message )
 		{
-			agent.push_event( limit, mbox_id, msg_type, message );
+			agent.push_event(
+					limit, mbox_id, msg_type, so_5::msg_type_id( msg_type ), message );
 		}
 
 		/*!
@@ -1206,6 +1245,12 @@ class SO_5_TYPE agent_t
 		 * v.5.4.0
 		 *
 		 * \brief Get the agent's direct mbox.
+		 *
+		 * \note Since v.5.5.25 the direct mbox is created at the first
+		 * call to that method. Agents which never use their direct mboxes
+		 * (for example, agents which are subscribed only to shared mboxes)
+		 * don't spend memory and mbox ids for them.
+		 * This method is thread-safe.
 		 */
 		const mbox_t &
 		so_direct_mbox() const;
@@ -2547,10 +2592,16 @@ class SO_5_TYPE agent_t
 		 */
 
 	private:
-		const state_t st_default = so_make_state( "<DEFAULT>" );
-
-		//! Current agent state.
-		const state_t * m_current_state_ptr;
+		/*!
+		 * \since
+		 * v.5.5.9
+		 *
+		 * \brief Type of function for searching event handler.
+		 */
+		using handler_finder_t = 
+			const impl::event_handler_data_t *(*)(
+					execution_demand_t & /* demand */,
+					const char * /* context_marker */ );
 
 		/*!
 		 * \brief Enumeration of possible agent statuses.
@@ -2570,27 +2621,17 @@ class SO_5_TYPE agent_t
 		};
 
 		/*!
-		 * \brief Current agent status.
+		 * \name Attributes used on every message delivery and handling.
 		 *
-		 * \since
-		 * v.5.5.18
+		 * \note
+		 * Since v.5.5.25 these attributes are declared one after another
+		 * at the beginning of agent_t. They occupy the first 64 bytes of
+		 * the object and are usually placed in the same cache line.
+		 * \{
 		 */
-		agent_status_t m_current_status;
-
-		//! State listeners controller.
-		std::unique_ptr< impl::state_listener_controller_t >
-			m_state_listener_controller;
 
-		/*!
-		 * \since
-		 * v.5.5.9
-		 *
-		 * \brief Type of function for searching event handler.
-		 */
-		using handler_finder_t = 
-			const impl::event_handler_data_t *(*)(
-					execution_demand_t & /* demand */,
-					const char * /* context_marker */ );
+		//! Current agent state.
+		const state_t * m_current_state_ptr;
 
 		/*!
 		 * \since
@@ -2611,26 +2652,6 @@ class SO_5_TYPE agent_t
 		 */
 		impl::subscription_storage_unique_ptr_t m_subscriptions;
 
-		/*!
-		 * \since
-		 * v.5.5.4
-		 *
-		 * \brief Run-time information for message limits.
-		 *
-		 * Created only of message limits are described in agent's
-		 * tuning options.
-		 *
-		 * \attention This attribute must be initialized before the
-		 * \a m_direct_mbox attribute. It is because the value of
-		 * \a m_message_limits is used in \a m_direct_mbox creation.
-		 * Because of that \a m_message_limits is declared before
-		 * \a m_direct_mbox.
-		 */
-		std::unique_ptr< message_limit::impl::info_storage_t > m_message_limits;
-
-		//! SObjectizer Environment for which the agent is belong.
-		environment_t & m_env;
-
 		/*!
 		 * \since
 		 * v.5.5.8
@@ -2671,13 +2692,49 @@ class SO_5_TYPE agent_t
 		 */
 		event_queue_t * m_event_queue;
 
+		/*!
+		 * \brief Current agent status.
+		 *
+		 * \since
+		 * v.5.5.18
+		 */
+		agent_status_t m_current_status;
+
 		/*!
 		 * \since
-		 * v.5.4.0
+		 * v.5.5.8
 		 *
-		 * \brief A direct mbox for the agent.
+		 * \brief Priority of the agent.
+		 */
+		const priority_t m_priority;
+
+		/*!
+		 * \brief Is the direct mbox already created?
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		mutable std::atomic< bool > m_direct_mbox_created;
+
+		/*!
+		 * \brief Lock for creation of the direct mbox.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		mutable default_spinlock_t m_direct_mbox_lock;
+
+		/*!
+		 * \brief Is the agent allocated in an agent_arena?
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		bool m_allocated_in_arena = false;
+
+		/*!
+		 * \}
 		 */
-		const mbox_t m_direct_mbox;
 
 		/*!
 		 * \since
@@ -2690,9 +2747,45 @@ class SO_5_TYPE agent_t
 		 */
 		so_5::current_thread_id_t m_working_thread_id;
 
+		/*!
+		 * \since
+		 * v.5.5.4
+		 *
+		 * \brief Run-time information for message limits.
+		 *
+		 * Created only of message limits are described in agent's
+		 * tuning options.
+		 *
+		 * \note The value of \a m_message_limits is used in
+		 * \a m_direct_mbox creation.
+		 */
+		std::unique_ptr< message_limit::impl::info_storage_t > m_message_limits;
+
+		/*!
+		 * \since
+		 * v.5.4.0
+		 *
+		 * \brief A direct mbox for the agent.
+		 *
+		 * \note Since v.5.5.25 it is created at the first call to
+		 * so_direct_mbox().
+		 */
+		mutable mbox_t m_direct_mbox;
+
+		//! SObjectizer Environment for which the agent is belong.
+		environment_t & m_env;
+
 		//! Agent is belong to this cooperation.
 		coop_t * m_agent_coop;
 
+		//! State listeners controller.
+		/*!
+		 * \note Since v.5.5.25 it is created only when the first
+		 * listener is added.
+		 */
+		std::unique_ptr< impl::state_listener_controller_t >
+			m_state_listener_controller;
+
 		/*!
 		 * \since
 		 * v.5.5.5
@@ -2704,12 +2797,33 @@ class SO_5_TYPE agent_t
 		std::unique_ptr< impl::delivery_filter_storage_t > m_delivery_filters;
 
 		/*!
+		 * \brief Cache for transitions between nested states.
+		 *
+		 * \note Cache is created only when the first transition
+		 * between nested states is performed.
+		 *
 		 * \since
-		 * v.5.5.8
+		 * v.5.5.25
+		 */
+		std::unique_ptr< impl::state_transitions_cache_t >
+			m_state_transitions_cache;
+
+		/*!
+		 * \brief Head of the list of armed suspension points.
 		 *
-		 * \brief Priority of the agent.
+		 * \note This list is accessed only on the agent's working context.
+		 *
+		 * \since
+		 * v.5.5.25
 		 */
-		const priority_t m_priority;
+		impl::suspension_point_t * m_suspension_points = nullptr;
+
+		//! The default state of the agent.
+		/*!
+		 * \note Since v.5.5.25 it is declared after all other attributes
+		 * because it is rarely accessed during message processing.
+		 */
+		const state_t st_default = so_make_state( "<DEFAULT>" );
 
 		//! Make an agent reference.
 		/*!
@@ -2720,6 +2834,53 @@ class SO_5_TYPE agent_t
 		agent_ref_t
 		create_ref();
 
+		/*!
+		 * \brief Create the direct mbox if it isn't created yet.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		create_direct_mbox() const;
+
+		/*!
+		 * \brief Push a resumption demand to the event queue.
+		 *
+		 * The demand is silently ignored if the agent has no event
+		 * queue anymore.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		push_resumption(
+			//! Suspension point to be resumed.
+			const message_ref_t & point );
+
+		/*!
+		 * \brief Cancel all armed suspension points.
+		 *
+		 * Is called at the end of the agent's work.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		cancel_suspension_points() SO_5_NOEXCEPT;
+
+		/*!
+		 * \brief Destroy the agent when the last reference to it is gone.
+		 *
+		 * An agent from the dynamic memory is deleted as usual.
+		 * An agent from an agent_arena is destroyed and its memory
+		 * is returned to the arena.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		static void
+		destroy_agent( agent_t * agent ) SO_5_NOEXCEPT;
+
 		/*!
 		 * \name Embedding agent into the SObjectizer Run-time.
 		 * \{
@@ -2844,6 +3005,8 @@ class SO_5_TYPE agent_t
 			mbox_id_t mbox_id,
 			//! Message type for event.
 			std::type_index msg_type,
+			//! ID of message type for event.
+			msg_type_id_t msg_type_id,
 			//! Event message.
 			const message_ref_t & message );
 		/*!
@@ -2967,6 +3130,24 @@ class SO_5_TYPE agent_t
 		 */
 		static demand_handler_pfn_t
 		get_demand_handler_on_enveloped_msg_ptr() SO_5_NOEXCEPT;
+
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief Resumes an activity suspended at a suspension point.
+		 */
+		static void
+		demand_handler_on_resumption(
+			current_thread_id_t working_thread_id,
+			execution_demand_t & d );
+
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		static demand_handler_pfn_t
+		get_demand_handler_on_resumption_ptr() SO_5_NOEXCEPT;
 		/*!
 		 * \}
 		 */
@@ -3029,6 +3210,27 @@ class SO_5_TYPE agent_t
 			execution_demand_t & d,
 			const impl::event_handler_data_t * handler_data );
 
+		/*!
+		 * \brief Drop the demand if the deadline of its message passed.
+		 *
+		 * The deadline is taken from the inline message metadata
+		 * (see so_5::send_with_deadline()). If the deadline passed then
+		 * the count of expired messages is incremented and the fact
+		 * of dropping is reflected in msg_tracing.
+		 *
+		 * \note
+		 * The current time is not queried for messages without deadline.
+		 *
+		 * \retval true if the demand is dropped and must not be handled.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		static bool
+		drop_if_expired(
+			execution_demand_t & d,
+			const char * context_marker ) SO_5_NOEXCEPT;
+
 		/*!
 		 * \since
 		 * v.5.4.0
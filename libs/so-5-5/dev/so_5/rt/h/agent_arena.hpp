@@ -0,0 +1,156 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief A monotonic arena for allocation of agents of a cooperation.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/h/declspec.hpp>
+#include <so_5/h/compiler_features.hpp>
+#include <so_5/h/atomic_refcounted.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#if defined( SO_5_MSVC )
+	#pragma warning(push)
+	#pragma warning(disable: 4251)
+#endif
+
+namespace so_5
+{
+
+class agent_t;
+
+//
+// agent_arena_t
+//
+/*!
+ * \brief A monotonic arena for allocation of agents of a cooperation.
+ *
+ * Memory is taken from the system by big chunks. Every agent allocated
+ * in the arena holds a reference to it, so the arena is destroyed and all
+ * the chunks are released in one step only when the last agent from
+ * the arena is destroyed. Memory of a destroyed agent isn't reused.
+ *
+ * Agents allocated in the dynamic memory are not affected by the arena:
+ * they are created by the usual new and destroyed by the usual delete.
+ *
+ * Allocation from the arena isn't thread-safe. Because of that the arena
+ * is intended to be filled only during the preparation of a cooperation
+ * (see coop_t::use_agent_arena()).
+ *
+ * \note
+ * Only agents themselves are allocated in the arena. Subscription
+ * storage, states and other data allocated by an agent at run-time
+ * are allocated as usual.
+ *
+ * \since
+ * v.5.5.25
+ */
+class SO_5_TYPE agent_arena_t final : private atomic_refcounted_t
+	{
+		friend class intrusive_ptr_t< agent_arena_t >;
+		friend class agent_t;
+		friend class coop_t;
+
+	public :
+		//! Default size of one chunk of the arena.
+		static const std::size_t default_chunk_size = 16u * 1024u;
+
+		agent_arena_t( const agent_arena_t & ) = delete;
+		agent_arena_t & operator=( const agent_arena_t & ) = delete;
+
+		//! Initializing constructor.
+		explicit agent_arena_t(
+			//! Size of one chunk of the arena.
+			std::size_t chunk_size = default_chunk_size );
+		~agent_arena_t();
+
+		//! Total size of all the chunks allocated by the arena.
+		std::size_t
+		allocated_bytes() const SO_5_NOEXCEPT { return m_allocated_bytes; }
+
+		//! Total size of all the blocks taken from the arena.
+		std::size_t
+		used_bytes() const SO_5_NOEXCEPT { return m_used_bytes; }
+
+	private :
+		//! Size of one chunk.
+		const std::size_t m_chunk_size;
+
+		//! All the chunks of the arena.
+		std::vector< std::unique_ptr< char[] > > m_chunks;
+
+		//! Pointer to the free space in the current chunk.
+		char * m_current = nullptr;
+		//! Size of the free space in the current chunk.
+		std::size_t m_available = 0u;
+
+		std::size_t m_allocated_bytes = 0u;
+		std::size_t m_used_bytes = 0u;
+
+		/*!
+		 * \name Allocation of memory for agents.
+		 *
+		 * \note
+		 * These methods are used by coop_t and agent_t. A pointer to
+		 * the arena is stored right before every agent in the arena.
+		 * \{
+		 */
+		//! Allocate memory for an agent.
+		/*!
+		 * The agent holds a reference to the arena until
+		 * deallocate_agent() is called.
+		 */
+		void *
+		allocate_agent(
+			//! Size of the agent.
+			std::size_t size,
+			//! Alignment of the agent.
+			std::size_t alignment );
+
+		//! Deallocate memory of an agent.
+		/*!
+		 * The reference count of the arena is decremented and the arena
+		 * is destroyed when there are no more agents in it.
+		 *
+		 * \attention
+		 * \a p must be a value returned by allocate_agent().
+		 */
+		static void
+		deallocate_agent( void * p ) SO_5_NOEXCEPT;
+		/*!
+		 * \}
+		 */
+
+		//! Take a block from the arena.
+		void *
+		allocate( std::size_t size );
+	};
+
+//
+// agent_arena_ref_t
+//
+/*!
+ * \brief Typedef for smart pointer to agent_arena.
+ *
+ * \since
+ * v.5.5.25
+ */
+using agent_arena_ref_t = intrusive_ptr_t< agent_arena_t >;
+
+} /* namespace so_5 */
+
+#if defined( SO_5_MSVC )
+	#pragma warning(pop)
+#endif
+
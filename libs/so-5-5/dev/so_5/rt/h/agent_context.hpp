@@ -201,6 +201,16 @@ operator+(
 		return ctx;
 	}
 
+template< class M >
+agent_context_t
+operator+(
+	agent_context_t ctx,
+	message_limit::wait_indicator_t< M > limit )
+	{
+		ctx.options().message_limits( limit );
+		return ctx;
+	}
+
 inline agent_context_t
 operator+(
 	agent_context_t ctx,
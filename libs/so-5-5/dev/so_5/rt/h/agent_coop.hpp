@@ -16,12 +16,16 @@
 
 #include <so_5/rt/h/nonempty_name.hpp>
 #include <so_5/rt/h/agent.hpp>
+#include <so_5/rt/h/agent_arena.hpp>
 #include <so_5/rt/h/adhoc_agent_wrapper.hpp>
 #include <so_5/rt/h/disp_binder.hpp>
 
+#include <so_5/details/h/rollback_on_exception.hpp>
+
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <vector>
 
 #if defined( SO_5_MSVC )
@@ -555,6 +559,81 @@ class SO_5_TYPE coop_t
 		 * \}
 		 */
 
+		/*!
+		 * \brief Enable parallel definition of agents for large cooperation.
+		 *
+		 * By default so_define_agent() is called for every agent of
+		 * the cooperation sequentially on the thread which registers
+		 * the cooperation. For a cooperation with many thousands of
+		 * agents it can take a significant amount of time. If parallel
+		 * definition is enabled then the agents are split into batches
+		 * and batches are defined on several temporary threads.
+		 * The number of threads is limited by \a max_threads and
+		 * by the count of agents divided by \a min_agents_per_thread.
+		 *
+		 * The all-or-nothing semantics of the registration is preserved:
+		 * if so_define_agent() throws for some agent then all the threads
+		 * are finished, the first exception is rethrown and the
+		 * registration of the whole cooperation fails.
+		 *
+		 * \attention
+		 * so_define_agent() of the agents of that cooperation must be
+		 * thread-safe with respect to each other. Parallel definition
+		 * must not be used with not thread-safe environment
+		 * infrastructures (like simple_not_mtsafe).
+		 *
+		 * \note
+		 * Binding of the agents to dispatchers is still performed
+		 * sequentially because dispatcher binders do not expect to
+		 * be called from different threads at the same time.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		set_parallel_agent_definition(
+			//! Max count of threads to be used for definition (including
+			//! the registering thread). Value 0 or 1 disables
+			//! parallel definition.
+			std::size_t max_threads,
+			//! Min count of agents to be defined by one thread.
+			std::size_t min_agents_per_thread = 1024u );
+
+		/*!
+		 * \brief Allocate agents of that cooperation in an agent_arena.
+		 *
+		 * After a call to that method all agents created by make_agent(),
+		 * make_agent_with_binder() and define_agent() are allocated in
+		 * one monotonic arena instead of a separate dynamic memory block
+		 * for every agent. The whole arena is released in one step when
+		 * the cooperation and all its agents are destroyed.
+		 *
+		 * \note
+		 * Agents created by user via new and passed to add_agent() are
+		 * not affected.
+		 *
+		 * \note
+		 * An agent in the arena is placed with respect to its alignment.
+		 * Class-level operators new/delete of the agent type are not
+		 * used for an agent in the arena.
+		 *
+		 * \par Usage sample:
+		 \code
+		 env.introduce_coop( [&]( so_5::coop_t & coop ) {
+		 	coop.use_agent_arena( 1000 * sizeof(my_agent) );
+		 	for( int i = 0; i != 1000; ++i )
+		 		coop.make_agent< my_agent >();
+		 } );
+		 \endcode
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		use_agent_arena(
+			//! Size of one chunk of the arena.
+			std::size_t chunk_size = agent_arena_t::default_chunk_size );
+
 		/*!
 		 * \since
 		 * v.5.5.8
@@ -618,7 +697,8 @@ class SO_5_TYPE coop_t
 			//! Agent tuning options.
 			agent_context_t ctx )
 			{
-				auto agent = new adhoc_agent_wrapper_t( std::move( ctx ) );
+				auto agent = new_agent_instance< adhoc_agent_wrapper_t >(
+						std::move( ctx ) );
 				this->add_agent( agent );
 
 				return adhoc_agent_definition_proxy_t( agent );
@@ -682,7 +762,8 @@ class SO_5_TYPE coop_t
 			//! A binder to the dispatcher.
 			disp_binder_unique_ptr_t binder )
 			{
-				auto agent = new adhoc_agent_wrapper_t( std::move( ctx ) );
+				auto agent = new_agent_instance< adhoc_agent_wrapper_t >(
+						std::move( ctx ) );
 				this->add_agent( agent, std::move(binder) );
 
 				return adhoc_agent_definition_proxy_t( agent );
@@ -729,7 +810,8 @@ class SO_5_TYPE coop_t
 		make_agent( Args &&... args )
 		{
 			auto a = std::unique_ptr< Agent >(
-					new Agent( environment(), std::forward<Args>(args)... ) );
+					new_agent_instance< Agent >(
+						environment(), std::forward<Args>(args)... ) );
 
 			return this->add_agent( std::move( a ) );
 		}
@@ -771,7 +853,8 @@ class SO_5_TYPE coop_t
 			Args &&... args )
 		{
 			auto a = std::unique_ptr< Agent >(
-					new Agent( environment(), std::forward<Args>(args)... ) );
+					new_agent_instance< Agent >(
+						environment(), std::forward<Args>(args)... ) );
 
 			return this->add_agent( std::move( a ), std::move( binder ) );
 		}
@@ -1061,6 +1144,59 @@ class SO_5_TYPE coop_t
 		 */
 		exception_reaction_t m_exception_reaction;
 
+		/*!
+		 * \brief Max count of threads for definition of agents.
+		 *
+		 * Value 1 means that agents are defined sequentially.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		std::size_t m_max_definition_threads = 1u;
+
+		/*!
+		 * \brief Min count of agents to be defined by one thread.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		std::size_t m_min_agents_per_definition_thread = 1024u;
+
+		/*!
+		 * \brief An arena for agents of the cooperation.
+		 *
+		 * Is null if agents are allocated in the dynamic memory.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		agent_arena_ref_t m_agent_arena;
+
+		/*!
+		 * \brief Create a new agent in the arena or in the dynamic memory.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		template< class Agent, typename... Args >
+		Agent *
+		new_agent_instance( Args &&... args )
+		{
+			if( !m_agent_arena )
+				return new Agent( std::forward<Args>(args)... );
+
+			void * memory = m_agent_arena->allocate_agent(
+					sizeof( Agent ), alignof( Agent ) );
+			Agent * agent = so_5::details::do_with_rollback_on_exception(
+					[&] { return ::new( memory ) Agent( std::forward<Args>(args)... ); },
+					[memory] { agent_arena_t::deallocate_agent( memory ); } );
+
+			// The agent must be destroyed by the arena-aware way.
+			static_cast< agent_t * >( agent )->m_allocated_in_arena = true;
+
+			return agent;
+		}
+
 		//! Add agent to cooperation.
 		/*!
 		 * Cooperation takes care about agent lifetime.
@@ -1129,6 +1265,17 @@ class SO_5_TYPE coop_t
 		void
 		define_all_agents();
 
+		/*!
+		 * \brief Call so_define_agent() for all agents on several threads.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		define_all_agents_in_parallel(
+			//! Count of threads to be used.
+			std::size_t threads );
+
 		//! Bind agents to the dispatcher.
 		void
 		bind_agents_to_disp();
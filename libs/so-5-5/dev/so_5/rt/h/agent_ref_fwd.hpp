@@ -28,6 +28,20 @@ namespace so_5
  */
 using agent_ref_t = intrusive_ptr_t< agent_t >;
 
+/*!
+ * \brief Release of a reference to an agent.
+ *
+ * An agent can be allocated in an agent_arena. Such an agent can't be
+ * deleted by the delete operator, so agent_t::destroy_agent() is used
+ * when the last reference to an agent is gone.
+ *
+ * \since
+ * v.5.5.25
+ */
+template<>
+SO_5_FUNC void
+intrusive_ptr_t< agent_t >::dismiss_object() SO_5_NOEXCEPT;
+
 namespace rt
 {
 
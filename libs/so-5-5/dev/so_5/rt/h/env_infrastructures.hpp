@@ -16,6 +16,9 @@
 
 #include <so_5/rt/h/environment_infrastructure.hpp>
 
+#include <cstdint>
+#include <functional>
+
 namespace so_5 {
 
 namespace env_infrastructures {
@@ -263,6 +266,372 @@ factory()
 
 } /* namespace simple_not_mtsafe */
 
+namespace hybrid_mtsafe {
+
+//
+// params_t
+//
+/*!
+ * \brief Parameters for hybrid thread-safe single-thread environment.
+ *
+ * Usage example:
+ * \code
+   so_5::env_infrastructures::hybrid_mtsafe::params_t params;
+	params.timer_manager( so_5::timer_list_manager_factory() );
+
+	env_params.infrastructure_factory( factory(std::move(params)) );
+ * \endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+class params_t
+	{
+		//! Timer manager factory for environment.
+		/*!
+		 * thread_heap mechanism is used by default.
+		 */
+		timer_manager_factory_t m_timer_factory{ timer_heap_manager_factory() };
+
+	public :
+		//! Setter for timer_manager factory.
+		params_t &
+		timer_manager( timer_manager_factory_t factory ) SO_5_OVERLOAD_FOR_REF
+			{
+				m_timer_factory = std::move(factory);
+				return *this;
+			}
+
+#if !defined( SO_5_NO_SUPPORT_FOR_RVALUE_REFERENCE_OVERLOADING )
+		//! Setter for timer_manager factory.
+		params_t &&
+		timer_manager( timer_manager_factory_t factory ) SO_5_OVERLOAD_FOR_RVALUE_REF
+			{
+				m_timer_factory = std::move(factory);
+				return std::move(*this);
+			}
+#endif
+
+		//! Getter for timer_manager factory.
+		const timer_manager_factory_t &
+		timer_manager() const
+			{
+				return m_timer_factory;
+			}
+	};
+
+// NOTE: implemented in so_5/rt/impl/hybrid_mtsafe_st_env_infrastructure.cpp
+//
+// factory
+//
+/*!
+ * \brief A factory for creation of hybrid thread-safe
+ * single-thread environment infrastructure object.
+ *
+ * This environment infrastructure is intended for applications where
+ * almost all messages are sent from the main thread of the environment,
+ * but some messages can be sent from other threads (for example, from
+ * threads which read data feeds).
+ *
+ * Demands pushed from the main thread go to an unsynchronized local
+ * queue, like in simple_not_mtsafe environment. Demands pushed from
+ * other threads go to a lock-free injection queue and the main thread
+ * is woken up only if it is sleeping. So there is no mutex on the path
+ * of local sends.
+ *
+ * Usage example:
+ * \code
+   so_5::launch(
+			[](so_5::environment_t & env) { ... },
+			[](so_5::environment_params_t & params) {
+				params.infrastructure_factory(
+						factory( so_5::env_infrastructures::hybrid_mtsafe::params_t{}
+								.timer_manager( so_5::timer_list_manager_factory() ) ) );
+				...
+			} );
+ * \endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+SO_5_FUNC environment_infrastructure_factory_t
+factory( params_t && params );
+
+/*!
+ * \brief A factory for creation of hybrid thread-safe
+ * single-thread environment infrastructure object with
+ * default parameters.
+ *
+ * Usage example:
+ * \code
+   so_5::launch(
+			[](so_5::environment_t & env) { ... },
+			[](so_5::environment_params_t & params) {
+				params.infrastructure_factory(
+						so_5::env_infrastructures::hybrid_mtsafe::factory() );
+				...
+			} );
+ * \endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+inline environment_infrastructure_factory_t
+factory()
+	{
+		return factory( params_t() );
+	}
+
+} /* namespace hybrid_mtsafe */
+
+#if defined( __linux__ )
+
+namespace epoll_mtsafe {
+
+//
+// params_t
+//
+/*!
+ * \brief Parameters for epoll-based thread-safe single-thread environment.
+ *
+ * Usage example:
+ * \code
+   so_5::env_infrastructures::epoll_mtsafe::params_t params;
+	params.timer_manager( so_5::timer_list_manager_factory() );
+
+	env_params.infrastructure_factory( factory(std::move(params)) );
+ * \endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+class params_t
+	{
+		//! Timer manager factory for environment.
+		/*!
+		 * thread_heap mechanism is used by default.
+		 */
+		timer_manager_factory_t m_timer_factory{ timer_heap_manager_factory() };
+
+		//! Max count of events to be handled between checks for I/O events.
+		std::size_t m_max_demands_between_io_checks{ 64 };
+
+	public :
+		//! Setter for timer_manager factory.
+		params_t &
+		timer_manager( timer_manager_factory_t factory ) SO_5_OVERLOAD_FOR_REF
+			{
+				m_timer_factory = std::move(factory);
+				return *this;
+			}
+
+#if !defined( SO_5_NO_SUPPORT_FOR_RVALUE_REFERENCE_OVERLOADING )
+		//! Setter for timer_manager factory.
+		params_t &&
+		timer_manager( timer_manager_factory_t factory ) SO_5_OVERLOAD_FOR_RVALUE_REF
+			{
+				m_timer_factory = std::move(factory);
+				return std::move(*this);
+			}
+#endif
+
+		//! Getter for timer_manager factory.
+		const timer_manager_factory_t &
+		timer_manager() const
+			{
+				return m_timer_factory;
+			}
+
+		//! Setter for max count of events between checks for I/O events.
+		/*!
+		 * When there are events in the queue the environment checks
+		 * I/O descriptors after processing of that count of events.
+		 * This prevents starvation of I/O handlers when agents are always
+		 * busy. Value 0 is treated as 1.
+		 */
+		params_t &
+		max_demands_between_io_checks( std::size_t v ) SO_5_OVERLOAD_FOR_REF
+			{
+				m_max_demands_between_io_checks = v;
+				return *this;
+			}
+
+#if !defined( SO_5_NO_SUPPORT_FOR_RVALUE_REFERENCE_OVERLOADING )
+		//! Setter for max count of events between checks for I/O events.
+		params_t &&
+		max_demands_between_io_checks( std::size_t v ) SO_5_OVERLOAD_FOR_RVALUE_REF
+			{
+				m_max_demands_between_io_checks = v;
+				return std::move(*this);
+			}
+#endif
+
+		//! Getter for max count of events between checks for I/O events.
+		std::size_t
+		max_demands_between_io_checks() const
+			{
+				return m_max_demands_between_io_checks;
+			}
+	};
+
+//
+// io_controller_t
+//
+/*!
+ * \brief An interface for registration of I/O descriptors in
+ * epoll-based environment infrastructure.
+ *
+ * Handlers for I/O descriptors are called on the main thread of the
+ * environment, the same thread where agents from the default dispatcher
+ * handle their events. So agents and I/O handlers can share data without
+ * any synchronization.
+ *
+ * Descriptors are registered in level-triggered mode. Flags for
+ * \a events are the same as for epoll_ctl() (EPOLLIN, EPOLLOUT and so on).
+ *
+ * Usage example:
+ * \code
+	auto & io = so_5::env_infrastructures::epoll_mtsafe::io_controller( env );
+	io.add( sock, EPOLLIN, [sock, mbox]( std::uint32_t ) {
+			char buf[ 512 ];
+			const auto n = ::read( sock, buf, sizeof(buf) );
+			if( n > 0 )
+				so_5::send< data_received >( mbox, std::string( buf, n ) );
+		} );
+ * \endcode
+ *
+ * \attention
+ * I/O handlers must not throw exceptions.
+ *
+ * \note
+ * All methods are thread-safe. A handler can remove its own descriptor.
+ *
+ * \since
+ * v.5.5.25
+ */
+class SO_5_TYPE io_controller_t
+	{
+	public :
+		//! Type of handler for I/O events.
+		/*!
+		 * Receives a mask of events from epoll_wait().
+		 */
+		using io_handler_t = std::function< void( std::uint32_t ) >;
+
+		virtual ~io_controller_t() SO_5_NOEXCEPT = default;
+
+		//! Get the epoll descriptor used by the environment.
+		/*!
+		 * Can be used, for example, for embedding to another epoll set.
+		 *
+		 * \attention
+		 * Descriptors must be registered via add(), not by direct
+		 * call to epoll_ctl().
+		 */
+		virtual int
+		epoll_fd() const SO_5_NOEXCEPT = 0;
+
+		//! Register a new descriptor.
+		/*!
+		 * \throw so_5::exception_t if \a fd is already registered or
+		 * epoll_ctl() fails.
+		 */
+		virtual void
+		add(
+			int fd,
+			std::uint32_t events,
+			io_handler_t handler ) = 0;
+
+		//! Change the mask of events for a registered descriptor.
+		virtual void
+		modify(
+			int fd,
+			std::uint32_t events ) = 0;
+
+		//! Remove a registered descriptor.
+		/*!
+		 * The handler for \a fd won't be called after the return
+		 * from this method (except the case when the handler is being
+		 * called right now on the main thread).
+		 *
+		 * Removal of an unknown descriptor is ignored.
+		 */
+		virtual void
+		remove( int fd ) = 0;
+	};
+
+// NOTE: implemented in so_5/rt/impl/epoll_mtsafe_st_env_infrastructure.cpp
+//
+// io_controller
+//
+/*!
+ * \brief Get the I/O controller of the environment.
+ *
+ * \throw so_5::exception_t if \a env doesn't use epoll_mtsafe
+ * environment infrastructure.
+ *
+ * \since
+ * v.5.5.25
+ */
+SO_5_FUNC io_controller_t &
+io_controller( environment_t & env );
+
+// NOTE: implemented in so_5/rt/impl/epoll_mtsafe_st_env_infrastructure.cpp
+//
+// factory
+//
+/*!
+ * \brief A factory for creation of epoll-based thread-safe
+ * single-thread environment infrastructure object.
+ *
+ * This environment infrastructure works like simple_mtsafe one but
+ * waits for new events, timers and I/O readiness by epoll_wait() and
+ * is woken up by eventfd. It allows to handle network I/O and events of
+ * agents on the same thread without handing off I/O events to another
+ * thread.
+ *
+ * Usage example:
+ * \code
+   so_5::launch(
+			[](so_5::environment_t & env) {
+				auto & io = so_5::env_infrastructures::epoll_mtsafe::io_controller( env );
+				...
+			},
+			[](so_5::environment_params_t & params) {
+				params.infrastructure_factory(
+						factory( so_5::env_infrastructures::epoll_mtsafe::params_t{}
+								.timer_manager( so_5::timer_list_manager_factory() ) ) );
+				...
+			} );
+ * \endcode
+ *
+ * \note
+ * Available on Linux only.
+ *
+ * \since
+ * v.5.5.25
+ */
+SO_5_FUNC environment_infrastructure_factory_t
+factory( params_t && params );
+
+/*!
+ * \brief A factory for creation of epoll-based thread-safe
+ * single-thread environment infrastructure object with
+ * default parameters.
+ *
+ * \since
+ * v.5.5.25
+ */
+inline environment_infrastructure_factory_t
+factory()
+	{
+		return factory( params_t() );
+	}
+
+} /* namespace epoll_mtsafe */
+
+#endif /* __linux__ */
+
 } /* namespace env_infrastructures */
 
 } /* namespace so_5 */
@@ -820,6 +820,38 @@ class SO_5_TYPE environment_t
 			//! Mbox name.
 			nonempty_name_t mbox_name );
 
+		//! Create an anonymous load-balancing mbox.
+		/*!
+		 * A load-balancing mbox is a MPMC mbox which delivers every message
+		 * to exactly one subscriber. It can be used for distribution of
+		 * work between a group of identical agents without an
+		 * intermediate collector agent:
+		 * \code
+			auto tasks = env.create_load_balancing_mbox(
+					so_5::load_balancing_policy_t::least_loaded );
+			for( int i = 0; i != performers; ++i )
+				coop.make_agent< performer >( tasks );
+			...
+			so_5::send< task >( tasks, ... );
+		 * \endcode
+		 *
+		 * A service request is also delivered to just one subscriber.
+		 *
+		 * \attention
+		 * Subscribers of a mbox with load_balancing_policy_t::least_loaded
+		 * must have message limits for all message types they subscribe to.
+		 *
+		 * \note
+		 * Always creates a new mbox.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		mbox_t
+		create_load_balancing_mbox(
+			//! Policy for selection of a receiver.
+			load_balancing_policy_t policy = load_balancing_policy_t::round_robin );
+
 		/*!
 		 * \deprecated Will be removed in v.5.6.0. Use create_mbox() instead.
 		 */
@@ -18,6 +18,9 @@
 #include <so_5/rt/h/fwd.hpp>
 
 #include <so_5/rt/h/message.hpp>
+#include <so_5/rt/h/msg_type_id.hpp>
+
+#include <so_5/details/h/small_function.hpp>
 
 namespace so_5
 {
@@ -30,8 +33,15 @@ namespace so_5
  * v.5.3.0
  *
  * \brief Type of event handler method.
+ *
+ * \note
+ * Since v.5.5.25 it is not a std::function but a callable object
+ * with small internal buffer. Handlers made from pointers to agent's
+ * methods are stored inside that buffer and copying of a handler
+ * doesn't allocate memory.
  */
-typedef std::function< void(invocation_type_t, message_ref_t &) >
+typedef so_5::details::small_function_t<
+				void(invocation_type_t, message_ref_t &) >
 		event_handler_method_t;
 
 struct execution_demand_t;
@@ -68,6 +78,15 @@ struct execution_demand_t
 	mbox_id_t m_mbox_id;
 	//! Type of the message.
 	std::type_index m_msg_type;
+	/*!
+	 * \since
+	 * v.5.5.25
+	 *
+	 * \brief Numeric ID of the message type.
+	 *
+	 * It is used for search of event handler instead of \a m_msg_type.
+	 */
+	msg_type_id_t m_msg_type_id;
 	//! Event incident.
 	message_ref_t m_message_ref;
 	//! Demand handler.
@@ -79,6 +98,7 @@ struct execution_demand_t
 		,	m_limit( nullptr )
 		,	m_mbox_id( 0 )
 		,	m_msg_type( typeid(void) )
+		,	m_msg_type_id( null_msg_type_id() )
 		,	m_demand_handler( nullptr )
 		{}
 
@@ -93,10 +113,51 @@ struct execution_demand_t
 		,	m_limit( limit )
 		,	m_mbox_id( mbox_id )
 		,	m_msg_type( msg_type )
+		,	m_msg_type_id( so_5::msg_type_id( msg_type ) )
+		,	m_message_ref( std::move( message_ref ) )
+		,	m_demand_handler( demand_handler )
+		{}
+
+	/*!
+	 * \since
+	 * v.5.5.25
+	 *
+	 * \brief Constructor for the case when ID of the message type is
+	 * already known.
+	 */
+	execution_demand_t(
+		agent_t * receiver,
+		const message_limit::control_block_t * limit,
+		mbox_id_t mbox_id,
+		std::type_index msg_type,
+		msg_type_id_t msg_type_id,
+		message_ref_t message_ref,
+		demand_handler_pfn_t demand_handler )
+		:	m_receiver( receiver )
+		,	m_limit( limit )
+		,	m_mbox_id( mbox_id )
+		,	m_msg_type( msg_type )
+		,	m_msg_type_id( msg_type_id )
 		,	m_message_ref( std::move( message_ref ) )
 		,	m_demand_handler( demand_handler )
 		{}
 
+	/*!
+	 * \since
+	 * v.5.5.25
+	 *
+	 * \brief Get metadata attached to the message.
+	 *
+	 * An empty metadata is returned for signals and for messages
+	 * without metadata. This method doesn't allocate and doesn't
+	 * make any virtual calls.
+	 */
+	message_metadata_t
+	metadata() const SO_5_NOEXCEPT
+		{
+			return message_metadata( m_message_ref );
+		}
+
 	/*!
 	 * \since
 	 * v.5.5.8
@@ -124,7 +185,12 @@ class execution_hint_t
 {
 public :
 	//! Type of function for calling event handler directly.
-	using direct_func_t = std::function<
+	/*!
+	 * \note
+	 * Since v.5.5.25 it is not a std::function. Creation of execution_hint
+	 * doesn't allocate memory if the function object is small.
+	 */
+	using direct_func_t = so_5::details::small_function_t<
 				void( execution_demand_t &, current_thread_id_t ) >;
 
 	//! Initializing constructor.
@@ -27,6 +27,9 @@ class internal_env_iface_t;
 class internal_message_iface_t;
 class layer_core_t;
 class state_switch_guard_t;
+struct state_transition_t;
+class state_transitions_cache_t;
+class suspension_point_t;
 
 } /* namespace impl */
 
@@ -36,6 +39,7 @@ class environment_t;
 class environment_params_t;
 class coop_t;
 class agent_t;
+class agent_arena_t;
 
 class event_queue_t;
 class event_queue_hook_t;
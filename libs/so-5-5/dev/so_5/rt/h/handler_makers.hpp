@@ -270,6 +270,58 @@ set_promise( std::promise< void > & to, L result_provider )
 	to.set_value();
 }
 
+/*!
+ * \brief Default processing of a value returned by an event handler.
+ *
+ * The value is ignored. A special overload for some result type can be
+ * found by argument-dependent lookup (see so_5::coro::task_t for
+ * example).
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename R >
+void
+process_event_handler_result( R && )
+{}
+
+/*!
+ * \brief A helper for calling an event handler for an ordinary message.
+ *
+ * A value returned by the handler is passed to
+ * process_event_handler_result().
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename R >
+struct event_handler_caller_t
+{
+	template< typename L >
+	static void
+	call( L handler )
+	{
+		process_event_handler_result( handler() );
+	}
+};
+
+/*!
+ * \brief A helper for calling an event handler without a result.
+ *
+ * \since
+ * v.5.5.25
+ */
+template<>
+struct event_handler_caller_t< void >
+{
+	template< typename L >
+	static void
+	call( L handler )
+	{
+		handler();
+	}
+};
+
 /*!
  * \brief Helper template for creation of event handler with actual
  * argument.
@@ -308,7 +360,9 @@ make_handler_with_arg( Lambda lambda )
 					}
 				else
 					{
-						lambda( arg_maker::make_arg( message_ref ) );
+						event_handler_caller_t< Result >::call( [&] {
+								return lambda( arg_maker::make_arg( message_ref ) );
+							} );
 					}
 			};
 
@@ -367,7 +421,9 @@ make_handler_with_arg_for_agent(
 					}
 				else
 					{
-						(agent->*pfn)( arg_maker::make_arg( message_ref ) );
+						event_handler_caller_t< result_type >::call( [&] {
+								return (agent->*pfn)( arg_maker::make_arg( message_ref ) );
+							} );
 					}
 			};
 
@@ -409,7 +465,9 @@ make_handler_without_arg( Lambda && lambda )
 					}
 				else
 					{
-						lambda();
+						event_handler_caller_t< Result >::call( [&] {
+								return lambda();
+							} );
 					}
 			};
 
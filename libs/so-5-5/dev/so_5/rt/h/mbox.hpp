@@ -623,6 +623,37 @@ enum class mbox_type_t
 		multi_producer_single_consumer
 	};
 
+//
+// load_balancing_policy_t
+//
+/*!
+ * \brief Policy for selection of a receiver by load-balancing mbox.
+ *
+ * \see environment_t::create_load_balancing_mbox().
+ *
+ * \since
+ * v.5.5.25
+ */
+enum class load_balancing_policy_t
+	{
+		//! Subscribers receive messages in turn.
+		round_robin,
+		//! A message is delivered to the subscriber with the smallest
+		//! count of messages of that type in its event queue.
+		/*!
+		 * The count of messages in event queue is known only for
+		 * subscribers with message limits. Because of that every
+		 * subscriber must have a message limit for the message type.
+		 * An attempt to subscribe without a message limit leads to
+		 * an exception with rc_message_limit_required_for_least_loaded
+		 * error code.
+		 *
+		 * If there are several subscribers with the same load they
+		 * are selected in turn.
+		 */
+		least_loaded
+	};
+
 //
 // abstract_message_box_t
 //
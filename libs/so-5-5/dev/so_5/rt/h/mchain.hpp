@@ -647,6 +647,14 @@ class mchain_params_t
 		//! Is message delivery tracing disabled explicitly?
 		bool m_msg_tracing_disabled = { false };
 
+		/*!
+		 * \brief Is conflation of messages enabled?
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		bool m_conflation_enabled = { false };
+
 	public :
 		//! Initializing constructor.
 		mchain_params_t(
@@ -709,6 +717,53 @@ class mchain_params_t
 			{
 				return m_msg_tracing_disabled;
 			}
+
+		//! Enable conflation of messages.
+		/*!
+		 * If conflation is enabled then a message with a conflation key
+		 * (see message_metadata_t::conflation_key()) doesn't go to the end
+		 * of the chain if there is a still pending message of the same
+		 * type with the same key. The new message replaces the pending one
+		 * and keeps its position in the chain. So the chain holds no more
+		 * than one message for every key and only the latest value is
+		 * extracted by a consumer.
+		 *
+		 * Messages without a conflation key and service requests are
+		 * stored as usual.
+		 *
+		 * Count of replaced messages is available via run-time
+		 * monitoring (see so_5::stats::suffixes::conflated_message_count()).
+		 *
+		 * \par Usage example:
+			\code
+			auto prices = env.create_mchain(
+					so_5::make_unlimited_mchain_params().enable_conflation() );
+			...
+			so_5::send_with_metadata< price_update >( prices,
+					so_5::message_metadata_t{}.conflation_key( instrument_id ),
+					instrument_id, bid, ask );
+			\endcode
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		mchain_params_t &
+		enable_conflation()
+			{
+				m_conflation_enabled = true;
+				return *this;
+			}
+
+		//! Is conflation of messages enabled?
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		bool
+		conflation_enabled() const
+			{
+				return m_conflation_enabled;
+			}
 	};
 
 /*!
@@ -15,12 +15,15 @@
 #include <so_5/h/types.hpp>
 
 #include <so_5/rt/h/agent_ref_fwd.hpp>
+#include <so_5/rt/h/msg_type_id.hpp>
+#include <so_5/rt/h/message_metadata.hpp>
 
 #include <type_traits>
 #include <typeindex>
 #include <functional>
 #include <future>
 #include <atomic>
+#include <memory>
 
 namespace so_5
 {
@@ -42,6 +45,11 @@ namespace so_5
  * But atomic_refcounted_t is not Copyable or Movable class.
  * It means that copy/move constructors and operators for message_t
  * have no influence on the reference counter inside message_t.
+ *
+ * \note
+ * Since v.5.5.25 copy/move constructors and operators for message_t
+ * don't copy message metadata. A new message object always has
+ * empty metadata.
  */
 class SO_5_TYPE message_t : public atomic_refcounted_t
 	{
@@ -180,6 +188,64 @@ class SO_5_TYPE message_t : public atomic_refcounted_t
 				return what.so5_message_kind();
 			}
 
+		/*!
+		 * \brief Helper method for safe get of message metadata.
+		 *
+		 * Returns an empty metadata if \a what is nullptr (it is
+		 * a signal).
+		 *
+		 * \note
+		 * Metadata of an envelope is returned if \a what is an envelope.
+		 * Metadata of the payload inside an envelope is not examined.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		friend message_metadata_t
+		message_metadata( const intrusive_ptr_t< message_t > & what ) SO_5_NOEXCEPT
+			{
+				message_metadata_t r;
+				if( what )
+					r = what->so5_message_metadata();
+				return r;
+			}
+
+		/*!
+		 * \brief Helper method for get message metadata.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		friend message_metadata_t
+		message_metadata( const message_t & what ) SO_5_NOEXCEPT
+			{
+				return what.so5_message_metadata();
+			}
+
+		/*!
+		 * \brief Helper method for set message metadata.
+		 *
+		 * \attention
+		 * Metadata should be set before the message is sent.
+		 * There is no any protection from data races if metadata
+		 * is changed for a message which is already delivered to
+		 * receivers.
+		 *
+		 * \throw std::bad_alloc if there is no memory for metadata block.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		friend void
+		set_message_metadata(
+			//! Message instance to be modified.
+			message_t & what,
+			//! New metadata for the message.
+			const message_metadata_t & metadata )
+			{
+				what.so5_set_message_metadata( metadata );
+			}
+
 	private :
 		/*!
 		 * \brief Is message mutable or immutable?
@@ -190,6 +256,47 @@ class SO_5_TYPE message_t : public atomic_refcounted_t
 		 */
 		message_mutability_t m_mutability;
 
+		/*!
+		 * \brief Message metadata.
+		 *
+		 * Is allocated only for messages with non-empty metadata.
+		 * Value nullptr means that metadata is empty.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		std::unique_ptr< message_metadata_t > m_metadata;
+
+		//! Get the message metadata.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		message_metadata_t
+		so5_message_metadata() const SO_5_NOEXCEPT
+			{
+				if( m_metadata )
+					return *m_metadata;
+				return message_metadata_t{};
+			}
+
+		//! Change the message metadata.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		so5_set_message_metadata(
+			const message_metadata_t & metadata )
+			{
+				if( metadata.empty() )
+					m_metadata.reset();
+				else if( m_metadata )
+					*m_metadata = metadata;
+				else
+					m_metadata.reset( new message_metadata_t{ metadata } );
+			}
+
 		/*!
 		 * \since
 		 * v.5.5.9
@@ -289,6 +396,22 @@ class SO_5_TYPE message_t : public atomic_refcounted_t
  */
 typedef intrusive_ptr_t< message_t > message_ref_t;
 
+/*
+ * Namespace-level declarations of message metadata helpers.
+ * They make so_5::message_metadata() and so_5::set_message_metadata()
+ * accessible by qualified names.
+ */
+message_metadata_t
+message_metadata( const message_ref_t & what ) SO_5_NOEXCEPT;
+
+message_metadata_t
+message_metadata( const message_t & what ) SO_5_NOEXCEPT;
+
+void
+set_message_metadata(
+	message_t & what,
+	const message_metadata_t & metadata );
+
 //
 // signal_t
 //
@@ -693,6 +816,20 @@ struct message_payload_type_impl
 				return typeid(subscription_type);
 			}
 
+		//! Numeric type ID for subscription.
+		/*!
+		 * The value is obtained only once and then cached.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		inline static msg_type_id_t subscription_type_id()
+			{
+				static const msg_type_id_t id =
+						msg_type_id( subscription_type_index() );
+				return id;
+			}
+
 		//! Helper for extraction of pointer to payload part.
 		/*!
 		 * \note This method return non-const pointer because it is
@@ -764,6 +901,20 @@ struct message_payload_type_impl< T, false >
 				return typeid(subscription_type);
 			}
 
+		//! Numeric type ID for subscription.
+		/*!
+		 * The value is obtained only once and then cached.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		inline static msg_type_id_t subscription_type_id()
+			{
+				static const msg_type_id_t id =
+						msg_type_id( subscription_type_index() );
+				return id;
+			}
+
 		//! Helper for extraction of pointer to payload part.
 		/*!
 		 * \note This method return const pointer because payload is
@@ -1122,6 +1273,20 @@ namespace impl
 
 class action_msg_tracer_t;
 
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Wake up senders which wait for free space in the receiver's
+ * queue.
+ *
+ * \note Is called only if there are waiting senders and the count of
+ * messages became less than the wakeup threshold.
+ */
+SO_5_FUNC
+void
+notify_waiting_senders( const control_block_t & limit ) SO_5_NOEXCEPT;
+
 } /* namespace impl */
 
 /*!
@@ -1213,14 +1378,66 @@ using action_t = std::function< void(const overlimit_context_t&) >;
  */
 struct control_block_t
 	{
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief Assumed size of CPU cache line.
+		 *
+		 * Used for separation of m_count from other data.
+		 */
+		static const std::size_t cache_line_size = 64;
+
 		//! Limit value.
 		unsigned int m_limit;
 
+		//! Limit overflow reaction.
+		action_t m_action;
+
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief Padding between read-only data and m_count.
+		 *
+		 * The counter is modified on every message delivery and
+		 * extraction. It must not share a cache line with data which is
+		 * read by producers (including counters and type info for
+		 * limits of other message types).
+		 */
+		char m_leading_padding[ cache_line_size ];
+
 		//! The current count of the messages of that type.
 		mutable std::atomic_uint m_count;
 
-		//! Limit overflow reaction.
-		action_t m_action;
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief The count of senders which wait for free space.
+		 *
+		 * Is used by limit_then_wait reaction. It is placed near m_count
+		 * because it is checked on every decrement of m_count.
+		 */
+		mutable std::atomic_uint m_waiting_senders;
+
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief Waiting senders are woken up when m_count becomes
+		 * less than this value.
+		 */
+		mutable std::atomic_uint m_wakeup_threshold;
+
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief Padding between m_count and the next data in memory.
+		 */
+		char m_trailing_padding[
+				cache_line_size - 3 * sizeof(std::atomic_uint) ];
 
 		//! Initializing constructor.
 		control_block_t(
@@ -1230,6 +1447,8 @@ struct control_block_t
 			,	m_action( std::move( action ) )
 			{
 				m_count = 0;
+				m_waiting_senders = 0;
+				m_wakeup_threshold = 0;
 			}
 
 		//! Copy constructor.
@@ -1241,6 +1460,8 @@ struct control_block_t
 				m_count.store(
 						o.m_count.load( std::memory_order_acquire ),
 						std::memory_order_release );
+				m_waiting_senders = 0;
+				m_wakeup_threshold = 0;
 			}
 
 		//! Copy operator.
@@ -1262,11 +1483,22 @@ struct control_block_t
 
 		//! A safe decrement of message count with respect to absence of limit
 		//! for a message.
+		/*!
+		 * \note Since v.5.5.25 senders which wait for free space
+		 * (see limit_then_wait) are woken up when the count becomes
+		 * less than the wakeup threshold.
+		 */
 		inline static void
 		decrement( const control_block_t * limit )
 			{
 				if( limit )
-					--(limit->m_count);
+					{
+						const auto count = --(limit->m_count);
+						if( limit->m_waiting_senders.load() &&
+								count < limit->m_wakeup_threshold.load(
+										std::memory_order_relaxed ) )
+							impl::notify_waiting_senders( *limit );
+					}
 			}
 	};
 
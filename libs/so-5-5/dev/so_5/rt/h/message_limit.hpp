@@ -26,6 +26,7 @@
 #include <typeindex>
 #include <atomic>
 #include <vector>
+#include <chrono>
 
 namespace so_5
 {
@@ -311,6 +312,93 @@ accept_one_indicator(
 namespace impl
 {
 
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Actual implementation of wait for free space reaction.
+ *
+ * \throw so_5::exception_t with rc_message_limit_wait_on_receiver_thread
+ * if the current thread handles an event of some agent.
+ */
+SO_5_FUNC
+void
+wait_reaction(
+	//! Context on which overlimit must be handled.
+	const overlimit_context_t & ctx,
+	//! Sender will be woken up when the count of messages becomes
+	//! less than that value.
+	unsigned int low_water_mark,
+	//! Max time for waiting.
+	std::chrono::steady_clock::duration timeout );
+
+} /* namespace impl */
+
+//
+// wait_indicator_t
+//
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Message limit with reaction 'wait for free space'.
+ */
+template< class M >
+struct wait_indicator_t
+	{
+		//! Max count of waiting messages.
+		const unsigned int m_limit;
+
+		//! Sender is woken up when the count of waiting messages becomes
+		//! less than that value.
+		const unsigned int m_low_water_mark;
+
+		//! Max time for waiting.
+		const std::chrono::steady_clock::duration m_timeout;
+
+		//! Initializing constructor.
+		/*!
+		 * \note Value of \a low_water_mark is trimmed to [1, limit].
+		 */
+		wait_indicator_t(
+			unsigned int limit,
+			unsigned int low_water_mark,
+			std::chrono::steady_clock::duration timeout )
+			:	m_limit( limit )
+			,	m_low_water_mark( low_water_mark > limit ? limit :
+					( low_water_mark ? low_water_mark : 1u ) )
+			,	m_timeout( timeout )
+			{}
+	};
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Helper function for accepting wait_indicator and storing
+ * the corresponding description into the limits container.
+ */
+template< class M >
+void
+accept_one_indicator(
+	//! Container for storing new description to.
+	description_container_t & to,
+	//! An instance of wait_indicator to store.
+	const wait_indicator_t< M > & indicator )
+	{
+		const auto low_water_mark = indicator.m_low_water_mark;
+		const auto timeout = indicator.m_timeout;
+
+		to.emplace_back( message_payload_type< M >::subscription_type_index(),
+				indicator.m_limit,
+				[low_water_mark, timeout]( const overlimit_context_t & ctx ) {
+					impl::wait_reaction( ctx, low_water_mark, timeout );
+				} );
+	}
+
+namespace impl
+{
+
 /*!
  * \since
  * v.5.5.4
@@ -682,6 +770,78 @@ struct message_limit_methods_mixin_t
 						limit, std::move(lambda) };
 			}
 
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief A helper function for creating wait_indicator.
+		 *
+		 * A sender of a message is blocked if there is no free space
+		 * for the message in the receiver's queue. The sender is woken up
+		 * when the count of waiting messages becomes less than
+		 * \a low_water_mark. If there is no free space after \a timeout
+		 * the message is dropped.
+		 *
+		 * \attention The waiting is refused (an exception is thrown) if
+		 * the sender is an event handler of any agent. Several agents
+		 * can share one working thread even if they have different event
+		 * queues. It means that limit_then_wait is intended for senders
+		 * from non-agent threads only.
+		 *
+		 * \note The waiting is performed after the delivery procedure of
+		 * the mbox releases the mbox's lock. Because of that changes of
+		 * subscriptions to that mbox are not blocked by the waiting sender.
+		 * But the send operation doesn't return until the waiting completes.
+		 *
+		 * \attention The timer thread is never blocked. A delayed or
+		 * periodic message is dropped if there is no free space
+		 * in the receiver's queue at the moment of delivery.
+		 *
+		 * \par Usage example:
+		 * \code
+			class a_writer_t : public so_5::agent_t
+			{
+			public :
+				a_writer_t( context_t ctx )
+					:	so_5::agent_t( ctx
+							// An ingest thread will wait if there are 100
+							// pending chunks. It will be woken up when
+							// there will be less than 50 chunks.
+							+ limit_then_wait< data_chunk >(
+									100, 50, std::chrono::seconds(5) ) )
+					{...}
+				...
+			};
+		 * \endcode
+		 */
+		template< typename Msg >
+		static wait_indicator_t< Msg >
+		limit_then_wait(
+			unsigned int limit,
+			unsigned int low_water_mark,
+			std::chrono::steady_clock::duration timeout )
+			{
+				return wait_indicator_t< Msg >( limit, low_water_mark, timeout );
+			}
+
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief A helper function for creating wait_indicator.
+		 *
+		 * A sender is woken up as soon as there is a free space in the
+		 * receiver's queue.
+		 */
+		template< typename Msg >
+		static wait_indicator_t< Msg >
+		limit_then_wait(
+			unsigned int limit,
+			std::chrono::steady_clock::duration timeout )
+			{
+				return wait_indicator_t< Msg >( limit, limit, timeout );
+			}
+
 		/*!
 		 * \since
 		 * v.5.5.4
@@ -0,0 +1,204 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \since
+ * v.5.5.25
+ *
+ * \brief Small fixed-size metadata which can be attached to a message.
+ */
+
+#pragma once
+
+#include <so_5/h/priority.hpp>
+#include <so_5/h/optional.hpp>
+#include <so_5/h/compiler_features.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+namespace so_5
+{
+
+//
+// message_metadata_t
+//
+/*!
+ * \brief A set of small values which can be attached to a message
+ * without creation of an envelope.
+ *
+ * Before v.5.5.25 the only way to attach some additional information
+ * (like a deadline or a trace ID) to an existing message was an envelope.
+ * But every envelope is a separate object in dynamic memory and every
+ * access to the payload is a virtual call to envelope_t::access_hook().
+ * It could be too expensive if two or three envelopes are nested just
+ * to carry a couple of numbers.
+ *
+ * Since v.5.5.25 a message can carry a deadline, a trace ID, a priority
+ * and a conflation key attached to the message_t object itself.
+ * These values are described by message_metadata_t and can be read
+ * from a message reference by so_5::message_metadata() or by
+ * execution_demand_t::metadata().
+ *
+ * All values (including the conflation key) are stored in one small
+ * block which is allocated only if a message has non-empty metadata.
+ * A message without metadata pays only for one pointer.
+ *
+ * Every value is optional. An empty message_metadata_t is used for signals
+ * and for messages without metadata.
+ *
+ * \note
+ * Envelopes are still supported and should be used if something more
+ * complex than a set of fixed values is necessary.
+ *
+ * Usage example:
+ * \code
+	so_5::send_with_metadata< request >( processor,
+		so_5::message_metadata_t{}
+			.deadline( std::chrono::steady_clock::now() + 250ms )
+			.trace_id( current_trace_id ),
+		... );
+	...
+	void on_request( mhood_t< request > cmd ) {
+		const auto md = so_5::message_metadata( *cmd );
+		if( md.query_trace_id() )
+			...
+	}
+ * \endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+class message_metadata_t
+	{
+	public :
+		//! Type of clock for deadlines.
+		using clock_type = std::chrono::steady_clock;
+		//! Type of time point for deadlines.
+		using time_point_type = clock_type::time_point;
+
+		//! Bit flags for presence of values.
+		enum flags_t : std::uint8_t
+			{
+				has_deadline = 1u,
+				has_trace_id = 2u,
+				has_priority = 4u,
+				has_conflation_key = 8u
+			};
+
+		//! Default constructor creates an empty metadata.
+		message_metadata_t() SO_5_NOEXCEPT
+			:	m_deadline{}
+			,	m_trace_id{ 0u }
+			,	m_conflation_key{ 0u }
+			,	m_priority{ priority_t::p_min }
+			,	m_flags{ 0u }
+			{}
+
+		//! Set a deadline for the message.
+		message_metadata_t &
+		deadline( time_point_type v ) SO_5_NOEXCEPT
+			{
+				m_deadline = v;
+				m_flags = static_cast< std::uint8_t >( m_flags | has_deadline );
+				return *this;
+			}
+
+		//! Set a trace ID for the message.
+		message_metadata_t &
+		trace_id( std::uint64_t v ) SO_5_NOEXCEPT
+			{
+				m_trace_id = v;
+				m_flags = static_cast< std::uint8_t >( m_flags | has_trace_id );
+				return *this;
+			}
+
+		//! Set a priority for the message.
+		/*!
+		 * \note
+		 * This value is not used by SObjectizer's dispatchers.
+		 * It is just carried with the message and can be used by
+		 * custom event queues or by event handlers.
+		 */
+		message_metadata_t &
+		priority( priority_t v ) SO_5_NOEXCEPT
+			{
+				m_priority = v;
+				m_flags = static_cast< std::uint8_t >( m_flags | has_priority );
+				return *this;
+			}
+
+		//! Set a conflation key for the message.
+		/*!
+		 * A message with a conflation key replaces a still pending
+		 * message of the same type with the same key in a message chain
+		 * with conflation enabled (see mchain_params_t::enable_conflation()).
+		 */
+		message_metadata_t &
+		conflation_key( std::uint64_t v ) SO_5_NOEXCEPT
+			{
+				m_conflation_key = v;
+				m_flags = static_cast< std::uint8_t >(
+						m_flags | has_conflation_key );
+				return *this;
+			}
+
+		//! Get the deadline if it is set.
+		optional< time_point_type >
+		query_deadline() const SO_5_NOEXCEPT
+			{
+				if( m_flags & has_deadline )
+					return m_deadline;
+				return nonstd::nullopt;
+			}
+
+		//! Get the trace ID if it is set.
+		optional< std::uint64_t >
+		query_trace_id() const SO_5_NOEXCEPT
+			{
+				if( m_flags & has_trace_id )
+					return m_trace_id;
+				return nonstd::nullopt;
+			}
+
+		//! Get the priority if it is set.
+		optional< priority_t >
+		query_priority() const SO_5_NOEXCEPT
+			{
+				if( m_flags & has_priority )
+					return m_priority;
+				return nonstd::nullopt;
+			}
+
+		//! Get the conflation key if it is set.
+		optional< std::uint64_t >
+		query_conflation_key() const SO_5_NOEXCEPT
+			{
+				if( m_flags & has_conflation_key )
+					return m_conflation_key;
+				return nonstd::nullopt;
+			}
+
+		//! Is there any value inside?
+		bool
+		empty() const SO_5_NOEXCEPT { return 0u == m_flags; }
+
+		//! Is the deadline set and already passed?
+		bool
+		is_expired( time_point_type now ) const SO_5_NOEXCEPT
+			{
+				return ( m_flags & has_deadline ) && m_deadline <= now;
+			}
+
+	private :
+		time_point_type m_deadline;
+		std::uint64_t m_trace_id;
+		std::uint64_t m_conflation_key;
+		priority_t m_priority;
+		std::uint8_t m_flags;
+	};
+
+} /* namespace so_5 */
+
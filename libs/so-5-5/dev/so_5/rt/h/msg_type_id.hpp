@@ -0,0 +1,59 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Process-wide numeric identifiers for message types.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/h/declspec.hpp>
+#include <so_5/h/types.hpp>
+#include <so_5/h/compiler_features.hpp>
+
+#include <typeindex>
+
+namespace so_5
+{
+
+/*!
+ * \brief Get the numeric identifier for a message type.
+ *
+ * Every message type receives a dense numeric identifier at the first
+ * call to this function for that type. The identifier remains the same
+ * till the end of the process.
+ *
+ * Identifiers are cheaper for comparison and hashing than std::type_index
+ * values: on some platforms std::type_index comparison and hashing
+ * requires processing of the whole type name (especially when
+ * type_info objects for the same type are created in different shared
+ * libraries).
+ *
+ * \note
+ * Search for an already known type doesn't acquire any locks.
+ *
+ * \since
+ * v.5.5.25
+ */
+SO_5_FUNC msg_type_id_t
+msg_type_id( const std::type_index & msg_type );
+
+/*!
+ * \brief Get the message type for a numeric identifier.
+ *
+ * Intended to be used for diagnostic purposes only.
+ *
+ * \throw so_5::exception_t if \a id is unknown.
+ *
+ * \since
+ * v.5.5.25
+ */
+SO_5_FUNC std::type_index
+msg_type_by_id( msg_type_id_t id );
+
+} /* namespace so_5 */
@@ -42,6 +42,23 @@ namespace impl
 						message_payload_type< Message >::mutability() );
 				}
 
+			template< typename... Args >
+			static void
+			send_with_metadata(
+				const so_5::mbox_t & to,
+				const message_metadata_t & metadata,
+				Args &&... args )
+				{
+					auto msg = so_5::details::make_message_instance< Message >(
+							std::forward< Args >( args )...);
+					so_5::set_message_metadata( *msg, metadata );
+
+					to->deliver_message(
+						message_payload_type< Message >::subscription_type_index(),
+						std::move( msg ),
+						message_payload_type< Message >::mutability() );
+				}
+
 			template< typename... Args >
 			static void
 			send_delayed(
@@ -238,6 +255,119 @@ send( Target && to, Args&&... args )
 				std::forward<Args>(args)... );
 	}
 
+/*!
+ * \brief A utility function for creating and delivering a message
+ * with metadata.
+ *
+ * The metadata (deadline, trace ID, priority) is attached to the
+ * message object itself. No envelopes are created and the
+ * metadata can be read by so_5::message_metadata() or by
+ * execution_demand_t::metadata().
+ *
+ * \note
+ * Metadata can't be attached to a signal because there is no
+ * message object for a signal.
+ *
+ * \tparam Message type of message to be sent.
+ * \tparam Target identification of request processor. The same as for
+ * so_5::send().
+ * \tparam Args arguments for Message's constructor.
+ *
+ * Usage example:
+ * \code
+	so_5::send_with_metadata< request >( processor,
+		so_5::message_metadata_t{}.trace_id( 42u ).priority( so_5::prio::p5 ),
+		"Hello", "World!" );
+ * \endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename Message, typename Target, typename... Args >
+void
+send_with_metadata(
+	Target && to,
+	const message_metadata_t & metadata,
+	Args&&... args )
+	{
+		static_assert( !is_signal<
+						typename message_payload_type< Message >::payload_type >::value,
+				"metadata can't be attached to a signal" );
+
+		so_5::impl::instantiator_and_sender< Message >::send_with_metadata(
+				send_functions_details::arg_to_mbox( std::forward<Target>(to) ),
+				metadata,
+				std::forward<Args>(args)... );
+	}
+
+/*!
+ * \brief A utility function for creating and delivering a message
+ * with a deadline.
+ *
+ * The deadline is stored as inline message metadata (see
+ * so_5::send_with_metadata()). If the deadline passes before an
+ * event handler for the message is called then the message is dropped
+ * by the receiver's working thread. Count of dropped messages is
+ * available via run-time monitoring (see
+ * so_5::stats::suffixes::expired_message_count()) and each drop is
+ * reflected in msg_tracing.
+ *
+ * \note
+ * A deadline can't be set for a signal.
+ *
+ * Usage example:
+ * \code
+	so_5::send_with_deadline< request >( processor,
+		std::chrono::steady_clock::now() + std::chrono::milliseconds(250),
+		... );
+ * \endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename Message, typename Target, typename... Args >
+void
+send_with_deadline(
+	Target && to,
+	std::chrono::steady_clock::time_point deadline,
+	Args&&... args )
+	{
+		send_with_metadata< Message >(
+				std::forward<Target>(to),
+				message_metadata_t{}.deadline( deadline ),
+				std::forward<Args>(args)... );
+	}
+
+/*!
+ * \brief A utility function for creating and delivering a message
+ * with a time-to-live.
+ *
+ * The same as so_5::send_with_deadline() but the deadline is calculated
+ * as the current time plus \a ttl.
+ *
+ * Usage example:
+ * \code
+	so_5::send_with_deadline< request >( processor,
+		std::chrono::milliseconds(250),
+		... );
+ * \endcode
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename Message, typename Target, typename... Args >
+void
+send_with_deadline(
+	Target && to,
+	std::chrono::steady_clock::duration ttl,
+	Args&&... args )
+	{
+		send_with_deadline< Message >(
+				std::forward<Target>(to),
+				std::chrono::steady_clock::now() + ttl,
+				std::forward<Args>(args)... );
+	}
+
 /*!
  * \brief A version of %send function for redirection of a message
  * from exising message hood.
@@ -24,6 +24,8 @@
 
 #include <so_5/rt/h/message_handler_format_detector.hpp>
 
+#include <so_5/details/h/small_function.hpp>
+
 namespace so_5
 {
 
@@ -149,6 +151,7 @@ class SO_5_TYPE state_t final
 		struct time_limit_t;
 
 		friend class agent_t;
+		friend struct impl::state_transition_t;
 
 #if defined( SO_5_NEED_GNU_4_8_WORKAROUNDS )
 // GCC 4.8.2 reports strange error about usage of deleted copy constructor.
@@ -204,8 +207,13 @@ class SO_5_TYPE state_t final
 		 * \brief Type of function to be called on enter to the state.
 		 *
 		 * \attention Handler must be noexcept function.
+		 *
+		 * \note Since v.5.5.25 it is small_function_t instead of
+		 * std::function. Handlers made from agent's methods and lambdas
+		 * with a couple of captured pointers are stored without
+		 * dynamic memory allocation.
 		 */
-		using on_enter_handler_t = std::function< void() >;
+		using on_enter_handler_t = so_5::details::small_function_t< void() >;
 
 		/*!
 		 * \since
@@ -214,8 +222,11 @@ class SO_5_TYPE state_t final
 		 * \brief Type of function to be called on exit from the state.
 		 *
 		 * \attention Handler must be noexcept function.
+		 *
+		 * \note Since v.5.5.25 it is small_function_t instead of
+		 * std::function.
 		 */
-		using on_exit_handler_t = std::function< void() >;
+		using on_exit_handler_t = so_5::details::small_function_t< void() >;
 
 		/*!
 		 * \since
@@ -1300,7 +1311,7 @@ class SO_5_TYPE state_t final
 		state_t &
 		on_enter( on_enter_handler_t handler )
 			{
-				m_on_enter = std::move(handler);
+				enter_exit_handlers().m_on_enter = std::move(handler);
 				return *this;
 			}
 
@@ -1390,10 +1401,7 @@ class SO_5_TYPE state_t final
 		 * \endcode
 		 */
 		const on_enter_handler_t &
-		on_enter() const
-			{
-				return m_on_enter;
-			}
+		on_enter() const;
 
 		/*!
 		 * \since
@@ -1427,7 +1435,7 @@ class SO_5_TYPE state_t final
 		state_t &
 		on_exit( on_exit_handler_t handler )
 			{
-				m_on_exit = std::move(handler);
+				enter_exit_handlers().m_on_exit = std::move(handler);
 				return *this;
 			}
 
@@ -1515,10 +1523,7 @@ class SO_5_TYPE state_t final
 		 * \endcode
 		 */
 		const on_exit_handler_t &
-		on_exit() const
-			{
-				return m_on_exit;
-			}
+		on_exit() const;
 		/*!
 		 * \}
 		 */
@@ -1785,20 +1790,32 @@ class SO_5_TYPE state_t final
 		size_t m_substate_count;
 
 		/*!
-		 * \since
-		 * v.5.5.15
+		 * \brief Handlers for the enter to and exit from the state.
 		 *
-		 * \brief Handler for the enter to the state.
+		 * Most of states have no such handlers. Because of that
+		 * the handlers are stored in a separate object which is created
+		 * only when a handler is set.
+		 *
+		 * \since
+		 * v.5.5.25
 		 */
-		on_enter_handler_t m_on_enter;
+		struct enter_exit_handlers_t
+			{
+				//! Handler for the enter to the state.
+				on_enter_handler_t m_on_enter;
+				//! Handler for the exit from the state.
+				on_exit_handler_t m_on_exit;
+			};
 
 		/*!
-		 * \since
-		 * v.5.5.15
+		 * \brief Handlers for the enter to and exit from the state.
 		 *
-		 * \brief Handler for the exit from the state.
+		 * \note Value nullptr means that there are no handlers.
+		 *
+		 * \since
+		 * v.5.5.25
 		 */
-		on_exit_handler_t m_on_exit;
+		std::unique_ptr< enter_exit_handlers_t > m_enter_exit_handlers;
 
 		/*!
 		 * \since
@@ -1918,14 +1935,13 @@ class SO_5_TYPE state_t final
 		handle_time_limit_on_enter() const;
 
 		/*!
-		 * \since
-		 * v.5.5.15
+		 * \brief Get handlers object. Creates it if it isn't created yet.
 		 *
-		 * \brief A special handler of time limit to be used on exiting from state.
-		 * \attention This method must be called only if m_time_limit is not null.
+		 * \since
+		 * v.5.5.25
 		 */
-		void
-		handle_time_limit_on_exit() const;
+		enter_exit_handlers_t &
+		enter_exit_handlers();
 
 		/*!
 		 * \since
@@ -1936,7 +1952,8 @@ class SO_5_TYPE state_t final
 		void
 		call_on_enter() const
 			{
-				if( m_on_enter ) m_on_enter();
+				if( m_enter_exit_handlers && m_enter_exit_handlers->m_on_enter )
+					m_enter_exit_handlers->m_on_enter();
 				if( m_time_limit ) handle_time_limit_on_enter();
 			}
 
@@ -1945,12 +1962,15 @@ class SO_5_TYPE state_t final
 		 * v.5.5.15
 		 *
 		 * \brief Call for on exit handler if defined.
+		 *
+		 * \note Since v.5.5.25 time limit isn't handled on exit.
+		 * A timer for time limit is checked lazily when it fires.
 		 */
 		void
 		call_on_exit() const
 			{
-				if( m_time_limit ) handle_time_limit_on_exit();
-				if( m_on_exit ) m_on_exit();
+				if( m_enter_exit_handlers && m_enter_exit_handlers->m_on_exit )
+					m_enter_exit_handlers->m_on_exit();
 			}
 		/*!
 		 * \}
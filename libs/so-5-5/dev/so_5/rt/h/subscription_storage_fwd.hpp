@@ -82,6 +82,29 @@ default_subscription_storage_factory();
 SO_5_FUNC subscription_storage_factory_t
 hash_table_based_subscription_storage_factory();
 
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Factory for subscription storage based on a flat
+ * open-addressing hash table.
+ *
+ * \note This storage keeps all subscriptions in one hash table with
+ * inline keys. Message types are represented in keys by numeric IDs
+ * assigned at the subscription time, so there is no hashing of
+ * std::type_index during event handler lookup. It is intended for agents
+ * with large amount of subscriptions (from hundreds to thousands) and
+ * requires less memory per subscription than
+ * hash_table_based_subscription_storage_factory().
+ *
+ * \par More about subscription storage tuning
+ * See \ref so_5_5_3__subscr_storage_selection for more details about selection
+ * of appropriate subscription storage type.
+ *
+ */
+SO_5_FUNC subscription_storage_factory_t
+flat_hash_subscription_storage_factory();
+
 /*!
  * \since
  * v.5.5.3
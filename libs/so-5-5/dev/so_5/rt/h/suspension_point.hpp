@@ -0,0 +1,166 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief A point at which an activity of an agent is suspended.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/h/compiler_features.hpp>
+
+#include <so_5/rt/h/agent.hpp>
+
+#include <atomic>
+
+namespace so_5
+{
+
+namespace impl
+{
+
+//
+// suspension_point_t
+//
+/*!
+ * \brief A point at which an activity of an agent is suspended.
+ *
+ * An activity (C++20 coroutine, for example) is suspended until some
+ * event happens. Such an event can be detected on any thread and is
+ * reported via trigger(). The activity is resumed later as an ordinary
+ * demand on the agent's event queue. Because of that the resumed
+ * activity is executed with the same guarantees as an ordinary
+ * not-thread-safe event handler.
+ *
+ * A point must be armed on the agent's working context. All armed points
+ * are canceled at the end of the agent's work, so the suspended
+ * activities are never resumed after so_evt_finish().
+ *
+ * \note Only the first call to trigger() has an effect. A new point
+ * should be created for every suspension.
+ *
+ * \since
+ * v.5.5.25
+ */
+class suspension_point_t : public message_t
+	{
+		friend class so_5::agent_t;
+
+	public :
+		//! Initializing constructor.
+		explicit suspension_point_t(
+			//! Agent whose activity is suspended.
+			agent_t & owner )
+			:	m_owner( &owner )
+			{}
+
+		//! Agent whose activity is suspended.
+		agent_t &
+		owner() const SO_5_NOEXCEPT
+			{
+				return *m_owner;
+			}
+
+		//! Include the point into the list of the agent's armed points.
+		/*!
+		 * \attention Must be called on the agent's working context.
+		 */
+		void
+		arm() SO_5_NOEXCEPT
+			{
+				auto & head = m_owner->m_suspension_points;
+				m_prev = nullptr;
+				m_next = head;
+				if( head )
+					head->m_prev = this;
+				head = this;
+
+				m_armed = true;
+			}
+
+		//! Exclude the point from the list of the agent's armed points.
+		/*!
+		 * A resumption will be ignored if the point is disarmed.
+		 *
+		 * \attention Must be called on the agent's working context.
+		 */
+		void
+		disarm() SO_5_NOEXCEPT
+			{
+				if( !m_armed )
+					return;
+
+				if( m_prev )
+					m_prev->m_next = m_next;
+				else
+					m_owner->m_suspension_points = m_next;
+				if( m_next )
+					m_next->m_prev = m_prev;
+
+				m_prev = m_next = nullptr;
+				m_armed = false;
+			}
+
+		//! Is the point armed?
+		bool
+		armed() const SO_5_NOEXCEPT
+			{
+				return m_armed;
+			}
+
+		//! Initiate a resumption of the suspended activity.
+		/*!
+		 * \note Can be called on any thread.
+		 */
+		void
+		trigger() SO_5_NOEXCEPT
+			{
+				if( !m_triggered.exchange( true, std::memory_order_acq_rel ) )
+					m_owner->push_resumption( message_ref_t( this ) );
+			}
+
+	protected :
+		//! Resume the suspended activity.
+		/*!
+		 * Is called on the agent's working context.
+		 */
+		virtual void
+		resume() = 0;
+
+		//! Cancel the suspended activity.
+		/*!
+		 * Is called on the agent's working context at the end of
+		 * the agent's work.
+		 */
+		virtual void
+		cancel() SO_5_NOEXCEPT = 0;
+
+	private :
+		//! Agent whose activity is suspended.
+		/*!
+		 * \note The reference to the agent is held because trigger()
+		 * can be called when the agent has already finished its work.
+		 */
+		const agent_ref_t m_owner;
+
+		//! Has trigger() been already called?
+		std::atomic< bool > m_triggered{ false };
+
+		//! Is the point in the list of armed points?
+		bool m_armed = false;
+
+		//! Previous point in the list of armed points.
+		suspension_point_t * m_prev = nullptr;
+		//! Next point in the list of armed points.
+		suspension_point_t * m_next = nullptr;
+	};
+
+} /* namespace impl */
+
+} /* namespace so_5 */
+
@@ -92,6 +92,31 @@ class SO_5_TYPE internal_env_iface_t
 		so_5::disp::mpmc_queue_traits::lock_factory_t
 		default_mpmc_queue_lock_factory() const;
 
+		//! Get access to the environment infrastructure.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		environment_infrastructure_t &
+		infrastructure() const;
+
+		//! Notification about a message dropped because its deadline passed.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		expired_message_dropped() SO_5_NOEXCEPT;
+
+		//! Notification about a message replaced by a newer message
+		//! with the same conflation key.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		message_conflated() SO_5_NOEXCEPT;
+
 		/*!
 		 * \name Methods for working with event_queue_hooks
 		 * \{
@@ -0,0 +1,555 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief A load-balancing mbox definition.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include <so_5/rt/impl/h/local_mbox.hpp>
+
+namespace so_5
+{
+
+namespace impl
+{
+
+namespace load_balancing_mbox_details
+{
+
+using subscriber_info_t = local_mbox_details::subscriber_info_t;
+
+//
+// subscribers_t
+//
+/*!
+ * \brief Subscribers for one message type.
+ *
+ * \since
+ * v.5.5.25
+ */
+struct subscribers_t
+	{
+		//! Subscribers in the order of subscription.
+		std::vector< subscriber_info_t > m_items;
+
+		//! Position for the start of search of the next receiver.
+		/*!
+		 * It is incremented by every delivery attempt. Because of that
+		 * it is modified when the mbox is locked in shared mode.
+		 */
+		mutable std::atomic< std::size_t > m_next{ 0u };
+
+		std::vector< subscriber_info_t >::iterator
+		find( agent_t * subscriber )
+			{
+				return std::find_if( m_items.begin(), m_items.end(),
+						[subscriber]( const subscriber_info_t & info ) {
+							return subscriber == info.subscriber_pointer();
+						} );
+			}
+	};
+
+//
+// data_t
+//
+/*!
+ * \brief A collection of data required for load-balancing mbox.
+ *
+ * \since
+ * v.5.5.25
+ */
+struct data_t
+	{
+		data_t( mbox_id_t id, load_balancing_policy_t policy )
+			:	m_id{ id }
+			,	m_policy{ policy }
+			{}
+
+		//! ID of this mbox.
+		const mbox_id_t m_id;
+
+		//! Policy for selection of a receiver.
+		const load_balancing_policy_t m_policy;
+
+		//! Object lock.
+		mutable default_rw_spinlock_t m_lock;
+
+		//! Map from message type to subscribers.
+		/*!
+		 * \note
+		 * std::map is used because subscribers_t is not movable.
+		 */
+		using messages_table_t = std::map< msg_type_id_t, subscribers_t >;
+
+		//! Map of subscribers to messages.
+		messages_table_t m_subscribers;
+	};
+
+} /* namespace load_balancing_mbox_details */
+
+//
+// load_balancing_mbox_template
+//
+
+//! A template with implementation of load-balancing mbox.
+/*!
+ * Every message is delivered to exactly one subscriber. The subscriber
+ * is selected in accordance with load_balancing_policy_t. Subscribers
+ * which have only delivery filters or which reject the message by their
+ * delivery filters are not selected.
+ *
+ * \tparam Tracing_Base base class with implementation of message
+ * delivery tracing methods.
+ *
+ * \since
+ * v.5.5.25
+ */
+template< typename Tracing_Base >
+class load_balancing_mbox_template
+	:	public abstract_message_box_t
+	,	private load_balancing_mbox_details::data_t
+	,	private Tracing_Base
+	{
+		using subscriber_info_t = load_balancing_mbox_details::subscriber_info_t;
+		using subscribers_t = load_balancing_mbox_details::subscribers_t;
+
+	public:
+		template< typename... Tracing_Args >
+		load_balancing_mbox_template(
+			//! ID of this mbox.
+			mbox_id_t id,
+			//! Policy for selection of a receiver.
+			load_balancing_policy_t policy,
+			//! Optional parameters for Tracing_Base's constructor.
+			Tracing_Args &&... args )
+			:	load_balancing_mbox_details::data_t{ id, policy }
+			,	Tracing_Base{ std::forward< Tracing_Args >(args)... }
+			{}
+
+		virtual mbox_id_t
+		id() const override
+			{
+				return m_id;
+			}
+
+		virtual void
+		subscribe_event_handler(
+			const std::type_index & type_wrapper,
+			const so_5::message_limit::control_block_t * limit,
+			agent_t * subscriber ) override
+			{
+				// The load of a subscriber is known only from its
+				// message limit.
+				if( load_balancing_policy_t::least_loaded == m_policy && !limit )
+					SO_5_THROW_EXCEPTION(
+							rc_message_limit_required_for_least_loaded,
+							std::string( "a message limit is required for "
+								"subscription to load-balancing mbox with "
+								"least_loaded policy, msg_type: " )
+							+ type_wrapper.name() );
+
+				insert_or_modify_subscriber(
+						type_wrapper,
+						subscriber,
+						[&] {
+							return subscriber_info_t{ subscriber, limit };
+						},
+						[&]( subscriber_info_t & info ) {
+							info.set_limit( limit );
+						} );
+			}
+
+		virtual void
+		unsubscribe_event_handlers(
+			const std::type_index & type_wrapper,
+			agent_t * subscriber ) override
+			{
+				modify_and_remove_subscriber_if_needed(
+						type_wrapper,
+						subscriber,
+						[]( subscriber_info_t & info ) {
+							info.drop_limit();
+						} );
+			}
+
+		virtual std::string
+		query_name() const override
+			{
+				std::ostringstream s;
+				s << "<mbox:type=MPMC_LB:id=" << m_id << ">";
+
+				return s.str();
+			}
+
+		virtual mbox_type_t
+		type() const override
+			{
+				return mbox_type_t::multi_producer_multi_consumer;
+			}
+
+		virtual void
+		do_deliver_message(
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			unsigned int overlimit_reaction_deep ) const override
+			{
+				typename Tracing_Base::deliver_op_tracer tracer{
+						*this, // as Tracing_base
+						*this, // as abstract_message_box_t
+						"deliver_message",
+						msg_type, message, overlimit_reaction_deep };
+
+				ensure_immutable_message( msg_type, message );
+
+				do_deliver_message_impl(
+						tracer,
+						msg_type,
+						message,
+						overlimit_reaction_deep,
+						invocation_type_t::event );
+			}
+
+		virtual void
+		do_deliver_service_request(
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			unsigned int overlimit_reaction_deep ) const override
+			{
+				typename Tracing_Base::deliver_op_tracer tracer{
+						*this, // as Tracing_Base
+						*this, // as abstract_message_box_t
+						"deliver_service_request",
+						msg_type, message, overlimit_reaction_deep };
+
+				msg_service_request_base_t::dispatch_wrapper( message,
+					[&] {
+						so_5::message_limit::impl::deferred_waits_t waits;
+						{
+							read_lock_guard_t< default_rw_spinlock_t > lock( m_lock );
+
+							const subscriber_info_t * receiver = nullptr;
+
+							auto it = m_subscribers.find( so_5::msg_type_id( msg_type ) );
+							if( it != m_subscribers.end() )
+								receiver = select_receiver(
+										it->second,
+										tracer,
+										message,
+										[]( const message_ref_t & m ) -> message_t & {
+											return dynamic_cast< msg_service_request_base_t & >(
+													*m ).query_param();
+										} );
+
+							if( !receiver )
+								{
+									tracer.no_subscribers();
+
+									SO_5_THROW_EXCEPTION(
+											so_5::rc_no_svc_handlers,
+											std::string( "no service handlers (no subscribers "
+												"for message or all subscribers are blocked by "
+												"delivery filters), msg_type: " )
+											+ msg_type.name() );
+								}
+
+							push_to_receiver(
+									*receiver,
+									tracer,
+									msg_type,
+									message,
+									overlimit_reaction_deep,
+									invocation_type_t::service_request );
+						}
+						waits.perform();
+					} );
+			}
+
+		void
+		do_deliver_enveloped_msg(
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			unsigned int overlimit_reaction_deep ) override
+			{
+				typename Tracing_Base::deliver_op_tracer tracer{
+						*this, // as Tracing_base
+						*this, // as abstract_message_box_t
+						"deliver_enveloped_msg",
+						msg_type, message, overlimit_reaction_deep };
+
+				ensure_immutable_message( msg_type, message );
+
+				do_deliver_message_impl(
+						tracer,
+						msg_type,
+						message,
+						overlimit_reaction_deep,
+						invocation_type_t::enveloped_msg );
+			}
+
+		virtual void
+		set_delivery_filter(
+			const std::type_index & msg_type,
+			const delivery_filter_t & filter,
+			agent_t & subscriber ) override
+			{
+				insert_or_modify_subscriber(
+						msg_type,
+						&subscriber,
+						[&] {
+							return subscriber_info_t{ &subscriber, &filter };
+						},
+						[&]( subscriber_info_t & info ) {
+							info.set_filter( filter );
+						} );
+			}
+
+		virtual void
+		drop_delivery_filter(
+			const std::type_index & msg_type,
+			agent_t & subscriber ) SO_5_NOEXCEPT override
+			{
+				modify_and_remove_subscriber_if_needed(
+						msg_type,
+						&subscriber,
+						[]( subscriber_info_t & info ) {
+							info.drop_filter();
+						} );
+			}
+
+	private :
+		template< typename Info_Maker, typename Info_Changer >
+		void
+		insert_or_modify_subscriber(
+			const std::type_index & type_wrapper,
+			agent_t * subscriber,
+			Info_Maker maker,
+			Info_Changer changer )
+			{
+				std::unique_lock< default_rw_spinlock_t > lock( m_lock );
+
+				auto it = m_subscribers.find( so_5::msg_type_id( type_wrapper ) );
+				if( it == m_subscribers.end() )
+					it = m_subscribers.emplace(
+							std::piecewise_construct,
+							std::forward_as_tuple( so_5::msg_type_id( type_wrapper ) ),
+							std::forward_as_tuple() ).first;
+
+				auto & subscribers = it->second;
+				auto pos = subscribers.find( subscriber );
+				if( pos != subscribers.m_items.end() )
+					// Agent is already in subscribers list.
+					// But its state must be updated.
+					changer( *pos );
+				else
+					subscribers.m_items.push_back( maker() );
+			}
+
+		template< typename Info_Changer >
+		void
+		modify_and_remove_subscriber_if_needed(
+			const std::type_index & type_wrapper,
+			agent_t * subscriber,
+			Info_Changer changer )
+			{
+				std::unique_lock< default_rw_spinlock_t > lock( m_lock );
+
+				auto it = m_subscribers.find( so_5::msg_type_id( type_wrapper ) );
+				if( it != m_subscribers.end() )
+				{
+					auto & subscribers = it->second;
+
+					auto pos = subscribers.find( subscriber );
+					if( pos != subscribers.m_items.end() )
+					{
+						// Subscriber is found and must be modified.
+						changer( *pos );
+
+						// If info about subscriber becomes empty after modification
+						// then subscriber info must be removed.
+						if( pos->empty() )
+							subscribers.m_items.erase( pos );
+					}
+
+					if( subscribers.m_items.empty() )
+						m_subscribers.erase( it );
+				}
+			}
+
+		//! Selection of a receiver for a message.
+		/*!
+		 * \attention
+		 * Must be called when object is locked in shared mode.
+		 *
+		 * \return nullptr if there is no appropriate receiver.
+		 */
+		template< typename Msg_Ref_Extractor >
+		const subscriber_info_t *
+		select_receiver(
+			const subscribers_t & subscribers,
+			typename Tracing_Base::deliver_op_tracer const & tracer,
+			const message_ref_t & message,
+			Msg_Ref_Extractor msg_extractor ) const
+			{
+				const auto & items = subscribers.m_items;
+				const auto size = items.size();
+				const auto start = subscribers.m_next.fetch_add(
+						1u, std::memory_order_relaxed );
+
+				const subscriber_info_t * selected = nullptr;
+				auto selected_load = std::numeric_limits< std::size_t >::max();
+
+				for( std::size_t i = 0u; i != size; ++i )
+					{
+						const auto & info = items[ ( start + i ) % size ];
+
+						const auto status = info.must_be_delivered(
+								message, msg_extractor );
+						if( delivery_possibility_t::must_be_delivered != status )
+							{
+								tracer.message_rejected(
+										info.subscriber_pointer(), status );
+								continue;
+							}
+
+						if( load_balancing_policy_t::round_robin == m_policy )
+							return &info;
+
+						// Every actual subscriber has a message limit.
+						// It is checked in subscribe_event_handler().
+						const std::size_t load =
+								info.limit()->m_count.load( std::memory_order_relaxed );
+						if( load < selected_load )
+							{
+								selected = &info;
+								selected_load = load;
+								if( !load )
+									// There can't be a better candidate.
+									break;
+							}
+					}
+
+				return selected;
+			}
+
+		void
+		do_deliver_message_impl(
+			typename Tracing_Base::deliver_op_tracer const & tracer,
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			unsigned int overlimit_reaction_deep,
+			invocation_type_t invocation_type ) const
+			{
+				const auto type_id = so_5::msg_type_id( msg_type );
+
+				so_5::message_limit::impl::deferred_waits_t waits;
+				{
+					read_lock_guard_t< default_rw_spinlock_t > lock( m_lock );
+
+					const subscriber_info_t * receiver = nullptr;
+
+					auto it = m_subscribers.find( type_id );
+					if( it != m_subscribers.end() )
+						receiver = select_receiver(
+								it->second,
+								tracer,
+								message,
+								[]( const message_ref_t & m ) -> message_t & {
+									return *m;
+								} );
+
+					if( receiver )
+						push_to_receiver(
+								*receiver,
+								tracer,
+								msg_type,
+								message,
+								overlimit_reaction_deep,
+								invocation_type );
+					else
+						tracer.no_subscribers();
+				}
+				waits.perform();
+			}
+
+		void
+		push_to_receiver(
+			const subscriber_info_t & agent_info,
+			typename Tracing_Base::deliver_op_tracer const & tracer,
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			unsigned int overlimit_reaction_deep,
+			invocation_type_t invocation_type ) const
+			{
+				using namespace so_5::message_limit::impl;
+
+				try_to_deliver_to_agent(
+						this->m_id,
+						invocation_type,
+						agent_info.subscriber_reference(),
+						agent_info.limit(),
+						msg_type,
+						message,
+						overlimit_reaction_deep,
+						tracer.overlimit_tracer(),
+						[&] {
+							tracer.push_to_queue( agent_info.subscriber_pointer() );
+
+							agent_t::call_push_event(
+									agent_info.subscriber_reference(),
+									agent_info.limit(),
+									this->m_id,
+									msg_type,
+									message );
+						} );
+			}
+
+		//! Ensures that message is an immutable message.
+		void
+		ensure_immutable_message(
+			const std::type_index & msg_type,
+			const message_ref_t & what ) const
+			{
+				if( message_mutability_t::immutable_message !=
+						message_mutability( what ) )
+					SO_5_THROW_EXCEPTION(
+							so_5::rc_mutable_msg_cannot_be_delivered_via_mpmc_mbox,
+							"an attempt to deliver mutable message via MPMC mbox"
+							", msg_type=" + std::string(msg_type.name()) );
+			}
+	};
+
+/*!
+ * \brief Alias for load-balancing mbox without message delivery tracing.
+ *
+ * \since
+ * v.5.5.25
+ */
+using load_balancing_mbox_without_tracing =
+	load_balancing_mbox_template< msg_tracing_helpers::tracing_disabled_base >;
+
+/*!
+ * \brief Alias for load-balancing mbox with message delivery tracing.
+ *
+ * \since
+ * v.5.5.25
+ */
+using load_balancing_mbox_with_tracing =
+	load_balancing_mbox_template< msg_tracing_helpers::tracing_enabled_base >;
+
+} /* namespace impl */
+
+} /* namespace so_5 */
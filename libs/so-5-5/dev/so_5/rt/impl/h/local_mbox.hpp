@@ -22,6 +22,7 @@
 #include <so_5/rt/h/mbox.hpp>
 #include <so_5/rt/h/agent.hpp>
 #include <so_5/rt/h/enveloped_msg.hpp>
+#include <so_5/rt/h/msg_type_id.hpp>
 
 #include <so_5/rt/impl/h/agent_ptr_compare.hpp>
 #include <so_5/rt/impl/h/message_limit_internals.hpp>
@@ -708,9 +709,12 @@ struct data_t
 		 * v.5.4.0
 		 *
 		 * \brief Map from message type to subscribers.
+		 *
+		 * \note
+		 * Since v.5.5.25 numeric message type ids are used as keys.
 		 */
 		typedef std::map<
-						std::type_index,
+						msg_type_id_t,
 						subscriber_adaptive_container_t >
 				messages_table_t;
 
@@ -906,14 +910,15 @@ class local_mbox_template
 			{
 				std::unique_lock< default_rw_spinlock_t > lock( m_lock );
 
-				auto it = m_subscribers.find( type_wrapper );
+				const auto type_id = so_5::msg_type_id( type_wrapper );
+				auto it = m_subscribers.find( type_id );
 				if( it == m_subscribers.end() )
 				{
 					// There isn't such message type yet.
 					local_mbox_details::subscriber_adaptive_container_t container;
 					container.insert( maker() );
 
-					m_subscribers.emplace( type_wrapper, std::move( container ) );
+					m_subscribers.emplace( type_id, std::move( container ) );
 				}
 				else
 				{
@@ -942,7 +947,7 @@ class local_mbox_template
 			{
 				std::unique_lock< default_rw_spinlock_t > lock( m_lock );
 
-				auto it = m_subscribers.find( type_wrapper );
+				auto it = m_subscribers.find( so_5::msg_type_id( type_wrapper ) );
 				if( it != m_subscribers.end() )
 				{
 					auto & agents = it->second;
@@ -972,22 +977,29 @@ class local_mbox_template
 			unsigned int overlimit_reaction_deep,
 			invocation_type_t invocation_type ) const
 			{
-				read_lock_guard_t< default_rw_spinlock_t > lock( m_lock );
+				const auto type_id = so_5::msg_type_id( msg_type );
 
-				auto it = m_subscribers.find( msg_type );
-				if( it != m_subscribers.end() )
-					{
-						for( const auto & a : it->second )
-							do_deliver_message_to_subscriber(
-									a,
-									tracer,
-									msg_type,
-									message,
-									overlimit_reaction_deep,
-									invocation_type );
-					}
-				else
-					tracer.no_subscribers();
+				so_5::message_limit::impl::deferred_waits_t waits;
+				{
+					read_lock_guard_t< default_rw_spinlock_t > lock( m_lock );
+
+					auto it = m_subscribers.find( type_id );
+					if( it != m_subscribers.end() )
+						{
+							for( const auto & a : it->second )
+								do_deliver_message_to_subscriber(
+										a,
+										tracer,
+										msg_type,
+										type_id,
+										message,
+										overlimit_reaction_deep,
+										invocation_type );
+						}
+					else
+						tracer.no_subscribers();
+				}
+				waits.perform();
 			}
 
 		void
@@ -995,6 +1007,7 @@ class local_mbox_template
 			const local_mbox_details::subscriber_info_t & agent_info,
 			typename Tracing_Base::deliver_op_tracer const & tracer,
 			const std::type_index & msg_type,
+			msg_type_id_t type_id,
 			const message_ref_t & message,
 			unsigned int overlimit_reaction_deep,
 			invocation_type_t invocation_type ) const
@@ -1027,6 +1040,7 @@ class local_mbox_template
 											agent_info.limit(),
 											this->m_id,
 											msg_type,
+											type_id,
 											message );
 								} );
 					}
@@ -1046,32 +1060,39 @@ class local_mbox_template
 
 				msg_service_request_base_t::dispatch_wrapper( message,
 					[&] {
-						read_lock_guard_t< default_rw_spinlock_t > lock( m_lock );
+						const auto type_id = so_5::msg_type_id( msg_type );
 
-						auto it = m_subscribers.find( msg_type );
+						so_5::message_limit::impl::deferred_waits_t waits;
+						{
+							read_lock_guard_t< default_rw_spinlock_t > lock( m_lock );
 
-						if( it == m_subscribers.end() )
-							{
-								tracer.no_subscribers();
+							auto it = m_subscribers.find( type_id );
 
-								SO_5_THROW_EXCEPTION(
-										so_5::rc_no_svc_handlers,
-										std::string( "no service handlers (no subscribers for message)"
-										", msg_type: " ) + msg_type.name() );
-							}
-
-						if( 1 != it->second.size() )
-							SO_5_THROW_EXCEPTION(
-									so_5::rc_more_than_one_svc_handler,
-									std::string( "more than one service handler found"
+							if( it == m_subscribers.end() )
+								{
+									tracer.no_subscribers();
+
+									SO_5_THROW_EXCEPTION(
+											so_5::rc_no_svc_handlers,
+											std::string( "no service handlers (no subscribers for message)"
 											", msg_type: " ) + msg_type.name() );
+								}
 
-						do_deliver_service_request_to_subscriber(
-								tracer,
-								*(it->second.begin()),
-								msg_type,
-								message,
-								overlimit_reaction_deep );
+							if( 1 != it->second.size() )
+								SO_5_THROW_EXCEPTION(
+										so_5::rc_more_than_one_svc_handler,
+										std::string( "more than one service handler found"
+												", msg_type: " ) + msg_type.name() );
+
+							do_deliver_service_request_to_subscriber(
+									tracer,
+									*(it->second.begin()),
+									msg_type,
+									type_id,
+									message,
+									overlimit_reaction_deep );
+						}
+						waits.perform();
 					} );
 			}
 
@@ -1080,6 +1101,7 @@ class local_mbox_template
 			typename Tracing_Base::deliver_op_tracer const & tracer,
 			const local_mbox_details::subscriber_info_t & agent_info,
 			const std::type_index & msg_type,
+			msg_type_id_t type_id,
 			const message_ref_t & message,
 			unsigned int overlimit_reaction_deep ) const
 			{
@@ -1112,6 +1134,7 @@ class local_mbox_template
 											agent_info.limit(),
 											m_id,
 											msg_type,
+											type_id,
 											message );
 								} );
 					}
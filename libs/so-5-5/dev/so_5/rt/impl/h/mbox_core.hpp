@@ -9,9 +9,10 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
-#include <map>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 #include <mutex>
@@ -37,6 +38,7 @@ namespace impl
 {
 
 class mbox_core_ref_t;
+class named_local_mbox_t;
 
 //
 // mbox_core_stats_t
@@ -94,6 +96,17 @@ class mbox_core_t
 			//! Mbox name.
 			nonempty_name_t mbox_name );
 
+		/*!
+		 * \brief Create anonymous load-balancing mbox.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		mbox_t
+		create_load_balancing_mbox(
+			//! Policy for selection of a receiver.
+			load_balancing_policy_t policy );
+
 		/*!
 		 * \since
 		 * v.5.4.0
@@ -110,14 +123,17 @@ class mbox_core_t
 			//! control will be created.
 			const so_5::message_limit::impl::info_storage_t * limits_storage );
 
-		//! Remove a reference to the named mbox.
+		//! Remove the named mbox from the dictionary.
 		/*!
-		 * If it was a last reference to named mbox the mbox destroyed.
+		 * Is called when the last reference to the named mbox is released.
+		 *
+		 * \note Since v.5.5.25 it receives the mbox instead of its name.
+		 * The mbox is removed only if the dictionary still refers to it.
 		*/
 		void
 		destroy_mbox(
-			//! Mbox name.
-			const std::string & name );
+			//! Mbox to be removed.
+			named_local_mbox_t & mbox );
 
 		/*!
 		 * \brief Create a custom mbox.
@@ -162,36 +178,94 @@ class mbox_core_t
 		 */
 		outliving_reference_t< so_5::msg_tracing::holder_t > m_msg_tracing_stuff;
 
-		//! Named mbox map's lock.
-		std::mutex m_dictionary_lock;
+		/*!
+		 * \brief A key for the dictionary of named mboxes.
+		 *
+		 * It refers to a name without owning it. So a lookup doesn't
+		 * require a copy of the name. The keys inside the dictionary refer
+		 * to names stored in named_local_mbox_t objects.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		struct name_key_t
+		{
+			const char * m_data;
+			std::size_t m_size;
+			//! Precalculated hash value for the name.
+			std::size_t m_hash;
+		};
+
+		/*!
+		 * \brief Hash function for name_key_t.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		struct name_key_hash_t
+		{
+			std::size_t
+			operator()( const name_key_t & key ) const SO_5_NOEXCEPT
+			{
+				return key.m_hash;
+			}
+		};
+
+		/*!
+		 * \brief Comparator for name_key_t.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		struct name_key_equal_t
+		{
+			bool
+			operator()(
+				const name_key_t & a,
+				const name_key_t & b ) const SO_5_NOEXCEPT;
+		};
 
-		//! Named mbox information.
-		struct named_mbox_info_t
+		/*!
+		 * \brief A part of the dictionary of named mboxes.
+		 *
+		 * Every shard has its own lock. It reduces the contention
+		 * between threads which work with different names.
+		 *
+		 * \note Raw pointers are stored in the map. A named mbox removes
+		 * itself from the map in the destructor. Because of that an mbox
+		 * found in the map can be in the middle of destruction.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		struct named_mboxes_shard_t
 		{
-			named_mbox_info_t()
-				:
-					m_external_ref_count( 0 )
-			{}
-
-			named_mbox_info_t(
-				const mbox_t mbox )
-				:
-					m_external_ref_count( 1 ),
-					m_mbox( mbox )
-			{}
-
-			//! Reference count by external mbox_refs.
-			unsigned int m_external_ref_count;
-			//! Real mbox for that name.
-			mbox_t m_mbox;
+			//! Shard's lock.
+			std::mutex m_lock;
+
+			//! Named mboxes from that shard.
+			std::unordered_map<
+						name_key_t,
+						named_local_mbox_t *,
+						name_key_hash_t,
+						name_key_equal_t >
+					m_mboxes;
 		};
 
-		//! Typedef for the map from the mbox name to the mbox information.
-		typedef std::map< std::string, named_mbox_info_t >
-			named_mboxes_dictionary_t;
+		//! Count of shards in the dictionary of named mboxes.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		enum { named_mboxes_shards_count = 16 };
 
 		//! Named mboxes.
-		named_mboxes_dictionary_t m_named_mboxes_dictionary;
+		/*!
+		 * \note Since v.5.5.25 it is split into several shards instead of
+		 * one map protected by the single lock.
+		 */
+		std::array< named_mboxes_shard_t, named_mboxes_shards_count >
+				m_named_mboxes_shards;
 
 		/*!
 		 * \since
@@ -214,6 +288,27 @@ class mbox_core_t
 			//! Functional object to create new instance of mbox.
 			//! Must have a prototype: mbox_t factory().
 			const std::function< mbox_t() > & factory );
+
+		/*!
+		 * \brief Make a key for the dictionary of named mboxes.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		static name_key_t
+		make_name_key( const std::string & name ) SO_5_NOEXCEPT;
+
+		/*!
+		 * \brief Get the shard for the specified key.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		named_mboxes_shard_t &
+		shard_for( const name_key_t & key ) SO_5_NOEXCEPT
+		{
+			return m_named_mboxes_shards[ key.m_hash % named_mboxes_shards_count ];
+		}
 };
 
 //! Smart reference to the mbox_core_t.
@@ -14,6 +14,8 @@
 
 #include <so_5/rt/h/mbox.hpp>
 
+#include <so_5/rt/impl/h/message_limit_internals.hpp>
+
 namespace so_5 {
 
 namespace rt {
@@ -42,6 +44,9 @@ class mbox_iface_for_timers_t
 			//! A message instance to be delivered.
 			const message_ref_t & message )
 			{
+				// limit_then_wait reaction must not block the timer thread.
+				so_5::message_limit::impl::timer_delivery_scope_t timer_scope;
+
 				m_mb.do_deliver_message_from_timer( msg_type, message );
 			}
 
@@ -16,6 +16,8 @@
 #include <so_5/rt/h/mchain_select_ifaces.hpp>
 #include <so_5/rt/h/environment.hpp>
 
+#include <so_5/rt/impl/h/internal_env_iface.hpp>
+
 #include <so_5/h/ret_code.hpp>
 #include <so_5/h/exception.hpp>
 #include <so_5/h/error_logger.hpp>
@@ -24,6 +26,7 @@
 
 #include <deque>
 #include <vector>
+#include <unordered_map>
 #include <mutex>
 #include <condition_variable>
 
@@ -108,6 +111,18 @@ class unlimited_demand_queue
 				return m_queue.front();
 			}
 
+		//! Access to back item from queue.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		demand_t &
+		back()
+			{
+				ensure_queue_not_empty( *this );
+				return m_queue.back();
+			}
+
 		//! Remove the front item from queue.
 		void
 		pop_front()
@@ -167,6 +182,18 @@ class limited_dynamic_demand_queue
 				return m_queue.front();
 			}
 
+		//! Access to back item from queue.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		demand_t &
+		back()
+			{
+				ensure_queue_not_empty( *this );
+				return m_queue.back();
+			}
+
 		//! Remove the front item from queue.
 		void
 		pop_front()
@@ -232,6 +259,18 @@ class limited_preallocated_demand_queue
 				return m_storage[ m_head ];
 			}
 
+		//! Access to back item from queue.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		demand_t &
+		back()
+			{
+				ensure_queue_not_empty( *this );
+				return m_storage[ (m_head + m_size - 1) % m_max_size ];
+			}
+
 		//! Remove the front item from queue.
 		void
 		pop_front()
@@ -268,6 +307,131 @@ class limited_preallocated_demand_queue
 		std::size_t m_size;
 	};
 
+//
+// conflation_index_t
+//
+/*!
+ * \brief An index of pending messages with conflation keys.
+ *
+ * Holds pointers to demands inside a demand queue. All demand queues
+ * don't move their items on push_back() and pop_front() so these
+ * pointers remain valid until the demand is removed from the queue.
+ *
+ * \attention
+ * A demand must be removed from the index by forget() before it
+ * is removed from the queue.
+ *
+ * \since
+ * v.5.5.25
+ */
+class conflation_index_t
+	{
+	public :
+		//! Find a pending demand which must be replaced by a new message.
+		/*!
+		 * \return nullptr if the message has no conflation key or there
+		 * is no pending message with the same type and key.
+		 */
+		demand_t *
+		find(
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			invocation_type_t demand_type ) const
+			{
+				const auto key = key_for( msg_type, message, demand_type );
+				if( key && !m_pending.empty() )
+					{
+						const auto it = m_pending.find( *key );
+						if( it != m_pending.end() )
+							return it->second;
+					}
+
+				return nullptr;
+			}
+
+		//! Store a demand which was just pushed to the queue.
+		void
+		remember( demand_t & demand )
+			{
+				const auto key = key_for( demand );
+				if( key )
+					m_pending[ *key ] = &demand;
+			}
+
+		//! Remove a demand which is going to be removed from the queue.
+		void
+		forget( const demand_t & demand ) SO_5_NOEXCEPT
+			{
+				if( m_pending.empty() )
+					return;
+
+				const auto key = key_for( demand );
+				if( key )
+					{
+						const auto it = m_pending.find( *key );
+						if( it != m_pending.end() && it->second == &demand )
+							m_pending.erase( it );
+					}
+			}
+
+	private :
+		//! Type of key for a pending message.
+		struct key_t
+			{
+				std::type_index m_msg_type;
+				std::uint64_t m_key;
+
+				bool
+				operator==( const key_t & o ) const SO_5_NOEXCEPT
+					{
+						return m_key == o.m_key && m_msg_type == o.m_msg_type;
+					}
+			};
+
+		//! Hash function for the key.
+		struct key_hash_t
+			{
+				std::size_t
+				operator()( const key_t & k ) const SO_5_NOEXCEPT
+					{
+						const auto h = std::hash< std::uint64_t >{}( k.m_key );
+						return h ^ ( k.m_msg_type.hash_code() + 0x9e3779b9u +
+								( h << 6 ) + ( h >> 2 ) );
+					}
+			};
+
+		//! Pending messages with conflation keys.
+		std::unordered_map< key_t, demand_t *, key_hash_t > m_pending;
+
+		static optional< key_t >
+		key_for(
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			invocation_type_t demand_type ) SO_5_NOEXCEPT
+			{
+				// Service requests can't be conflated because a sender
+				// waits for a reply for every one of them.
+				if( invocation_type_t::service_request != demand_type )
+					{
+						const auto key =
+								message_metadata( message ).query_conflation_key();
+						if( key )
+							return key_t{ msg_type, *key };
+					}
+
+				return nonstd::nullopt;
+			}
+
+		static optional< key_t >
+		key_for( const demand_t & demand ) SO_5_NOEXCEPT
+			{
+				return key_for(
+						demand.m_msg_type,
+						demand.m_message_ref,
+						demand.m_demand_type );
+			}
+	};
+
 //
 // status
 //
@@ -322,7 +486,10 @@ class mchain_template
 			,	m_capacity( params.capacity() )
 			,	m_not_empty_notificator( params.not_empty_notificator() )
 			,	m_queue( params.capacity() )
-			{}
+			{
+				if( params.conflation_enabled() )
+					m_conflation_index.reset( new details::conflation_index_t{} );
+			}
 
 		virtual mbox_id_t
 		id() const override
@@ -504,7 +671,7 @@ class mchain_template
 							{
 								this->trace_demand_drop_on_close(
 										*this, m_queue.front() );
-								m_queue.pop_front();
+								pop_front_demand();
 							}
 					}
 
@@ -617,6 +784,16 @@ class mchain_template
 		//! Chain's demands queue.
 		mutable Queue m_queue;
 
+		/*!
+		 * \brief An index of pending messages for conflation.
+		 *
+		 * Created only if conflation is enabled for the chain.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		std::unique_ptr< details::conflation_index_t > m_conflation_index;
+
 		//! Chain's lock.
 		mutable std::mutex m_lock;
 
@@ -670,6 +847,12 @@ class mchain_template
 				if( details::status::closed == m_status )
 					return;
 
+				// A pending message can be replaced by the new one.
+				// There is no need to check for overflow in that case
+				// because the size of the queue isn't changed.
+				if( try_conflate( tracer, msg_type, message, demand_type ) )
+					return;
+
 				// If queue full and waiting on full queue is enabled we
 				// must wait for some time until there will be some space in
 				// the queue.
@@ -700,7 +883,7 @@ class mchain_template
 							{
 								// The oldest message must be simply removed.
 								tracer.overflow_remove_oldest( m_queue.front() );
-								m_queue.pop_front();
+								pop_front_demand();
 							}
 						else if( overflow_reaction_t::throw_exception == reaction )
 							{
@@ -770,6 +953,12 @@ class mchain_template
 				if( details::status::closed == m_status )
 					return;
 
+				// A pending message can be replaced by the new one.
+				// There is no need to check for overflow in that case
+				// because the size of the queue isn't changed.
+				if( try_conflate( tracer, msg_type, message, demand_type ) )
+					return;
+
 				bool queue_full = m_queue.is_full();
 				// NOTE: there is no awaiting on full mchain.
 				// If queue full we must perform some reaction.
@@ -787,7 +976,7 @@ class mchain_template
 							{
 								// The oldest message must be simply removed.
 								tracer.overflow_remove_oldest( m_queue.front() );
-								m_queue.pop_front();
+								pop_front_demand();
 							}
 						else
 							{
@@ -828,6 +1017,8 @@ class mchain_template
 			{
 				// If queue was full then someone can wait on it.
 				const bool queue_was_full = m_queue.is_full();
+				if( m_conflation_index )
+					m_conflation_index->forget( m_queue.front() );
 				dest = std::move( m_queue.front() );
 				m_queue.pop_front();
 
@@ -897,6 +1088,64 @@ class mchain_template
 				if( m_threads_to_wakeup && m_threads_to_wakeup >= m_queue.size() )
 					// Someone is waiting on empty queue.
 					m_underflow_cond.notify_one();
+
+				// NOTE: if there is an exception then the message will remain
+				// in the queue but it won't be replaced by next messages
+				// with the same key.
+				if( m_conflation_index )
+					m_conflation_index->remember( m_queue.back() );
+			}
+
+		/*!
+		 * \brief An attempt to replace a pending message by a new one.
+		 *
+		 * \attention
+		 * This helper method must be called when chain object
+		 * is locked in some hi-level method.
+		 *
+		 * \return true if the new message replaced a pending message.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		bool
+		try_conflate(
+			typename Tracing_Base::deliver_op_tracer & tracer,
+			const std::type_index & msg_type,
+			const message_ref_t & message,
+			invocation_type_t demand_type )
+			{
+				if( !m_conflation_index )
+					return false;
+
+				demand_t * pending = m_conflation_index->find(
+						msg_type, message, demand_type );
+				if( !pending )
+					return false;
+
+				tracer.conflated( *pending );
+
+				pending->m_message_ref = message;
+				pending->m_demand_type = demand_type;
+
+				so_5::impl::internal_env_iface_t{ m_env }.message_conflated();
+
+				return true;
+			}
+
+		/*!
+		 * \brief Remove the front demand from the queue with respect
+		 * to conflation index.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		void
+		pop_front_demand()
+			{
+				if( m_conflation_index )
+					m_conflation_index->forget( m_queue.front() );
+				m_queue.pop_front();
 			}
 	};
 
@@ -66,6 +66,18 @@ class action_msg_tracer_t
 			const std::type_index & msg_type,
 			//! An instance of new message.
 			const message_ref_t & transformed ) const SO_5_NOEXCEPT = 0;
+
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief Message will be pushed to the receiver's queue after
+		 * waiting for free space.
+		 */
+		virtual void
+		reaction_push_after_wait(
+			//! Agent-receiver for the message.
+			const agent_t * subscriber ) const SO_5_NOEXCEPT = 0;
 	};
 
 } /* namespace impl */
@@ -12,11 +12,15 @@
 #pragma once
 
 #include <so_5/rt/h/message_limit.hpp>
+#include <so_5/rt/h/agent_ref_fwd.hpp>
 
 #include <vector>
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <chrono>
+#include <typeindex>
+#include <cstdint>
 
 namespace so_5
 {
@@ -69,6 +73,120 @@ struct info_block_t
  */
 using info_block_container_t = std::vector< info_block_t >;
 
+//
+// hash_index_t
+//
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Immutable open-addressing index for fast search of info_blocks.
+ *
+ * The address of the name of type_info object is used as a key.
+ * It allows to find info_block without calls to type_info::hash_code()
+ * or type_info::before() which can be rather expensive (they can
+ * do processing of the whole type's name).
+ *
+ * \note
+ * There can be several type_info objects for one type (for example
+ * when type_info is created in different shared libraries). Because of
+ * that the absence of a key in the index doesn't mean the absence of a
+ * limit for the type. A full search must be performed in that case.
+ */
+class hash_index_t
+	{
+	public :
+		//! Build index for the sorted container of info_blocks.
+		hash_index_t( const info_block_container_t & blocks )
+			:	m_mask( calculate_capacity( blocks.size() ) - 1u )
+			,	m_slots( m_mask + 1u )
+			{
+				for( const auto & b : blocks )
+					{
+						auto index = slot_for( key_of( b.m_msg_type ) );
+						while( m_slots[ index ].m_key )
+							index = ( index + 1u ) & m_mask;
+
+						m_slots[ index ] = slot_t{ key_of( b.m_msg_type ), &b };
+					}
+			}
+
+		//! Try to find info_block by key.
+		/*!
+		 * \return nullptr if there is no such key in the index.
+		 */
+		inline const info_block_t *
+		find( const std::type_index & msg_type ) const
+			{
+				const auto key = key_of( msg_type );
+				auto index = slot_for( key );
+				for(;;)
+					{
+						const auto & slot = m_slots[ index ];
+						if( slot.m_key == key )
+							return slot.m_block;
+						else if( !slot.m_key )
+							return nullptr;
+
+						index = ( index + 1u ) & m_mask;
+					}
+			}
+
+	private :
+		//! Description of one slot in the index.
+		struct slot_t
+			{
+				//! Key for info_block.
+				/*!
+				 * Value nullptr means that slot is empty.
+				 */
+				const char * m_key = nullptr;
+				//! Pointer to info_block for that key.
+				const info_block_t * m_block = nullptr;
+
+				slot_t() = default;
+				slot_t( const char * key, const info_block_t * block )
+					:	m_key( key ), m_block( block )
+					{}
+			};
+
+		//! Mask for index of a slot.
+		const std::size_t m_mask;
+
+		//! Slots for index.
+		std::vector< slot_t > m_slots;
+
+		//! Capacity of index for the specified count of items.
+		/*!
+		 * Capacity is always a power of two and there will be at least
+		 * the half of slots free.
+		 */
+		static std::size_t
+		calculate_capacity( std::size_t items )
+			{
+				std::size_t capacity = 2u;
+				while( capacity < items * 2u )
+					capacity <<= 1;
+				return capacity;
+			}
+
+		static const char *
+		key_of( const std::type_index & msg_type )
+			{
+				return msg_type.name();
+			}
+
+		std::size_t
+		slot_for( const char * key ) const
+			{
+				auto v = reinterpret_cast< std::uintptr_t >( key );
+				// Type names are aligned in memory so the lowest bits
+				// are mixed with high ones.
+				v ^= ( v >> 4 ) ^ ( v >> 12 );
+				return static_cast< std::size_t >( v ) & m_mask;
+			}
+	};
+
 //
 // info_storage_t
 //
@@ -90,6 +208,7 @@ class info_storage_t
 			description_container_t && descriptions )
 			:	m_blocks( build_blocks( std::move( descriptions ) ) )
 			,	m_small_container( m_blocks.size() <= 8 )
+			,	m_hash_index( m_blocks )
 			{}
 
 		inline const control_block_t *
@@ -124,6 +243,18 @@ class info_storage_t
 		//! Is the container is small and linear search must be used?
 		const bool m_small_container;
 
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief Index for fast search of info_blocks.
+		 *
+		 * \note
+		 * Must be initialized after m_blocks because it holds pointers
+		 * to the content of m_blocks.
+		 */
+		const hash_index_t m_hash_index;
+
 		//! Run-time limit information builder.
 		inline static info_block_container_t
 		build_blocks( description_container_t && descriptions )
@@ -166,6 +297,11 @@ class info_storage_t
 		inline const info_block_t *
 		find_block( const std::type_index & msg_type ) const
 			{
+				// In most cases info_block will be found via index.
+				auto r = m_hash_index.find( msg_type );
+				if( r )
+					return r;
+
 				if( m_small_container )
 					return find_block_in_small_container( msg_type );
 				else
@@ -249,7 +385,7 @@ struct decrement_on_exception_t
 	~decrement_on_exception_t()
 	{
 		if( !m_commited )
-			--(m_limit->m_count);
+			control_block_t::decrement( m_limit );
 	}
 
 	void
@@ -262,6 +398,130 @@ struct decrement_on_exception_t
 
 } /* namespace anonymous */
 
+//
+// deferred_waits_t
+//
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief A storage for limit_then_wait reactions which must be performed
+ * after the release of mbox's lock.
+ *
+ * An mbox creates an instance of deferred_waits_t before acquiring
+ * its lock and calls perform() after the lock is released. If there is
+ * an active deferred_waits_t instance on the current thread then
+ * wait_reaction() only stores the description of the wait and returns.
+ *
+ * If deferred_waits_t is created inside the scope of another
+ * deferred_waits_t object (it is possible for redirection and
+ * transformation of messages) then the stored waits are passed to the
+ * outer object. It is because the outer mbox still holds its lock.
+ */
+class deferred_waits_t
+	{
+	public :
+		//! Description of one deferred wait.
+		struct item_t
+			{
+				//! Receiver of the message.
+				agent_ref_t m_receiver;
+				//! Message limit for the message.
+				const control_block_t * m_limit;
+				//! ID of mbox which is used for message delivery.
+				mbox_id_t m_mbox_id;
+				//! Type of the message.
+				std::type_index m_msg_type;
+				//! Message instance.
+				message_ref_t m_message;
+				//! Optional tracer.
+				/*!
+				 * \note It is set to nullptr if the item is passed to
+				 * the outer deferred_waits_t object because the tracer
+				 * object is destroyed at that moment.
+				 */
+				const action_msg_tracer_t * m_msg_tracer;
+				//! Sender is woken up when the count of waiting messages
+				//! becomes less than this value.
+				unsigned int m_low_water_mark;
+				//! Time point when the waiting must be finished.
+				std::chrono::steady_clock::time_point m_deadline;
+			};
+
+		deferred_waits_t();
+		~deferred_waits_t();
+
+		deferred_waits_t( const deferred_waits_t & ) = delete;
+		deferred_waits_t &
+		operator=( const deferred_waits_t & ) = delete;
+
+		//! Get the active deferred_waits_t object for the current thread.
+		/*!
+		 * \return nullptr if there is no active object.
+		 */
+		static deferred_waits_t *
+		current() SO_5_NOEXCEPT;
+
+		//! Store the description of a wait.
+		void
+		add( item_t item );
+
+		//! Perform all stored waits.
+		/*!
+		 * Must be called after the release of mbox's lock.
+		 * The object is deactivated before the waiting.
+		 *
+		 * If several waits throw then the first exception is rethrown
+		 * after the completion of all waits.
+		 */
+		void
+		perform();
+
+	private :
+		//! Object which was active before this one.
+		deferred_waits_t * m_previous;
+		//! Is this object still active?
+		bool m_active{ true };
+		//! Stored waits.
+		std::vector< item_t > m_items;
+
+		//! Make the previous object active again.
+		void
+		deactivate() SO_5_NOEXCEPT;
+	};
+
+//
+// timer_delivery_scope_t
+//
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief A marker of delivery of a message from the timer thread.
+ *
+ * The timer thread must not be blocked by limit_then_wait reaction.
+ * Because of that wait_reaction() drops the message if it is called
+ * inside timer_delivery_scope_t.
+ */
+class timer_delivery_scope_t
+	{
+	public :
+		timer_delivery_scope_t() SO_5_NOEXCEPT;
+		~timer_delivery_scope_t() SO_5_NOEXCEPT;
+
+		timer_delivery_scope_t( const timer_delivery_scope_t & ) = delete;
+		timer_delivery_scope_t &
+		operator=( const timer_delivery_scope_t & ) = delete;
+
+		//! Is there an active timer_delivery_scope_t on the current thread?
+		static bool
+		active() SO_5_NOEXCEPT;
+
+	private :
+		//! Previous value of the marker.
+		bool m_previous;
+	};
+
 /*!
  * \since
  * v.5.5.4
@@ -297,10 +557,24 @@ try_to_deliver_to_agent(
 	//! Actual delivery action.
 	Lambda delivery_action )
 {
-	if( limit && ( limit->m_limit < ++(limit->m_count) ) )
+	bool overlimit = false;
+	if( limit )
 	{
-		--(limit->m_count);
+		// NOTE: since v.5.5.25 the current value of the counter is checked
+		// before the increment. It prevents modification of the counter
+		// (and the ownership transfer for the cache line with it) by all
+		// producers when the receiver is already overloaded.
+		if( limit->m_limit <= limit->m_count.load( std::memory_order_relaxed ) )
+			overlimit = true;
+		else if( limit->m_limit < ++(limit->m_count) )
+		{
+			--(limit->m_count);
+			overlimit = true;
+		}
+	}
 
+	if( overlimit )
+	{
 		limit->m_action(
 			overlimit_context_t{
 				mbox_id,
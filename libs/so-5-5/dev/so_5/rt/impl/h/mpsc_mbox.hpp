@@ -253,12 +253,16 @@ class limitless_mpsc_mbox_template
 			//! Lambda with actual delivery actions.
 			L l ) const
 		{
-			read_lock_guard_t< default_rw_spinlock_t > lock{ m_lock };
+			so_5::message_limit::impl::deferred_waits_t waits;
+			{
+				read_lock_guard_t< default_rw_spinlock_t > lock{ m_lock };
 
-			if( m_subscriptions_count )
-				l();
-			else
-				tracer.no_subscribers();
+				if( m_subscriptions_count )
+					l();
+				else
+					tracer.no_subscribers();
+			}
+			waits.perform();
 		}
 };
 
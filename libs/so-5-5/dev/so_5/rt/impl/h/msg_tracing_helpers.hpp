@@ -768,6 +768,13 @@ class tracing_enabled_base
 								details::type_of_transformed_msg{ msg_type },
 								transformed );
 					}
+
+				virtual void
+				reaction_push_after_wait(
+					const agent_t * subscriber ) const SO_5_NOEXCEPT override
+					{
+						make_trace( "push_to_queue", subscriber );
+					}
 			};
 
 #if defined(__clang__)
@@ -822,6 +829,33 @@ trace_deadletter_handler_search_result(
 			search_result );
 	}
 
+/*!
+ * \brief Helper for tracing the fact of dropping a message
+ * because its deadline passed.
+ *
+ * \note This helper checks status of msg tracing by itself. It means that
+ * it is safe to call this function if msg tracing is disabled.
+ *
+ * \since
+ * v.5.5.25
+ */
+inline void
+safe_trace_expired_message_dropped(
+	const execution_demand_t & demand,
+	const char * context_marker )
+	{
+		internal_env_iface_t env{ demand.m_receiver->so_environment() };
+
+		if( env.is_msg_tracing_enabled() )
+			details::make_trace(
+				env.msg_tracing_stuff(),
+				demand.m_receiver,
+				details::composed_action_name{ context_marker, "drop_expired" },
+				details::mbox_identification{ demand.m_mbox_id },
+				details::original_msg_type{ demand.m_msg_type },
+				demand.m_message_ref );
+	}
+
 /*!
  * \since
  * v.5.5.15
@@ -908,6 +942,8 @@ struct mchain_tracing_disabled_base
 
 				void overflow_remove_oldest( const so_5::mchain_props::demand_t & ) {}
 
+				void conflated( const so_5::mchain_props::demand_t & ) {}
+
 				void overflow_throw_exception() {}
 
 				void overflow_abort_app() {}
@@ -1038,6 +1074,14 @@ class mchain_tracing_enabled_base
 								d.m_message_ref );
 					}
 
+				void
+				conflated( const so_5::mchain_props::demand_t & d )
+					{
+						make_trace( "conflated",
+								details::type_of_removed_msg{ d.m_msg_type },
+								d.m_message_ref );
+					}
+
 				void
 				overflow_throw_exception()
 					{
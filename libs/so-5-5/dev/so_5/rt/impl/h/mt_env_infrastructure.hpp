@@ -13,7 +13,6 @@
 #pragma once
 
 #include <so_5/rt/h/environment_infrastructure.hpp>
-#include <so_5/rt/h/mchain.hpp>
 
 #include <so_5/disp/one_thread/h/params.hpp>
 
@@ -23,6 +22,11 @@
 
 #include <so_5/h/timers.hpp>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace so_5 {
 
 namespace env_infrastructures {
@@ -121,14 +125,42 @@ class coop_repo_t final : protected ::so_5::impl::coop_repository_basis_t
 		 * \{
 		 */
 		/*!
+		 * \brief Lock for the queue of coops to be finally deregistered.
+		 *
 		 * \since
-		 * v.5.5.13
+		 * v.5.5.25
+		 */
+		std::mutex m_final_dereg_lock;
+
+		/*!
+		 * \brief Condition variable for waking up the final
+		 * deregistration thread.
 		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		std::condition_variable m_final_dereg_cond;
+
+		/*!
 		 * \brief Queue of coops to be finally deregistered.
 		 *
-		 * \note Actual mchain is created inside start() method.
+		 * \note
+		 * Before v.5.5.25 an mchain was used as that queue.
+		 * Now the final deregistration thread takes all the coops from
+		 * the queue at once and processes them in bulk.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		std::vector< coop_t * > m_final_dereg_queue;
+
+		/*!
+		 * \brief Is the final deregistration thread should be finished?
+		 *
+		 * \since
+		 * v.5.5.25
 		 */
-		mchain_t m_final_dereg_chain;
+		bool m_final_dereg_finish = false;
 
 		/*!
 		 * \since
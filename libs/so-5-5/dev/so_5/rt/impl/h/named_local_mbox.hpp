@@ -32,6 +32,11 @@ namespace impl
  * reference counting for anonymous and named local mboxes. Named
  * local mboxes should have only one instance inside
  * SObjectizer Environment.
+ *
+ * \note Since v.5.5.25 there is only one instance of that class for
+ * every name. All mbox_t for the name refer to that instance. The instance
+ * removes itself from the dictionary of named mboxes when the last
+ * reference is released.
 */
 class named_local_mbox_t
 	:
@@ -40,7 +45,7 @@ class named_local_mbox_t
 		friend class impl::mbox_core_t;
 
 		named_local_mbox_t(
-			const std::string & name,
+			std::string name,
 			const mbox_t & mbox,
 			impl::mbox_core_t & mbox_core );
 
@@ -0,0 +1,146 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief Cache of transitions between agent's states.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#pragma once
+
+#include <so_5/rt/h/state.hpp>
+
+#include <so_5/h/compiler_features.hpp>
+
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+namespace so_5 {
+
+namespace impl {
+
+//
+// state_transition_t
+//
+/*!
+ * \brief Description of transition from one state to another.
+ *
+ * Holds the list of states to be exited (from the deepest one) and
+ * the list of states to be entered (from the top-most one).
+ *
+ * \since
+ * v.5.5.25
+ */
+struct state_transition_t
+	{
+		//! States to be exited.
+		state_t::path_t m_exits;
+		//! Count of states to be exited.
+		std::size_t m_exits_count = 0;
+
+		//! States to be entered.
+		state_t::path_t m_enters;
+		//! Count of states to be entered.
+		std::size_t m_enters_count = 0;
+
+		//! Calculate the transition.
+		void
+		calculate(
+			const state_t & from,
+			const state_t & to ) SO_5_NOEXCEPT
+			{
+				state_t::path_t from_path;
+				state_t::path_t to_path;
+
+				from.fill_path( from_path );
+				to.fill_path( to_path );
+
+				const auto common_level = from.nested_level() < to.nested_level() ?
+						from.nested_level() : to.nested_level();
+
+				// Find the first item which is different in the paths.
+				std::size_t first_diff = 0;
+				for(; first_diff < common_level; ++first_diff )
+					if( from_path[ first_diff ] != to_path[ first_diff ] )
+						break;
+
+				m_exits_count = 0;
+				for( std::size_t i = from.nested_level(); i >= first_diff; )
+					{
+						m_exits[ m_exits_count++ ] = from_path[ i ];
+						if( i )
+							--i;
+						else
+							break;
+					}
+
+				m_enters_count = 0;
+				for( std::size_t i = first_diff; i <= to.nested_level(); ++i )
+					m_enters[ m_enters_count++ ] = to_path[ i ];
+			}
+	};
+
+//
+// state_transitions_cache_t
+//
+/*!
+ * \brief Cache of transitions between states of an agent.
+ *
+ * A transition between a pair of states is calculated only once.
+ *
+ * \note States are identified by their addresses. It is safe because
+ * the structure of agent's states can't be changed after the creation
+ * of states.
+ *
+ * \since
+ * v.5.5.25
+ */
+class state_transitions_cache_t
+	{
+	public :
+		//! Get the transition. Calculate it if it isn't calculated yet.
+		const state_transition_t &
+		find_or_create(
+			const state_t & from,
+			const state_t & to )
+			{
+				const key_t key{ &from, &to };
+
+				auto it = m_transitions.find( key );
+				if( it == m_transitions.end() )
+					{
+						it = m_transitions.emplace( key, state_transition_t{} ).first;
+						it->second.calculate( from, to );
+					}
+
+				return it->second;
+			}
+
+	private :
+		//! Type of key for the cache.
+		using key_t = std::pair< const state_t *, const state_t * >;
+
+		//! Hash function for the key.
+		struct key_hash_t
+			{
+				std::size_t
+				operator()( const key_t & key ) const SO_5_NOEXCEPT
+					{
+						const std::hash< const state_t * > h{};
+						return h( key.first ) ^ ( h( key.second ) << 1 );
+					}
+			};
+
+		//! Calculated transitions.
+		std::unordered_map< key_t, state_transition_t, key_hash_t >
+				m_transitions;
+	};
+
+} /* namespace impl */
+
+} /* namespace so_5 */
@@ -21,6 +21,7 @@
 #include <so_5/rt/h/mbox.hpp>
 #include <so_5/rt/h/state.hpp>
 #include <so_5/rt/h/execution_demand.hpp>
+#include <so_5/rt/h/msg_type_id.hpp>
 #include <so_5/rt/h/subscription_storage_fwd.hpp>
 
 namespace so_5
@@ -78,6 +79,13 @@ struct subscr_info_t
 		 */
 		mbox_t m_mbox;
 		std::type_index m_msg_type;
+		/*!
+		 * \since
+		 * v.5.5.25
+		 *
+		 * \brief Numeric ID for m_msg_type.
+		 */
+		msg_type_id_t m_msg_type_id;
 		const state_t * m_state;
 		event_handler_data_t m_handler;
 
@@ -89,6 +97,7 @@ struct subscr_info_t
 			thread_safety_t thread_safety )
 			:	m_mbox( std::move( mbox ) )
 			,	m_msg_type( std::move( msg_type ) )
+			,	m_msg_type_id( so_5::msg_type_id( m_msg_type ) )
 			,	m_state( &state )
 			,	m_handler( method, thread_safety )
 			{}
@@ -167,10 +176,16 @@ class subscription_storage_t
 			const mbox_t & mbox,
 			const std::type_index & msg_type ) = 0;
 
+		//! Find event handler.
+		/*!
+		 * \note
+		 * Since v.5.5.25 numeric ID of message type is used instead
+		 * of std::type_index.
+		 */
 		virtual const event_handler_data_t *
 		find_handler(
 			mbox_id_t mbox_id,
-			const std::type_index & msg_type,
+			msg_type_id_t msg_type_id,
 			const state_t & current_state ) const SO_5_NOEXCEPT = 0;
 
 		virtual void
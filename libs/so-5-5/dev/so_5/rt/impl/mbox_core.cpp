@@ -7,11 +7,14 @@
 #include <so_5/h/exception.hpp>
 
 #include <so_5/rt/impl/h/local_mbox.hpp>
+#include <so_5/rt/impl/h/load_balancing_mbox.hpp>
 #include <so_5/rt/impl/h/named_local_mbox.hpp>
 #include <so_5/rt/impl/h/mpsc_mbox.hpp>
 #include <so_5/rt/impl/h/mchain_details.hpp>
 
 #include <algorithm>
+#include <cstring>
+#include <cstdint>
 
 namespace so_5
 {
@@ -40,6 +43,18 @@ mbox_core_t::create_mbox()
 		return mbox_t{ new local_mbox_with_tracing{ id, m_msg_tracing_stuff } };
 }
 
+mbox_t
+mbox_core_t::create_load_balancing_mbox(
+	load_balancing_policy_t policy )
+{
+	auto id = ++m_mbox_id_counter;
+	if( !m_msg_tracing_stuff.get().is_msg_tracing_enabled() )
+		return mbox_t{ new load_balancing_mbox_without_tracing{ id, policy } };
+	else
+		return mbox_t{ new load_balancing_mbox_with_tracing{
+				id, policy, m_msg_tracing_stuff.get() } };
+}
+
 mbox_t
 mbox_core_t::create_mbox(
 	nonempty_name_t mbox_name )
@@ -106,19 +121,18 @@ mbox_core_t::create_mpsc_mbox(
 
 void
 mbox_core_t::destroy_mbox(
-	const std::string & name )
+	named_local_mbox_t & mbox )
 {
-	std::lock_guard< std::mutex > lock( m_dictionary_lock );
+	const auto key = make_name_key( mbox.m_name );
+	auto & shard = shard_for( key );
 
-	named_mboxes_dictionary_t::iterator it =
-		m_named_mboxes_dictionary.find( name );
+	std::lock_guard< std::mutex > lock( shard.m_lock );
 
-	if( m_named_mboxes_dictionary.end() != it )
-	{
-		const unsigned int ref_count = --(it->second.m_external_ref_count);
-		if( 0 == ref_count )
-			m_named_mboxes_dictionary.erase( it );
-	}
+	auto it = shard.m_mboxes.find( key );
+
+	// The dictionary can already refer to a new mbox with the same name.
+	if( shard.m_mboxes.end() != it && &mbox == it->second )
+		shard.m_mboxes.erase( it );
 }
 
 mbox_t
@@ -183,9 +197,14 @@ mbox_core_t::create_mchain(
 mbox_core_stats_t
 mbox_core_t::query_stats()
 {
-	std::lock_guard< std::mutex > lock{ m_dictionary_lock };
+	std::size_t count = 0;
+	for( auto & shard : m_named_mboxes_shards )
+	{
+		std::lock_guard< std::mutex > lock{ shard.m_lock };
+		count += shard.m_mboxes.size();
+	}
 
-	return mbox_core_stats_t{ m_named_mboxes_dictionary.size() };
+	return mbox_core_stats_t{ count };
 }
 
 mbox_t
@@ -193,28 +212,73 @@ mbox_core_t::create_named_mbox(
 	nonempty_name_t nonempty_name,
 	const std::function< mbox_t() > & factory )
 {
-	const std::string & name = nonempty_name.query_name();
-	std::lock_guard< std::mutex > lock( m_dictionary_lock );
+	const auto key = make_name_key( nonempty_name.query_name() );
+	auto & shard = shard_for( key );
+
+	// NOTE: this object must be destroyed when the shard's lock
+	// is released because the destructor of named_local_mbox_t
+	// acquires that lock.
+	std::unique_ptr< named_local_mbox_t > new_mbox;
 
-	named_mboxes_dictionary_t::iterator it =
-		m_named_mboxes_dictionary.find( name );
+	std::lock_guard< std::mutex > lock( shard.m_lock );
 
-	if( m_named_mboxes_dictionary.end() != it )
+	auto it = shard.m_mboxes.find( key );
+	if( shard.m_mboxes.end() != it )
 	{
-		++(it->second.m_external_ref_count);
-		return mbox_t(
-			new named_local_mbox_t(
-				name,
-				it->second.m_mbox,
-				*this ) );
+		named_local_mbox_t * existing = it->second;
+		// The mbox can be in the middle of destruction.
+		// Its reference count is 0 in that case.
+		if( existing->inc_ref_count_if_not_zero() )
+		{
+			mbox_t result{ existing };
+			// The extra reference made by inc_ref_count_if_not_zero()
+			// must be removed. The count can't become zero here.
+			existing->dec_ref_count();
+
+			return result;
+		}
+
+		// The old mbox will be replaced by a new one.
+		shard.m_mboxes.erase( it );
 	}
 
 	// There is no mbox with such name. New mbox should be created.
-	mbox_t mbox_ref = factory();
+	new_mbox.reset( new named_local_mbox_t(
+			nonempty_name.giveout_value(), factory(), *this ) );
+
+	// The key must refer to the name inside the new mbox.
+	shard.m_mboxes.emplace(
+			name_key_t{
+				new_mbox->m_name.data(), new_mbox->m_name.size(), key.m_hash },
+			new_mbox.get() );
 
-	m_named_mboxes_dictionary[ name ] = named_mbox_info_t( mbox_ref );
+	return mbox_t( new_mbox.release() );
+}
+
+bool
+mbox_core_t::name_key_equal_t::operator()(
+	const name_key_t & a,
+	const name_key_t & b ) const SO_5_NOEXCEPT
+{
+	return a.m_size == b.m_size &&
+			0 == std::memcmp( a.m_data, b.m_data, a.m_size );
+}
+
+mbox_core_t::name_key_t
+mbox_core_t::make_name_key( const std::string & name ) SO_5_NOEXCEPT
+{
+	// FNV-1a hash function.
+	std::uint64_t hash = 14695981039346656037ull;
+	for( const char c : name )
+	{
+		hash ^= static_cast< unsigned char >( c );
+		hash *= 1099511628211ull;
+	}
 
-	return mbox_t( new named_local_mbox_t( name, mbox_ref, *this ) );
+	return name_key_t{
+			name.data(),
+			name.size(),
+			static_cast< std::size_t >( hash ^ ( hash >> 32 ) ) };
 }
 
 //
@@ -42,16 +42,31 @@ coop_repo_t::coop_repo_t(
 void
 coop_repo_t::start()
 {
-	// mchain for final coop deregs must be created.
-	m_final_dereg_chain = environment().create_mchain(
-			make_unlimited_mchain_params().disable_msg_tracing() );
 	// A separate thread for doing the final dereg must be started.
 	m_final_dereg_thread = std::thread{ [this] {
-		// Process dereg demands until chain will be closed.
-		receive( from( m_final_dereg_chain ),
-			[]( coop_t * coop ) {
+		std::vector< coop_t * > coops;
+
+		std::unique_lock< std::mutex > lck{ m_final_dereg_lock };
+		for(;;)
+		{
+			m_final_dereg_cond.wait( lck, [this] {
+					return m_final_dereg_finish || !m_final_dereg_queue.empty();
+				} );
+
+			if( m_final_dereg_queue.empty() )
+				// Queue is empty and thread should be finished.
+				break;
+
+			// All coops are taken from the queue at once.
+			// The queue's buffer is reused at the next iteration.
+			coops.swap( m_final_dereg_queue );
+
+			lck.unlock();
+			for( auto * coop : coops )
 				coop_t::call_final_deregister_coop( coop );
-			} );
+			coops.clear();
+			lck.lock();
+		}
 	} };
 }
 
@@ -65,7 +80,11 @@ coop_repo_t::finish()
 	wait_all_coop_to_deregister();
 
 	// Notify a dedicated thread and wait while it will be stopped.
-	close_retain_content( m_final_dereg_chain );
+	{
+		std::lock_guard< std::mutex > lck{ m_final_dereg_lock };
+		m_final_dereg_finish = true;
+	}
+	m_final_dereg_cond.notify_one();
 	m_final_dereg_thread.join();
 }
 
@@ -73,7 +92,17 @@ void
 coop_repo_t::ready_to_deregister_notify(
 	coop_t * coop )
 {
-	so_5::send< coop_t * >( m_final_dereg_chain, coop );
+	bool need_wakeup = false;
+	{
+		std::lock_guard< std::mutex > lck{ m_final_dereg_lock };
+		// If the queue isn't empty then the final deregistration
+		// thread is already notified.
+		need_wakeup = m_final_dereg_queue.empty();
+		m_final_dereg_queue.push_back( coop );
+	}
+
+	if( need_wakeup )
+		m_final_dereg_cond.notify_one();
 }
 
 bool
@@ -122,7 +151,11 @@ coop_repo_t::wait_all_coop_to_deregister()
 environment_infrastructure_t::coop_repository_stats_t
 coop_repo_t::query_stats()
 {
-	const auto final_dereg_coops = m_final_dereg_chain->size();
+	std::size_t final_dereg_coops = 0u;
+	{
+		std::lock_guard< std::mutex > lck{ m_final_dereg_lock };
+		final_dereg_coops = m_final_dereg_queue.size();
+	}
 
 	const auto basis_stats = coop_repository_basis_t::query_stats();
 
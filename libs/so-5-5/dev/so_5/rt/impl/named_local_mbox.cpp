@@ -17,11 +17,11 @@ namespace impl
 //
 
 named_local_mbox_t::named_local_mbox_t(
-	const std::string & name,
+	std::string name,
 	const mbox_t & mbox,
 	impl::mbox_core_t & mbox_core )
 	:
-		m_name( name ),
+		m_name( std::move(name) ),
 		m_mbox_core( &mbox_core ),
 		m_mbox( mbox )
 {
@@ -29,7 +29,7 @@ named_local_mbox_t::named_local_mbox_t(
 
 named_local_mbox_t::~named_local_mbox_t()
 {
-	m_mbox_core->destroy_mbox( m_name );
+	m_mbox_core->destroy_mbox( *this );
 }
 
 mbox_id_t
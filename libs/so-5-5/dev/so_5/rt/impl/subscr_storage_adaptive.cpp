@@ -42,6 +42,9 @@ namespace adaptive_subscr_storage
  * Controls the size of the current storage. If size of the small storage
  * exceeded threshold then switches from small to the big one. If size of the
  * big storage drops below the threshold then switches to the small storage.
+ *
+ * \note Since v.5.5.25 the big storage is created only when it is
+ * necessary for the first time.
  */
 class storage_t : public subscription_storage_t
 	{
@@ -50,7 +53,7 @@ class storage_t : public subscription_storage_t
 			agent_t * owner,
 			std::size_t threshold,
 			subscription_storage_unique_ptr_t small_storage,
-			subscription_storage_unique_ptr_t large_storage );
+			subscription_storage_factory_t large_storage_factory );
 
 		virtual void
 		create_event_subscription(
@@ -75,7 +78,7 @@ class storage_t : public subscription_storage_t
 		const event_handler_data_t *
 		find_handler(
 			mbox_id_t mbox_id,
-			const std::type_index & msg_type,
+			msg_type_id_t msg_type_id,
 			const state_t & current_state ) const SO_5_NOEXCEPT override;
 
 		void
@@ -100,21 +103,36 @@ class storage_t : public subscription_storage_t
 		subscription_storage_unique_ptr_t m_small_storage;
 		subscription_storage_unique_ptr_t m_large_storage;
 
+		//! Factory for creation of the large storage.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		const subscription_storage_factory_t m_large_storage_factory;
+
 		subscription_storage_t * m_current_storage = nullptr;
 
 		void
 		try_switch_to_smaller_storage();
+
+		//! Get the large storage. Creates it if necessary.
+		/*!
+		 * \since
+		 * v.5.5.25
+		 */
+		subscription_storage_t &
+		large_storage();
 	};
 
 storage_t::storage_t(
 	agent_t * owner,
 	std::size_t threshold,
 	subscription_storage_unique_ptr_t small_storage,
-	subscription_storage_unique_ptr_t large_storage )
+	subscription_storage_factory_t large_storage_factory )
 	:	subscription_storage_t( owner )
 	,	m_threshold( threshold )
 	,	m_small_storage( std::move( small_storage ) )
-	,	m_large_storage( std::move( large_storage ) )
+	,	m_large_storage_factory( std::move( large_storage_factory ) )
 	{
 		m_current_storage = m_small_storage.get();
 	}
@@ -135,12 +153,12 @@ storage_t::create_event_subscription(
 				// Exceptions are going out.
 				// It means that exception during switching
 				// to the large storage will prohibit subscription.
-				m_large_storage->setup_content(
-						m_small_storage->query_content() );
+				auto & large = large_storage();
+				large.setup_content( m_small_storage->query_content() );
 
 				m_small_storage->drop_content();
 
-				m_current_storage = m_large_storage.get();
+				m_current_storage = &large;
 			}
 
 		m_current_storage->create_event_subscription(
@@ -176,12 +194,12 @@ storage_t::drop_subscription_for_all_states(
 const event_handler_data_t *
 storage_t::find_handler(
 	mbox_id_t mbox_id,
-	const std::type_index & msg_type,
+	msg_type_id_t msg_type_id,
 	const state_t & current_state ) const SO_5_NOEXCEPT
 	{
 		return m_current_storage->find_handler(
 				mbox_id,
-				msg_type,
+				msg_type_id,
 				current_state );
 	}
 
@@ -209,7 +227,7 @@ storage_t::setup_content(
 	subscription_storage_common::subscr_info_vector_t && info )
 	{
 		auto s = info.size() <= m_threshold ?
-				m_small_storage.get() : m_large_storage.get();
+				m_small_storage.get() : &large_storage();
 
 		s->setup_content( std::move( info ) );
 
@@ -222,6 +240,15 @@ storage_t::query_subscriptions_count() const
 		return m_current_storage->query_subscriptions_count();
 	}
 
+subscription_storage_t &
+storage_t::large_storage()
+	{
+		if( !m_large_storage )
+			m_large_storage = m_large_storage_factory( owner() );
+
+		return *m_large_storage;
+	}
+
 void
 storage_t::try_switch_to_smaller_storage()
 	{
@@ -260,7 +287,7 @@ adaptive_subscription_storage_factory(
 							threshold,
 							vector_based_subscription_storage_factory(
 									threshold )( owner ),
-							map_based_subscription_storage_factory()( owner ) ) );
+							map_based_subscription_storage_factory() ) );
 		};
 	}
 
@@ -276,7 +303,7 @@ adaptive_subscription_storage_factory(
 							owner,
 							threshold,
 							small_storage_factory( owner ),
-							large_storage_factory( owner ) ) );
+							large_storage_factory ) );
 		};
 	}
 
@@ -0,0 +1,583 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \file
+ * \brief A flat hash-table-based storage for agent's subscriptions
+ * information.
+ */
+
+#include <so_5/rt/impl/h/subscription_storage_iface.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <so_5/details/h/rollback_on_exception.hpp>
+
+namespace so_5
+{
+
+namespace impl
+{
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief A flat hash-table-based storage for agent's subscriptions
+ * information.
+ */
+namespace flat_hash_subscr_storage
+{
+
+namespace
+{
+
+//! Mixing of bits of integer value.
+/*!
+ * Finalizer from MurmurHash3.
+ */
+inline std::uint64_t
+mix( std::uint64_t v )
+	{
+		v ^= v >> 33;
+		v *= 0xff51afd7ed558ccdull;
+		v ^= v >> 33;
+		v *= 0xc4ceb9fe1a85ec53ull;
+		v ^= v >> 33;
+		return v;
+	}
+
+//! Capacity of open-addressing table for the specified count of items.
+/*!
+ * Capacity is always a power of two and the half of slots is free.
+ */
+inline std::size_t
+capacity_for( std::size_t items )
+	{
+		std::size_t capacity = 16u;
+		while( capacity < items * 2u )
+			capacity <<= 1;
+		return capacity;
+	}
+
+} /* namespace anonymous */
+
+//
+// key_t
+//
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Subscription key type.
+ */
+struct key_t
+	{
+		//! Unique ID of mbox.
+		mbox_id_t m_mbox_id;
+		//! State of agent.
+		/*!
+		 * Value nullptr is used as a mark of empty slot.
+		 */
+		const state_t * m_state;
+		//! ID of message type.
+		msg_type_id_t m_type_id;
+
+		bool
+		operator==( const key_t & o ) const SO_5_NOEXCEPT
+			{
+				return m_mbox_id == o.m_mbox_id &&
+						m_state == o.m_state &&
+						m_type_id == o.m_type_id;
+			}
+
+		std::uint64_t
+		hash() const SO_5_NOEXCEPT
+			{
+				return mix( m_mbox_id ^
+						( std::uint64_t{ m_type_id } << 40 ) ^
+						reinterpret_cast< std::uintptr_t >( m_state ) );
+			}
+	};
+
+//
+// table_t
+//
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Open-addressing hash table with linear probing for
+ * event handlers.
+ *
+ * Keys and event handlers are stored inline in the table.
+ * Deletion is performed by backward shifting of the following items,
+ * so there is no need in tombstones.
+ */
+class table_t
+	{
+	public :
+		//! One slot of the table.
+		struct slot_t
+			{
+				key_t m_key{ null_mbox_id(), nullptr, 0 };
+				event_handler_data_t m_handler{
+						event_handler_method_t{}, thread_safety_t::unsafe };
+
+				bool
+				empty() const SO_5_NOEXCEPT { return !m_key.m_state; }
+			};
+
+		using slots_t = std::vector< slot_t >;
+
+		const slot_t *
+		find( const key_t & key ) const SO_5_NOEXCEPT
+			{
+				if( m_slots.empty() )
+					return nullptr;
+
+				for( auto index = home_of( key ); ; index = next( index ) )
+					{
+						const auto & slot = m_slots[ index ];
+						if( slot.empty() )
+							return nullptr;
+						else if( slot.m_key == key )
+							return &slot;
+					}
+			}
+
+		//! Insert new item.
+		/*!
+		 * \attention
+		 * There must not be an item with the same key.
+		 */
+		void
+		insert( const key_t & key, event_handler_data_t handler )
+			{
+				if( m_slots.size() < ( m_size + 1u ) * 2u )
+					rehash( capacity_for( m_size + 1u ) );
+
+				auto index = home_of( key );
+				while( !m_slots[ index ].empty() )
+					index = next( index );
+
+				auto & slot = m_slots[ index ];
+				slot.m_handler = std::move( handler );
+				slot.m_key = key;
+				++m_size;
+			}
+
+		//! Remove item.
+		/*!
+		 * \retval true if item was found and removed.
+		 */
+		bool
+		erase( const key_t & key ) SO_5_NOEXCEPT
+			{
+				auto slot = find( key );
+				if( !slot )
+					return false;
+
+				auto hole = static_cast< std::size_t >( slot - m_slots.data() );
+				for( auto index = next( hole );
+						!m_slots[ index ].empty();
+						index = next( index ) )
+					{
+						const auto home = home_of( m_slots[ index ].m_key );
+						// Item must be moved to the hole if its home slot
+						// is not in the cyclic range (hole, index].
+						const bool stays = hole <= index ?
+								( hole < home && home <= index ) :
+								( hole < home || home <= index );
+						if( !stays )
+							{
+								m_slots[ hole ] = std::move( m_slots[ index ] );
+								hole = index;
+							}
+					}
+
+				m_slots[ hole ] = slot_t{};
+				--m_size;
+
+				return true;
+			}
+
+		std::size_t
+		size() const SO_5_NOEXCEPT { return m_size; }
+
+		const slots_t &
+		slots() const SO_5_NOEXCEPT { return m_slots; }
+
+		void
+		swap( table_t & o ) SO_5_NOEXCEPT
+			{
+				m_slots.swap( o.m_slots );
+				std::swap( m_size, o.m_size );
+			}
+
+	private :
+		slots_t m_slots;
+		std::size_t m_size = 0;
+
+		std::size_t
+		home_of( const key_t & key ) const SO_5_NOEXCEPT
+			{
+				return static_cast< std::size_t >( key.hash() ) &
+						( m_slots.size() - 1u );
+			}
+
+		std::size_t
+		next( std::size_t index ) const SO_5_NOEXCEPT
+			{
+				return ( index + 1u ) & ( m_slots.size() - 1u );
+			}
+
+		void
+		rehash( std::size_t capacity )
+			{
+				slots_t fresh( capacity );
+				m_slots.swap( fresh );
+
+				for( auto & s : fresh )
+					if( !s.empty() )
+						{
+							auto index = home_of( s.m_key );
+							while( !m_slots[ index ].empty() )
+								index = next( index );
+							m_slots[ index ] = std::move( s );
+						}
+			}
+	};
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief A flat hash-table-based storage for agent's subscriptions
+ * information.
+ *
+ * In contrast to hash_table_subscr_storage::storage_t there is only one
+ * hash table with inline keys.
+ *
+ * Mbox references are stored only once for every (mbox, msg_type) pair.
+ */
+class storage_t : public subscription_storage_t
+	{
+	public :
+		storage_t( agent_t * owner );
+		~storage_t() override;
+
+		virtual void
+		create_event_subscription(
+			const mbox_t & mbox_ref,
+			const std::type_index & type_index,
+			const message_limit::control_block_t * limit,
+			const state_t & target_state,
+			const event_handler_method_t & method,
+			thread_safety_t thread_safety ) override;
+
+		virtual void
+		drop_subscription(
+			const mbox_t & mbox_ref,
+			const std::type_index & type_index,
+			const state_t & target_state ) override;
+
+		void
+		drop_subscription_for_all_states(
+			const mbox_t & mbox_ref,
+			const std::type_index & type_index ) override;
+
+		const event_handler_data_t *
+		find_handler(
+			mbox_id_t mbox_id,
+			msg_type_id_t msg_type_id,
+			const state_t & current_state ) const SO_5_NOEXCEPT override;
+
+		void
+		debug_dump( std::ostream & to ) const override;
+
+		void
+		drop_content() override;
+
+		subscription_storage_common::subscr_info_vector_t
+		query_content() const override;
+
+		void
+		setup_content(
+			subscription_storage_common::subscr_info_vector_t && info ) override;
+
+		std::size_t
+		query_subscriptions_count() const override;
+
+	private :
+		//! Information about subscriptions for (mbox, msg_type) pair.
+		struct pair_info_t
+			{
+				//! Reference to mbox.
+				/*!
+				 * Reference must be stored because we must have
+				 * access to mbox during destroyment of all
+				 * subscriptions in destructor.
+				 */
+				mbox_t m_mbox;
+				//! Type of message.
+				std::type_index m_msg_type;
+				//! Count of subscriptions for that pair.
+				std::size_t m_subscriptions;
+			};
+
+		//! Type of map for (mbox, msg_type) pairs.
+		using pairs_map_t = std::map<
+				std::pair< mbox_id_t, msg_type_id_t >,
+				pair_info_t >;
+
+		//! Event handlers.
+		table_t m_table;
+
+		//! Known (mbox, msg_type) pairs.
+		pairs_map_t m_pairs;
+
+		void
+		destroy_all_subscriptions();
+	};
+
+storage_t::storage_t( agent_t * owner )
+	:	subscription_storage_t( owner )
+	{}
+
+storage_t::~storage_t()
+	{
+		destroy_all_subscriptions();
+	}
+
+void
+storage_t::create_event_subscription(
+	const mbox_t & mbox_ref,
+	const std::type_index & type_index,
+	const message_limit::control_block_t * limit,
+	const state_t & target_state,
+	const event_handler_method_t & method,
+	thread_safety_t thread_safety )
+	{
+		using namespace subscription_storage_common;
+
+		const key_t key{
+				mbox_ref->id(), &target_state, so_5::msg_type_id( type_index ) };
+
+		if( m_table.find( key ) )
+			SO_5_THROW_EXCEPTION(
+				rc_evt_handler_already_provided,
+				"agent is already subscribed to message, " +
+				make_subscription_description( mbox_ref, type_index, target_state ) );
+
+		const auto pair_key = std::make_pair( key.m_mbox_id, key.m_type_id );
+		auto pair_it = m_pairs.find( pair_key );
+		const bool mbox_msg_known = m_pairs.end() != pair_it;
+		if( !mbox_msg_known )
+			pair_it = m_pairs.emplace(
+					pair_key, pair_info_t{ mbox_ref, type_index, 0u } ).first;
+
+		so_5::details::do_with_rollback_on_exception(
+			[&] {
+				m_table.insert( key, event_handler_data_t( method, thread_safety ) );
+				++(pair_it->second.m_subscriptions);
+			},
+			[&] {
+				if( !mbox_msg_known )
+					m_pairs.erase( pair_it );
+			} );
+
+		if( !mbox_msg_known )
+		{
+			// Mbox must create subscription.
+			so_5::details::do_with_rollback_on_exception(
+				[&] {
+					mbox_ref->subscribe_event_handler(
+							type_index, limit, owner() );
+				},
+				[&] {
+					m_table.erase( key );
+					m_pairs.erase( pair_it );
+				} );
+		}
+	}
+
+void
+storage_t::drop_subscription(
+	const mbox_t & mbox_ref,
+	const std::type_index & type_index,
+	const state_t & target_state )
+	{
+		const auto type_id = so_5::msg_type_id( type_index );
+
+		const key_t key{ mbox_ref->id(), &target_state, type_id };
+		if( m_table.erase( key ) )
+		{
+			auto it = m_pairs.find( std::make_pair( key.m_mbox_id, type_id ) );
+			if( 0u == --(it->second.m_subscriptions) )
+			{
+				m_pairs.erase( it );
+				mbox_ref->unsubscribe_event_handlers( type_index, owner() );
+			}
+		}
+	}
+
+void
+storage_t::drop_subscription_for_all_states(
+	const mbox_t & mbox_ref,
+	const std::type_index & type_index )
+	{
+		const auto type_id = so_5::msg_type_id( type_index );
+
+		auto it = m_pairs.find( std::make_pair( mbox_ref->id(), type_id ) );
+		if( m_pairs.end() == it )
+			return;
+
+		std::vector< key_t > keys;
+		keys.reserve( it->second.m_subscriptions );
+		for( const auto & s : m_table.slots() )
+			if( !s.empty() &&
+					s.m_key.m_mbox_id == it->first.first &&
+					s.m_key.m_type_id == type_id )
+				keys.push_back( s.m_key );
+
+		for( const auto & k : keys )
+			m_table.erase( k );
+
+		m_pairs.erase( it );
+
+		mbox_ref->unsubscribe_event_handlers( type_index, owner() );
+	}
+
+const event_handler_data_t *
+storage_t::find_handler(
+	mbox_id_t mbox_id,
+	msg_type_id_t msg_type_id,
+	const state_t & current_state ) const SO_5_NOEXCEPT
+	{
+		auto slot = m_table.find( key_t{ mbox_id, &current_state, msg_type_id } );
+		if( slot )
+			return &(slot->m_handler);
+		else
+			return nullptr;
+	}
+
+void
+storage_t::debug_dump( std::ostream & to ) const
+	{
+		for( const auto & s : m_table.slots() )
+			if( !s.empty() )
+				to << "{" << s.m_key.m_mbox_id << ", "
+						<< m_pairs.find( std::make_pair(
+								s.m_key.m_mbox_id,
+								s.m_key.m_type_id ) )->second.m_msg_type.name() << ", "
+						<< s.m_key.m_state->query_name() << "}"
+						<< std::endl;
+	}
+
+void
+storage_t::destroy_all_subscriptions()
+	{
+		for( auto & p : m_pairs )
+			p.second.m_mbox->unsubscribe_event_handlers(
+					p.second.m_msg_type,
+					owner() );
+
+		drop_content();
+	}
+
+void
+storage_t::drop_content()
+	{
+		table_t tmp_table;
+		m_table.swap( tmp_table );
+
+		pairs_map_t tmp_pairs;
+		m_pairs.swap( tmp_pairs );
+	}
+
+subscription_storage_common::subscr_info_vector_t
+storage_t::query_content() const
+	{
+		using namespace subscription_storage_common;
+
+		subscr_info_vector_t events;
+
+		if( m_table.size() )
+			{
+				events.reserve( m_table.size() );
+
+				for( const auto & s : m_table.slots() )
+					if( !s.empty() )
+						{
+							const auto & pair_info = m_pairs.find(
+									std::make_pair(
+											s.m_key.m_mbox_id,
+											s.m_key.m_type_id ) )->second;
+
+							events.emplace_back(
+									pair_info.m_mbox,
+									pair_info.m_msg_type,
+									*(s.m_key.m_state),
+									s.m_handler.m_method,
+									s.m_handler.m_thread_safety );
+						}
+			}
+
+		return events;
+	}
+
+void
+storage_t::setup_content(
+	subscription_storage_common::subscr_info_vector_t && info )
+	{
+		table_t fresh_table;
+		pairs_map_t fresh_pairs;
+
+		for( const auto & i : info )
+			{
+				const key_t key{
+						i.m_mbox->id(),
+						i.m_state,
+						i.m_msg_type_id };
+
+				fresh_table.insert( key, i.m_handler );
+
+				auto & pair_info = fresh_pairs.emplace(
+						std::make_pair( key.m_mbox_id, key.m_type_id ),
+						pair_info_t{ i.m_mbox, i.m_msg_type, 0u } ).first->second;
+				++pair_info.m_subscriptions;
+			}
+
+		m_table.swap( fresh_table );
+		m_pairs.swap( fresh_pairs );
+	}
+
+std::size_t
+storage_t::query_subscriptions_count() const
+	{
+		return m_table.size();
+	}
+
+} /* namespace flat_hash_subscr_storage */
+
+} /* namespace impl */
+
+SO_5_FUNC subscription_storage_factory_t
+flat_hash_subscription_storage_factory()
+	{
+		return []( agent_t * owner ) {
+			return impl::subscription_storage_unique_ptr_t(
+					new impl::flat_hash_subscr_storage::storage_t( owner ) );
+		};
+	}
+
+} /* namespace so_5 */
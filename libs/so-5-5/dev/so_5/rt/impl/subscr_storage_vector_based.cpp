@@ -77,7 +77,7 @@ class storage_t : public subscription_storage_t
 		const event_handler_data_t *
 		find_handler(
 			mbox_id_t mbox_id,
-			const std::type_index & msg_type,
+			msg_type_id_t msg_type_id,
 			const state_t & current_state ) const SO_5_NOEXCEPT override;
 
 		void
@@ -106,16 +106,28 @@ class storage_t : public subscription_storage_t
 		struct is_same_mbox_msg
 			{
 				const mbox_id_t m_id;
-				const std::type_index & m_type;
+				const msg_type_id_t m_type_id;
 
 				bool
 				operator()( const info_t & info ) const
 					{
-						return m_id == info.m_mbox->id() &&
-								m_type == info.m_msg_type;
+						return m_type_id == info.m_msg_type_id &&
+								m_id == info.m_mbox->id();
 					}
 			};
 
+		/*!
+		 * \brief Capacity to be reserved at the first subscription.
+		 *
+		 * \note Before v.5.5.25 the capacity was reserved in the
+		 * constructor. It led to memory consumption for agents
+		 * without subscriptions.
+		 *
+		 * \since
+		 * v.5.5.25
+		 */
+		const std::size_t m_initial_capacity;
+
 		//! Subscription information.
 		subscr_info_vector_t m_events;
 
@@ -129,16 +141,16 @@ namespace
 	auto
 	find( Container & c,
 		const mbox_id_t & mbox_id,
-		const std::type_index & msg_type,
+		msg_type_id_t msg_type_id,
 		const state_t & target_state ) -> decltype( c.begin() )
 		{
 			using namespace std;
 
 			return find_if( begin( c ), end( c ),
 				[&]( typename Container::value_type const & o ) {
-					return ( o.m_mbox->id() == mbox_id &&
-						o.m_msg_type == msg_type &&
-						o.m_state == &target_state );
+					return ( o.m_msg_type_id == msg_type_id &&
+						o.m_state == &target_state &&
+						o.m_mbox->id() == mbox_id );
 				} );
 		}
 
@@ -148,9 +160,8 @@ storage_t::storage_t(
 	agent_t * owner,
 	std::size_t initial_capacity )
 	:	subscription_storage_t( owner )
-	{
-		m_events.reserve( initial_capacity );
-	}
+	,	m_initial_capacity( initial_capacity )
+	{}
 
 storage_t::~storage_t()
 	{
@@ -170,10 +181,11 @@ storage_t::create_event_subscription(
 		using namespace subscription_storage_common;
 
 		const auto mbox_id = mbox->id();
+		const auto msg_type_id = so_5::msg_type_id( msg_type );
 
 		// Check that this subscription is new.
 		auto existed_position = find(
-				m_events, mbox_id, msg_type, target_state );
+				m_events, mbox_id, msg_type_id, target_state );
 
 		if( existed_position != m_events.end() )
 			SO_5_THROW_EXCEPTION(
@@ -181,6 +193,9 @@ storage_t::create_event_subscription(
 				"agent is already subscribed to message, " +
 				make_subscription_description( mbox, msg_type, target_state ) );
 
+		if( m_events.empty() )
+			m_events.reserve( m_initial_capacity );
+
 		// Just add subscription to the end.
 		m_events.emplace_back(
 				mbox, msg_type, target_state, method, thread_safety );
@@ -195,7 +210,7 @@ storage_t::create_event_subscription(
 		auto last_to_check = --end( m_events );
 		if( last_to_check == find_if(
 				begin( m_events ), last_to_check,
-				is_same_mbox_msg{ mbox_id, msg_type } ) )
+				is_same_mbox_msg{ mbox_id, msg_type_id } ) )
 			{
 				// Mbox must create subscription.
 				so_5::details::do_with_rollback_on_exception(
@@ -220,9 +235,10 @@ storage_t::drop_subscription(
 		using namespace std;
 
 		const auto mbox_id = mbox->id();
+		const auto msg_type_id = so_5::msg_type_id( msg_type );
 
 		auto existed_position = find(
-				m_events, mbox_id, msg_type, target_state );
+				m_events, mbox_id, msg_type_id, target_state );
 		if( existed_position != m_events.end() )
 			{
 				m_events.erase( existed_position );
@@ -235,7 +251,7 @@ storage_t::drop_subscription(
 				// the mbox must remove information about that agent.
 				if( end( m_events ) == find_if(
 						begin( m_events ), end( m_events ),
-						is_same_mbox_msg{ mbox_id, msg_type } ) )
+						is_same_mbox_msg{ mbox_id, msg_type_id } ) )
 					{
 						// If we are here then there is no more references
 						// to the mbox. And mbox must not hold reference
@@ -252,16 +268,12 @@ storage_t::drop_subscription_for_all_states(
 	{
 		using namespace std;
 
-		const auto mbox_id = mbox->id();
-
 		const auto old_size = m_events.size();
 
 		m_events.erase(
 				remove_if( begin( m_events ), end( m_events ),
-						[mbox_id, &msg_type]( const info_t & i ) {
-							return i.m_mbox->id() == mbox_id &&
-									i.m_msg_type == msg_type;
-						} ),
+						is_same_mbox_msg{
+								mbox->id(), so_5::msg_type_id( msg_type ) } ),
 				end( m_events ) );
 
 		// Note: since v.5.5.9 mbox unsubscription is initiated even if
@@ -275,10 +287,10 @@ storage_t::drop_subscription_for_all_states(
 const event_handler_data_t *
 storage_t::find_handler(
 	mbox_id_t mbox_id,
-	const std::type_index & msg_type,
+	msg_type_id_t msg_type_id,
 	const state_t & current_state ) const SO_5_NOEXCEPT
 	{
-		auto it = find( m_events, mbox_id, msg_type, current_state );
+		auto it = find( m_events, mbox_id, msg_type_id, current_state );
 
 		if( it != std::end( m_events ) )
 			return &(it->m_handler);
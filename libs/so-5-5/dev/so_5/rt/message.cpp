@@ -16,6 +16,9 @@ message_t::message_t()
 {
 }
 
+// NOTE: metadata isn't copied by copy/move constructors and operators.
+// A copy of a message is a new message and a deadline or a conflation
+// key of the original message has no sense for it.
 message_t::message_t( const message_t & other )
 	:	atomic_refcounted_t()
 	,	m_mutability( other.m_mutability )
@@ -11,6 +11,7 @@
 
 #include <so_5/rt/h/message_limit.hpp>
 
+#include <so_5/rt/impl/h/message_limit_internals.hpp>
 #include <so_5/rt/impl/h/message_limit_action_msg_tracer.hpp>
 #include <so_5/rt/impl/h/enveloped_msg_details.hpp>
 
@@ -24,6 +25,10 @@
 #include <so_5/details/h/abort_on_fatal_error.hpp>
 
 #include <sstream>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstdint>
 
 namespace so_5
 {
@@ -121,6 +126,165 @@ redirect_reaction(
 
 namespace {
 
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Synchronization objects for senders which wait for free space.
+ *
+ * There is no mutex and condition variable in every control_block.
+ * Instead a fixed set of stripes is used. A stripe for control_block
+ * is selected by the address of control_block.
+ */
+struct wait_stripe_t
+	{
+		std::mutex m_lock;
+		std::condition_variable m_wakeup_cv;
+	};
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Get a stripe for the control_block.
+ */
+wait_stripe_t &
+wait_stripe_for( const control_block_t & limit )
+	{
+		static const std::size_t stripes_count = 64;
+		static wait_stripe_t stripes[ stripes_count ];
+
+		const auto addr = reinterpret_cast< std::uintptr_t >( &limit );
+		return stripes[ (addr / control_block_t::cache_line_size) %
+				stripes_count ];
+	}
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief An attempt to occupy a place in the receiver's queue.
+ *
+ * \note Must be called when the stripe's mutex is locked.
+ */
+bool
+try_occupy_place(
+	const control_block_t & limit,
+	unsigned int low_water_mark )
+	{
+		if( limit.m_count.load() < low_water_mark )
+			{
+				if( ++(limit.m_count) <= limit.m_limit )
+					return true;
+
+				// NOTE: control_block_t::decrement can't be used here
+				// because it can try to lock the stripe's mutex.
+				// There is no need to wake up anyone because the count
+				// returns to a value which is not less than the limit.
+				--(limit.m_count);
+			}
+
+		return false;
+	}
+
+void
+throw_exception_about_wait_on_receiver_thread(
+	const overlimit_context_t & ctx )
+	{
+		std::ostringstream ss;
+		ss << "waiting for free space on an agent's working thread "
+				"can lead to a deadlock;"
+				<< " msg_type: " << ctx.m_msg_type.name()
+				<< ", limit: " << ctx.m_limit.m_limit
+				<< ", agent: " << &(ctx.m_receiver);
+		SO_5_THROW_EXCEPTION(
+				rc_message_limit_wait_on_receiver_thread,
+				ss.str() );
+	}
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief The active deferred_waits_t object for the current thread.
+ */
+thread_local deferred_waits_t * current_deferred_waits = nullptr;
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Is a message from the timer thread delivered right now?
+ */
+thread_local bool timer_delivery_in_progress = false;
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Actual waiting for free space in the receiver's queue.
+ *
+ * \note Must be called when no mbox's lock is held.
+ */
+void
+do_wait( const deferred_waits_t::item_t & item )
+	{
+		const auto & limit = *(item.m_limit);
+		auto & stripe = wait_stripe_for( limit );
+
+		bool place_occupied = false;
+		{
+			std::unique_lock< std::mutex > lock{ stripe.m_lock };
+
+			limit.m_wakeup_threshold.store(
+					item.m_low_water_mark, std::memory_order_relaxed );
+			++(limit.m_waiting_senders);
+
+			for(;;)
+				{
+					place_occupied = try_occupy_place(
+							limit, item.m_low_water_mark );
+					if( place_occupied ||
+							std::chrono::steady_clock::now() >= item.m_deadline )
+						break;
+
+					stripe.m_wakeup_cv.wait_until( lock, item.m_deadline );
+				}
+
+			--(limit.m_waiting_senders);
+		}
+
+		if( !place_occupied )
+			{
+				// There is no free space in the receiver's queue.
+				// Message is dropped.
+				if( item.m_msg_tracer )
+					item.m_msg_tracer->reaction_drop_message(
+							item.m_receiver.get() );
+			}
+		else
+			{
+				try
+					{
+						if( item.m_msg_tracer )
+							item.m_msg_tracer->reaction_push_after_wait(
+									item.m_receiver.get() );
+
+						agent_t::call_push_event(
+								*(item.m_receiver),
+								&limit,
+								item.m_mbox_id,
+								item.m_msg_type,
+								item.m_message );
+					}
+				catch( ... )
+					{
+						control_block_t::decrement( &limit );
+						throw;
+					}
+			}
+	}
+
 void
 throw_exception_about_service_request_transformation(
 	const overlimit_context_t & ctx )
@@ -137,6 +301,154 @@ throw_exception_about_service_request_transformation(
 
 } /* namespace anonymous */
 
+SO_5_FUNC
+void
+notify_waiting_senders( const control_block_t & limit ) SO_5_NOEXCEPT
+	{
+		auto & stripe = wait_stripe_for( limit );
+
+		// Mutex must be locked to avoid a lost wakeup for a sender
+		// which checks the count right now.
+		std::lock_guard< std::mutex > lock{ stripe.m_lock };
+		stripe.m_wakeup_cv.notify_all();
+	}
+
+SO_5_FUNC
+void
+wait_reaction(
+	const overlimit_context_t & ctx,
+	unsigned int low_water_mark,
+	std::chrono::steady_clock::duration timeout )
+	{
+		if( agent_t::is_agent_event_handled_on_current_thread() )
+			throw_exception_about_wait_on_receiver_thread( ctx );
+
+		// The timer thread must not be blocked.
+		// A message from the timer is dropped instead of waiting.
+		if( timer_delivery_scope_t::active() )
+			{
+				drop_message_reaction( ctx );
+				return;
+			}
+
+		deferred_waits_t::item_t item{
+				agent_ref_t{ const_cast< agent_t * >( &ctx.m_receiver ) },
+				&ctx.m_limit,
+				ctx.m_mbox_id,
+				ctx.m_msg_type,
+				ctx.m_message,
+				ctx.m_msg_tracer,
+				low_water_mark,
+				std::chrono::steady_clock::now() + timeout };
+
+		// If the reaction is called inside mbox's delivery procedure
+		// the waiting will be performed after the release of mbox's lock.
+		auto * waits = deferred_waits_t::current();
+		if( waits )
+			waits->add( std::move( item ) );
+		else
+			do_wait( item );
+	}
+
+//
+// deferred_waits_t
+//
+deferred_waits_t::deferred_waits_t()
+	:	m_previous( current_deferred_waits )
+	{
+		current_deferred_waits = this;
+	}
+
+deferred_waits_t::~deferred_waits_t()
+	{
+		// Waits which are not performed yet are just discarded.
+		// It is possible only if an exception is thrown during the delivery.
+		deactivate();
+	}
+
+deferred_waits_t *
+deferred_waits_t::current() SO_5_NOEXCEPT
+	{
+		return current_deferred_waits;
+	}
+
+void
+deferred_waits_t::add( item_t item )
+	{
+		m_items.push_back( std::move( item ) );
+	}
+
+void
+deferred_waits_t::perform()
+	{
+		deactivate();
+
+		if( m_items.empty() )
+			return;
+
+		if( m_previous )
+			{
+				// The outer mbox still holds its lock.
+				// The waiting will be performed by the outer object.
+				for( auto & item : m_items )
+					{
+						item.m_msg_tracer = nullptr;
+						m_previous->add( std::move( item ) );
+					}
+			}
+		else
+			{
+				std::exception_ptr first_exception;
+				for( const auto & item : m_items )
+					{
+						try
+							{
+								do_wait( item );
+							}
+						catch( ... )
+							{
+								if( !first_exception )
+									first_exception = std::current_exception();
+							}
+					}
+
+				if( first_exception )
+					std::rethrow_exception( first_exception );
+			}
+
+		m_items.clear();
+	}
+
+void
+deferred_waits_t::deactivate() SO_5_NOEXCEPT
+	{
+		if( m_active )
+			{
+				current_deferred_waits = m_previous;
+				m_active = false;
+			}
+	}
+
+//
+// timer_delivery_scope_t
+//
+timer_delivery_scope_t::timer_delivery_scope_t() SO_5_NOEXCEPT
+	:	m_previous( timer_delivery_in_progress )
+	{
+		timer_delivery_in_progress = true;
+	}
+
+timer_delivery_scope_t::~timer_delivery_scope_t() SO_5_NOEXCEPT
+	{
+		timer_delivery_in_progress = m_previous;
+	}
+
+bool
+timer_delivery_scope_t::active() SO_5_NOEXCEPT
+	{
+		return timer_delivery_in_progress;
+	}
+
 SO_5_FUNC
 void
 ensure_event_transform_reaction(
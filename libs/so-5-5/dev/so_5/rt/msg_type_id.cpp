@@ -0,0 +1,250 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Process-wide numeric identifiers for message types.
+ *
+ * \since
+ * v.5.5.25
+ */
+
+#include <so_5/rt/h/msg_type_id.hpp>
+
+#include <so_5/h/exception.hpp>
+#include <so_5/h/ret_code.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace so_5
+{
+
+namespace
+{
+
+//
+// registry_t
+//
+/*!
+ * \brief Registry of numeric identifiers for message types.
+ *
+ * The address of the type's name is used as a key for search.
+ * Keys are stored in an open-addressing table which can be read without
+ * locks. New keys are added under the lock. When the table grows a new
+ * table is created and published. Old tables are not destroyed because
+ * they can be in use by readers.
+ *
+ * There can be several type_info objects (and several type names) for
+ * one type. All of them receive the same identifier: unknown keys are
+ * checked by comparison of std::type_index values.
+ */
+class registry_t
+	{
+	public :
+		registry_t()
+			{
+				// Identifier 0 is reserved for null_msg_type_id().
+				m_types.push_back( typeid(void) );
+				publish( make_table( 64u ) );
+			}
+
+		msg_type_id_t
+		find_or_register( const std::type_index & msg_type )
+			{
+				msg_type_id_t id;
+				if( try_find( *(m_table.load( std::memory_order_acquire )),
+						msg_type.name(), id ) )
+					return id;
+
+				return register_key( msg_type );
+			}
+
+		std::type_index
+		type_by_id( msg_type_id_t id )
+			{
+				std::lock_guard< std::mutex > lock{ m_lock };
+
+				if( null_msg_type_id() == id || m_types.size() <= id )
+					SO_5_THROW_EXCEPTION( rc_unexpected_error,
+							"unknown msg_type_id: " + std::to_string( id ) );
+
+				return m_types[ id ];
+			}
+
+	private :
+		//! One slot of the table.
+		struct slot_t
+			{
+				//! Address of the type's name.
+				/*!
+				 * Value nullptr means that slot is empty.
+				 */
+				std::atomic< const char * > m_key{ nullptr };
+				//! Identifier for the type.
+				std::atomic< msg_type_id_t > m_id{ null_msg_type_id() };
+			};
+
+		//! Open-addressing table for keys.
+		struct table_t
+			{
+				const std::size_t m_mask;
+				std::unique_ptr< slot_t[] > m_slots;
+
+				table_t( std::size_t capacity )
+					:	m_mask( capacity - 1u )
+					,	m_slots( new slot_t[ capacity ] )
+					{}
+
+				std::size_t
+				home_of( const char * key ) const
+					{
+						auto v = static_cast< std::uint64_t >(
+								reinterpret_cast< std::uintptr_t >( key ) );
+						v ^= v >> 33;
+						v *= 0xff51afd7ed558ccdull;
+						v ^= v >> 33;
+						return static_cast< std::size_t >( v ) & m_mask;
+					}
+			};
+
+		//! The current table.
+		std::atomic< table_t * > m_table{ nullptr };
+
+		//! Object lock for modification of the registry.
+		std::mutex m_lock;
+
+		//! All tables created (the last one is the current).
+		std::vector< std::unique_ptr< table_t > > m_tables;
+
+		//! Count of keys in the current table.
+		std::size_t m_keys = 0;
+
+		//! Known types.
+		/*!
+		 * Index in that vector is the identifier of type.
+		 */
+		std::vector< std::type_index > m_types;
+
+		static bool
+		try_find(
+			const table_t & table,
+			const char * key,
+			msg_type_id_t & id )
+			{
+				for( auto index = table.home_of( key ); ;
+						index = ( index + 1u ) & table.m_mask )
+					{
+						const auto & slot = table.m_slots[ index ];
+						const char * k = slot.m_key.load( std::memory_order_acquire );
+						if( k == key )
+							{
+								id = slot.m_id.load( std::memory_order_relaxed );
+								return true;
+							}
+						else if( !k )
+							return false;
+					}
+			}
+
+		static void
+		place( table_t & table, const char * key, msg_type_id_t id )
+			{
+				auto index = table.home_of( key );
+				while( table.m_slots[ index ].m_key.load( std::memory_order_relaxed ) )
+					index = ( index + 1u ) & table.m_mask;
+
+				auto & slot = table.m_slots[ index ];
+				slot.m_id.store( id, std::memory_order_relaxed );
+				// Key must be published after the identifier.
+				slot.m_key.store( key, std::memory_order_release );
+			}
+
+		table_t *
+		make_table( std::size_t capacity )
+			{
+				m_tables.emplace_back( new table_t( capacity ) );
+				return m_tables.back().get();
+			}
+
+		void
+		publish( table_t * table )
+			{
+				m_table.store( table, std::memory_order_release );
+			}
+
+		msg_type_id_t
+		register_key( const std::type_index & msg_type )
+			{
+				std::lock_guard< std::mutex > lock{ m_lock };
+
+				auto * table = m_table.load( std::memory_order_relaxed );
+
+				// Key can be added by another thread.
+				msg_type_id_t id;
+				if( try_find( *table, msg_type.name(), id ) )
+					return id;
+
+				// Maybe it is a new type_info object for known type.
+				auto it = std::find(
+						m_types.begin() + 1, m_types.end(), msg_type );
+				if( it != m_types.end() )
+					id = static_cast< msg_type_id_t >( it - m_types.begin() );
+				else
+					{
+						id = static_cast< msg_type_id_t >( m_types.size() );
+						m_types.push_back( msg_type );
+					}
+
+				if( table->m_mask + 1u < ( m_keys + 1u ) * 2u )
+					{
+						auto * fresh = make_table( ( table->m_mask + 1u ) * 2u );
+						for( std::size_t i = 0; i <= table->m_mask; ++i )
+							{
+								const auto & slot = table->m_slots[ i ];
+								const char * k = slot.m_key.load(
+										std::memory_order_relaxed );
+								if( k )
+									place( *fresh, k, slot.m_id.load(
+											std::memory_order_relaxed ) );
+							}
+
+						publish( fresh );
+						table = fresh;
+					}
+
+				place( *table, msg_type.name(), id );
+				++m_keys;
+
+				return id;
+			}
+	};
+
+registry_t &
+registry()
+	{
+		static registry_t instance;
+		return instance;
+	}
+
+} /* namespace anonymous */
+
+SO_5_FUNC msg_type_id_t
+msg_type_id( const std::type_index & msg_type )
+	{
+		return registry().find_or_register( msg_type );
+	}
+
+SO_5_FUNC std::type_index
+msg_type_by_id( msg_type_id_t id )
+	{
+		return registry().type_by_id( id );
+	}
+
+} /* namespace so_5 */
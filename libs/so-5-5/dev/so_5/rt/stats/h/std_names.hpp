@@ -50,6 +50,16 @@ mbox_repository();
 SO_5_FUNC prefix_t
 timer_thread();
 
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Prefix of data sources with statistics for message delivery
+ * (for example, count of expired or conflated messages).
+ */
+SO_5_FUNC prefix_t
+message_delivery();
+
 } /* namespace prefixes */
 
 namespace suffixes {
@@ -167,6 +177,46 @@ timer_periodic_count();
 SO_5_FUNC suffix_t
 demand_quote();
 
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Suffix for data source with count of messages dropped
+ * because their deadlines passed.
+ */
+SO_5_FUNC suffix_t
+expired_message_count();
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Suffix for data source with count of messages replaced
+ * by newer messages with the same conflation key.
+ */
+SO_5_FUNC suffix_t
+conflated_message_count();
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Suffix for data source with count of working threads
+ * started by a dispatcher in elastic mode.
+ */
+SO_5_FUNC suffix_t
+disp_threads_added_count();
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief Suffix for data source with count of working threads
+ * retired by a dispatcher in elastic mode.
+ */
+SO_5_FUNC suffix_t
+disp_threads_retired_count();
+
 } /* namespace suffixes */
 
 } /* namespace stats */
@@ -0,0 +1,56 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \file
+ * \brief A data source class for run-time monitoring of message delivery.
+ */
+
+#include <so_5/rt/stats/impl/h/ds_message_delivery_stats.hpp>
+
+#include <so_5/rt/stats/h/messages.hpp>
+#include <so_5/rt/stats/h/std_names.hpp>
+
+#include <so_5/rt/h/send_functions.hpp>
+
+namespace so_5 {
+
+namespace stats {
+
+namespace impl {
+
+//
+// ds_message_delivery_stats_t
+//
+ds_message_delivery_stats_t::ds_message_delivery_stats_t(
+	const std::atomic< std::size_t > & expired_messages,
+	const std::atomic< std::size_t > & conflated_messages )
+	:	m_expired_messages( expired_messages )
+	,	m_conflated_messages( conflated_messages )
+	{}
+
+void
+ds_message_delivery_stats_t::distribute(
+	const mbox_t & distribution_mbox )
+	{
+		send< messages::quantity< std::size_t > >( distribution_mbox,
+				prefixes::message_delivery(),
+				suffixes::expired_message_count(),
+				m_expired_messages.load( std::memory_order_relaxed ) );
+
+		send< messages::quantity< std::size_t > >( distribution_mbox,
+				prefixes::message_delivery(),
+				suffixes::conflated_message_count(),
+				m_conflated_messages.load( std::memory_order_relaxed ) );
+	}
+
+} /* namespace impl */
+
+} /* namespace stats */
+
+} /* namespace so_5 */
+
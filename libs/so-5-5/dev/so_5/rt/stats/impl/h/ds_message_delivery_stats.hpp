@@ -0,0 +1,61 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \file
+ * \brief A data source class for run-time monitoring of message delivery.
+ */
+
+#pragma once
+
+#include <so_5/rt/stats/h/repository.hpp>
+
+#include <atomic>
+
+namespace so_5 {
+
+namespace stats {
+
+namespace impl {
+
+//
+// ds_message_delivery_stats_t
+//
+/*!
+ * \since
+ * v.5.5.25
+ *
+ * \brief A data source for distributing information about message delivery.
+ */
+class ds_message_delivery_stats_t final : public source_t
+	{
+	public :
+		ds_message_delivery_stats_t(
+			//! Counter of messages dropped because of expired deadlines.
+			//! This reference must stay valid during all lifetime of
+			//! the data source object.
+			const std::atomic< std::size_t > & expired_messages,
+			//! Counter of messages replaced by conflation.
+			//! This reference must stay valid during all lifetime of
+			//! the data source object.
+			const std::atomic< std::size_t > & conflated_messages );
+
+		void
+		distribute(
+			const mbox_t & distribution_mbox ) override;
+
+	private :
+		const std::atomic< std::size_t > & m_expired_messages;
+		const std::atomic< std::size_t > & m_conflated_messages;
+	};
+
+} /* namespace impl */
+
+} /* namespace stats */
+
+} /* namespace so_5 */
+
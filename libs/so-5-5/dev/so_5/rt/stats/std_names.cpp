@@ -36,6 +36,12 @@ timer_thread()
 		return prefix_t( "timer_thread" );
 	}
 
+SO_5_FUNC prefix_t
+message_delivery()
+	{
+		return prefix_t( "message_delivery" );
+	}
+
 } /* namespace prefixes */
 
 namespace suffixes {
@@ -116,6 +122,30 @@ demand_quote()
 		IMPL_SUFFIX( "/demands.quote" )
 	}
 
+SO_5_FUNC suffix_t
+expired_message_count()
+	{
+		IMPL_SUFFIX( "/expired_msgs.count" )
+	}
+
+SO_5_FUNC suffix_t
+conflated_message_count()
+	{
+		IMPL_SUFFIX( "/conflated_msgs.count" )
+	}
+
+SO_5_FUNC suffix_t
+disp_threads_added_count()
+	{
+		IMPL_SUFFIX( "/threads.added.count" )
+	}
+
+SO_5_FUNC suffix_t
+disp_threads_retired_count()
+	{
+		IMPL_SUFFIX( "/threads.retired.count" )
+	}
+
 #undef IMPL_SUFFIX
 
 } /* namespace suffixes */
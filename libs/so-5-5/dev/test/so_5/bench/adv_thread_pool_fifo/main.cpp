@@ -0,0 +1,261 @@
+/*
+ * A benchmark for adv_thread_pool dispatcher with mostly thread-safe
+ * event handlers.
+ *
+ * Two agents are registered in one coop on adv_thread_pool like in
+ * sample adv_thread_pool_fifo. Agent A handles thread-safe M1 and
+ * not-thread-safe M3. Agent B handles thread-safe M2. Producer threads
+ * send M1 and M2 alternately to a common mbox. Every N-th message can be
+ * replaced by M3.
+ */
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <cstdlib>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/benchmark_helpers.hpp>
+#include <various_helpers_1/cmd_line_args_helpers.hpp>
+
+struct cfg_t
+	{
+		std::size_t m_threads = 0;
+		std::size_t m_producers = 1;
+		std::size_t m_messages = 1000000;
+		std::size_t m_unsafe_every = 0;
+		std::size_t m_work = 0;
+		bool m_individual_fifo = false;
+	};
+
+std::size_t
+default_thread_pool_size()
+{
+	auto c = std::thread::hardware_concurrency();
+	if( !c )
+		c = 4;
+
+	return c;
+}
+
+cfg_t
+try_parse_cmdline(
+	int argc,
+	char ** argv )
+{
+	cfg_t tmp_cfg;
+
+	for( char ** current = &argv[ 1 ], **last = argv + argc;
+			current != last;
+			++current )
+		{
+			if( is_arg( *current, "-h", "--help" ) )
+				{
+					std::cout << "usage:\n"
+							"_test.bench.so_5.adv_thread_pool_fifo <options>\n"
+							"\noptions:\n"
+							"-t, --threads          size of thread pool\n"
+							"-p, --producers        count of producer threads\n"
+							"-m, --messages         count of messages from every producer\n"
+							"-u, --unsafe-every     every N-th message is not thread safe\n"
+							"                       (0 means that all messages are thread safe)\n"
+							"-w, --work             count of iterations of busy loop in handlers\n"
+							"-i, --individual-fifo  use individual FIFO for agents\n"
+							"-h, --help             show this description\n"
+							<< std::endl;
+					std::exit(1);
+				}
+			else if( is_arg( *current, "-t", "--threads" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_threads, ++current, last,
+						"-t", "size of thread pool" );
+
+			else if( is_arg( *current, "-p", "--producers" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_producers, ++current, last,
+						"-p", "count of producer threads" );
+
+			else if( is_arg( *current, "-m", "--messages" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_messages, ++current, last,
+						"-m", "count of messages from every producer" );
+
+			else if( is_arg( *current, "-u", "--unsafe-every" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_unsafe_every, ++current, last,
+						"-u", "every N-th message is not thread safe" );
+
+			else if( is_arg( *current, "-w", "--work" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_work, ++current, last,
+						"-w", "count of iterations of busy loop in handlers" );
+
+			else if( is_arg( *current, "-i", "--individual-fifo" ) )
+				tmp_cfg.m_individual_fifo = true;
+
+			else
+				throw std::runtime_error(
+						std::string( "unknown argument: " ) + *current );
+		}
+
+	if( !tmp_cfg.m_threads )
+		tmp_cfg.m_threads = default_thread_pool_size();
+
+	if( !tmp_cfg.m_producers || !tmp_cfg.m_messages )
+		throw std::runtime_error( "there must be at least one message" );
+
+	return tmp_cfg;
+}
+
+void
+show_cfg( const cfg_t & cfg )
+{
+	std::cout << "Configuration: "
+		<< "threads: " << cfg.m_threads
+		<< ", producers: " << cfg.m_producers
+		<< ", messages: " << cfg.m_messages
+		<< ", unsafe every: " << cfg.m_unsafe_every
+		<< ", work: " << cfg.m_work
+		<< ", FIFO: " << ( cfg.m_individual_fifo ? "individual" : "cooperation" )
+		<< std::endl;
+}
+
+struct M1 : public so_5::signal_t {};
+struct M2 : public so_5::signal_t {};
+struct M3 : public so_5::signal_t {};
+
+//! Shared data for all agents.
+class completion_t
+	{
+	public :
+		completion_t( std::size_t total, std::size_t work )
+			:	m_total( total )
+			,	m_work( work )
+			{}
+
+		std::future< void >
+		future()
+			{
+				return m_done.get_future();
+			}
+
+		void
+		handled()
+			{
+				// Imitation of some work.
+				volatile std::size_t dummy = 0;
+				for( std::size_t i = 0; i != m_work; ++i )
+					dummy = dummy + i;
+
+				if( m_total == ++m_handled )
+					m_done.set_value();
+			}
+
+	private :
+		const std::size_t m_total;
+		const std::size_t m_work;
+
+		std::atomic< std::size_t > m_handled{ 0 };
+
+		std::promise< void > m_done;
+	};
+
+class A final : public so_5::agent_t
+{
+public :
+	A( context_t ctx, const so_5::mbox_t & mbox, completion_t & completion )
+		:	so_5::agent_t{ ctx }
+	{
+		so_subscribe( mbox )
+			.event< M1 >( [&completion] { completion.handled(); },
+				so_5::thread_safe )
+			.event< M3 >( [&completion] { completion.handled(); } );
+	}
+};
+
+class B final : public so_5::agent_t
+{
+public :
+	B( context_t ctx, const so_5::mbox_t & mbox, completion_t & completion )
+		:	so_5::agent_t{ ctx }
+	{
+		so_subscribe( mbox )
+			.event< M2 >( [&completion] { completion.handled(); },
+				so_5::thread_safe );
+	}
+};
+
+void
+run_benchmark( const cfg_t & cfg )
+{
+	const auto total = cfg.m_producers * cfg.m_messages;
+	completion_t completion{ total, cfg.m_work };
+	auto done = completion.future();
+
+	so_5::wrapped_env_t sobj;
+	auto & env = sobj.environment();
+
+	namespace pool_disp = so_5::disp::adv_thread_pool;
+
+	const auto mbox = env.create_mbox();
+	env.introduce_coop(
+		pool_disp::create_private_disp( env, cfg.m_threads )->binder(
+			pool_disp::bind_params_t{}.fifo( cfg.m_individual_fifo ?
+					pool_disp::fifo_t::individual :
+					pool_disp::fifo_t::cooperation ) ),
+		[&]( so_5::coop_t & coop ) {
+			coop.make_agent< A >( mbox, completion );
+			coop.make_agent< B >( mbox, completion );
+		} );
+
+	benchmarker_t benchmarker;
+	benchmarker.start();
+
+	std::vector< std::thread > producers;
+	producers.reserve( cfg.m_producers );
+	for( std::size_t p = 0; p != cfg.m_producers; ++p )
+		producers.emplace_back( [&] {
+				for( std::size_t i = 0; i != cfg.m_messages; ++i )
+					{
+						if( cfg.m_unsafe_every && 0 == ( i + 1 ) % cfg.m_unsafe_every )
+							so_5::send< M3 >( mbox );
+						else if( i & 1u )
+							so_5::send< M2 >( mbox );
+						else
+							so_5::send< M1 >( mbox );
+					}
+			} );
+
+	for( auto & t : producers )
+		t.join();
+
+	done.wait();
+
+	benchmarker.finish_and_show_stats(
+			static_cast< unsigned long long >( total ), "messages" );
+
+	sobj.stop_then_join();
+}
+
+int
+main( int argc, char ** argv )
+{
+	try
+	{
+		cfg_t cfg = try_parse_cmdline( argc, argv );
+		show_cfg( cfg );
+
+		run_benchmark( cfg );
+
+		return 0;
+	}
+	catch( const std::exception & x )
+	{
+		std::cerr << "*** Exception caught: " << x.what() << std::endl;
+	}
+
+	return 2;
+}
@@ -0,0 +1,195 @@
+/*
+ * A tool for measurement of memory footprint of idle agents.
+ *
+ * Shows sizeof for agent_t and state_t and the amount of dynamic
+ * memory allocated for every idle agent (an agent without any
+ * subscriptions and states, which is registered and bound to
+ * a dispatcher).
+ */
+
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/cmd_line_args_helpers.hpp>
+
+//
+// Counters for the dynamic memory.
+//
+std::atomic< std::size_t > g_allocated_bytes{ 0 };
+std::atomic< std::size_t > g_allocations{ 0 };
+
+// A header before every block is used for storing block's size.
+const std::size_t header_size = alignof( std::max_align_t );
+
+void *
+operator new( std::size_t size )
+{
+	auto * block = static_cast< char * >( std::malloc( size + header_size ) );
+	if( !block )
+		throw std::bad_alloc();
+
+	*reinterpret_cast< std::size_t * >( block ) = size;
+	g_allocated_bytes += size;
+	++g_allocations;
+
+	return block + header_size;
+}
+
+void
+operator delete( void * p ) noexcept
+{
+	if( p )
+	{
+		auto * block = static_cast< char * >( p ) - header_size;
+		g_allocated_bytes -= *reinterpret_cast< std::size_t * >( block );
+		--g_allocations;
+		std::free( block );
+	}
+}
+
+void
+operator delete( void * p, std::size_t ) noexcept
+{
+	::operator delete( p );
+}
+
+void *
+operator new[]( std::size_t size ) { return ::operator new( size ); }
+
+void
+operator delete[]( void * p ) noexcept { ::operator delete( p ); }
+
+void
+operator delete[]( void * p, std::size_t ) noexcept { ::operator delete( p ); }
+
+struct cfg_t
+{
+	std::size_t m_agents = 100000;
+	bool m_use_arena = false;
+};
+
+cfg_t
+try_parse_cmdline(
+	int argc,
+	char ** argv )
+{
+	cfg_t tmp_cfg;
+
+	for( char ** current = &argv[ 1 ], **last = argv + argc;
+			current != last;
+			++current )
+		{
+			if( is_arg( *current, "-h", "--help" ) )
+				{
+					std::cout << "usage:\n"
+							"_test.bench.so_5.agent_footprint <options>\n"
+							"\noptions:\n"
+							"-n, --agents   count of agents to be created\n"
+							"-A, --arena    allocate agents in an arena\n"
+							"-h, --help     show this help"
+							<< std::endl;
+					std::exit( 1 );
+				}
+			else if( is_arg( *current, "-n", "--agents" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_agents, ++current, last,
+						"-n", "count of agents to be created" );
+			else if( is_arg( *current, "-A", "--arena" ) )
+				tmp_cfg.m_use_arena = true;
+			else
+				throw std::runtime_error(
+						std::string( "unknown argument: " ) + *current );
+		}
+
+	return tmp_cfg;
+}
+
+class a_idle_t final : public so_5::agent_t
+{
+public :
+	using so_5::agent_t::agent_t;
+};
+
+struct snapshot_t
+{
+	std::size_t m_bytes;
+	std::size_t m_allocations;
+
+	static snapshot_t
+	make()
+	{
+		return { g_allocated_bytes.load(), g_allocations.load() };
+	}
+};
+
+void
+show_per_agent(
+	const char * stage,
+	const snapshot_t & from,
+	const snapshot_t & to,
+	std::size_t agents )
+{
+	std::cout << stage << ": "
+		<< double( to.m_bytes - from.m_bytes ) / double( agents )
+		<< " bytes, "
+		<< double( to.m_allocations - from.m_allocations ) / double( agents )
+		<< " allocations per agent" << std::endl;
+}
+
+void
+run( const cfg_t & cfg )
+{
+	so_5::launch( [&cfg]( so_5::environment_t & env ) {
+		auto disp = so_5::disp::one_thread::create_private_disp( env );
+
+		const auto before_creation = snapshot_t::make();
+		auto coop = env.create_coop( so_5::autoname, disp->binder() );
+		if( cfg.m_use_arena )
+			coop->use_agent_arena( cfg.m_agents * ( sizeof( a_idle_t ) + 32u ) );
+		coop->reserve( cfg.m_agents );
+		for( std::size_t i = 0; i != cfg.m_agents; ++i )
+			coop->make_agent< a_idle_t >();
+		const auto after_creation = snapshot_t::make();
+
+		env.register_coop( std::move( coop ) );
+		const auto after_registration = snapshot_t::make();
+
+		show_per_agent( "creation", before_creation, after_creation,
+				cfg.m_agents );
+		show_per_agent( "registration", after_creation, after_registration,
+				cfg.m_agents );
+		show_per_agent( "total", before_creation, after_registration,
+				cfg.m_agents );
+
+		env.stop();
+	} );
+}
+
+int
+main( int argc, char ** argv )
+{
+	try
+	{
+		const cfg_t cfg = try_parse_cmdline( argc, argv );
+
+		std::cout << "sizeof(agent_t): " << sizeof( so_5::agent_t )
+			<< ", sizeof(state_t): " << sizeof( so_5::state_t )
+			<< ", agents: " << cfg.m_agents
+			<< ", arena: " << ( cfg.m_use_arena ? "yes" : "no" )
+			<< std::endl;
+
+		run( cfg );
+
+		return 0;
+	}
+	catch( const std::exception & x )
+	{
+		std::cerr << "*** Exception caught: " << x.what() << std::endl;
+	}
+
+	return 2;
+}
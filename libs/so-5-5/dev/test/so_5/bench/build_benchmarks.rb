@@ -14,8 +14,14 @@ MxxRu::Cpp::composite_target {
 	required_prj "#{path}/no_workload/prj.rb" 
 	required_prj "#{path}/agent_ring/prj.rb" 
 	required_prj "#{path}/coop_dereg/prj.rb" 
-	required_prj "#{path}/skynet1m/prj.rb" 
+	required_prj "#{path}/skynet1m/prj.rb"
+	required_prj "#{path}/agent_footprint/prj.rb" 
 	required_prj "#{path}/parallel_parent_child/prj.rb" 
 	required_prj "#{path}/prepared_receive/prj.rb" 
 	required_prj "#{path}/prepared_select/prj.rb" 
+	required_prj "#{path}/prio_one_thread_latency/prj.rb" 
+	required_prj "#{path}/adv_thread_pool_fifo/prj.rb" 
+	required_prj "#{path}/message_limits/prj.rb" 
+	required_prj "#{path}/keyed_mbox/prj.rb" 
+	required_prj "#{path}/load_balancing_mbox/prj.rb" 
 }
@@ -1,5 +1,11 @@
 /*
  * A simple benchmark for so_change_state() performance.
+ *
+ * Usage:
+ * _test.bench.so_5.change_state [iterations] [nested]
+ *
+ * If "nested" is specified then switching between nested states
+ * with on_enter/on_exit handlers is measured.
  */
 
 #include <iostream>
@@ -7,6 +13,8 @@
 #include <numeric>
 #include <chrono>
 #include <cstdlib>
+#include <cstring>
+#include <memory>
 
 #include <so_5/all.hpp>
 
@@ -20,10 +28,17 @@ class a_test_t
 	public :
 		a_test_t(
 			so_5::environment_t & env,
-			unsigned int iterations )
+			unsigned int iterations,
+			bool nested )
 			:	so_5::agent_t( env )
 			,	m_iterations( iterations )
 			{
+				if( nested )
+					{
+						make_nested_states();
+						return;
+					}
+
 				m_states.push_back( &st_0 );
 				m_states.push_back( &st_1 );
 				m_states.push_back( &st_2 );
@@ -70,6 +85,10 @@ class a_test_t
 
 				bench.finish_and_show_stats( changes, "changes" );
 
+				if( m_handlers_called )
+					std::cout << "on_enter/on_exit calls: "
+							<< m_handlers_called << std::endl;
+
 				so_environment().stop();
 			}
 
@@ -94,6 +113,54 @@ class a_test_t
 		unsigned int m_iterations;
 
 		std::vector< const so_5::state_t * > m_states;
+
+		// States for nested mode.
+		// There are two top-level states with two substates in every one.
+		// Every substate has two leaf substates.
+		std::vector< std::unique_ptr< so_5::state_t > > m_nested_states;
+
+		unsigned long long m_handlers_called = 0;
+
+		void
+		on_enter_or_exit()
+			{
+				++m_handlers_called;
+			}
+
+		so_5::state_t &
+		make_nested_state( so_5::state_t * parent, bool initial )
+			{
+				std::unique_ptr< so_5::state_t > st;
+				if( !parent )
+					st.reset( new so_5::state_t( this ) );
+				else if( initial )
+					st.reset( new so_5::state_t( initial_substate_of{ *parent } ) );
+				else
+					st.reset( new so_5::state_t( substate_of{ *parent } ) );
+
+				st->on_enter( &a_test_t::on_enter_or_exit )
+					.on_exit( &a_test_t::on_enter_or_exit );
+				st->event( &a_test_t::evt_dummy );
+
+				m_nested_states.push_back( std::move(st) );
+				return *m_nested_states.back();
+			}
+
+		void
+		make_nested_states()
+			{
+				for( int t = 0; t != 2; ++t )
+					{
+						auto & top = make_nested_state( nullptr, false );
+						for( int m = 0; m != 2; ++m )
+							{
+								auto & mid = make_nested_state( &top, 0 == m );
+								for( int l = 0; l != 2; ++l )
+									m_states.push_back(
+											&make_nested_state( &mid, 0 == l ) );
+							}
+					}
+			}
 	};
 
 int
@@ -101,15 +168,16 @@ main( int argc, char ** argv )
 {
 	try
 	{
-		const unsigned int tick_count = 2 == static_cast< unsigned int >(
-				argc ? std::atoi( argv[1] ) : 1000);
+		const unsigned int tick_count = argc > 1 ?
+				static_cast< unsigned int >( std::atoi( argv[1] ) ) : 1000u;
+		const bool nested = argc > 2 && 0 == std::strcmp( "nested", argv[2] );
 
 		so_5::launch(
-			[tick_count]( so_5::environment_t & env )
+			[tick_count, nested]( so_5::environment_t & env )
 			{
 				env.register_agent_as_coop(
 					"test",
-					new a_test_t( env, tick_count ) );
+					new a_test_t( env, tick_count, nested ) );
 			} );
 	}
 	catch( const std::exception & ex )
@@ -24,6 +24,8 @@ struct	cfg_t
 	unsigned int m_coop_size = 10;
 
 	dispatcher_type_t m_dispatcher_type = dispatcher_type_t::one_thread;
+
+	bool m_use_arena = false;
 };
 
 cfg_t
@@ -46,6 +48,7 @@ try_parse_cmdline(
 							"-a, --coop-size      size of every coop\n"
 							"-D, --dispatcher     type of dispatcher to be used:\n"
 							"                     one_thread, thread_pool\n"
+							"-A, --arena          allocate agents of every coop in an arena\n"
 							"-h, --help           show this help"
 							<< std::endl;
 					std::exit( 1 );
@@ -71,6 +74,8 @@ try_parse_cmdline(
 					else
 						throw std::runtime_error( "unsupported dispatcher type: " + name );
 				}
+			else if( is_arg( *current, "-A", "--arena" ) )
+				tmp_cfg.m_use_arena = true;
 			else
 				throw std::runtime_error(
 						std::string( "unknown argument: " ) + *current );
@@ -202,6 +207,9 @@ class a_benchmarker_t : public so_5::agent_t
 						m_binder_generator(),
 						[this]( so_5::coop_t & coop ) {
 							coop.set_parent_coop_name( m_root_coop_name );
+							if( m_cfg.m_use_arena )
+								coop.use_agent_arena( m_cfg.m_coop_size *
+										( sizeof( so_5::adhoc_agent_wrapper_t ) + 32u ) );
 							coop.add_reg_notificator(
 									so_5::make_coop_reg_notificator(
 											so_direct_mbox() ) );
@@ -257,6 +265,7 @@ show_cfg(
 			<< "coops: " << cfg.m_coop_count
 			<< ", agents_per_coop: " << cfg.m_coop_size
 			<< ", disp: " << dispatcher_type_name( cfg.m_dispatcher_type )
+			<< ", arena: " << ( cfg.m_use_arena ? "yes" : "no" )
 			<< std::endl;
 	}
 
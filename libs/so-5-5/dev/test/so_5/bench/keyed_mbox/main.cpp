@@ -0,0 +1,183 @@
+/*
+ * A benchmark for comparison of content-based routing via
+ * delivery filters and via keyed mbox.
+ *
+ * Usage:
+ * _test.bench.so_5.keyed_mbox [filter|keyed] [subscribers] [messages]
+ */
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/benchmark_helpers.hpp>
+
+struct cfg_t
+	{
+		bool m_keyed = true;
+		unsigned int m_subscribers = 10000;
+		unsigned int m_messages = 10000;
+	};
+
+struct msg_quote : public so_5::message_t
+	{
+		unsigned int m_instrument;
+
+		msg_quote( unsigned int instrument ) : m_instrument( instrument ) {}
+	};
+
+using keyed_mbox_ref_t = so_5::keyed_mbox::keyed_mbox_ref_t< unsigned int >;
+
+class a_subscriber_t
+	:	public so_5::agent_t
+	{
+	public :
+		a_subscriber_t(
+			context_t ctx,
+			unsigned int instrument,
+			so_5::mbox_t common_mbox,
+			keyed_mbox_ref_t keyed_mbox )
+			:	so_5::agent_t( ctx )
+			,	m_instrument( instrument )
+			,	m_common_mbox( std::move(common_mbox) )
+			,	m_keyed_mbox( std::move(keyed_mbox) )
+			{}
+
+		virtual void
+		so_define_agent() override
+			{
+				if( m_keyed_mbox )
+					so_subscribe( m_keyed_mbox->key_mbox( m_instrument ) )
+						.event( &a_subscriber_t::evt_quote );
+				else
+					{
+						const auto instrument = m_instrument;
+						so_set_delivery_filter( m_common_mbox,
+							[instrument]( const msg_quote & msg ) {
+								return instrument == msg.m_instrument;
+							} );
+						so_subscribe( m_common_mbox )
+							.event( &a_subscriber_t::evt_quote );
+					}
+			}
+
+		void
+		evt_quote( mhood_t< msg_quote > )
+			{
+				++m_received;
+			}
+
+	private :
+		const unsigned int m_instrument;
+		const so_5::mbox_t m_common_mbox;
+		const keyed_mbox_ref_t m_keyed_mbox;
+
+		unsigned int m_received = 0;
+	};
+
+class a_sender_t
+	:	public so_5::agent_t
+	{
+	public :
+		a_sender_t(
+			context_t ctx,
+			const cfg_t & cfg,
+			so_5::mbox_t dest )
+			:	so_5::agent_t( ctx )
+			,	m_cfg( cfg )
+			,	m_dest( std::move(dest) )
+			{}
+
+		virtual void
+		so_evt_start() override
+			{
+				benchmarker_t bench;
+				bench.start();
+
+				for( unsigned int i = 0; i != m_cfg.m_messages; ++i )
+					so_5::send< msg_quote >( m_dest, i % m_cfg.m_subscribers );
+
+				bench.finish_and_show_stats( m_cfg.m_messages, "sends" );
+
+				so_environment().stop();
+			}
+
+	private :
+		const cfg_t m_cfg;
+		const so_5::mbox_t m_dest;
+	};
+
+cfg_t
+parse_args( int argc, char ** argv )
+	{
+		cfg_t cfg;
+
+		if( argc > 1 )
+			{
+				const std::string mode = argv[ 1 ];
+				if( "filter" == mode )
+					cfg.m_keyed = false;
+				else if( "keyed" != mode )
+					throw std::runtime_error( "unknown mode: " + mode );
+			}
+		if( argc > 2 )
+			cfg.m_subscribers = static_cast< unsigned int >(
+					std::atoi( argv[ 2 ] ) );
+		if( argc > 3 )
+			cfg.m_messages = static_cast< unsigned int >(
+					std::atoi( argv[ 3 ] ) );
+
+		if( !cfg.m_subscribers )
+			throw std::runtime_error( "subscribers count can't be 0" );
+
+		return cfg;
+	}
+
+int
+main( int argc, char ** argv )
+{
+	try
+	{
+		const cfg_t cfg = parse_args( argc, argv );
+
+		std::cout << "mode: " << ( cfg.m_keyed ? "keyed" : "filter" )
+				<< ", subscribers: " << cfg.m_subscribers
+				<< ", messages: " << cfg.m_messages << std::endl;
+
+		so_5::launch(
+			[&cfg]( so_5::environment_t & env )
+			{
+				so_5::mbox_t common_mbox;
+				keyed_mbox_ref_t keyed_mbox;
+				if( cfg.m_keyed )
+					{
+						keyed_mbox = so_5::keyed_mbox::make_keyed_mbox<
+								unsigned int >( env );
+						keyed_mbox->set_key_extractor< msg_quote >(
+							[]( const msg_quote & msg ) { return msg.m_instrument; } );
+						common_mbox = keyed_mbox->as_mbox();
+					}
+				else
+					common_mbox = env.create_mbox();
+
+				env.introduce_coop( [&]( so_5::coop_t & coop ) {
+						for( unsigned int i = 0; i != cfg.m_subscribers; ++i )
+							coop.make_agent< a_subscriber_t >(
+									i, common_mbox, keyed_mbox );
+					} );
+
+				env.introduce_coop( [&]( so_5::coop_t & coop ) {
+						coop.make_agent< a_sender_t >( cfg, common_mbox );
+					} );
+			} );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,319 @@
+/*
+ * A benchmark for distribution of work between several performers.
+ *
+ * Compares load-balancing mbox with round_robin and least_loaded
+ * policies with the collector/performer pattern.
+ *
+ * Usage:
+ * _test.bench.so_5.load_balancing_mbox [rr|ll|collector] [performers] [tasks]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/benchmark_helpers.hpp>
+
+using namespace std::chrono;
+
+enum class work_mode_t { round_robin, least_loaded, collector };
+
+struct cfg_t
+	{
+		work_mode_t m_mode = work_mode_t::round_robin;
+		unsigned int m_performers = 4;
+		unsigned int m_tasks = 200000;
+	};
+
+struct msg_task : public so_5::message_t
+	{
+		unsigned int m_index;
+		steady_clock::time_point m_sent_at;
+
+		msg_task( unsigned int index, steady_clock::time_point sent_at )
+			:	m_index( index ), m_sent_at( sent_at )
+			{}
+	};
+
+struct msg_ready : public so_5::message_t
+	{
+		so_5::mbox_t m_performer;
+
+		msg_ready( so_5::mbox_t performer ) : m_performer( std::move(performer) )
+			{}
+	};
+
+struct results_t
+	{
+		std::atomic< unsigned int > m_processed{ 0u };
+		steady_clock::time_point m_started_at;
+		steady_clock::time_point m_finished_at;
+		std::vector< std::vector< steady_clock::duration > > m_latencies;
+	};
+
+// Every tenth task is much more expensive than others.
+void
+do_work( unsigned int index )
+	{
+		const unsigned int iterations = ( 0 == index % 10 ) ? 20000u : 500u;
+
+		volatile unsigned int sink = 0;
+		for( unsigned int i = 0; i != iterations; ++i )
+			sink += i;
+	}
+
+class a_performer_t final : public so_5::agent_t
+	{
+	public :
+		a_performer_t(
+			context_t ctx,
+			const cfg_t & cfg,
+			unsigned int index,
+			so_5::mbox_t tasks,
+			so_5::mbox_t collector,
+			results_t & results )
+			:	so_5::agent_t( ctx + limit_then_abort< msg_task >( cfg.m_tasks ) )
+			,	m_cfg( cfg )
+			,	m_tasks( std::move(tasks) )
+			,	m_collector( std::move(collector) )
+			,	m_results( results )
+			,	m_latencies( results.m_latencies[ index ] )
+			{
+				m_latencies.reserve( cfg.m_tasks );
+			}
+
+		virtual void
+		so_define_agent() override
+			{
+				so_subscribe( m_collector ? so_direct_mbox() : m_tasks )
+					.event( &a_performer_t::evt_task );
+			}
+
+		virtual void
+		so_evt_start() override
+			{
+				if( m_collector )
+					so_5::send< msg_ready >( m_collector, so_direct_mbox() );
+			}
+
+	private :
+		const cfg_t m_cfg;
+		const so_5::mbox_t m_tasks;
+		const so_5::mbox_t m_collector;
+		results_t & m_results;
+		std::vector< steady_clock::duration > & m_latencies;
+
+		void
+		evt_task( mhood_t< msg_task > cmd )
+			{
+				m_latencies.push_back( steady_clock::now() - cmd->m_sent_at );
+
+				do_work( cmd->m_index );
+
+				if( m_collector )
+					so_5::send< msg_ready >( m_collector, so_direct_mbox() );
+
+				if( m_cfg.m_tasks == ++m_results.m_processed )
+					{
+						m_results.m_finished_at = steady_clock::now();
+						so_environment().stop();
+					}
+			}
+	};
+
+class a_collector_t final : public so_5::agent_t
+	{
+	public :
+		using so_5::agent_t::agent_t;
+
+		virtual void
+		so_define_agent() override
+			{
+				so_subscribe_self()
+					.event( &a_collector_t::evt_task )
+					.event( &a_collector_t::evt_ready );
+			}
+
+	private :
+		std::deque< so_5::intrusive_ptr_t< msg_task > > m_pending;
+		std::deque< so_5::mbox_t > m_free_performers;
+
+		void
+		evt_task( mhood_t< msg_task > cmd )
+			{
+				if( m_free_performers.empty() )
+					m_pending.push_back( cmd.make_reference() );
+				else
+					{
+						const auto performer = m_free_performers.front();
+						m_free_performers.pop_front();
+						so_5::send( performer, cmd );
+					}
+			}
+
+		void
+		evt_ready( mhood_t< msg_ready > cmd )
+			{
+				if( m_pending.empty() )
+					m_free_performers.push_back( cmd->m_performer );
+				else
+					{
+						cmd->m_performer->deliver_message( m_pending.front() );
+						m_pending.pop_front();
+					}
+			}
+	};
+
+class a_producer_t final : public so_5::agent_t
+	{
+	public :
+		a_producer_t(
+			context_t ctx,
+			const cfg_t & cfg,
+			so_5::mbox_t dest,
+			results_t & results )
+			:	so_5::agent_t( ctx )
+			,	m_cfg( cfg )
+			,	m_dest( std::move(dest) )
+			,	m_results( results )
+			{}
+
+		virtual void
+		so_evt_start() override
+			{
+				m_results.m_started_at = steady_clock::now();
+
+				for( unsigned int i = 0; i != m_cfg.m_tasks; ++i )
+					so_5::send< msg_task >( m_dest, i, steady_clock::now() );
+			}
+
+	private :
+		const cfg_t m_cfg;
+		const so_5::mbox_t m_dest;
+		results_t & m_results;
+	};
+
+cfg_t
+parse_args( int argc, char ** argv )
+	{
+		cfg_t cfg;
+
+		if( argc > 1 )
+			{
+				const std::string mode = argv[ 1 ];
+				if( "rr" == mode )
+					cfg.m_mode = work_mode_t::round_robin;
+				else if( "ll" == mode )
+					cfg.m_mode = work_mode_t::least_loaded;
+				else if( "collector" == mode )
+					cfg.m_mode = work_mode_t::collector;
+				else
+					throw std::runtime_error( "unknown mode: " + mode );
+			}
+		if( argc > 2 )
+			cfg.m_performers = static_cast< unsigned int >(
+					std::atoi( argv[ 2 ] ) );
+		if( argc > 3 )
+			cfg.m_tasks = static_cast< unsigned int >(
+					std::atoi( argv[ 3 ] ) );
+
+		if( !cfg.m_performers || !cfg.m_tasks )
+			throw std::runtime_error( "performers and tasks can't be 0" );
+
+		return cfg;
+	}
+
+void
+show_results( const cfg_t & cfg, const results_t & results )
+	{
+		std::vector< steady_clock::duration > all;
+		all.reserve( cfg.m_tasks );
+		for( const auto & v : results.m_latencies )
+			all.insert( all.end(), v.begin(), v.end() );
+		std::sort( all.begin(), all.end() );
+
+		const auto percentile = [&all]( double p ) {
+			const auto pos = static_cast< std::size_t >(
+					static_cast< double >( all.size() - 1 ) * p );
+			return duration_cast< microseconds >( all[ pos ] ).count();
+		};
+
+		const auto total_ms = duration_cast< milliseconds >(
+				results.m_finished_at - results.m_started_at ).count();
+
+		benchmarks_details::precision_settings_t precision{ std::cout, 10 };
+		std::cout << "total time: " << total_ms / 1000.0 << "s"
+			<< ", throughput: "
+			<< ( total_ms ? cfg.m_tasks * 1000.0 / total_ms : 0.0 )
+			<< " tasks/s" << std::endl;
+
+		std::cout << "latency (us): p50=" << percentile( 0.5 )
+			<< ", p99=" << percentile( 0.99 )
+			<< ", p99.9=" << percentile( 0.999 )
+			<< ", max=" << percentile( 1.0 ) << std::endl;
+
+		for( std::size_t i = 0; i != results.m_latencies.size(); ++i )
+			std::cout << "performer #" << i << ": "
+				<< results.m_latencies[ i ].size() << " tasks" << std::endl;
+	}
+
+int
+main( int argc, char ** argv )
+{
+	try
+	{
+		const cfg_t cfg = parse_args( argc, argv );
+
+		const char * mode_names[] = { "round_robin", "least_loaded", "collector" };
+		std::cout << "mode: " << mode_names[ static_cast< int >( cfg.m_mode ) ]
+				<< ", performers: " << cfg.m_performers
+				<< ", tasks: " << cfg.m_tasks << std::endl;
+
+		results_t results;
+		results.m_latencies.resize( cfg.m_performers );
+
+		so_5::launch(
+			[&]( so_5::environment_t & env )
+			{
+				env.introduce_coop(
+					so_5::disp::active_obj::create_private_disp( env )->binder(),
+					[&]( so_5::coop_t & coop ) {
+						so_5::mbox_t dest;
+						so_5::mbox_t collector;
+						if( work_mode_t::collector == cfg.m_mode )
+							{
+								collector = coop.make_agent< a_collector_t >()
+										->so_direct_mbox();
+								dest = collector;
+							}
+						else
+							dest = env.create_load_balancing_mbox(
+									work_mode_t::round_robin == cfg.m_mode ?
+										so_5::load_balancing_policy_t::round_robin :
+										so_5::load_balancing_policy_t::least_loaded );
+
+						for( unsigned int i = 0; i != cfg.m_performers; ++i )
+							coop.make_agent< a_performer_t >(
+									cfg, i, dest, collector, results );
+
+						coop.make_agent< a_producer_t >( cfg, dest, results );
+					} );
+			} );
+
+		show_results( cfg, results );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * A benchmark for message delivery to an agent with message limits
+ * from several producer threads.
+ */
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <thread>
+#include <cstdlib>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/benchmark_helpers.hpp>
+#include <various_helpers_1/cmd_line_args_helpers.hpp>
+
+const std::size_t max_types = 16;
+
+struct cfg_t
+	{
+		std::size_t m_producers = 4;
+		std::size_t m_messages = 1000000;
+		std::size_t m_types = 1;
+		unsigned int m_limit = 1000;
+		bool m_mpmc_mbox = false;
+	};
+
+cfg_t
+try_parse_cmdline(
+	int argc,
+	char ** argv )
+{
+	cfg_t tmp_cfg;
+
+	for( char ** current = &argv[ 1 ], **last = argv + argc;
+			current != last;
+			++current )
+		{
+			if( is_arg( *current, "-h", "--help" ) )
+				{
+					std::cout << "usage:\n"
+							"_test.bench.so_5.message_limits <options>\n"
+							"\noptions:\n"
+							"-p, --producers  count of producer threads\n"
+							"-m, --messages   count of messages from every producer\n"
+							"-t, --types      count of message types (max: 16)\n"
+							"-l, --limit      message limit for every type\n"
+							"-M, --mpmc-mbox  use MPMC mbox instead of direct mbox\n"
+							"-h, --help       show this description\n"
+							<< std::endl;
+					std::exit(1);
+				}
+			else if( is_arg( *current, "-p", "--producers" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_producers, ++current, last,
+						"-p", "count of producer threads" );
+
+			else if( is_arg( *current, "-m", "--messages" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_messages, ++current, last,
+						"-m", "count of messages from every producer" );
+
+			else if( is_arg( *current, "-t", "--types" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_types, ++current, last,
+						"-t", "count of message types" );
+
+			else if( is_arg( *current, "-l", "--limit" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_limit, ++current, last,
+						"-l", "message limit for every type" );
+
+			else if( is_arg( *current, "-M", "--mpmc-mbox" ) )
+				tmp_cfg.m_mpmc_mbox = true;
+
+			else
+				throw std::runtime_error(
+						std::string( "unknown argument: " ) + *current );
+		}
+
+	if( !tmp_cfg.m_types || max_types < tmp_cfg.m_types )
+		throw std::runtime_error( "count of types must be in [1, 16]" );
+
+	if( !tmp_cfg.m_producers || !tmp_cfg.m_messages )
+		throw std::runtime_error(
+				"count of producers and messages cannot be 0" );
+
+	return tmp_cfg;
+}
+
+void
+show_cfg( const cfg_t & cfg )
+{
+	std::cout << "Configuration: "
+		<< "producers: " << cfg.m_producers
+		<< ", messages: " << cfg.m_messages
+		<< ", types: " << cfg.m_types
+		<< ", limit: " << cfg.m_limit
+		<< ", mbox: " << ( cfg.m_mpmc_mbox ? "MPMC" : "direct" )
+		<< std::endl;
+}
+
+template< std::size_t N >
+struct msg_tick : public so_5::signal_t {};
+
+struct msg_finish : public so_5::signal_t {};
+
+using sender_t = void (*)( const so_5::mbox_t & );
+
+template< std::size_t N >
+void
+send_tick( const so_5::mbox_t & to )
+{
+	so_5::send< msg_tick< N > >( to );
+}
+
+//
+// Helpers for iteration over all msg_tick types.
+//
+template< std::size_t N >
+struct types_iterator_t
+	{
+		static so_5::agent_context_t
+		add_limits( so_5::agent_context_t ctx, unsigned int limit )
+			{
+				return types_iterator_t< N - 1 >::add_limits(
+						ctx + so_5::agent_t::limit_then_drop< msg_tick< N - 1 > >(
+								limit ),
+						limit );
+			}
+
+		template< typename Action >
+		static void
+		for_each( Action & action )
+			{
+				types_iterator_t< N - 1 >::for_each( action );
+				action.template apply< N - 1 >();
+			}
+	};
+
+template<>
+struct types_iterator_t< 0 >
+	{
+		static so_5::agent_context_t
+		add_limits( so_5::agent_context_t ctx, unsigned int )
+			{
+				return ctx + so_5::agent_t::limit_then_abort< msg_finish >( 1 );
+			}
+
+		template< typename Action >
+		static void
+		for_each( Action & ) {}
+	};
+
+using all_types_t = types_iterator_t< max_types >;
+
+class a_receiver_t : public so_5::agent_t
+	{
+	public :
+		a_receiver_t(
+			context_t ctx,
+			const cfg_t & cfg,
+			unsigned long long & received )
+			:	so_5::agent_t( all_types_t::add_limits( ctx, cfg.m_limit ) )
+			,	m_mbox( cfg.m_mpmc_mbox ?
+					so_environment().create_mbox() : so_direct_mbox() )
+			,	m_received( received )
+			{
+				subscriber_t subscriber{ *this };
+				all_types_t::for_each( subscriber );
+
+				so_subscribe( m_mbox ).event< msg_finish >(
+						[this] { so_environment().stop(); } );
+			}
+
+		const so_5::mbox_t &
+		mbox() const { return m_mbox; }
+
+	private :
+		struct subscriber_t
+			{
+				a_receiver_t & m_self;
+
+				template< std::size_t N >
+				void
+				apply()
+					{
+						auto & self = m_self;
+						self.so_subscribe( self.m_mbox ).event< msg_tick< N > >(
+								[&self] { ++self.m_received; } );
+					}
+			};
+
+		const so_5::mbox_t m_mbox;
+		unsigned long long & m_received;
+	};
+
+struct senders_maker_t
+	{
+		std::array< sender_t, max_types > m_senders;
+
+		template< std::size_t N >
+		void
+		apply() { m_senders[ N ] = &send_tick< N >; }
+	};
+
+void
+run_benchmark( const cfg_t & cfg )
+{
+	senders_maker_t senders;
+	all_types_t::for_each( senders );
+
+	unsigned long long received = 0;
+	so_5::mbox_t dest;
+
+	so_5::wrapped_env_t sobj;
+
+	sobj.environment().introduce_coop(
+		so_5::disp::one_thread::create_private_disp(
+				sobj.environment() )->binder(),
+		[&]( so_5::coop_t & coop ) {
+			dest = coop.make_agent< a_receiver_t >( cfg, received )->mbox();
+		} );
+
+	benchmarker_t benchmarker;
+	benchmarker.start();
+
+	std::vector< std::thread > producers;
+	producers.reserve( cfg.m_producers );
+	for( std::size_t i = 0; i != cfg.m_producers; ++i )
+		producers.emplace_back( [&cfg, &senders, &dest, i] {
+				for( std::size_t m = 0; m != cfg.m_messages; ++m )
+					senders.m_senders[ ( m + i ) % cfg.m_types ]( dest );
+			} );
+
+	for( auto & t : producers )
+		t.join();
+
+	so_5::send< msg_finish >( dest );
+	sobj.join();
+
+	const auto total = static_cast< unsigned long long >(
+			cfg.m_producers * cfg.m_messages );
+	benchmarker.finish_and_show_stats( total, "sends" );
+
+	std::cout << "received: " << received
+			<< ", dropped: " << ( total - received ) << std::endl;
+}
+
+int
+main( int argc, char ** argv )
+{
+	try
+	{
+		cfg_t cfg = try_parse_cmdline( argc, argv );
+		show_cfg( cfg );
+
+		run_benchmark( cfg );
+
+		return 0;
+	}
+	catch( const std::exception & x )
+	{
+		std::cerr << "*** Exception caught: " << x.what() << std::endl;
+	}
+
+	return 2;
+}
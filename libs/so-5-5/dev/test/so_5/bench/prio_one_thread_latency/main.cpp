@@ -0,0 +1,273 @@
+/*
+ * A benchmark for latency of high-priority demands under load of
+ * low-priority demands for prio_one_thread dispatchers.
+ */
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdlib>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/benchmark_helpers.hpp>
+#include <various_helpers_1/cmd_line_args_helpers.hpp>
+
+using namespace std::chrono;
+
+enum class dispatcher_t
+	{
+		strictly_ordered,
+		quoted_round_robin
+	};
+
+struct cfg_t
+	{
+		std::size_t m_producers = 4;
+		std::size_t m_messages = 200000;
+		std::size_t m_probes = 1000;
+		std::size_t m_probe_interval_us = 100;
+		dispatcher_t m_dispatcher = dispatcher_t::strictly_ordered;
+		bool m_simple_lock = false;
+	};
+
+cfg_t
+try_parse_cmdline(
+	int argc,
+	char ** argv )
+{
+	cfg_t tmp_cfg;
+
+	for( char ** current = &argv[ 1 ], **last = argv + argc;
+			current != last;
+			++current )
+		{
+			if( is_arg( *current, "-h", "--help" ) )
+				{
+					std::cout << "usage:\n"
+							"_test.bench.so_5.prio_one_thread_latency <options>\n"
+							"\noptions:\n"
+							"-p, --producers          count of low-priority producer threads\n"
+							"-m, --messages           count of messages from every producer\n"
+							"-P, --probes             count of high-priority probes\n"
+							"-i, --probe-interval     interval between probes (in us)\n"
+							"-q, --quoted-round-robin use quoted_round_robin dispatcher\n"
+							"-s, --simple-lock        use simple_lock_factory for queue\n"
+							"-h, --help               show this description\n"
+							<< std::endl;
+					std::exit(1);
+				}
+			else if( is_arg( *current, "-p", "--producers" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_producers, ++current, last,
+						"-p", "count of low-priority producer threads" );
+
+			else if( is_arg( *current, "-m", "--messages" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_messages, ++current, last,
+						"-m", "count of messages from every producer" );
+
+			else if( is_arg( *current, "-P", "--probes" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_probes, ++current, last,
+						"-P", "count of high-priority probes" );
+
+			else if( is_arg( *current, "-i", "--probe-interval" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_probe_interval_us, ++current, last,
+						"-i", "interval between probes (in us)" );
+
+			else if( is_arg( *current, "-q", "--quoted-round-robin" ) )
+				tmp_cfg.m_dispatcher = dispatcher_t::quoted_round_robin;
+
+			else if( is_arg( *current, "-s", "--simple-lock" ) )
+				tmp_cfg.m_simple_lock = true;
+
+			else
+				throw std::runtime_error(
+						std::string( "unknown argument: " ) + *current );
+		}
+
+	if( !tmp_cfg.m_probes )
+		throw std::runtime_error( "count of probes cannot be 0" );
+
+	return tmp_cfg;
+}
+
+void
+show_cfg( const cfg_t & cfg )
+{
+	std::cout << "Configuration: "
+		<< "producers: " << cfg.m_producers
+		<< ", messages: " << cfg.m_messages
+		<< ", probes: " << cfg.m_probes
+		<< ", probe interval: " << cfg.m_probe_interval_us << "us"
+		<< ", dispatcher: " << ( dispatcher_t::strictly_ordered ==
+				cfg.m_dispatcher ? "strictly_ordered" : "quoted_round_robin" )
+		<< ", lock: " << ( cfg.m_simple_lock ? "simple" : "combined" )
+		<< std::endl;
+}
+
+struct msg_background : public so_5::signal_t {};
+
+struct msg_probe : public so_5::message_t
+	{
+		steady_clock::time_point m_sent_at;
+
+		msg_probe( steady_clock::time_point sent_at )
+			:	m_sent_at( sent_at )
+			{}
+	};
+
+class a_background_t : public so_5::agent_t
+	{
+	public :
+		a_background_t( context_t ctx )
+			:	so_5::agent_t( ctx + so_5::prio::p0 )
+			{
+				so_subscribe_self().event< msg_background >( [] {} );
+			}
+	};
+
+class a_probe_t : public so_5::agent_t
+	{
+	public :
+		a_probe_t(
+			context_t ctx,
+			std::vector< steady_clock::duration > & latencies )
+			:	so_5::agent_t( ctx + so_5::prio::p7 )
+			,	m_latencies( latencies )
+			{
+				so_subscribe_self().event( [this]( const msg_probe & m ) {
+						m_latencies.push_back( steady_clock::now() - m.m_sent_at );
+					} );
+			}
+
+	private :
+		std::vector< steady_clock::duration > & m_latencies;
+	};
+
+so_5::disp_binder_unique_ptr_t
+make_binder( so_5::environment_t & env, const cfg_t & cfg )
+{
+	auto lock_factory = cfg.m_simple_lock ?
+			so_5::disp::mpsc_queue_traits::simple_lock_factory() :
+			so_5::disp::mpsc_queue_traits::combined_lock_factory();
+
+	if( dispatcher_t::strictly_ordered == cfg.m_dispatcher )
+		{
+			using namespace so_5::disp::prio_one_thread::strictly_ordered;
+			return create_private_disp( env, std::string(),
+					disp_params_t{}.tune_queue_params(
+						[&]( queue_traits::queue_params_t & p ) {
+							p.lock_factory( lock_factory );
+						} ) )->binder();
+		}
+	else
+		{
+			using namespace so_5::disp::prio_one_thread::quoted_round_robin;
+			return create_private_disp( env, quotes_t{ 20 }, std::string(),
+					disp_params_t{}.tune_queue_params(
+						[&]( queue_traits::queue_params_t & p ) {
+							p.lock_factory( lock_factory );
+						} ) )->binder();
+		}
+}
+
+void
+show_latencies( std::vector< steady_clock::duration > latencies )
+{
+	if( latencies.empty() )
+		throw std::runtime_error( "no probes were handled" );
+
+	std::sort( latencies.begin(), latencies.end() );
+
+	auto us = []( steady_clock::duration d ) {
+		return duration_cast< duration< double, std::micro > >( d ).count();
+	};
+	auto percentile = [&]( double p ) {
+		const auto index = static_cast< std::size_t >(
+				p * static_cast< double >( latencies.size() - 1 ) );
+		return us( latencies[ index ] );
+	};
+
+	const auto total = std::accumulate( latencies.begin(), latencies.end(),
+			steady_clock::duration::zero() );
+
+	benchmarks_details::precision_settings_t precision{ std::cout, 6 };
+	std::cout << "high-priority latency (us) for "
+			<< latencies.size() << " probes: "
+			<< "min: " << us( latencies.front() )
+			<< ", avg: " << us( total ) / static_cast< double >( latencies.size() )
+			<< ", p50: " << percentile( 0.5 )
+			<< ", p99: " << percentile( 0.99 )
+			<< ", max: " << us( latencies.back() )
+			<< std::endl;
+}
+
+void
+run_benchmark( const cfg_t & cfg )
+{
+	std::vector< steady_clock::duration > latencies;
+	latencies.reserve( cfg.m_probes );
+
+	so_5::wrapped_env_t sobj;
+
+	so_5::mbox_t background_mbox;
+	so_5::mbox_t probe_mbox;
+
+	sobj.environment().introduce_coop(
+		make_binder( sobj.environment(), cfg ),
+		[&]( so_5::coop_t & coop ) {
+			background_mbox = coop.make_agent< a_background_t >()->so_direct_mbox();
+			probe_mbox = coop.make_agent< a_probe_t >(
+					latencies )->so_direct_mbox();
+		} );
+
+	std::vector< std::thread > producers;
+	producers.reserve( cfg.m_producers );
+	for( std::size_t i = 0; i != cfg.m_producers; ++i )
+		producers.emplace_back( [&] {
+				for( std::size_t m = 0; m != cfg.m_messages; ++m )
+					so_5::send< msg_background >( background_mbox );
+			} );
+
+	for( std::size_t i = 0; i != cfg.m_probes; ++i )
+		{
+			so_5::send< msg_probe >( probe_mbox, steady_clock::now() );
+			std::this_thread::sleep_for(
+					microseconds( cfg.m_probe_interval_us ) );
+		}
+
+	for( auto & t : producers )
+		t.join();
+
+	// Probes are handled before background messages so all of them
+	// should be processed at this point.
+	sobj.stop_then_join();
+
+	show_latencies( std::move( latencies ) );
+}
+
+int
+main( int argc, char ** argv )
+{
+	try
+	{
+		cfg_t cfg = try_parse_cmdline( argc, argv );
+		show_cfg( cfg );
+
+		run_benchmark( cfg );
+
+		return 0;
+	}
+	catch( const std::exception & x )
+	{
+		std::cerr << "*** Exception caught: " << x.what() << std::endl;
+	}
+
+	return 2;
+}
@@ -6,6 +6,8 @@
 #include <numeric>
 #include <chrono>
 #include <cstdlib>
+#include <string>
+#include <stdexcept>
 
 #include <so_5/all.hpp>
 
@@ -21,8 +23,9 @@ class a_test_t
 		a_test_t(
 			so_5::environment_t & env,
 			std::size_t states_count,
-			int tick_count )
-			:	so_5::agent_t( env )
+			int tick_count,
+			so_5::subscription_storage_factory_t storage_factory )
+			:	so_5::agent_t( env + std::move( storage_factory ) )
 			,	m_self_mbox( env.create_mbox() )
 			,	m_tick_count( tick_count )
 			,	m_messages_received( 0 )
@@ -93,6 +96,24 @@ class a_test_t
 		benchmarker_t m_benchmarker;
 	};
 
+so_5::subscription_storage_factory_t
+make_storage_factory( const std::string & name )
+{
+	if( "default" == name )
+		return so_5::default_subscription_storage_factory();
+	else if( "vector" == name )
+		return so_5::vector_based_subscription_storage_factory( 16 );
+	else if( "map" == name )
+		return so_5::map_based_subscription_storage_factory();
+	else if( "hash_table" == name )
+		return so_5::hash_table_based_subscription_storage_factory();
+	else if( "flat_hash" == name )
+		return so_5::flat_hash_subscription_storage_factory();
+
+	throw std::runtime_error( "unknown subscription storage: " + name +
+			" (expected: default, vector, map, hash_table, flat_hash)" );
+}
+
 int
 main( int argc, char ** argv )
 {
@@ -101,25 +122,34 @@ main( int argc, char ** argv )
 		std::size_t max_states = 16;
 		int tick_count = 100000;
 
-		if( 3 == argc )
+		std::string storage = "default";
+
+		if( 3 == argc || 4 == argc )
 		{
 			max_states = static_cast< std::size_t >(std::atoi( argv[1] ));
 			ensure( max_states > 0, "max_states must be >= 1" );
 
 			tick_count = std::atoi( argv[2] );
 			ensure( tick_count > 0, "tick_count must be >= 1" );
+
+			if( 4 == argc )
+				storage = argv[3];
 		}
 
+		const auto storage_factory = make_storage_factory( storage );
+		std::cout << "subscription storage: " << storage << std::endl;
+
 		for( std::size_t states = 1; states <= max_states; states *= 2 )
 		{
 			std::cout << "*** benchmark for " << states << " state(s) ***"
 				<< std::endl;
 
 			so_5::launch(
-				[states, tick_count]( so_5::environment_t & env )
+				[states, tick_count, &storage_factory]( so_5::environment_t & env )
 				{
 					env.register_agent_as_coop( "test",
-							new a_test_t( env, states, tick_count ) );
+							new a_test_t(
+									env, states, tick_count, storage_factory ) );
 				} );
 
 			tick_count /= 2;
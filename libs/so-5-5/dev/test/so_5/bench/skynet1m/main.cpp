@@ -12,6 +12,8 @@ using number = unsigned long long;
 
 using disp_handle = disp::thread_pool::private_dispatcher_handle_t;
 
+bool use_arena = false;
+
 disp::thread_pool::bind_params_t bind_params()
 {
 	return disp::thread_pool::bind_params_t{}
@@ -71,6 +73,8 @@ private :
 			[&]( coop_t & coop ) {
 				const auto subsize = m_size / divider;
 				coop.reserve( divider );
+				if( use_arena )
+					coop.use_agent_arena( divider * ( sizeof( skynet ) + 32u ) );
 				for( unsigned int i = 0; i != divider; ++i )
 					coop.make_agent< skynet >( m_disp, so_direct_mbox(), m_num + i * subsize, subsize );
 			} );
@@ -83,8 +87,12 @@ size_t pool_size()
 	return c > 1 ? c - 1 : 1;
 }
 
-int main()
+int main( int argc, char ** argv )
 {
+	// Agents of every coop will be allocated in an arena if
+	// the benchmark is started as: _test.bench.so_5.skynet1m arena
+	use_arena = 2 == argc && string( "arena" ) == argv[ 1 ];
+
 	number result = 0;
 
 	using clock_type = std::chrono::high_resolution_clock;
@@ -113,6 +121,7 @@ int main()
 
 	std::cout << "result: " << result
 		<< ", time: " << chrono::duration_cast< chrono::milliseconds >(
-				finish_at - start_at ).count() << "ms" << std::endl;
+				finish_at - start_at ).count() << "ms"
+		<< ", arena: " << ( use_arena ? "yes" : "no" ) << std::endl;
 }
 
@@ -0,0 +1,239 @@
+/*
+ * A test for allocation of agents in agent_arena.
+ */
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+using namespace std;
+
+const std::size_t total_agents = 100;
+
+atomic< int > live_agents{ 0 };
+
+struct hello : public so_5::signal_t {};
+
+class a_worker_t final : public so_5::agent_t
+{
+public :
+	a_worker_t(
+		context_t ctx,
+		so_5::mbox_t common_mbox,
+		so_5::mbox_t reply_mbox,
+		bool must_throw = false )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_common_mbox( std::move(common_mbox) )
+		,	m_reply_mbox( std::move(reply_mbox) )
+	{
+		if( must_throw )
+			throw runtime_error( "test exception from constructor" );
+
+		++live_agents;
+	}
+
+	~a_worker_t()
+	{
+		--live_agents;
+	}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe( m_common_mbox ).event( &a_worker_t::on_hello );
+	}
+
+private :
+	const so_5::mbox_t m_common_mbox;
+	const so_5::mbox_t m_reply_mbox;
+
+	void
+	on_hello( mhood_t< hello > )
+	{
+		so_5::send< hello >( m_reply_mbox );
+	}
+};
+
+void
+check_agents_in_arena()
+{
+	std::size_t replies = 0;
+	so_5::agent_ref_t survivor;
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+		auto common_mbox = env.create_mbox();
+		auto reply_ch = env.create_mchain( so_5::make_unlimited_mchain_params() );
+
+		env.introduce_coop( [&]( so_5::coop_t & coop ) {
+			const std::size_t arena_size =
+					total_agents * ( sizeof( a_worker_t ) + 32u );
+			coop.use_agent_arena( arena_size );
+
+			const char * first = nullptr;
+			const char * last = nullptr;
+			for( std::size_t i = 0; i != total_agents; ++i )
+			{
+				auto a = coop.make_agent< a_worker_t >(
+						common_mbox, reply_ch->as_mbox() );
+				last = reinterpret_cast< const char * >( a );
+				if( !first )
+				{
+					first = last;
+					// That agent will live longer than its coop.
+					survivor = so_5::agent_ref_t( a );
+				}
+			}
+
+			// All agents must be allocated in the same chunk.
+			ensure( static_cast< std::size_t >( last - first ) < arena_size,
+					"agents must be allocated in the same chunk" );
+
+			// An ad-hoc agent must be allocated in the arena too.
+			coop.define_agent().event< hello >( common_mbox, [reply_ch] {
+					so_5::send< hello >( reply_ch );
+				} );
+		} );
+
+		so_5::send< hello >( common_mbox );
+
+		receive(
+				from( reply_ch ).handle_n( total_agents + 1 ),
+				[&replies]( so_5::mhood_t< hello > ) { ++replies; } );
+
+		env.stop();
+	} );
+
+	ensure( total_agents + 1 == replies,
+			"all agents must reply, replies: " + to_string( replies ) );
+
+	// Only one agent must be alive and its memory must still be valid.
+	ensure( 1 == live_agents,
+			"only one agent must be alive, live agents: " +
+			to_string( live_agents.load() ) );
+	survivor.reset();
+	ensure( 0 == live_agents, "all agents must be destroyed" );
+}
+
+void
+check_exception_from_constructor()
+{
+	so_5::launch( [&]( so_5::environment_t & env ) {
+		auto mbox = env.create_mbox();
+
+		bool thrown = false;
+		try
+		{
+			env.introduce_coop( [&]( so_5::coop_t & coop ) {
+				coop.use_agent_arena();
+				coop.make_agent< a_worker_t >( mbox, mbox );
+				coop.make_agent< a_worker_t >( mbox, mbox, true );
+			} );
+		}
+		catch( const runtime_error & )
+		{
+			thrown = true;
+		}
+		ensure( thrown, "exception from agent constructor expected" );
+
+		env.stop();
+	} );
+
+	ensure( 0 == live_agents, "all agents must be destroyed" );
+}
+
+class alignas( 64 ) a_aligned_t final : public so_5::agent_t
+{
+public :
+	a_aligned_t( context_t ctx )
+		:	so_5::agent_t( std::move(ctx) )
+	{
+		++live_agents;
+	}
+
+	~a_aligned_t()
+	{
+		--live_agents;
+	}
+};
+
+void
+check_aligned_agents_in_arena()
+{
+	so_5::launch( [&]( so_5::environment_t & env ) {
+		env.introduce_coop( [&]( so_5::coop_t & coop ) {
+			coop.use_agent_arena();
+			for( int i = 0; i != 5; ++i )
+			{
+				auto a = coop.make_agent< a_aligned_t >();
+				ensure( 0u == reinterpret_cast< std::uintptr_t >( a ) %
+							alignof( a_aligned_t ),
+						"agent in arena must be properly aligned" );
+			}
+		} );
+
+		env.stop();
+	} );
+
+	ensure( 0 == live_agents, "all agents must be destroyed" );
+}
+
+void
+check_nothrow_and_placement_new()
+{
+	so_5::launch( [&]( so_5::environment_t & env ) {
+		auto mbox = env.create_mbox();
+
+		// An agent created by nothrow form can be passed to a coop.
+		env.introduce_coop( [&]( so_5::coop_t & coop ) {
+			auto a = new( std::nothrow ) a_worker_t(
+					so_5::agent_context_t{ env }, mbox, mbox );
+			ensure( nullptr != a, "agent must be created" );
+			coop.add_agent( a );
+		} );
+
+		// An agent created by placement form is destroyed explicitly.
+		{
+			std::aligned_storage<
+					sizeof( a_worker_t ), alignof( a_worker_t ) >::type buf;
+			auto a = new( &buf ) a_worker_t(
+					so_5::agent_context_t{ env }, mbox, mbox );
+			ensure( static_cast< void * >( a ) == &buf,
+					"agent must be created in the buffer" );
+			a->~a_worker_t();
+		}
+
+		env.stop();
+	} );
+
+	ensure( 0 == live_agents, "all agents must be destroyed" );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				check_agents_in_arena();
+				check_exception_from_constructor();
+				check_aligned_agents_in_arena();
+				check_nothrow_and_placement_new();
+			},
+			20,
+			"allocation of agents in agent_arena" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
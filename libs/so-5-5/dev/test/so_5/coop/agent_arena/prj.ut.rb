@@ -0,0 +1,8 @@
+require 'mxx_ru/binary_unittest'
+
+MxxRu::setup_target(
+	MxxRu::Binary_unittest_target.new(
+		"test/so_5/coop/agent_arena/prj.ut.rb",
+		"test/so_5/coop/agent_arena/prj.rb" )
+)
+
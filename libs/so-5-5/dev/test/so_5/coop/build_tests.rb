@@ -24,4 +24,6 @@ MxxRu::Cpp::composite_target {
 	required_prj( "#{path}/user_resource/prj.ut.rb" )
 	required_prj( "#{path}/introduce_coop/prj.ut.rb" )
 	required_prj( "#{path}/create_child_coop_5_5_8/prj.ut.rb" )
+	required_prj( "#{path}/parallel_definition/prj.ut.rb" )
+	required_prj( "#{path}/agent_arena/prj.ut.rb" )
 }
@@ -0,0 +1,191 @@
+/*
+ * A test for parallel definition of agents of a large cooperation.
+ */
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+const std::size_t total_agents = 10000;
+const std::size_t max_threads = 4;
+const std::size_t min_agents_per_thread = 100;
+
+struct definition_info_t
+{
+	mutex m_lock;
+	set< thread::id > m_threads;
+	atomic< std::size_t > m_defined{ 0 };
+	atomic< std::size_t > m_started{ 0 };
+};
+
+struct hello : public so_5::signal_t {};
+
+class a_worker_t final : public so_5::agent_t
+{
+public :
+	a_worker_t(
+		context_t ctx,
+		definition_info_t & info,
+		so_5::mbox_t common_mbox,
+		so_5::mbox_t reply_mbox,
+		bool must_throw )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_info( info )
+		,	m_common_mbox( std::move(common_mbox) )
+		,	m_reply_mbox( std::move(reply_mbox) )
+		,	m_must_throw( must_throw )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		{
+			lock_guard< mutex > lock{ m_info.m_lock };
+			m_info.m_threads.insert( this_thread::get_id() );
+		}
+
+		if( m_must_throw )
+			throw runtime_error( "test exception from so_define_agent" );
+
+		so_subscribe( m_common_mbox ).event( &a_worker_t::on_hello );
+
+		++m_info.m_defined;
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		++m_info.m_started;
+	}
+
+private :
+	definition_info_t & m_info;
+	const so_5::mbox_t m_common_mbox;
+	const so_5::mbox_t m_reply_mbox;
+	const bool m_must_throw;
+
+	void
+	on_hello( mhood_t< hello > )
+	{
+		so_5::send< hello >( m_reply_mbox );
+	}
+};
+
+void
+fill_coop(
+	so_5::coop_t & coop,
+	definition_info_t & info,
+	const so_5::mbox_t & common_mbox,
+	const so_5::mbox_t & reply_mbox,
+	std::size_t throwing_agent )
+{
+	coop.set_parallel_agent_definition( max_threads, min_agents_per_thread );
+	coop.reserve( total_agents );
+	for( std::size_t i = 0; i != total_agents; ++i )
+		coop.make_agent< a_worker_t >(
+				info, common_mbox, reply_mbox, throwing_agent == i );
+}
+
+void
+check_successful_registration()
+{
+	definition_info_t info;
+	std::size_t replies = 0;
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+		auto common_mbox = env.create_mbox();
+		auto reply_ch = env.create_mchain( so_5::make_unlimited_mchain_params() );
+
+		env.introduce_coop(
+			so_5::disp::thread_pool::create_private_disp( env, 2 )->binder(
+					so_5::disp::thread_pool::bind_params_t{} ),
+			[&]( so_5::coop_t & coop ) {
+				fill_coop( coop, info, common_mbox, reply_ch->as_mbox(),
+						total_agents );
+			} );
+
+		so_5::send< hello >( common_mbox );
+
+		receive(
+				from( reply_ch ).handle_n( total_agents ),
+				[&replies]( so_5::mhood_t< hello > ) { ++replies; } );
+
+		env.stop();
+	} );
+
+	ensure( total_agents == info.m_defined,
+			"all agents must be defined, defined: " +
+			to_string( info.m_defined.load() ) );
+	ensure( total_agents == info.m_started,
+			"all agents must be started, started: " +
+			to_string( info.m_started.load() ) );
+	ensure( total_agents == replies,
+			"all agents must reply, replies: " + to_string( replies ) );
+	ensure( max_threads == info.m_threads.size(),
+			"agents must be defined on several threads, threads: " +
+			to_string( info.m_threads.size() ) );
+}
+
+void
+check_failed_registration()
+{
+	definition_info_t info;
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+		auto common_mbox = env.create_mbox();
+
+		bool thrown = false;
+		try
+		{
+			env.introduce_coop( [&]( so_5::coop_t & coop ) {
+					fill_coop( coop, info, common_mbox, common_mbox,
+							total_agents / 2 + 1 );
+				} );
+		}
+		catch( const so_5::exception_t & x )
+		{
+			ensure( so_5::rc_coop_define_agent_failed == x.error_code(),
+					string( "unexpected exception: " ) + x.what() );
+			thrown = true;
+		}
+		ensure( thrown, "registration must fail" );
+
+		env.stop();
+	} );
+
+	ensure( 0 == info.m_started,
+			"no agent must be started, started: " +
+			to_string( info.m_started.load() ) );
+	ensure( total_agents > info.m_defined,
+			"not all agents must be defined" );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				check_successful_registration();
+				check_failed_registration();
+			},
+			60,
+			"parallel definition of agents" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
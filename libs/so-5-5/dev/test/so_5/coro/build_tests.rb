@@ -0,0 +1,11 @@
+#!/usr/local/bin/ruby
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::composite_target {
+
+	path = 'test/so_5/coro'
+
+	required_prj "#{path}/receive/prj.ut.rb"
+	required_prj "#{path}/cancel_on_dereg/prj.ut.rb"
+	required_prj "#{path}/inline_start/prj.ut.rb"
+}
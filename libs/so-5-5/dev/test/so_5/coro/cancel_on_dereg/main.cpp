@@ -0,0 +1,148 @@
+/*
+ * A test for cancellation of suspended coroutines at the end of
+ * agent's work.
+ */
+
+#include <iostream>
+#include <atomic>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+#if defined( SO_5_HAVE_COROUTINES )
+
+using namespace std::chrono;
+
+struct start_wait final : public so_5::signal_t {};
+struct start_sleep final : public so_5::signal_t {};
+struct start_fail final : public so_5::signal_t {};
+struct data final : public so_5::signal_t {};
+
+std::atomic< int > g_destroyed{ 0 };
+std::atomic< int > g_resumed{ 0 };
+
+// An object which lives in a coroutine frame.
+struct frame_guard_t
+{
+	~frame_guard_t() { ++g_destroyed; }
+};
+
+class a_test_t final : public so_5::agent_t
+{
+public :
+	a_test_t( context_t ctx )
+		:	so_5::agent_t( ctx )
+		,	m_chain( so_5::create_mchain( so_environment() ) )
+	{
+		so_subscribe_self()
+			.event( &a_test_t::wait_forever )
+			.event( &a_test_t::sleep_long )
+			.event( &a_test_t::fail );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		so_5::send< start_wait >( *this );
+		so_5::send< start_sleep >( *this );
+		so_5::send< start_fail >( *this );
+	}
+
+	virtual void
+	so_evt_finish() override
+	{
+		// Only the failed coroutine is destroyed at this point.
+		ensure_or_die( 1 == g_destroyed.load(),
+				"suspended coroutines must be alive in so_evt_finish" );
+
+		// The agent can't be resumed anymore.
+		so_5::send< data >( m_chain );
+	}
+
+	virtual so_5::exception_reaction_t
+	so_exception_reaction() const override
+	{
+		return so_5::deregister_coop_on_exception;
+	}
+
+private :
+	const so_5::mchain_t m_chain;
+
+	so_5::coro::task_t
+	wait_forever( mhood_t< start_wait > )
+	{
+		frame_guard_t guard;
+
+		co_await so_5::coro::receive( m_chain, so_5::infinite_wait,
+				[]( so_5::mhood_t< data > ) {} );
+
+		++g_resumed;
+	}
+
+	so_5::coro::task_t
+	sleep_long( mhood_t< start_sleep > )
+	{
+		frame_guard_t guard;
+
+		co_await so_5::coro::sleep_for( hours( 1 ) );
+
+		++g_resumed;
+	}
+
+	so_5::coro::task_t
+	fail( mhood_t< start_fail > )
+	{
+		frame_guard_t guard;
+
+		co_await so_5::coro::sleep_for( milliseconds( 20 ) );
+
+		throw std::runtime_error( "exception from coroutine" );
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				so_5::launch( []( so_5::environment_t & env ) {
+						env.introduce_coop( []( so_5::coop_t & coop ) {
+								coop.make_agent< a_test_t >();
+							} );
+					} );
+
+				ensure_or_die( 3 == g_destroyed.load(),
+						"all coroutines must be destroyed, destroyed: " +
+						std::to_string( g_destroyed.load() ) );
+				ensure_or_die( 0 == g_resumed.load(),
+						"suspended coroutines must not be resumed" );
+			},
+			20,
+			"cancellation of coroutines" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+#else
+
+int
+main()
+{
+	std::cout << "C++20 coroutines are not supported, test skipped" << std::endl;
+
+	return 0;
+}
+
+#endif
+
@@ -0,0 +1,154 @@
+/*
+ * A test for the start of a coroutine inside the event handler.
+ */
+
+#include <iostream>
+#include <atomic>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+#if defined( SO_5_HAVE_COROUTINES )
+
+using namespace std::chrono;
+
+struct start_sleep final : public so_5::signal_t {};
+struct start_quick final : public so_5::signal_t {};
+struct start_fail final : public so_5::signal_t {};
+struct check final : public so_5::signal_t {};
+
+std::atomic< int > g_destroyed{ 0 };
+
+// An object which lives in a coroutine frame.
+struct frame_guard_t
+{
+	~frame_guard_t() { ++g_destroyed; }
+};
+
+class a_test_t final : public so_5::agent_t
+{
+public :
+	a_test_t( context_t ctx ) : so_5::agent_t( ctx )
+	{
+		so_subscribe_self()
+			.event( &a_test_t::sleep )
+			.event( &a_test_t::quick )
+			.event( &a_test_t::fail )
+			.event( &a_test_t::on_check );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		so_5::send< start_sleep >( *this );
+		so_5::send< start_quick >( *this );
+		so_5::send< start_fail >( *this );
+		so_5::send< check >( *this );
+	}
+
+	virtual so_5::exception_reaction_t
+	so_exception_reaction() const override
+	{
+		++m_exceptions;
+		return so_5::ignore_exception;
+	}
+
+private :
+	bool m_sleep_started = false;
+	bool m_quick_finished = false;
+	bool m_must_throw = true;
+	mutable int m_exceptions = 0;
+
+	so_5::coro::task_t
+	sleep( mhood_t< start_sleep > )
+	{
+		frame_guard_t guard;
+
+		m_sleep_started = true;
+
+		co_await so_5::coro::sleep_for( milliseconds( 20 ) );
+
+		so_deregister_agent_coop_normally();
+	}
+
+	so_5::coro::task_t
+	quick( mhood_t< start_quick > )
+	{
+		frame_guard_t guard;
+
+		// There is no suspension for a zero pause.
+		co_await so_5::coro::sleep_for( milliseconds( 0 ) );
+
+		m_quick_finished = true;
+	}
+
+	so_5::coro::task_t
+	fail( mhood_t< start_fail > )
+	{
+		frame_guard_t guard;
+
+		if( m_must_throw )
+			throw std::runtime_error( "exception before the first suspension" );
+
+		co_await so_5::coro::sleep_for( milliseconds( 20 ) );
+	}
+
+	void
+	on_check( mhood_t< check > )
+	{
+		ensure_or_die( m_sleep_started,
+				"coroutine must be started inside the event handler" );
+		ensure_or_die( m_quick_finished,
+				"coroutine without suspension must be finished" );
+		ensure_or_die( 1 == m_exceptions,
+				"exception must be rethrown by the event handler, exceptions: " +
+				std::to_string( m_exceptions ) );
+		ensure_or_die( 2 == g_destroyed.load(),
+				"finished coroutines must be destroyed, destroyed: " +
+				std::to_string( g_destroyed.load() ) );
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				so_5::launch( []( so_5::environment_t & env ) {
+						env.introduce_coop( []( so_5::coop_t & coop ) {
+								coop.make_agent< a_test_t >();
+							} );
+					} );
+
+				ensure_or_die( 3 == g_destroyed.load(),
+						"all coroutines must be destroyed, destroyed: " +
+						std::to_string( g_destroyed.load() ) );
+			},
+			20,
+			"inline start of coroutines" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+#else
+
+int
+main()
+{
+	std::cout << "C++20 coroutines are not supported, test skipped" << std::endl;
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,193 @@
+/*
+ * A test for receiving messages from mchain in coroutines.
+ */
+
+#include <iostream>
+#include <thread>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+#if defined( SO_5_HAVE_COROUTINES )
+
+using namespace std::chrono;
+
+using so_5::mchain_props::extraction_status_t;
+
+struct start final : public so_5::signal_t {};
+struct other final : public so_5::signal_t {};
+
+struct request final : public so_5::message_t
+{
+	so_5::mbox_t m_reply_to;
+	int m_value;
+
+	request( so_5::mbox_t reply_to, int value )
+		:	m_reply_to( std::move(reply_to) ), m_value( value )
+	{}
+};
+
+struct reply final : public so_5::message_t
+{
+	int m_value;
+
+	reply( int value ) : m_value( value ) {}
+};
+
+class a_server_t final : public so_5::agent_t
+{
+public :
+	a_server_t( context_t ctx ) : so_5::agent_t( ctx )
+	{
+		so_subscribe_self().event( []( mhood_t< request > cmd ) {
+				// Negative values are ignored.
+				if( cmd->m_value >= 0 )
+					so_5::send< reply >( cmd->m_reply_to, cmd->m_value * 2 );
+			} );
+	}
+};
+
+class a_client_t final : public so_5::agent_t
+{
+public :
+	a_client_t( context_t ctx, so_5::mbox_t server )
+		:	so_5::agent_t( ctx )
+		,	m_server( std::move(server) )
+	{
+		so_subscribe_self()
+			.event( &a_client_t::on_start )
+			.event( [this]( mhood_t< other > ) { ++m_others; } );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		m_thread = std::this_thread::get_id();
+		so_5::send< start >( *this );
+	}
+
+private :
+	const so_5::mbox_t m_server;
+	std::thread::id m_thread;
+	int m_others = 0;
+
+	void
+	ensure_same_thread( const char * where )
+	{
+		ensure_or_die( m_thread == std::this_thread::get_id(),
+				std::string( "unexpected working thread: " ) + where );
+	}
+
+	so_5::coro::task_t
+	on_start( mhood_t< start > )
+	{
+		ensure_same_thread( "start" );
+
+		auto ch = so_5::create_mchain( so_environment() );
+
+		// Request and reply. The server and the client work on the same
+		// thread so the thread must not be blocked.
+		so_5::send< request >( m_server, ch->as_mbox(), 21 );
+		so_5::send< other >( *this );
+
+		int value = 0;
+		auto r = co_await so_5::coro::receive( ch, seconds( 5 ),
+				[&value]( const reply & msg ) { value = msg.m_value; } );
+
+		ensure_same_thread( "reply" );
+		ensure_or_die( 1u == r.handled(), "reply must be handled" );
+		ensure_or_die( 42 == value, "unexpected reply: " + std::to_string( value ) );
+		ensure_or_die( 1 == m_others,
+				"other event must be handled while the coroutine is suspended" );
+
+		// There is no reply.
+		so_5::send< request >( m_server, ch->as_mbox(), -1 );
+		auto started_at = steady_clock::now();
+		r = co_await so_5::coro::receive( ch, milliseconds( 100 ),
+				[]( const reply & ) {} );
+
+		ensure_same_thread( "timeout" );
+		ensure_or_die( 0u == r.extracted(), "nothing must be extracted" );
+		ensure_or_die( extraction_status_t::no_messages == r.status(),
+				"no_messages is expected" );
+		ensure_or_die( steady_clock::now() - started_at >= milliseconds( 100 ),
+				"the coroutine is resumed too early" );
+
+		// Sleeping.
+		started_at = steady_clock::now();
+		co_await so_5::coro::sleep_for( milliseconds( 50 ) );
+
+		ensure_same_thread( "sleep_for" );
+		ensure_or_die( steady_clock::now() - started_at >= milliseconds( 50 ),
+				"the coroutine is resumed too early after sleep_for" );
+
+		// A message is already in the chain.
+		so_5::send< reply >( ch, 1 );
+		r = co_await so_5::coro::receive( ch, so_5::no_wait,
+				[&value]( const reply & msg ) { value = msg.m_value; } );
+		ensure_or_die( 1u == r.handled() && 1 == value,
+				"message from non-empty chain must be handled" );
+
+		r = co_await so_5::coro::receive( ch, so_5::no_wait,
+				[]( const reply & ) {} );
+		ensure_or_die( 0u == r.extracted(), "the chain must be empty" );
+
+		// Closing of the chain.
+		so_5::send< reply >( ch, 2 );
+		so_5::close_retain_content( ch );
+		r = co_await so_5::coro::receive( ch, so_5::infinite_wait,
+				[&value]( const reply & msg ) { value = msg.m_value; } );
+		ensure_or_die( 1u == r.handled() && 2 == value,
+				"content of the closed chain must be handled" );
+
+		r = co_await so_5::coro::receive( ch, so_5::infinite_wait,
+				[]( const reply & ) {} );
+		ensure_or_die( extraction_status_t::chain_closed == r.status(),
+				"chain_closed is expected" );
+
+		so_deregister_agent_coop_normally();
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				so_5::launch( []( so_5::environment_t & env ) {
+						env.introduce_coop( []( so_5::coop_t & coop ) {
+								auto server = coop.make_agent< a_server_t >();
+								coop.make_agent< a_client_t >(
+										server->so_direct_mbox() );
+							} );
+					} );
+			},
+			20,
+			"receive from mchain in coroutine" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+#else
+
+int
+main()
+{
+	std::cout << "C++20 coroutines are not supported, test skipped" << std::endl;
+
+	return 0;
+}
+
+#endif
+
@@ -8,4 +8,5 @@ MxxRu::Cpp::composite_target {
 	required_prj( "#{path}/invoke_noexcept_code/prj.ut.rb" )
 	required_prj( "#{path}/remaining_time_counter/prj.ut.rb" )
 	required_prj( "#{path}/lock_holder_detector/prj.ut.rb" )
+	required_prj( "#{path}/small_function/prj.ut.rb" )
 }
@@ -0,0 +1,177 @@
+/*
+ * A test for so_5::details::small_function_t.
+ *
+ */
+
+#include <so_5/details/h/small_function.hpp>
+
+#include <various_helpers_1/ensure.hpp>
+
+#include <array>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+using func_t = so_5::details::small_function_t< int(int) >;
+
+int g_alive = 0;
+int g_copies = 0;
+
+// A small callable object which fits into the buffer.
+struct small_t
+{
+	int m_delta;
+
+	small_t( int delta ) : m_delta( delta ) { ++g_alive; }
+	small_t( const small_t & o ) SO_5_NOEXCEPT : m_delta( o.m_delta )
+	{
+		++g_alive; ++g_copies;
+	}
+	small_t( small_t && o ) SO_5_NOEXCEPT : m_delta( o.m_delta ) { ++g_alive; }
+	~small_t() { --g_alive; }
+
+	int operator()( int v ) const { return v + m_delta; }
+};
+
+// A big callable object which goes to dynamic memory.
+struct big_t
+{
+	std::array< int, 32 > m_data;
+
+	big_t( int delta ) { m_data.fill( delta ); ++g_alive; }
+	big_t( const big_t & o ) : m_data( o.m_data ) { ++g_alive; ++g_copies; }
+	big_t( big_t && o ) : m_data( o.m_data ) { ++g_alive; }
+	~big_t() { --g_alive; }
+
+	int operator()( int v ) const { return v + m_data[ 31 ]; }
+};
+
+void
+check_empty()
+{
+	func_t f;
+	ensure_or_die( !f, "default constructed must be empty" );
+
+	func_t f2{ nullptr };
+	ensure_or_die( !f2, "constructed from nullptr must be empty" );
+
+	func_t f3{ f };
+	ensure_or_die( !f3, "copy of empty must be empty" );
+}
+
+void
+check_small()
+{
+	g_copies = 0;
+	{
+		func_t f{ small_t{ 1 } };
+		ensure_or_die( f && 2 == f( 1 ), "small: invalid result" );
+
+		func_t copy{ f };
+		ensure_or_die( 1 == g_copies, "small: object must be copied" );
+		ensure_or_die( 11 == copy( 10 ), "small: invalid result of copy" );
+
+		func_t moved{ std::move(f) };
+		ensure_or_die( !f, "small: source of move must be empty" );
+		ensure_or_die( 4 == moved( 3 ), "small: invalid result after move" );
+
+		moved = nullptr;
+		ensure_or_die( !moved, "small: must be empty after reset" );
+	}
+	ensure_or_die( 0 == g_alive, "small: all objects must be destroyed" );
+}
+
+void
+check_big()
+{
+	g_copies = 0;
+	{
+		func_t f{ big_t{ 2 } };
+		ensure_or_die( f && 3 == f( 1 ), "big: invalid result" );
+
+		// Copies share the same object.
+		func_t c1{ f };
+		func_t c2;
+		c2 = c1;
+		ensure_or_die( 0 == g_copies, "big: object must not be copied" );
+		ensure_or_die( 1 == g_alive, "big: only one object must exist" );
+		ensure_or_die( 12 == c2( 10 ), "big: invalid result of copy" );
+
+		f = nullptr;
+		c1 = nullptr;
+		ensure_or_die( 1 == g_alive, "big: object must be alive" );
+		ensure_or_die( 5 == c2( 3 ), "big: invalid result after reset" );
+	}
+	ensure_or_die( 0 == g_alive, "big: all objects must be destroyed" );
+}
+
+void
+check_big_mutable()
+{
+	std::array< int, 32 > data;
+	data.fill( 0 );
+
+	// A mutable lambda is copied for every copy of small_function.
+	func_t f{ [data]( int v ) mutable { data[ 0 ] += v; return data[ 0 ]; } };
+	ensure_or_die( 1 == f( 1 ), "big mutable: invalid result" );
+
+	func_t copy{ f };
+	ensure_or_die( 3 == f( 2 ), "big mutable: invalid result of source" );
+	ensure_or_die( 11 == copy( 10 ), "big mutable: copies must be independent" );
+
+	func_t moved{ std::move(f) };
+	ensure_or_die( !f, "big mutable: source of move must be empty" );
+	ensure_or_die( 4 == moved( 1 ), "big mutable: state must be moved" );
+
+	copy = moved;
+	ensure_or_die( 5 == copy( 1 ) && 5 == moved( 1 ),
+			"big mutable: copies must be independent after assignment" );
+}
+
+void
+check_not_invocable()
+{
+	static_assert( !std::is_constructible< func_t, int >::value,
+			"small_function must not be constructible from int" );
+	static_assert( !std::is_constructible< func_t, void (*)() >::value,
+			"small_function must not be constructible from "
+			"function with another signature" );
+	static_assert( !std::is_constructible< func_t, std::string (*)(int) >::value,
+			"small_function must not be constructible from "
+			"function with inconvertible result" );
+	static_assert( std::is_constructible< func_t, long (*)(int) >::value,
+			"small_function must be constructible from "
+			"function with convertible result" );
+}
+
+void
+check_swap()
+{
+	{
+		func_t a{ small_t{ 1 } };
+		func_t b{ big_t{ 100 } };
+		func_t e;
+
+		swap( a, b );
+		ensure_or_die( 101 == a( 1 ) && 2 == b( 1 ), "swap: invalid results" );
+
+		a.swap( e );
+		ensure_or_die( !a && 101 == e( 1 ), "swap with empty failed" );
+	}
+	ensure_or_die( 0 == g_alive, "swap: all objects must be destroyed" );
+}
+
+int
+main()
+{
+	check_empty();
+	check_small();
+	check_big();
+	check_big_mutable();
+	check_not_invocable();
+	check_swap();
+
+	std::cout << "OK" << std::endl;
+
+	return 0;
+}
@@ -16,6 +16,8 @@ MxxRu::Cpp::composite_target {
 	add_test[ 'prio_ot_quoted_round_robin/build_tests.rb' ]
 
 	add_test[ 'prio_dt_one_per_prio/build_tests.rb' ]
+
+	add_test[ 'thread_affinity/build_tests.rb' ]
 }
 
 
@@ -8,4 +8,5 @@ MxxRu::Cpp::composite_target {
 	required_prj "#{path}/simple/prj.ut.rb"
 	required_prj "#{path}/contexts/prj.ut.rb"
 	required_prj "#{path}/dereg_when_queue_not_empty/prj.ut.rb"
+	required_prj "#{path}/work_stealing/prj.ut.rb"
 }
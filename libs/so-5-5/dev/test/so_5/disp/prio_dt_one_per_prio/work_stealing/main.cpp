@@ -0,0 +1,200 @@
+/*
+ * A test for work stealing in prio_dedicated_threads::one_per_prio
+ * dispatcher.
+ */
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+const std::size_t messages_count = 20;
+const std::size_t steal_safe_agents = 3;
+
+using thread_ids_t = std::set< so_5::current_thread_id_t >;
+
+struct msg_work : public so_5::message_t
+	{
+		std::size_t m_index;
+
+		msg_work( std::size_t index ) : m_index( index ) {}
+	};
+
+struct msg_done : public so_5::message_t
+	{
+		std::string m_name;
+		thread_ids_t m_threads;
+		std::string m_error;
+
+		msg_done(
+			std::string name,
+			thread_ids_t threads,
+			std::string error )
+			:	m_name( std::move(name) )
+			,	m_threads( std::move(threads) )
+			,	m_error( std::move(error) )
+			{}
+	};
+
+class a_worker_t : public so_5::agent_t
+{
+	public:
+		a_worker_t(
+			context_t ctx,
+			so_5::priority_t priority,
+			std::string name,
+			so_5::mbox_t coordinator )
+			:	so_5::agent_t( ctx + priority )
+			,	m_name( std::move(name) )
+			,	m_coordinator( std::move(coordinator) )
+		{}
+
+		virtual void
+		so_define_agent() override
+		{
+			so_subscribe_self().event( &a_worker_t::evt_work );
+		}
+
+		virtual void
+		so_evt_start() override
+		{
+			for( std::size_t i = 0; i != messages_count; ++i )
+				so_5::send< msg_work >( *this, i );
+		}
+
+		void
+		evt_work( const msg_work & msg )
+		{
+			if( 1 != ++m_in_handler )
+				set_error( "parallel execution of event handlers" );
+
+			if( m_handled != msg.m_index )
+				set_error( "unexpected index: " + std::to_string( msg.m_index ) +
+						", expected: " + std::to_string( m_handled ) );
+
+			m_threads.insert( so_5::query_current_thread_id() );
+
+			// Owner of the queue must be busy for some time.
+			std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+
+			--m_in_handler;
+
+			if( messages_count == ++m_handled )
+				so_5::send< msg_done >( m_coordinator,
+						m_name, m_threads, m_error );
+		}
+
+	private:
+		const std::string m_name;
+		const so_5::mbox_t m_coordinator;
+
+		// NOTE: there is no need for synchronization because
+		// event handlers must not be called in parallel.
+		std::size_t m_handled{ 0 };
+		thread_ids_t m_threads;
+		std::string m_error;
+
+		std::atomic< int > m_in_handler{ 0 };
+
+		void
+		set_error( std::string error )
+		{
+			if( m_error.empty() )
+				m_error = std::move(error);
+		}
+};
+
+class a_coordinator_t : public so_5::agent_t
+{
+	public:
+		a_coordinator_t( context_t ctx )
+			:	so_5::agent_t( ctx )
+		{
+			so_subscribe_self().event( &a_coordinator_t::evt_done );
+		}
+
+	private:
+		std::size_t m_done{ 0 };
+		thread_ids_t m_steal_safe_threads;
+
+		void
+		evt_done( const msg_done & msg )
+		{
+			if( !msg.m_error.empty() )
+				throw std::runtime_error( msg.m_name + ": " + msg.m_error );
+
+			if( "ordinary" == msg.m_name && 1 != msg.m_threads.size() )
+				throw std::runtime_error( "ordinary agent is handled on "
+						"several threads: " +
+						std::to_string( msg.m_threads.size() ) );
+
+			if( "steal_safe" == msg.m_name )
+				m_steal_safe_threads.insert(
+						msg.m_threads.begin(), msg.m_threads.end() );
+
+			if( steal_safe_agents + 1 == ++m_done )
+				{
+					if( 1 == m_steal_safe_threads.size() )
+						throw std::runtime_error( "steal-safe agents are handled "
+								"only on their own thread" );
+
+					so_deregister_agent_coop_normally();
+				}
+		}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				using namespace so_5::disp::prio_dedicated_threads::one_per_prio;
+
+				so_5::launch(
+					[]( so_5::environment_t & env )
+					{
+						env.introduce_coop( [&]( so_5::coop_t & coop ) {
+							auto coordinator = coop.make_agent< a_coordinator_t >()
+									->so_direct_mbox();
+
+							for( std::size_t i = 0; i != steal_safe_agents; ++i )
+								coop.make_agent_with_binder< a_worker_t >(
+										create_disp_binder( "prio_dispatcher",
+												bind_params_t{}.steal_safe( true ) ),
+										so_5::prio::p7,
+										"steal_safe",
+										coordinator );
+
+							coop.make_agent_with_binder< a_worker_t >(
+									create_disp_binder( "prio_dispatcher" ),
+									so_5::prio::p6,
+									"ordinary",
+									coordinator );
+						} );
+					},
+					[]( so_5::environment_params_t & params )
+					{
+						params.add_named_dispatcher(
+								"prio_dispatcher",
+								create_disp( disp_params_t{}.turn_work_stealing_on() ) );
+					} );
+			},
+			20,
+			"work stealing in prio_dedicated_threads::one_per_prio dispatcher" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
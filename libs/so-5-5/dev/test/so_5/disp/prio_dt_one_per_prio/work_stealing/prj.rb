@@ -0,0 +1,11 @@
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+	required_prj 'so_5/prj.rb'
+
+	target '_unit.test.disp.prio_dt_one_per_prio.work_stealing'
+
+	cpp_source 'main.cpp'
+}
+
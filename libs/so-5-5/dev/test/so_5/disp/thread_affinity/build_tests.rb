@@ -0,0 +1,7 @@
+#!/usr/local/bin/ruby
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::composite_target {
+
+	required_prj "test/so_5/disp/thread_affinity/simple/prj.ut.rb"
+}
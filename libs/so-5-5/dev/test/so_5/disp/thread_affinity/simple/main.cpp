@@ -0,0 +1,199 @@
+/*
+ * A simple test for thread affinity of dispatchers' working threads.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+
+#if defined( __linux__ )
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+namespace affinity = so_5::disp::thread_affinity;
+
+// Get CPUs the current thread is allowed to run on.
+affinity::cpus_t
+current_cpus()
+{
+	affinity::cpus_t result;
+#if defined( __linux__ )
+	cpu_set_t set;
+	CPU_ZERO( &set );
+	if( 0 != pthread_getaffinity_np( pthread_self(), sizeof( set ), &set ) )
+		throw std::runtime_error( "pthread_getaffinity_np failed" );
+
+	for( affinity::cpu_index_t cpu = 0; cpu != CPU_SETSIZE; ++cpu )
+		if( CPU_ISSET( cpu, &set ) )
+			result.push_back( cpu );
+#endif
+	return result;
+}
+
+struct msg_result : public so_5::message_t
+{
+	std::string m_who;
+	affinity::cpus_t m_cpus;
+
+	msg_result( std::string who, affinity::cpus_t cpus )
+		:	m_who( std::move( who ) )
+		,	m_cpus( std::move( cpus ) )
+	{}
+};
+
+class a_collector_t : public so_5::agent_t
+{
+public :
+	a_collector_t(
+		context_t ctx,
+		affinity::cpus_t expected,
+		unsigned int messages_to_receive )
+		:	so_5::agent_t( ctx )
+		,	m_expected( std::move( expected ) )
+		,	m_remaining( messages_to_receive )
+	{
+		so_default_state().event( [this]( const msg_result & msg ) {
+				if( !m_expected.empty() && m_expected != msg.m_cpus )
+					throw std::runtime_error( "unexpected CPUs for: " + msg.m_who );
+
+				if( 0 == (--m_remaining) )
+					so_deregister_agent_coop_normally();
+			} );
+	}
+
+private :
+	const affinity::cpus_t m_expected;
+	unsigned int m_remaining;
+};
+
+class a_test_t : public so_5::agent_t
+{
+public :
+	a_test_t(
+		context_t ctx,
+		std::string name,
+		so_5::mbox_t collector )
+		:	so_5::agent_t( ctx )
+		,	m_name( std::move( name ) )
+		,	m_collector( std::move( collector ) )
+	{}
+
+	virtual void
+	so_evt_start() override
+	{
+		so_5::send< msg_result >( m_collector, m_name, current_cpus() );
+	}
+
+private :
+	const std::string m_name;
+	const so_5::mbox_t m_collector;
+};
+
+void
+init( so_5::environment_t & env )
+{
+	// The last CPU available for the main thread is used.
+	auto available = current_cpus();
+	affinity::cpus_t expected;
+	if( !available.empty() )
+		expected.push_back( available.back() );
+
+	const auto aff = affinity::affinity_t::same_cpus( expected );
+
+	using namespace so_5::disp;
+
+	auto one_thread_disp = one_thread::create_private_disp( env,
+			std::string(),
+			one_thread::disp_params_t{}.thread_affinity( aff ) );
+	auto active_obj_disp = active_obj::create_private_disp( env,
+			std::string(),
+			active_obj::disp_params_t{}.thread_affinity( aff ) );
+	auto active_group_disp = active_group::create_private_disp( env,
+			std::string(),
+			active_group::disp_params_t{}.thread_affinity( aff ) );
+	auto thread_pool_disp = thread_pool::create_private_disp( env,
+			std::string(),
+			thread_pool::disp_params_t{}.thread_count( 2 ).thread_affinity( aff ) );
+	auto adv_thread_pool_disp = adv_thread_pool::create_private_disp( env,
+			std::string(),
+			adv_thread_pool::disp_params_t{}.thread_count( 2 ).thread_affinity( aff ) );
+	auto strictly_ordered_disp = prio_one_thread::strictly_ordered::create_private_disp(
+			env,
+			std::string(),
+			prio_one_thread::strictly_ordered::disp_params_t{}.thread_affinity( aff ) );
+	auto quoted_round_robin_disp = prio_one_thread::quoted_round_robin::create_private_disp(
+			env,
+			prio_one_thread::quoted_round_robin::quotes_t{ 10 },
+			std::string(),
+			prio_one_thread::quoted_round_robin::disp_params_t{}.thread_affinity( aff ) );
+	auto one_per_prio_disp = prio_dedicated_threads::one_per_prio::create_private_disp(
+			env,
+			std::string(),
+			prio_dedicated_threads::one_per_prio::disp_params_t{}.thread_affinity( aff ) );
+
+	env.introduce_coop( [&]( so_5::coop_t & coop ) {
+		auto collector = coop.make_agent< a_collector_t >( expected, 8u )
+				->so_direct_mbox();
+
+		coop.make_agent_with_binder< a_test_t >( one_thread_disp->binder(),
+				"one_thread", collector );
+		coop.make_agent_with_binder< a_test_t >( active_obj_disp->binder(),
+				"active_obj", collector );
+		coop.make_agent_with_binder< a_test_t >(
+				active_group_disp->binder( "group" ),
+				"active_group", collector );
+		coop.make_agent_with_binder< a_test_t >(
+				thread_pool_disp->binder( thread_pool::bind_params_t{} ),
+				"thread_pool", collector );
+		coop.make_agent_with_binder< a_test_t >(
+				adv_thread_pool_disp->binder( adv_thread_pool::bind_params_t{} ),
+				"adv_thread_pool", collector );
+		coop.make_agent_with_binder< a_test_t >( strictly_ordered_disp->binder(),
+				"strictly_ordered", collector );
+		coop.make_agent_with_binder< a_test_t >( quoted_round_robin_disp->binder(),
+				"quoted_round_robin", collector );
+		coop.make_agent_with_binder< a_test_t >( one_per_prio_disp->binder(),
+				"one_per_prio", collector );
+	} );
+}
+
+void
+check_affinity_object()
+{
+	const auto aff = affinity::affinity_t::one_cpu_per_thread( { 1, 3, 5 } );
+	if( affinity::cpus_t{ 3 } != aff.cpus_for_thread( 1 ) ||
+			affinity::cpus_t{ 1 } != aff.cpus_for_thread( 3 ) )
+		throw std::runtime_error( "unexpected result of one_cpu_per_thread" );
+
+	if( !affinity::affinity_t{}.cpus_for_thread( 0 ).empty() )
+		throw std::runtime_error( "CPUs for empty affinity must be empty" );
+}
+
+int
+main()
+{
+	try
+	{
+		check_affinity_object();
+
+		run_with_time_limit(
+			[]()
+			{
+				so_5::launch( &init );
+			},
+			20,
+			"thread affinity test" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
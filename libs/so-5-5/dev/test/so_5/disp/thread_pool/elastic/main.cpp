@@ -0,0 +1,254 @@
+/*
+ * Test for elastic mode of thread_pool dispatcher.
+ */
+
+#include <so_5/all.hpp>
+
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+using namespace std;
+
+using namespace so_5;
+using namespace so_5::disp::thread_pool;
+
+const size_t min_threads = 1;
+const size_t max_threads = 4;
+const unsigned int workers_count = 8;
+
+struct thread_ids_t
+	{
+		mutex m_lock;
+		set< thread::id > m_ids;
+		unsigned int m_handled = 0;
+
+		void
+		add()
+			{
+				lock_guard< mutex > lock{ m_lock };
+				m_ids.insert( this_thread::get_id() );
+				++m_handled;
+			}
+
+		unsigned int
+		handled()
+			{
+				lock_guard< mutex > lock{ m_lock };
+				return m_handled;
+			}
+	};
+
+struct do_work : public signal_t {};
+
+class a_worker_t final : public agent_t
+	{
+	public :
+		a_worker_t( context_t ctx, thread_ids_t & ids )
+			:	agent_t{ ctx }
+			,	m_ids( ids )
+			{
+				so_subscribe_self().event< do_work >( [this] {
+					m_ids.add();
+					this_thread::sleep_for( chrono::milliseconds(100) );
+				} );
+			}
+
+	private :
+		thread_ids_t & m_ids;
+	};
+
+struct resize_counters_t
+	{
+		size_t m_added = 0;
+		size_t m_retired = 0;
+	};
+
+void
+wait_for_shrinking( environment_t & env )
+	{
+		namespace stats = so_5::stats;
+
+		auto ch = create_mchain( env );
+
+		env.introduce_coop( [&]( coop_t & coop ) {
+				auto a = coop.define_agent();
+				a.event( env.stats_controller().mbox(),
+					[ch]( const stats::messages::quantity< size_t > & evt ) {
+						if( stats::suffixes::disp_threads_added_count() == evt.m_suffix ||
+								stats::suffixes::disp_threads_retired_count() ==
+										evt.m_suffix )
+							send< stats::messages::quantity< size_t > >( ch, evt );
+					} );
+			} );
+
+		env.stats_controller().set_distribution_period(
+				chrono::milliseconds( 50 ) );
+		env.stats_controller().turn_on();
+
+		resize_counters_t counters;
+		receive( from( ch )
+				.empty_timeout( chrono::seconds( 5 ) )
+				.stop_on( [&counters] {
+						return counters.m_retired &&
+								counters.m_added == counters.m_retired;
+					} ),
+			[&counters]( const stats::messages::quantity< size_t > & evt ) {
+				if( stats::suffixes::disp_threads_added_count() == evt.m_suffix )
+					counters.m_added = evt.m_value;
+				else
+					counters.m_retired = evt.m_value;
+			} );
+
+		ensure_or_die( counters.m_added > 0,
+				"there must be added threads" );
+		ensure_or_die( counters.m_added == counters.m_retired,
+				"all added threads must be retired, added: " +
+				to_string( counters.m_added ) + ", retired: " +
+				to_string( counters.m_retired ) );
+	}
+
+void
+do_test()
+	{
+		thread_ids_t ids;
+
+		wrapped_env_t sobj;
+		auto & env = sobj.environment();
+
+		auto disp = create_private_disp( env,
+				"elastic",
+				disp_params_t{}.elastic(
+					elastic_params_t{ min_threads, max_threads }
+						.idle_timeout( chrono::milliseconds( 100 ) ) ) );
+
+		vector< mbox_t > workers;
+		env.introduce_coop(
+			disp->binder( bind_params_t{}.fifo( fifo_t::individual ) ),
+			[&]( coop_t & coop ) {
+				for( unsigned int i = 0; i != workers_count; ++i )
+					workers.push_back(
+							coop.make_agent< a_worker_t >( ids )->so_direct_mbox() );
+			} );
+
+		for( auto & w : workers )
+			send< do_work >( w );
+
+		while( ids.handled() != workers_count )
+			this_thread::sleep_for( chrono::milliseconds( 10 ) );
+
+		ensure_or_die( ids.m_ids.size() > min_threads,
+				"count of threads must grow, actual: " +
+				to_string( ids.m_ids.size() ) );
+		ensure_or_die( ids.m_ids.size() <= max_threads,
+				"too many threads are used: " + to_string( ids.m_ids.size() ) );
+
+		wait_for_shrinking( env );
+	}
+
+// A lock without the support of waiting with a timeout.
+class custom_cond_t final : public queue_traits::condition_t
+	{
+	public :
+		custom_cond_t( queue_traits::condition_unique_ptr_t actual )
+			:	m_actual( std::move(actual) )
+			{}
+
+		virtual void
+		wait() SO_5_NOEXCEPT override { m_actual->wait(); }
+
+		virtual void
+		notify() SO_5_NOEXCEPT override { m_actual->notify(); }
+
+	private :
+		queue_traits::condition_unique_ptr_t m_actual;
+	};
+
+class custom_lock_t final : public queue_traits::lock_t
+	{
+	public :
+		custom_lock_t( queue_traits::lock_unique_ptr_t actual )
+			:	m_actual( std::move(actual) )
+			{}
+
+		virtual void
+		lock() SO_5_NOEXCEPT override { m_actual->lock(); }
+
+		virtual void
+		unlock() SO_5_NOEXCEPT override { m_actual->unlock(); }
+
+		virtual queue_traits::condition_unique_ptr_t
+		allocate_condition() override
+			{
+				return queue_traits::condition_unique_ptr_t{
+						new custom_cond_t{ m_actual->allocate_condition() } };
+			}
+
+	private :
+		queue_traits::lock_unique_ptr_t m_actual;
+	};
+
+void
+do_test_custom_lock_rejected()
+	{
+		wrapped_env_t sobj;
+		auto & env = sobj.environment();
+
+		const auto factory = [] {
+				return queue_traits::lock_unique_ptr_t{
+						new custom_lock_t{ queue_traits::simple_lock_factory()() } };
+			};
+
+		// Custom lock can be used in the ordinary mode.
+		create_private_disp( env,
+				"ordinary",
+				disp_params_t{}.thread_count( 2 ).tune_queue_params(
+					[&]( queue_traits::queue_params_t & p ) {
+						p.lock_factory( factory );
+					} ) );
+
+		try
+			{
+				create_private_disp( env,
+						"elastic",
+						disp_params_t{}
+							.elastic( elastic_params_t{ min_threads, max_threads } )
+							.tune_queue_params(
+								[&]( queue_traits::queue_params_t & p ) {
+									p.lock_factory( factory );
+								} ) );
+
+				ensure_or_die( false, "an exception must be thrown" );
+			}
+		catch( const so_5::exception_t & x )
+			{
+				ensure_or_die( rc_timed_wait_not_supported == x.error_code(),
+						"unexpected error code: " + to_string( x.error_code() ) );
+			}
+	}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				do_test();
+				do_test_custom_lock_rejected();
+			},
+			20,
+			"thread_pool elastic mode" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -7,4 +7,9 @@ MxxRu::Cpp::composite_target {
 
 	required_prj "#{path}/simple_mtsafe_st/build_tests.rb"
 	required_prj "#{path}/simple_not_mtsafe_st/build_tests.rb"
+	required_prj "#{path}/hybrid_mtsafe_st/build_tests.rb"
+
+	if 'linux' == toolset.tag( 'unix_port', 'unknown' )
+		required_prj "#{path}/epoll_mtsafe_st/build_tests.rb"
+	end
 }
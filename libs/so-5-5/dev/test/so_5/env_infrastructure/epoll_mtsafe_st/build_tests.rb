@@ -0,0 +1,14 @@
+#!/usr/local/bin/ruby
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::composite_target {
+
+	path = 'test/so_5/env_infrastructure/epoll_mtsafe_st'
+
+	required_prj "#{path}/simple_agent/prj.ut.rb"
+	required_prj "#{path}/thread_id/prj.ut.rb"
+	required_prj "#{path}/periodic_msg/prj.ut.rb"
+	required_prj "#{path}/delayed_msg_from_outside/prj.ut.rb"
+	required_prj "#{path}/socketpair_ping_pong/prj.ut.rb"
+	required_prj "#{path}/io_from_outside/prj.ut.rb"
+}
@@ -0,0 +1,177 @@
+/*
+ * A test for epoll_mtsafe_st_env_infastructure: data is written to
+ * a socket from another thread while the main thread sleeps.
+ */
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <thread>
+
+using namespace std;
+
+namespace io = so_5::env_infrastructures::epoll_mtsafe;
+
+const int total_bytes = 10;
+
+struct data_received { int m_total; };
+
+class a_test_t final : public so_5::agent_t
+{
+public :
+	using so_5::agent_t::agent_t;
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( [this]( const data_received & msg ) {
+				if( total_bytes == msg.m_total )
+					so_deregister_agent_coop_normally();
+			} );
+	}
+};
+
+void
+check_errors()
+{
+	// There is no I/O controller in the default environment.
+	so_5::launch( []( so_5::environment_t & env ) {
+			bool thrown = false;
+			try
+			{
+				io::io_controller( env );
+			}
+			catch( const so_5::exception_t & ex )
+			{
+				ensure( so_5::rc_no_io_controller == ex.error_code(),
+						"rc_no_io_controller expected" );
+				thrown = true;
+			}
+			ensure( thrown, "an exception expected for default environment" );
+		} );
+
+	// A descriptor can't be registered twice.
+	so_5::launch(
+		[]( so_5::environment_t & env ) {
+			int fds[ 2 ];
+			ensure( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ),
+					"socketpair failed" );
+
+			auto & controller = io::io_controller( env );
+			ensure( controller.epoll_fd() >= 0, "epoll_fd must be valid" );
+
+			controller.add( fds[ 0 ], EPOLLIN, []( std::uint32_t ) {} );
+
+			bool thrown = false;
+			try
+			{
+				controller.add( fds[ 0 ], EPOLLIN, []( std::uint32_t ) {} );
+			}
+			catch( const so_5::exception_t & ex )
+			{
+				ensure( so_5::rc_epoll_operation_failed == ex.error_code(),
+						"rc_epoll_operation_failed expected" );
+				thrown = true;
+			}
+			ensure( thrown, "an exception expected for second add" );
+
+			controller.modify( fds[ 0 ], EPOLLIN | EPOLLOUT );
+			controller.remove( fds[ 0 ] );
+			// Removal of unknown descriptor is ignored.
+			controller.remove( fds[ 0 ] );
+
+			::close( fds[ 0 ] );
+			::close( fds[ 1 ] );
+		},
+		[]( so_5::environment_params_t & params ) {
+			params.infrastructure_factory( io::factory() );
+		} );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				check_errors();
+
+				int fds[ 2 ];
+				ensure( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ),
+						"socketpair failed" );
+				::fcntl( fds[ 1 ], F_SETFL, O_NONBLOCK );
+
+				thread outside_thread;
+				int received = 0;
+				bool removed = false;
+
+				so_5::launch(
+					[&]( so_5::environment_t & env ) {
+						so_5::mbox_t agent_mbox;
+						env.introduce_coop( [&]( so_5::coop_t & coop ) {
+							agent_mbox = coop.make_agent< a_test_t >()->so_direct_mbox();
+						} );
+
+						const int fd = fds[ 1 ];
+						auto & controller = io::io_controller( env );
+						controller.add( fd, EPOLLIN,
+							[&, fd, agent_mbox]( std::uint32_t ) {
+								ensure( !removed, "handler called after removal" );
+
+								char buf[ 16 ];
+								const auto n = ::read( fd, buf, sizeof(buf) );
+								if( n > 0 )
+									received += static_cast< int >( n );
+
+								if( total_bytes == received )
+								{
+									// A handler can remove its own descriptor.
+									controller.remove( fd );
+									removed = true;
+								}
+
+								so_5::send< data_received >( agent_mbox, received );
+							} );
+
+						outside_thread = thread( [&fds] {
+							for( int i = 0; i != total_bytes; ++i )
+							{
+								this_thread::sleep_for( chrono::milliseconds( 20 ) );
+								const char c = 'a';
+								ensure( 1 == ::write( fds[ 0 ], &c, 1 ),
+										"write to socket failed" );
+							}
+						} );
+					},
+					[]( so_5::environment_params_t & params ) {
+						params.infrastructure_factory( io::factory() );
+					} );
+
+				outside_thread.join();
+
+				ensure( total_bytes == received,
+						"unexpected count of bytes: " + to_string( received ) );
+
+				::close( fds[ 0 ] );
+				::close( fds[ 1 ] );
+			},
+			5,
+			"I/O events from outside" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
+
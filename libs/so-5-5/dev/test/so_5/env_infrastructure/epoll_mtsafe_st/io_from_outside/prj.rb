@@ -0,0 +1,11 @@
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+	required_prj 'so_5/prj.rb'
+
+	target '_unit.test.env_infrastructure.epoll_mtsafe_st.io_from_outside'
+
+	cpp_source 'main.cpp'
+}
+
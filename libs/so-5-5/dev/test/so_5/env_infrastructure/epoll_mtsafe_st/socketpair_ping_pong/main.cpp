@@ -0,0 +1,138 @@
+/*
+ * A test for epoll_mtsafe_st_env_infastructure: ping-pong between
+ * an agent and an I/O handler via socketpair.
+ */
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <thread>
+
+using namespace std;
+
+namespace io = so_5::env_infrastructures::epoll_mtsafe;
+
+const unsigned int total_pings = 1000;
+
+struct pong { unsigned int m_value; };
+
+class a_test_t final : public so_5::agent_t
+{
+public :
+	a_test_t( context_t ctx, int fd, thread::id & agent_thread )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_fd( fd )
+		,	m_agent_thread( agent_thread )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( &a_test_t::on_pong );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		m_agent_thread = this_thread::get_id();
+		send_ping( 0 );
+	}
+
+private :
+	const int m_fd;
+	thread::id & m_agent_thread;
+
+	void
+	on_pong( const pong & msg )
+	{
+		ensure( this_thread::get_id() == m_agent_thread,
+				"agent must work on the same thread" );
+
+		if( msg.m_value + 1 == total_pings )
+			so_deregister_agent_coop_normally();
+		else
+			send_ping( msg.m_value + 1 );
+	}
+
+	void
+	send_ping( unsigned int value )
+	{
+		ensure( sizeof(value) == ::write( m_fd, &value, sizeof(value) ),
+				"write to socket failed" );
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				int fds[ 2 ];
+				ensure( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ),
+						"socketpair failed" );
+				::fcntl( fds[ 1 ], F_SETFL, O_NONBLOCK );
+
+				thread::id agent_thread;
+				thread::id io_thread;
+				unsigned int received = 0;
+
+				so_5::launch(
+					[&]( so_5::environment_t & env ) {
+						so_5::mbox_t agent_mbox;
+						env.introduce_coop( [&]( so_5::coop_t & coop ) {
+							agent_mbox = coop.make_agent< a_test_t >(
+									fds[ 0 ], agent_thread )->so_direct_mbox();
+						} );
+
+						const int fd = fds[ 1 ];
+						io::io_controller( env ).add( fd, EPOLLIN,
+							[&, fd, agent_mbox]( std::uint32_t events ) {
+								ensure( 0 != ( events & EPOLLIN ),
+										"EPOLLIN expected" );
+								io_thread = this_thread::get_id();
+
+								unsigned int value;
+								while( sizeof(value) == ::read( fd, &value, sizeof(value) ) )
+								{
+									ensure( received == value,
+											"unexpected value: " + to_string( value ) );
+									++received;
+									so_5::send< pong >( agent_mbox, value );
+								}
+							} );
+					},
+					[]( so_5::environment_params_t & params ) {
+						params.infrastructure_factory(
+								io::factory( io::params_t{}
+										.max_demands_between_io_checks( 2 ) ) );
+					} );
+
+				ensure( total_pings == received,
+						"unexpected count of pings: " + to_string( received ) );
+				ensure( agent_thread == io_thread,
+						"agent and I/O handler must work on the same thread" );
+
+				::close( fds[ 0 ] );
+				::close( fds[ 1 ] );
+			},
+			5,
+			"ping-pong via socketpair" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,11 @@
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+	required_prj 'so_5/prj.rb'
+
+	target '_unit.test.env_infrastructure.hybrid_mtsafe_st.create_default_disp_binder'
+
+	cpp_source 'main.cpp'
+}
+
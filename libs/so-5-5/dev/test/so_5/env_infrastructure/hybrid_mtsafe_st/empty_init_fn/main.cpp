@@ -0,0 +1,37 @@
+/*
+ * A test for hybrid_mtsafe_st_env_infastructure with empty init_fn function.
+ */
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+
+#include <utest_helper_1/h/helper.hpp>
+
+using namespace std;
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				so_5::launch( []( so_5::environment_t & ) {},
+					[]( so_5::environment_params_t & params ) {
+						params.infrastructure_factory(
+								so_5::env_infrastructures::hybrid_mtsafe::factory() );
+					} );
+			},
+			5,
+			"empty init_fn for hybrid_mtsafe_st_env_infrastructure" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,11 @@
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+	required_prj 'so_5/prj.rb'
+
+	target '_unit.test.env_infrastructure.hybrid_mtsafe_st.empty_init_fn'
+
+	cpp_source 'main.cpp'
+}
+
@@ -0,0 +1,149 @@
+/*
+ * A test for hybrid_mtsafe_st_env_infastructure: messages are sent
+ * from several outside threads while the agent sends messages to itself.
+ */
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+#include <array>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const std::size_t producers_count = 4;
+const unsigned int messages_from_producer = 10000;
+const unsigned int local_messages = 10000;
+
+struct from_outside
+{
+	std::size_t m_producer;
+	unsigned int m_value;
+};
+
+struct local_tick : public so_5::signal_t {};
+
+class a_test_t final : public so_5::agent_t
+{
+public :
+	a_test_t( context_t ctx, thread::id & agent_thread )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_agent_thread( agent_thread )
+	{
+		m_expected.fill( 0u );
+	}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( &a_test_t::on_from_outside )
+			.event( &a_test_t::on_local_tick );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		m_agent_thread = this_thread::get_id();
+		so_5::send< local_tick >( *this );
+	}
+
+private :
+	thread::id & m_agent_thread;
+
+	array< unsigned int, producers_count > m_expected;
+	std::size_t m_completed_producers = 0;
+	unsigned int m_local_ticks = 0;
+
+	void
+	on_from_outside( const from_outside & msg )
+	{
+		ensure( this_thread::get_id() == m_agent_thread,
+				"agent must work on the same thread" );
+
+		auto & expected = m_expected[ msg.m_producer ];
+		ensure( expected == msg.m_value,
+				"unexpected value from producer " + to_string( msg.m_producer ) +
+				": " + to_string( msg.m_value ) +
+				", expected: " + to_string( expected ) );
+		++expected;
+
+		if( messages_from_producer == expected )
+			++m_completed_producers;
+
+		try_finish();
+	}
+
+	void
+	on_local_tick( mhood_t< local_tick > )
+	{
+		if( ++m_local_ticks != local_messages )
+			so_5::send< local_tick >( *this );
+
+		try_finish();
+	}
+
+	void
+	try_finish()
+	{
+		if( producers_count == m_completed_producers &&
+				local_messages == m_local_ticks )
+			so_deregister_agent_coop_normally();
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				thread::id agent_thread;
+				vector< thread > producers;
+
+				so_5::launch(
+					[&]( so_5::environment_t & env ) {
+						so_5::mbox_t test_mbox;
+						env.introduce_coop( [&]( so_5::coop_t & coop ) {
+							test_mbox = coop.make_agent< a_test_t >( agent_thread )
+									->so_direct_mbox();
+						} );
+
+						for( std::size_t p = 0; p != producers_count; ++p )
+							producers.emplace_back( [test_mbox, p] {
+								for( unsigned int i = 0; i != messages_from_producer; ++i )
+								{
+									so_5::send< from_outside >( test_mbox, p, i );
+									// Let the main thread to fall asleep sometimes.
+									if( 0 == i % 1000 )
+										this_thread::sleep_for( chrono::milliseconds( 1 ) );
+								}
+							} );
+					},
+					[]( so_5::environment_params_t & params ) {
+						params.infrastructure_factory(
+								so_5::env_infrastructures::hybrid_mtsafe::factory() );
+					} );
+
+				for( auto & t : producers )
+					t.join();
+
+				ensure( this_thread::get_id() == agent_thread,
+						"agent must work on the thread which called launch()" );
+			},
+			20,
+			"sends from outside threads" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
+
@@ -9,6 +9,7 @@ MxxRu::Cpp::composite_target {
 	required_prj( "#{path}/drop_subscription/prj.ut.rb" )
 	required_prj( "#{path}/drop_subscr_when_demand_in_queue/prj.ut.rb" )
 	required_prj( "#{path}/adaptive_subscr_storage/prj.ut.rb" )
+	required_prj( "#{path}/flat_hash_subscr_storage/prj.ut.rb" )
 	required_prj( "#{path}/mpsc_mbox/prj.ut.rb" )
 	required_prj( "#{path}/mpsc_mbox_illegal_subscriber/prj.ut.rb" )
 	required_prj( "#{path}/mpsc_mbox_stress/prj.ut.rb" )
@@ -16,4 +17,8 @@ MxxRu::Cpp::composite_target {
 	required_prj( "#{path}/delivery_filters/build_tests.rb" )
 	required_prj( "#{path}/local_mbox_growth/prj.ut.rb" )
 	required_prj( "#{path}/custom_mbox_simple/prj.ut.rb" )
+	required_prj( "#{path}/lazy_direct_mbox/prj.ut.rb" )
+	required_prj( "#{path}/keyed_mbox/prj.ut.rb" )
+	required_prj( "#{path}/load_balancing_mbox/prj.ut.rb" )
+	required_prj( "#{path}/named_mbox_concurrent/prj.ut.rb" )
 }
@@ -332,6 +332,7 @@ do_test()
 	,	{ "vector[16]", so_5::vector_based_subscription_storage_factory( 16 ) }
 	,	{ "map", so_5::map_based_subscription_storage_factory() }
 	,	{ "hash_table", so_5::hash_table_based_subscription_storage_factory() }
+	,	{ "flat_hash", so_5::flat_hash_subscription_storage_factory() }
 	,	{ "adaptive[1]", so_5::adaptive_subscription_storage_factory( 1 ) }
 	,	{ "adaptive[2]", so_5::adaptive_subscription_storage_factory( 2 ) }
 	,	{ "adaptive[3]", so_5::adaptive_subscription_storage_factory( 3 ) }
@@ -0,0 +1,179 @@
+/*
+ * A test for flat hash-table-based subscription storage with
+ * big count of subscriptions.
+ */
+
+#include <iostream>
+#include <set>
+#include <tuple>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+struct msg_one : public so_5::signal_t {};
+struct msg_two : public so_5::signal_t {};
+
+struct msg_check : public so_5::signal_t {};
+
+class a_test_t : public so_5::agent_t
+{
+	// Subscription key: (mbox index, state index, is msg_two).
+	using key_t = std::tuple< std::size_t, std::size_t, bool >;
+
+public :
+	a_test_t( context_t ctx )
+		:	so_5::agent_t( ctx + so_5::flat_hash_subscription_storage_factory() )
+	{
+		for( std::size_t i = 0; i != mboxes_count; ++i )
+			m_mboxes.push_back( so_environment().create_mbox() );
+
+		for( std::size_t i = 0; i != states_count; ++i )
+			m_states.emplace_back( new state_t( this ) );
+	}
+
+	virtual void
+	so_define_agent() override
+	{
+		for( std::size_t m = 0; m != mboxes_count; ++m )
+			for( std::size_t s = 0; s != states_count; ++s )
+			{
+				subscribe( key_t{ m, s, false } );
+				if( 0 == ( m + s ) % 2 )
+					subscribe( key_t{ m, s, true } );
+			}
+
+		so_subscribe_self().event( &a_test_t::evt_check );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		ensure_subscriptions( "after creation" );
+
+		// Drop some subscriptions in pseudo-random order.
+		unsigned int seed = 42;
+		for( std::size_t i = 0; i != mboxes_count * states_count / 2; ++i )
+		{
+			seed = seed * 1103515245u + 12345u;
+			const key_t key{
+					( seed >> 8 ) % mboxes_count,
+					( seed >> 16 ) % states_count,
+					0 != ( seed & 0x80u ) };
+
+			drop( key );
+		}
+		ensure_subscriptions( "after dropping of subscriptions" );
+
+		// Drop all subscriptions for several mboxes.
+		for( std::size_t m = 0; m < mboxes_count; m += 3 )
+		{
+			so_drop_subscription_for_all_states< msg_one >( m_mboxes[ m ] );
+			for( std::size_t s = 0; s != states_count; ++s )
+				m_subscriptions.erase( key_t{ m, s, false } );
+		}
+		ensure_subscriptions( "after dropping of subscriptions for all states" );
+
+		// Restore some subscriptions.
+		for( std::size_t m = 0; m < mboxes_count; m += 3 )
+			subscribe( key_t{ m, m % states_count, false } );
+		ensure_subscriptions( "after restoring of subscriptions" );
+
+		so_5::send< msg_check >( *this );
+	}
+
+private :
+	static const std::size_t mboxes_count = 40;
+	static const std::size_t states_count = 10;
+
+	std::vector< so_5::mbox_t > m_mboxes;
+	std::vector< std::unique_ptr< state_t > > m_states;
+
+	std::set< key_t > m_subscriptions;
+
+	void
+	subscribe( const key_t & key )
+	{
+		auto & mbox = m_mboxes[ std::get<0>( key ) ];
+		auto & state = *m_states[ std::get<1>( key ) ];
+		if( std::get<2>( key ) )
+			so_subscribe( mbox ).in( state ).event< msg_two >( [] {} );
+		else
+			so_subscribe( mbox ).in( state ).event< msg_one >( [] {} );
+
+		m_subscriptions.insert( key );
+	}
+
+	void
+	drop( const key_t & key )
+	{
+		auto & mbox = m_mboxes[ std::get<0>( key ) ];
+		auto & state = *m_states[ std::get<1>( key ) ];
+		if( std::get<2>( key ) )
+			so_drop_subscription< msg_two >( mbox, state );
+		else
+			so_drop_subscription< msg_one >( mbox, state );
+
+		m_subscriptions.erase( key );
+	}
+
+	void
+	ensure_subscriptions( const std::string & stage ) const
+	{
+		for( std::size_t m = 0; m != mboxes_count; ++m )
+			for( std::size_t s = 0; s != states_count; ++s )
+			{
+				const auto & mbox = m_mboxes[ m ];
+				const auto & state = *m_states[ s ];
+
+				ensure( ( 0 != m_subscriptions.count( key_t{ m, s, false } ) ) ==
+						so_has_subscription< msg_one >( mbox, state ),
+						"unexpected presence of msg_one subscription " + stage );
+				ensure( ( 0 != m_subscriptions.count( key_t{ m, s, true } ) ) ==
+						so_has_subscription< msg_two >( mbox, state ),
+						"unexpected presence of msg_two subscription " + stage );
+			}
+	}
+
+	void
+	evt_check( mhood_t< msg_check > )
+	{
+		// Subscriptions must be the same on the next event.
+		ensure_subscriptions( "on message handling" );
+
+		so_deregister_agent_coop_normally();
+	}
+};
+
+const std::size_t a_test_t::mboxes_count;
+const std::size_t a_test_t::states_count;
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				so_5::launch( []( so_5::environment_t & env ) {
+					env.introduce_coop( []( so_5::coop_t & coop ) {
+						coop.make_agent< a_test_t >();
+					} );
+				} );
+			},
+			20,
+			"flat hash subscription storage test" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,273 @@
+/*
+ * A test for keyed mbox.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+using namespace std;
+
+using keyed_mbox_ref_t = so_5::keyed_mbox::keyed_mbox_ref_t< int >;
+
+const int receivers_count = 8;
+
+struct msg_quote : public so_5::message_t
+{
+	int m_key;
+
+	msg_quote( int key ) : m_key( key ) {}
+};
+
+struct msg_request : public so_5::message_t
+{
+	int m_key;
+
+	msg_request( int key ) : m_key( key ) {}
+};
+
+struct msg_other : public so_5::message_t {};
+
+struct results_t
+{
+	vector< int > m_quotes = vector< int >( receivers_count, 0 );
+	vector< int > m_strings = vector< int >( receivers_count, 0 );
+	int m_wildcard_quotes = 0;
+	int m_wildcard_others = 0;
+};
+
+class a_receiver_t final : public so_5::agent_t
+{
+public :
+	a_receiver_t(
+		context_t ctx,
+		int key,
+		keyed_mbox_ref_t keyed,
+		results_t & results )
+		:	so_5::agent_t( ctx )
+		,	m_key( key )
+		,	m_keyed( std::move(keyed) )
+		,	m_results( results )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe( m_keyed->key_mbox( m_key ) )
+			.event( &a_receiver_t::on_quote )
+			.event( &a_receiver_t::on_request )
+			.event( &a_receiver_t::on_string );
+	}
+
+private :
+	const int m_key;
+	const keyed_mbox_ref_t m_keyed;
+	results_t & m_results;
+
+	void
+	on_quote( mhood_t< msg_quote > cmd )
+	{
+		ensure_or_die( m_key == cmd->m_key,
+				"unexpected key: " + to_string( cmd->m_key ) +
+				", expected: " + to_string( m_key ) );
+		++m_results.m_quotes[ static_cast< size_t >( m_key ) ];
+	}
+
+	int
+	on_request( mhood_t< msg_request > cmd )
+	{
+		ensure_or_die( m_key == cmd->m_key,
+				"unexpected key in request: " + to_string( cmd->m_key ) );
+		return m_key * 10;
+	}
+
+	void
+	on_string( mhood_t< string > cmd )
+	{
+		ensure_or_die( m_key == static_cast< int >( cmd->size() ),
+				"unexpected string: " + *cmd );
+		++m_results.m_strings[ static_cast< size_t >( m_key ) ];
+	}
+};
+
+class a_wildcard_t final : public so_5::agent_t
+{
+public :
+	a_wildcard_t(
+		context_t ctx,
+		keyed_mbox_ref_t keyed,
+		results_t & results )
+		:	so_5::agent_t( ctx )
+		,	m_keyed( std::move(keyed) )
+		,	m_results( results )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe( m_keyed->as_mbox() )
+			.event( [this]( mhood_t< msg_quote > ) {
+					++m_results.m_wildcard_quotes;
+				} )
+			.event( [this]( mhood_t< msg_other > ) {
+					++m_results.m_wildcard_others;
+				} );
+	}
+
+private :
+	const keyed_mbox_ref_t m_keyed;
+	results_t & m_results;
+};
+
+void
+check_results( const results_t & results )
+{
+	for( int i = 0; i != receivers_count; ++i )
+	{
+		ensure_or_die( 2 == results.m_quotes[ static_cast< size_t >( i ) ],
+				"two quotes expected for key " + to_string( i ) );
+
+		ensure_or_die( ( 3 == i ? 1 : 0 ) ==
+					results.m_strings[ static_cast< size_t >( i ) ],
+				"unexpected count of strings for key " + to_string( i ) );
+	}
+
+	// All quotes, including the quote without a key subscriber.
+	ensure_or_die( receivers_count * 2 + 1 == results.m_wildcard_quotes,
+			"unexpected count of wildcard quotes: " +
+			to_string( results.m_wildcard_quotes ) );
+
+	ensure_or_die( 1 == results.m_wildcard_others,
+			"unexpected count of wildcard others: " +
+			to_string( results.m_wildcard_others ) );
+}
+
+void
+do_test()
+{
+	results_t results;
+
+	{
+		so_5::wrapped_env_t sobj;
+
+		auto keyed = so_5::keyed_mbox::make_keyed_mbox< int >(
+				sobj.environment() );
+
+		keyed->set_key_extractor< msg_quote >(
+				[]( const msg_quote & m ) { return m.m_key; } );
+		keyed->set_key_extractor< msg_request >(
+				[]( const msg_request & m ) { return m.m_key; } );
+		keyed->set_key_extractor< string >(
+				[]( const string & s ) { return static_cast< int >( s.size() ); } );
+
+		ensure_or_die( keyed->key_mbox( 1 ) == keyed->key_mbox( 1 ),
+				"the same mbox is expected for the same key" );
+
+		sobj.environment().introduce_coop( [&]( so_5::coop_t & coop ) {
+				for( int i = 0; i != receivers_count; ++i )
+					coop.make_agent< a_receiver_t >( i, keyed, results );
+				coop.make_agent< a_wildcard_t >( keyed, results );
+			} );
+
+		const auto dest = keyed->as_mbox();
+		for( int pass = 0; pass != 2; ++pass )
+			for( int i = 0; i != receivers_count; ++i )
+				so_5::send< msg_quote >( dest, i );
+
+		// There is no subscriber for that key.
+		so_5::send< msg_quote >( dest, receivers_count + 1 );
+
+		// There is no key extractor for that message type.
+		so_5::send< msg_other >( dest );
+
+		// A message of user type.
+		so_5::send< string >( dest, "abc" );
+
+		// All agents work on the same thread and the service request
+		// will be handled after all previous messages.
+		const int reply = so_5::request_value< int, msg_request >(
+				dest, so_5::infinite_wait, 2 );
+		ensure_or_die( 20 == reply,
+				"unexpected reply: " + to_string( reply ) );
+
+		check_results( results );
+	}
+}
+
+// A new key mbox can be created while a message is being delivered.
+void
+do_test_key_mbox_inside_delivery()
+{
+	so_5::wrapped_env_t sobj;
+
+	auto keyed = so_5::keyed_mbox::make_keyed_mbox< int >(
+			sobj.environment() );
+	auto * raw = keyed.get();
+
+	int extractor_calls = 0;
+	keyed->set_key_extractor< msg_quote >(
+			[raw, &extractor_calls]( const msg_quote & m ) {
+				++extractor_calls;
+				// A key mbox for a new key is created.
+				raw->key_mbox( m.m_key + 100 );
+				return m.m_key;
+			} );
+
+	so_5::send< msg_quote >( keyed->as_mbox(), 1 );
+
+	ensure_or_die( 1 == extractor_calls, "key extractor must be called" );
+}
+
+// A key mbox is removed when there are no more references to it.
+void
+do_test_key_mbox_removal()
+{
+	so_5::wrapped_env_t sobj;
+
+	auto keyed = so_5::keyed_mbox::make_keyed_mbox< int >(
+			sobj.environment() );
+	keyed->set_key_extractor< msg_quote >(
+			[]( const msg_quote & m ) { return m.m_key; } );
+
+	auto first = keyed->key_mbox( 1 );
+	const auto first_id = first->id();
+
+	ensure_or_die( first_id == keyed->key_mbox( 1 )->id(),
+			"the same mbox is expected while there is a reference to it" );
+
+	first = so_5::mbox_t{};
+
+	// There is no key mbox for that key now.
+	so_5::send< msg_quote >( keyed->as_mbox(), 1 );
+
+	ensure_or_die( first_id != keyed->key_mbox( 1 )->id(),
+			"a new mbox is expected after the removal of the old one" );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				do_test();
+				do_test_key_mbox_inside_delivery();
+				do_test_key_mbox_removal();
+			},
+			20,
+			"keyed mbox" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * A test for lazy creation of agent's direct mbox.
+ */
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct hello : public so_5::signal_t {};
+
+class a_worker_t final : public so_5::agent_t
+{
+public :
+	a_worker_t( context_t ctx, so_5::mbox_t common_mbox )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_common_mbox( std::move(common_mbox) )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		// Direct mbox isn't used by that agent.
+		so_subscribe( m_common_mbox ).event( &a_worker_t::on_hello );
+	}
+
+private :
+	const so_5::mbox_t m_common_mbox;
+
+	void
+	on_hello( mhood_t< hello > )
+	{
+		so_deregister_agent_coop_normally();
+	}
+};
+
+class a_direct_t final : public so_5::agent_t
+{
+public :
+	using so_5::agent_t::agent_t;
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( &a_direct_t::on_hello );
+	}
+
+private :
+	void
+	on_hello( mhood_t< hello > )
+	{
+		so_deregister_agent_coop_normally();
+	}
+};
+
+void
+check_no_mbox_for_unused_direct_mbox()
+{
+	so_5::launch( []( so_5::environment_t & env ) {
+		auto common_mbox = env.create_mbox();
+
+		env.introduce_coop( [&]( so_5::coop_t & coop ) {
+			for( int i = 0; i != 10; ++i )
+				coop.make_agent< a_worker_t >( common_mbox );
+		} );
+
+		// No one mbox id should be spent for workers.
+		auto next_mbox = env.create_mbox();
+		ensure( common_mbox->id() + 1 == next_mbox->id(),
+				"direct mboxes must not be created for workers, "
+				"common_mbox id: " + to_string( common_mbox->id() ) +
+				", next_mbox id: " + to_string( next_mbox->id() ) );
+
+		so_5::send< hello >( common_mbox );
+	} );
+}
+
+void
+check_direct_mbox_from_several_threads()
+{
+	so_5::launch( []( so_5::environment_t & env ) {
+		a_direct_t * agent = nullptr;
+		env.introduce_coop( [&]( so_5::coop_t & coop ) {
+			agent = coop.make_agent< a_direct_t >();
+		} );
+
+		// The direct mbox is created only once even if it is
+		// requested from several threads at the same time.
+		vector< so_5::mbox_t > mboxes( 4 );
+		vector< thread > threads;
+		for( auto & m : mboxes )
+			threads.emplace_back( [&m, agent] { m = agent->so_direct_mbox(); } );
+		for( auto & t : threads )
+			t.join();
+
+		for( const auto & m : mboxes )
+			ensure( m == agent->so_direct_mbox(),
+					"the same direct mbox must be returned" );
+
+		so_5::send< hello >( *agent );
+	} );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				check_no_mbox_for_unused_direct_mbox();
+				check_direct_mbox_from_several_threads();
+			},
+			20,
+			"lazy creation of direct mbox" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,297 @@
+/*
+ * A test for load-balancing mbox.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+using namespace std;
+
+const unsigned int performers_count = 4;
+const unsigned int tasks_per_performer = 10;
+const unsigned int direct_tasks = 6;
+
+struct msg_task : public so_5::message_t
+{
+	unsigned int m_value;
+
+	msg_task( unsigned int value ) : m_value( value ) {}
+};
+
+struct msg_request : public so_5::message_t {};
+
+struct msg_finish : public so_5::signal_t {};
+
+using counters_t = vector< unsigned int >;
+
+class a_performer_t final : public so_5::agent_t
+{
+public :
+	a_performer_t(
+		context_t ctx,
+		unsigned int index,
+		so_5::mbox_t tasks,
+		counters_t & counters )
+		:	so_5::agent_t( ctx
+				+ limit_then_abort< msg_task >( 1000 )
+				+ limit_then_abort< msg_request >( 10 ) )
+		,	m_index( index )
+		,	m_tasks( std::move(tasks) )
+		,	m_counters( counters )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe( m_tasks )
+			.event( &a_performer_t::on_task )
+			.event( &a_performer_t::on_request );
+		so_subscribe_self().event( &a_performer_t::on_task );
+	}
+
+private :
+	const unsigned int m_index;
+	const so_5::mbox_t m_tasks;
+	counters_t & m_counters;
+
+	void
+	on_task( mhood_t< msg_task > )
+	{
+		++m_counters[ m_index ];
+	}
+
+	unsigned int
+	on_request( mhood_t< msg_request > )
+	{
+		return m_index;
+	}
+};
+
+// An agent which rejects all tasks by a delivery filter.
+class a_rejecter_t final : public so_5::agent_t
+{
+public :
+	a_rejecter_t( context_t ctx, so_5::mbox_t tasks )
+		:	so_5::agent_t( ctx + limit_then_drop< msg_task >( 1000 ) )
+		,	m_tasks( std::move(tasks) )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_set_delivery_filter( m_tasks, []( const msg_task & ) {
+				return false;
+			} );
+		so_subscribe( m_tasks ).event( []( mhood_t< msg_task > ) {
+				throw runtime_error( "task must not be delivered to rejecter" );
+			} );
+	}
+
+private :
+	const so_5::mbox_t m_tasks;
+};
+
+class a_sender_t final : public so_5::agent_t
+{
+public :
+	a_sender_t(
+		context_t ctx,
+		so_5::mbox_t tasks,
+		vector< so_5::mbox_t > performers,
+		unsigned int direct_tasks_count,
+		counters_t & counters )
+		:	so_5::agent_t( ctx )
+		,	m_tasks( std::move(tasks) )
+		,	m_performers( std::move(performers) )
+		,	m_direct_tasks_count( direct_tasks_count )
+		,	m_counters( counters )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( &a_sender_t::on_finish );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		// The first performer is loaded in advance.
+		for( unsigned int i = 0; i != m_direct_tasks_count; ++i )
+			so_5::send< msg_task >( m_performers.front(), i );
+
+		const unsigned int total = performers_count * tasks_per_performer;
+		for( unsigned int i = m_direct_tasks_count; i != total; ++i )
+			so_5::send< msg_task >( m_tasks, i );
+
+		so_5::send< msg_finish >( *this );
+	}
+
+private :
+	const so_5::mbox_t m_tasks;
+	const vector< so_5::mbox_t > m_performers;
+	const unsigned int m_direct_tasks_count;
+	counters_t & m_counters;
+
+	void
+	on_finish( mhood_t< msg_finish > )
+	{
+		// All tasks are already processed because all agents work on
+		// the same thread.
+		for( unsigned int i = 0; i != performers_count; ++i )
+			ensure_or_die( tasks_per_performer == m_counters[ i ],
+					"unexpected count of tasks for performer #" +
+					to_string( i ) + ": " + to_string( m_counters[ i ] ) );
+
+		so_deregister_agent_coop_normally();
+	}
+};
+
+void
+run_test(
+	const char * case_name,
+	so_5::load_balancing_policy_t policy,
+	unsigned int direct_tasks_count )
+{
+	cout << case_name << "..." << flush;
+
+	counters_t counters( performers_count, 0u );
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+			env.introduce_coop( [&]( so_5::coop_t & coop ) {
+					auto tasks = env.create_load_balancing_mbox( policy );
+
+					vector< so_5::mbox_t > performers;
+					for( unsigned int i = 0; i != performers_count; ++i )
+						performers.push_back(
+								coop.make_agent< a_performer_t >(
+										i, tasks, counters )->so_direct_mbox() );
+
+					// NOTE: a rejecter shifts the round-robin sequence.
+					// Because of that it is used only for least_loaded policy.
+					if( so_5::load_balancing_policy_t::least_loaded == policy )
+						coop.make_agent< a_rejecter_t >( tasks );
+
+					coop.make_agent< a_sender_t >(
+							tasks, performers, direct_tasks_count, counters );
+				} );
+		} );
+
+	cout << "OK" << endl;
+}
+
+void
+check_service_request()
+{
+	cout << "service_request..." << flush;
+
+	so_5::wrapped_env_t sobj;
+
+	counters_t counters( performers_count, 0u );
+	auto tasks = sobj.environment().create_load_balancing_mbox();
+
+	sobj.environment().introduce_coop(
+		so_5::disp::active_obj::create_private_disp(
+				sobj.environment() )->binder(),
+		[&]( so_5::coop_t & coop ) {
+			for( unsigned int i = 0; i != performers_count; ++i )
+				coop.make_agent< a_performer_t >( i, tasks, counters );
+		} );
+
+	// Every performer must handle exactly one request in turn.
+	vector< unsigned int > replies;
+	for( unsigned int i = 0; i != performers_count; ++i )
+		replies.push_back( so_5::request_value< unsigned int, msg_request >(
+				tasks, so_5::infinite_wait ) );
+
+	sort( replies.begin(), replies.end() );
+	for( unsigned int i = 0; i != performers_count; ++i )
+		ensure_or_die( i == replies[ i ],
+				"unexpected reply: " + to_string( replies[ i ] ) );
+
+	cout << "OK" << endl;
+}
+
+// An agent without message limits.
+class a_unlimited_t final : public so_5::agent_t
+{
+public :
+	a_unlimited_t( context_t ctx, so_5::mbox_t tasks )
+		:	so_5::agent_t( ctx )
+		,	m_tasks( std::move(tasks) )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe( m_tasks ).event( []( mhood_t< msg_task > ) {} );
+	}
+
+private :
+	const so_5::mbox_t m_tasks;
+};
+
+void
+check_least_loaded_requires_limit()
+{
+	cout << "least_loaded_requires_limit..." << flush;
+
+	so_5::launch( []( so_5::environment_t & env ) {
+			auto tasks = env.create_load_balancing_mbox(
+					so_5::load_balancing_policy_t::least_loaded );
+
+			int error_code = 0;
+			try
+			{
+				env.introduce_coop( [&]( so_5::coop_t & coop ) {
+						coop.make_agent< a_unlimited_t >( tasks );
+					} );
+			}
+			catch( const so_5::exception_t & ex )
+			{
+				error_code = ex.error_code();
+			}
+
+			ensure_or_die(
+					so_5::rc_message_limit_required_for_least_loaded == error_code,
+					"subscription without message limit must be rejected, "
+					"error_code: " + to_string( error_code ) );
+
+			env.stop();
+		} );
+
+	cout << "OK" << endl;
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				run_test( "round_robin",
+						so_5::load_balancing_policy_t::round_robin, 0u );
+				run_test( "least_loaded",
+						so_5::load_balancing_policy_t::least_loaded, direct_tasks );
+				check_service_request();
+				check_least_loaded_requires_limit();
+			},
+			20,
+			"load-balancing mbox" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
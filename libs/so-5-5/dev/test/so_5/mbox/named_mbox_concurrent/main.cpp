@@ -0,0 +1,132 @@
+/*
+ * A test for concurrent creation and destruction of named mboxes.
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+using namespace std;
+
+const unsigned int threads_count = 4;
+const unsigned int iterations = 20000;
+const unsigned int names_count = 8;
+
+struct msg_ping : public so_5::signal_t {};
+
+void
+worker(
+	so_5::environment_t & env,
+	const so_5::mbox_id_t anchor_id,
+	unsigned int thread_index )
+{
+	vector< string > names;
+	for( unsigned int i = 0; i != names_count; ++i )
+		names.push_back( "name-" + to_string( i ) );
+
+	for( unsigned int i = 0; i != iterations; ++i )
+	{
+		auto anchor = env.create_mbox( "anchor" );
+		ensure_or_die( anchor_id == anchor->id(),
+				"unexpected id of anchor mbox: " + to_string( anchor->id() ) );
+
+		// These mboxes are created and destroyed by several threads
+		// at the same time.
+		const auto & name = names[ ( i + thread_index ) % names_count ];
+		auto m1 = env.create_mbox( name );
+		auto m2 = env.create_mbox( name );
+		ensure_or_die( m1->id() == m2->id(),
+				"different mboxes for the same name: " + name );
+		ensure_or_die( name == m1->query_name(),
+				"unexpected name: " + m1->query_name() );
+	}
+}
+
+void
+check_named_mbox_count(
+	so_5::environment_t & env,
+	std::size_t expected )
+{
+	namespace stats = so_5::stats;
+
+	auto results = create_mchain( env );
+
+	env.introduce_coop( [&]( so_5::coop_t & coop ) {
+			auto a = coop.define_agent();
+			a.event( env.stats_controller().mbox(),
+				[results]( const stats::messages::quantity< std::size_t > & evt ) {
+					if( stats::prefixes::mbox_repository() == evt.m_prefix &&
+							stats::suffixes::named_mbox_count() == evt.m_suffix )
+						so_5::send< std::size_t >( results, evt.m_value );
+				} );
+		} );
+
+	env.stats_controller().set_distribution_period( chrono::milliseconds( 50 ) );
+	env.stats_controller().turn_on();
+
+	std::size_t actual = 0u;
+	auto r = receive( results, chrono::seconds( 5 ),
+			[&actual]( std::size_t v ) { actual = v; } );
+
+	ensure_or_die( 1u == r.handled(), "there is no named_mbox.count value" );
+	ensure_or_die( expected == actual,
+			"unexpected count of named mboxes: " + to_string( actual ) );
+}
+
+void
+do_test()
+{
+	so_5::wrapped_env_t sobj;
+	auto & env = sobj.environment();
+
+	auto anchor = env.create_mbox( "anchor" );
+	const auto anchor_id = anchor->id();
+
+	// A message sent to another instance for the same name must be
+	// delivered to a subscriber.
+	auto ch = create_mchain( env );
+	env.introduce_coop( [&]( so_5::coop_t & coop ) {
+			coop.define_agent().event< msg_ping >( anchor,
+				[ch] { so_5::send< msg_ping >( ch ); } );
+		} );
+
+	vector< thread > threads;
+	for( unsigned int i = 0; i != threads_count; ++i )
+		threads.emplace_back( worker, ref( env ), anchor_id, i );
+	for( auto & t : threads )
+		t.join();
+
+	so_5::send< msg_ping >( env.create_mbox( "anchor" ) );
+	auto r = receive( ch, chrono::seconds( 5 ), []( so_5::mhood_t< msg_ping > ) {} );
+	ensure_or_die( 1u == r.handled(), "msg_ping must be received" );
+
+	// Only the anchor mbox must remain.
+	check_named_mbox_count( env, 1u );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				do_test();
+			},
+			60,
+			"concurrent named mboxes" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
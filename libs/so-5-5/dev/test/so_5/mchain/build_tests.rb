@@ -35,4 +35,6 @@ MxxRu::Cpp::composite_target {
 
 	required_prj( "#{path}/receive_closed_handler/prj.ut.rb" )
 	required_prj( "#{path}/select_closed_handler/prj.ut.rb" )
+
+	required_prj( "#{path}/conflation/prj.ut.rb" )
 }
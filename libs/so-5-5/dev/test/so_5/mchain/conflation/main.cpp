@@ -0,0 +1,131 @@
+/*
+ * A test for mchain with conflation of messages.
+ */
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+#include "../mchain_params.hpp"
+
+using namespace std;
+
+struct msg_price
+{
+	int m_value;
+};
+
+// Count of conflated messages for every chain.
+const std::size_t conflations_per_chain = 4u;
+
+so_5::message_metadata_t
+key( std::uint64_t k )
+{
+	return so_5::message_metadata_t{}.conflation_key( k );
+}
+
+void
+check_chain( const so_5::mchain_t & chain )
+{
+	so_5::send_with_metadata< msg_price >( chain, key( 1u ), 1 );
+	so_5::send_with_metadata< msg_price >( chain, key( 2u ), 10 );
+	so_5::send_with_metadata< msg_price >( chain, key( 1u ), 2 );
+	// A message without conflation key is never conflated.
+	so_5::send< msg_price >( chain, 100 );
+	so_5::send_with_metadata< msg_price >( chain, key( 1u ), 3 );
+	so_5::send_with_metadata< msg_price >( chain, key( 2u ), 20 );
+	// The same key for different message types means different keys.
+	so_5::send_with_metadata< int >( chain, key( 1u ), 7 );
+	so_5::send_with_metadata< int >( chain, key( 1u ), 8 );
+
+	ensure_or_die( 4u == chain->size(),
+			"unexpected chain size: " + to_string( chain->size() ) );
+
+	vector< int > values;
+	auto r = receive( from( chain ).no_wait_on_empty(),
+			[&values]( const msg_price & m ) { values.push_back( m.m_value ); },
+			[&values]( int v ) { values.push_back( v ); } );
+
+	ensure_or_die( 4u == r.handled(),
+			"unexpected count of handled messages: " + to_string( r.handled() ) );
+	ensure_or_die( (vector< int >{ 3, 20, 100, 8 }) == values,
+			"unexpected values or their order" );
+
+	// A message with the same key after the extraction must be stored
+	// as a new one.
+	so_5::send_with_metadata< msg_price >( chain, key( 1u ), 4 );
+	ensure_or_die( 1u == chain->size(),
+			"unexpected chain size after extraction: " +
+			to_string( chain->size() ) );
+	receive( chain, so_5::no_wait,
+			[]( const msg_price & m ) {
+				ensure_or_die( 4 == m.m_value,
+						"unexpected value: " + to_string( m.m_value ) );
+			} );
+}
+
+void
+check_stats(
+	so_5::environment_t & env,
+	std::size_t expected )
+{
+	auto results = create_mchain( env );
+
+	env.introduce_coop( [&]( so_5::coop_t & coop ) {
+			namespace stats = so_5::stats;
+
+			auto a = coop.define_agent();
+			a.event( env.stats_controller().mbox(),
+				[results]( const stats::messages::quantity< std::size_t > & evt ) {
+					if( stats::prefixes::message_delivery() == evt.m_prefix &&
+							stats::suffixes::conflated_message_count() == evt.m_suffix )
+						so_5::send< std::size_t >( results, evt.m_value );
+				} );
+		} );
+
+	env.stats_controller().set_distribution_period( chrono::milliseconds( 50 ) );
+	env.stats_controller().turn_on();
+
+	std::size_t actual = 0u;
+	auto r = receive( results, chrono::seconds( 5 ),
+			[&actual]( std::size_t v ) { actual = v; } );
+
+	ensure_or_die( 1u == r.handled(), "there is no conflated_msgs.count value" );
+	ensure_or_die( expected == actual,
+			"unexpected count of conflated messages: " + to_string( actual ) );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				so_5::wrapped_env_t sobj;
+
+				auto params = build_mchain_params();
+				for( auto & p : params )
+				{
+					cout << "=== " << p.first << " ===" << endl;
+
+					check_chain( sobj.environment().create_mchain(
+							p.second.enable_conflation() ) );
+				}
+
+				check_stats( sobj.environment(),
+						conflations_per_chain * params.size() );
+			},
+			20,
+			"mchain conflation" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -9,6 +9,7 @@ MxxRu::Cpp::composite_target {
 	required_prj "#{path}/duplicate_limit/prj.ut.rb"
 	required_prj "#{path}/drop/prj.ut.rb"
 	required_prj "#{path}/drop_at_peaks/prj.ut.rb"
+	required_prj "#{path}/drop_many_types/prj.ut.rb"
 	required_prj "#{path}/abort_app/mc_mbox/prj.ut.rb"
 	required_prj "#{path}/abort_app/sc_mbox/prj.ut.rb"
 
@@ -31,4 +32,6 @@ MxxRu::Cpp::composite_target {
 	required_prj "#{path}/transform_msg_too_deep/sc_mbox/prj.ut.rb"
 	required_prj "#{path}/transform_svc/mc_mbox/prj.ut.rb"
 	required_prj "#{path}/transform_svc/sc_mbox/prj.ut.rb"
+
+	required_prj "#{path}/wait/prj.ut.rb"
 }
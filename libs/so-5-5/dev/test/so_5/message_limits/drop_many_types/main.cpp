@@ -0,0 +1,156 @@
+/*
+ * A test for message limits for big count of message types
+ * (dropping the message).
+ */
+
+#include <iostream>
+#include <array>
+#include <exception>
+#include <stdexcept>
+#include <cstdlib>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+
+const std::size_t types_count = 12;
+
+template< std::size_t N >
+struct msg_sig : public so_5::signal_t {};
+
+struct msg_finish : public so_5::signal_t {};
+
+template< std::size_t N >
+struct types_iterator_t
+{
+	static so_5::agent_context_t
+	add_limits( so_5::agent_context_t ctx )
+	{
+		return types_iterator_t< N - 1 >::add_limits(
+				ctx + so_5::agent_t::limit_then_drop< msg_sig< N - 1 > >( 2 ) );
+	}
+
+	template< typename Action >
+	static void
+	for_each( Action & action )
+	{
+		types_iterator_t< N - 1 >::for_each( action );
+		action.template apply< N - 1 >();
+	}
+};
+
+template<>
+struct types_iterator_t< 0 >
+{
+	static so_5::agent_context_t
+	add_limits( so_5::agent_context_t ctx )
+	{
+		return ctx + so_5::agent_t::limit_then_drop< msg_finish >( 1 );
+	}
+
+	template< typename Action >
+	static void
+	for_each( Action & ) {}
+};
+
+using all_types_t = types_iterator_t< types_count >;
+
+class a_test_t : public so_5::agent_t
+{
+public :
+	a_test_t( context_t ctx )
+		:	so_5::agent_t( all_types_t::add_limits( ctx ) )
+		,	m_mbox( so_environment().create_mbox() )
+	{
+		m_received.fill( 0 );
+	}
+
+	virtual void
+	so_define_agent() override
+	{
+		subscriber_t subscriber{ *this };
+		all_types_t::for_each( subscriber );
+
+		so_subscribe_self().event< msg_finish >( [&]{
+				for( std::size_t i = 0; i != types_count; ++i )
+					if( 2 != m_received[ i ] )
+						throw std::runtime_error( "unexpected count of "
+								"received msg_sig<" + std::to_string( i ) +
+								"> instances: " + std::to_string( m_received[ i ] ) );
+
+				so_deregister_agent_coop_normally();
+			} );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		sender_t sender{ *this };
+		all_types_t::for_each( sender );
+
+		so_5::send< msg_finish >( *this );
+	}
+
+private :
+	struct subscriber_t
+	{
+		a_test_t & m_self;
+
+		template< std::size_t N >
+		void
+		apply()
+		{
+			auto & self = m_self;
+			auto handler = [&self] { ++self.m_received[ N ]; };
+
+			self.so_subscribe_self().event< msg_sig< N > >( handler );
+			self.so_subscribe( self.m_mbox ).event< msg_sig< N > >( handler );
+		}
+	};
+
+	struct sender_t
+	{
+		a_test_t & m_self;
+
+		template< std::size_t N >
+		void
+		apply()
+		{
+			for( int i = 0; i != 3; ++i )
+			{
+				so_5::send< msg_sig< N > >( m_self );
+				so_5::send< msg_sig< N > >( m_self.m_mbox );
+			}
+		}
+	};
+
+	const so_5::mbox_t m_mbox;
+
+	std::array< unsigned int, types_count > m_received;
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				so_5::launch( []( so_5::environment_t & env ) {
+					env.introduce_coop( []( so_5::coop_t & coop ) {
+						coop.make_agent< a_test_t >();
+					} );
+				} );
+			},
+			20,
+			"message drop for many message types test" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
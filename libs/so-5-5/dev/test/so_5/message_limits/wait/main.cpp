@@ -0,0 +1,399 @@
+/*
+ * A test for message limits (waiting for free space in receiver's queue).
+ */
+
+#include <iostream>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <chrono>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+using namespace std;
+
+struct msg_data : public so_5::message_t
+{
+	int m_value;
+
+	msg_data( int value ) : m_value( value ) {}
+};
+
+struct msg_refused : public so_5::signal_t {};
+
+const unsigned int limit = 3;
+const int messages_count = 20;
+
+class a_slow_receiver_t final : public so_5::agent_t
+{
+public :
+	a_slow_receiver_t(
+		context_t ctx,
+		const atomic< int > & sent,
+		atomic< int > & received )
+		:	so_5::agent_t( ctx
+				+ limit_then_wait< msg_data >(
+						limit, 1u, chrono::seconds( 10 ) ) )
+		,	m_sent( sent )
+		,	m_received( received )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( &a_slow_receiver_t::on_data );
+	}
+
+private :
+	const atomic< int > & m_sent;
+	atomic< int > & m_received;
+
+	void
+	on_data( mhood_t< msg_data > cmd )
+	{
+		ensure_or_die( m_received.load() == cmd->m_value,
+				"unexpected value: " + to_string( cmd->m_value ) );
+
+		const int received = ++m_received;
+		ensure_or_die( m_sent.load() - received <= static_cast< int >( limit ),
+				"too many messages in the queue: sent=" +
+				to_string( m_sent.load() ) + ", received=" +
+				to_string( received ) );
+
+		this_thread::sleep_for( chrono::milliseconds( 5 ) );
+	}
+};
+
+void
+check_wait_until_drained()
+{
+	cout << "wait_until_drained..." << flush;
+
+	atomic< int > sent{ 0 };
+	atomic< int > received{ 0 };
+
+	{
+		so_5::wrapped_env_t sobj;
+
+		so_5::mbox_t dest;
+		sobj.environment().introduce_coop(
+			so_5::disp::active_obj::create_private_disp(
+					sobj.environment() )->binder(),
+			[&]( so_5::coop_t & coop ) {
+				dest = coop.make_agent< a_slow_receiver_t >(
+						sent, received )->so_direct_mbox();
+			} );
+
+		for( int i = 0; i != messages_count; ++i )
+		{
+			so_5::send< msg_data >( dest, i );
+			++sent;
+		}
+
+		while( received.load() != messages_count )
+			this_thread::sleep_for( chrono::milliseconds( 5 ) );
+	}
+
+	cout << "OK" << endl;
+}
+
+class a_blocked_receiver_t final : public so_5::agent_t
+{
+public :
+	a_blocked_receiver_t(
+		context_t ctx,
+		promise< void > & started,
+		atomic< int > & received,
+		chrono::steady_clock::duration timeout = chrono::milliseconds( 50 ) )
+		:	so_5::agent_t( ctx
+				+ limit_then_wait< msg_data >( 1u, 1u, timeout ) )
+		,	m_started( started )
+		,	m_received( received )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( &a_blocked_receiver_t::on_data );
+	}
+
+private :
+	promise< void > & m_started;
+	atomic< int > & m_received;
+
+	void
+	on_data( mhood_t< msg_data > cmd )
+	{
+		++m_received;
+		if( 0 == cmd->m_value )
+		{
+			m_started.set_value();
+			this_thread::sleep_for( chrono::milliseconds( 300 ) );
+		}
+	}
+};
+
+void
+check_timeout()
+{
+	cout << "timeout..." << flush;
+
+	promise< void > started;
+	atomic< int > received{ 0 };
+
+	{
+		so_5::wrapped_env_t sobj;
+
+		so_5::mbox_t dest;
+		sobj.environment().introduce_coop(
+			so_5::disp::active_obj::create_private_disp(
+					sobj.environment() )->binder(),
+			[&]( so_5::coop_t & coop ) {
+				dest = coop.make_agent< a_blocked_receiver_t >(
+						started, received )->so_direct_mbox();
+			} );
+
+		so_5::send< msg_data >( dest, 0 );
+		started.get_future().wait();
+
+		// This message will wait in the queue.
+		so_5::send< msg_data >( dest, 1 );
+
+		// There is no free space for that message.
+		const auto started_at = chrono::steady_clock::now();
+		so_5::send< msg_data >( dest, 2 );
+		const auto waited = chrono::steady_clock::now() - started_at;
+
+		ensure_or_die( waited >= chrono::milliseconds( 40 ),
+				"sender must wait for free space" );
+
+		while( received.load() != 2 )
+			this_thread::sleep_for( chrono::milliseconds( 5 ) );
+	}
+
+	ensure_or_die( 2 == received.load(),
+			"the last message must be dropped after timeout, received: " +
+			to_string( received.load() ) );
+
+	cout << "OK" << endl;
+}
+
+void
+check_drop_from_timer()
+{
+	cout << "drop_from_timer..." << flush;
+
+	promise< void > started;
+	atomic< int > received{ 0 };
+
+	{
+		so_5::wrapped_env_t sobj;
+
+		so_5::mbox_t dest;
+		sobj.environment().introduce_coop(
+			so_5::disp::active_obj::create_private_disp(
+					sobj.environment() )->binder(),
+			[&]( so_5::coop_t & coop ) {
+				dest = coop.make_agent< a_blocked_receiver_t >(
+						started, received, chrono::seconds( 10 ) )->
+								so_direct_mbox();
+			} );
+
+		so_5::send< msg_data >( dest, 0 );
+		started.get_future().wait();
+
+		// This message will wait in the queue.
+		so_5::send< msg_data >( dest, 1 );
+
+		// There is no free space for that message and the timer thread
+		// must not wait for it.
+		so_5::send_delayed< msg_data >(
+				sobj.environment(), dest, chrono::milliseconds( 10 ), 2 );
+		this_thread::sleep_for( chrono::milliseconds( 50 ) );
+
+		while( received.load() != 2 )
+			this_thread::sleep_for( chrono::milliseconds( 5 ) );
+
+		// Give a chance to the delayed message if it wasn't dropped.
+		this_thread::sleep_for( chrono::milliseconds( 50 ) );
+	}
+
+	ensure_or_die( 2 == received.load(),
+			"the delayed message must be dropped, received: " +
+			to_string( received.load() ) );
+
+	cout << "OK" << endl;
+}
+
+class a_self_sender_t final : public so_5::agent_t
+{
+public :
+	a_self_sender_t(
+		context_t ctx,
+		so_5::priority_t priority = so_5::prio::default_priority )
+		:	so_5::agent_t( ctx
+				+ priority
+				+ limit_then_wait< msg_data >(
+						1u, 1u, chrono::seconds( 10 ) )
+				+ limit_then_drop< msg_refused >( 10 ) )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( &a_self_sender_t::on_data )
+			.event( &a_self_sender_t::on_refused );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		send_and_expect_refuse( *this );
+	}
+
+	static void
+	send_and_expect_refuse( const so_5::agent_t & to )
+	{
+		try
+		{
+			// There is no free space for the second message but
+			// the sender works on the same thread as the receiver.
+			so_5::send< msg_data >( to, 0 );
+			so_5::send< msg_data >( to, 1 );
+		}
+		catch( const so_5::exception_t & x )
+		{
+			if( so_5::rc_message_limit_wait_on_receiver_thread ==
+					x.error_code() )
+				so_5::send< msg_refused >( to );
+		}
+	}
+
+private :
+	int m_refused = 0;
+
+	void
+	on_data( mhood_t< msg_data > cmd )
+	{
+		ensure_or_die( 0 == cmd->m_value,
+				"unexpected value: " + to_string( cmd->m_value ) );
+	}
+
+	void
+	on_refused( mhood_t< msg_refused > )
+	{
+		if( 2 == ++m_refused )
+			so_deregister_agent_coop_normally();
+	}
+};
+
+// An agent which works on the same thread as the receiver.
+class a_neighbour_t final : public so_5::agent_t
+{
+public :
+	a_neighbour_t(
+		context_t ctx,
+		const so_5::agent_t & receiver,
+		so_5::priority_t priority = so_5::prio::default_priority )
+		:	so_5::agent_t( ctx + priority )
+		,	m_receiver( receiver )
+	{}
+
+	virtual void
+	so_evt_start() override
+	{
+		a_self_sender_t::send_and_expect_refuse( m_receiver );
+	}
+
+private :
+	const so_5::agent_t & m_receiver;
+};
+
+void
+check_refuse_on_receiver_thread()
+{
+	cout << "refuse_on_receiver_thread..." << flush;
+
+	so_5::launch( []( so_5::environment_t & env ) {
+			env.introduce_coop( []( so_5::coop_t & coop ) {
+					auto receiver = coop.make_agent< a_self_sender_t >();
+					coop.make_agent< a_neighbour_t >( *receiver );
+				} );
+		} );
+
+	cout << "OK" << endl;
+}
+
+// Agents have different event queues but share one working thread.
+void
+check_refuse_on_thread_pool_individual_fifo()
+{
+	cout << "refuse_on_thread_pool_individual_fifo..." << flush;
+
+	so_5::launch( []( so_5::environment_t & env ) {
+			using namespace so_5::disp::thread_pool;
+
+			env.introduce_coop(
+				create_private_disp( env, 1 )->binder(
+						bind_params_t{}.fifo( fifo_t::individual ) ),
+				[]( so_5::coop_t & coop ) {
+					auto receiver = coop.make_agent< a_self_sender_t >();
+					coop.make_agent< a_neighbour_t >( *receiver );
+				} );
+		} );
+
+	cout << "OK" << endl;
+}
+
+// Agents of different priorities share one working thread.
+void
+check_refuse_on_prio_one_thread()
+{
+	cout << "refuse_on_prio_one_thread..." << flush;
+
+	so_5::launch( []( so_5::environment_t & env ) {
+			using namespace so_5::disp::prio_one_thread::strictly_ordered;
+
+			env.introduce_coop(
+				create_private_disp( env )->binder(),
+				[]( so_5::coop_t & coop ) {
+					auto receiver = coop.make_agent< a_self_sender_t >(
+							so_5::prio::p0 );
+					coop.make_agent< a_neighbour_t >(
+							*receiver, so_5::prio::p1 );
+				} );
+		} );
+
+	cout << "OK" << endl;
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				check_wait_until_drained();
+				check_timeout();
+				check_drop_from_timer();
+				check_refuse_on_receiver_thread();
+				check_refuse_on_thread_pool_individual_fifo();
+				check_refuse_on_prio_one_thread();
+			},
+			20,
+			"message limit with waiting" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
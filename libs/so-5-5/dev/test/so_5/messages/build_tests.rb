@@ -11,6 +11,9 @@ MxxRu::Cpp::composite_target {
 	required_prj( "#{path}/lambda_handlers/prj.ut.rb" )
 	required_prj( "#{path}/tuple_as_message/prj.ut.rb" )
 	required_prj( "#{path}/typed_mtag/prj.ut.rb" )
+	required_prj( "#{path}/msg_type_id/prj.ut.rb" )
+	required_prj( "#{path}/inline_metadata/prj.ut.rb" )
+	required_prj( "#{path}/send_with_deadline/prj.ut.rb" )
 
 	required_prj( "#{path}/user_type_msgs/build_tests.rb" )
 }
@@ -0,0 +1,170 @@
+/*
+ * A test for inline message metadata.
+ */
+
+#include <iostream>
+#include <string>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+using namespace std;
+
+struct msg_request : public so_5::message_t
+{
+	int m_value;
+
+	msg_request( int value ) : m_value( value ) {}
+};
+
+struct msg_signal : public so_5::signal_t {};
+
+const auto test_deadline = chrono::steady_clock::time_point{} +
+		chrono::hours( 1 );
+
+class a_test_t final : public so_5::agent_t
+{
+public :
+	using so_5::agent_t::agent_t;
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( &a_test_t::on_request )
+			.event( &a_test_t::on_mutable_request );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		so_5::send_with_metadata< msg_request >( *this,
+				so_5::message_metadata_t{}
+					.deadline( test_deadline )
+					.trace_id( 42u )
+					.priority( so_5::prio::p5 ),
+				0 );
+
+		// A message without metadata.
+		so_5::send< msg_request >( *this, 1 );
+
+		so_5::send_with_metadata< so_5::mutable_msg< msg_request > >( *this,
+				so_5::message_metadata_t{}.trace_id( 43u ),
+				2 );
+	}
+
+private :
+	void
+	on_request( mhood_t< msg_request > cmd )
+	{
+		const auto md = so_5::message_metadata( *cmd );
+		if( 0 == cmd->m_value )
+		{
+			ensure( !md.empty(), "metadata expected" );
+			ensure( test_deadline == *md.query_deadline(),
+					"unexpected deadline" );
+			ensure( 42u == *md.query_trace_id(), "unexpected trace_id" );
+			ensure( so_5::prio::p5 == *md.query_priority(),
+					"unexpected priority" );
+			ensure( md.is_expired( test_deadline ), "must be expired" );
+			ensure( !md.is_expired( test_deadline - chrono::seconds( 1 ) ),
+					"must not be expired" );
+		}
+		else
+		{
+			ensure( md.empty(), "metadata must be empty" );
+			ensure( !md.query_deadline(), "no deadline expected" );
+			ensure( !md.is_expired( chrono::steady_clock::now() ),
+					"message without deadline can't be expired" );
+		}
+	}
+
+	void
+	on_mutable_request( mutable_mhood_t< msg_request > cmd )
+	{
+		const auto md = so_5::message_metadata( *cmd );
+		ensure( 43u == *md.query_trace_id(), "unexpected trace_id" );
+		ensure( !md.query_deadline(), "no deadline expected" );
+		ensure( !md.query_priority(), "no priority expected" );
+
+		so_deregister_agent_coop_normally();
+	}
+};
+
+void
+check_message_objects()
+{
+	const auto md = so_5::message_metadata_t{}.trace_id( 7u );
+
+	// Metadata isn't copied with message.
+	msg_request original{ 0 };
+	so_5::set_message_metadata( original, md );
+	ensure( 7u == *so_5::message_metadata( original ).query_trace_id(),
+			"metadata must be set" );
+	msg_request copy{ original };
+	ensure( so_5::message_metadata( copy ).empty(),
+			"metadata must not be copied" );
+	copy = original;
+	ensure( so_5::message_metadata( copy ).empty(),
+			"metadata must not be assigned" );
+
+	// Empty metadata removes the previous one.
+	so_5::set_message_metadata( original, so_5::message_metadata_t{} );
+	ensure( so_5::message_metadata( original ).empty(),
+			"metadata must be removed" );
+
+	// Metadata for a signal is always empty.
+	ensure( so_5::message_metadata( so_5::message_ref_t{} ).empty(),
+			"metadata of signal must be empty" );
+
+	// Metadata of user-type message is available via execution_demand_t.
+	so_5::message_ref_t user_msg{
+			new so_5::user_type_message_t< string >{ "hello" } };
+	so_5::set_message_metadata( *user_msg, md );
+
+	so_5::execution_demand_t demand{
+			nullptr, nullptr, 0,
+			typeid(string),
+			user_msg,
+			nullptr };
+	ensure( 7u == *demand.metadata().query_trace_id(),
+			"metadata must be available from execution_demand" );
+
+	so_5::execution_demand_t signal_demand{
+			nullptr, nullptr, 0,
+			typeid(msg_signal),
+			so_5::message_ref_t{},
+			nullptr };
+	ensure( signal_demand.metadata().empty(),
+			"metadata of signal demand must be empty" );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				check_message_objects();
+
+				so_5::launch( []( so_5::environment_t & env ) {
+						env.register_agent_as_coop(
+								so_5::autoname,
+								env.make_agent< a_test_t >() );
+					} );
+			},
+			20,
+			"inline message metadata" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,207 @@
+/*
+ * A test for numeric message type identifiers.
+ */
+
+#include <iostream>
+#include <array>
+#include <thread>
+#include <vector>
+#include <typeindex>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+const std::size_t types_count = 100;
+
+template< std::size_t N >
+struct msg_tick : public so_5::signal_t {};
+
+using ids_t = std::array< so_5::msg_type_id_t, types_count >;
+
+//
+// Helper for iteration over all msg_tick types.
+//
+template< std::size_t N >
+struct types_iterator_t
+	{
+		template< typename Action >
+		static void
+		for_each( Action & action )
+			{
+				types_iterator_t< N - 1 >::for_each( action );
+				action.template apply< N - 1 >();
+			}
+	};
+
+template<>
+struct types_iterator_t< 0 >
+	{
+		template< typename Action >
+		static void
+		for_each( Action & ) {}
+	};
+
+using all_types_t = types_iterator_t< types_count >;
+
+struct id_collector_t
+	{
+		ids_t m_ids;
+
+		template< std::size_t N >
+		void
+		apply()
+			{
+				m_ids[ N ] = so_5::msg_type_id( typeid(msg_tick< N >) );
+			}
+	};
+
+struct id_checker_t
+	{
+		const ids_t & m_ids;
+
+		template< std::size_t N >
+		void
+		apply()
+			{
+				using payload_t = so_5::message_payload_type< msg_tick< N > >;
+
+				ensure( m_ids[ N ] == payload_t::subscription_type_id(),
+						"cached id must be the same as registered one" );
+				ensure( so_5::msg_type_by_id( m_ids[ N ] ) ==
+						std::type_index( typeid(msg_tick< N >) ),
+						"type for id must be the same as registered one" );
+			}
+	};
+
+void
+check_ids()
+{
+	// Registration of types from several threads at the same time.
+	std::vector< ids_t > results( 4 );
+	std::vector< std::thread > threads;
+	for( auto & r : results )
+		threads.emplace_back( [&r] {
+				id_collector_t collector;
+				all_types_t::for_each( collector );
+				r = collector.m_ids;
+			} );
+	for( auto & t : threads )
+		t.join();
+
+	for( const auto & r : results )
+		ensure( r == results.front(), "ids must be the same in all threads" );
+
+	const auto & ids = results.front();
+	for( std::size_t i = 0; i != ids.size(); ++i )
+		{
+			ensure( so_5::null_msg_type_id() != ids[ i ],
+					"id must not be null" );
+			for( std::size_t j = i + 1; j != ids.size(); ++j )
+				ensure( ids[ i ] != ids[ j ], "ids must be unique" );
+		}
+
+	id_checker_t checker{ ids };
+	all_types_t::for_each( checker );
+
+	bool thrown = false;
+	try
+		{
+			so_5::msg_type_by_id( so_5::null_msg_type_id() );
+		}
+	catch( const so_5::exception_t & )
+		{
+			thrown = true;
+		}
+	ensure( thrown, "an exception expected for null id" );
+}
+
+class a_test_t : public so_5::agent_t
+{
+	struct subscriber_t
+		{
+			a_test_t & m_self;
+
+			template< std::size_t N >
+			void
+			apply()
+				{
+					auto & self = m_self;
+					self.so_subscribe( self.m_mbox ).event< msg_tick< N > >(
+							[&self] { self.on_tick( N ); } );
+				}
+		};
+
+	struct sender_t
+		{
+			const so_5::mbox_t & m_to;
+
+			template< std::size_t N >
+			void
+			apply() { so_5::send< msg_tick< N > >( m_to ); }
+		};
+
+public :
+	a_test_t( context_t ctx )
+		:	so_5::agent_t( ctx )
+		,	m_mbox( so_environment().create_mbox() )
+	{}
+
+	virtual void
+	so_define_agent() override
+	{
+		subscriber_t subscriber{ *this };
+		all_types_t::for_each( subscriber );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		sender_t sender{ m_mbox };
+		all_types_t::for_each( sender );
+	}
+
+private :
+	const so_5::mbox_t m_mbox;
+	std::size_t m_expected = 0;
+
+	void
+	on_tick( std::size_t n )
+	{
+		ensure( m_expected == n, "unexpected message: " + std::to_string( n ) +
+				", expected: " + std::to_string( m_expected ) );
+
+		if( types_count == ++m_expected )
+			so_deregister_agent_coop_normally();
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				check_ids();
+
+				so_5::launch( []( so_5::environment_t & env ) {
+					env.introduce_coop( []( so_5::coop_t & coop ) {
+						coop.make_agent< a_test_t >();
+					} );
+				} );
+			},
+			20,
+			"msg_type_id test" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,199 @@
+/*
+ * A test for dropping of messages with expired deadlines.
+ */
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <thread>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+using namespace std;
+
+const int expired_count = 5;
+const int alive_count = 5;
+
+struct msg_value { int m_value; };
+
+struct msg_block : public so_5::signal_t {};
+
+struct msg_check : public so_5::signal_t {};
+
+class counting_tracer_t final : public so_5::msg_tracing::tracer_t
+{
+public :
+	counting_tracer_t( atomic< unsigned int > & counter )
+		:	m_counter( counter )
+	{}
+
+	virtual void
+	trace( const std::string & message ) SO_5_NOEXCEPT override
+	{
+		if( string::npos != message.find( "drop_expired" ) )
+			++m_counter;
+	}
+
+private :
+	atomic< unsigned int > & m_counter;
+};
+
+class a_test_t final : public so_5::agent_t
+{
+public :
+	using so_5::agent_t::agent_t;
+
+	virtual void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( &a_test_t::on_block )
+			.event( &a_test_t::on_value )
+			.event( &a_test_t::on_check );
+
+		so_subscribe( so_environment().stats_controller().mbox() )
+			.event( &a_test_t::on_quantity );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		so_5::send< msg_block >( *this );
+
+		for( int i = 0; i != expired_count; ++i )
+			so_5::send_with_deadline< msg_value >( *this,
+					chrono::milliseconds( 10 ), i );
+
+		for( int i = 0; i != alive_count; ++i )
+			so_5::send_with_deadline< msg_value >( *this,
+					chrono::steady_clock::now() + chrono::seconds( 30 ),
+					expired_count + i );
+
+		// A message without deadline is never dropped.
+		so_5::send< msg_value >( *this, expired_count + alive_count );
+
+		so_5::send< msg_check >( *this );
+	}
+
+private :
+	int m_received = 0;
+
+	void
+	on_block( mhood_t< msg_block > )
+	{
+		// All messages with short deadlines should expire.
+		this_thread::sleep_for( chrono::milliseconds( 100 ) );
+	}
+
+	void
+	on_value( mhood_t< msg_value > cmd )
+	{
+		ensure( cmd->m_value >= expired_count,
+				"expired message received: " + to_string( cmd->m_value ) );
+		++m_received;
+	}
+
+	void
+	on_check( mhood_t< msg_check > )
+	{
+		ensure( alive_count + 1 == m_received,
+				"unexpected count of received messages: " +
+				to_string( m_received ) );
+
+		auto & controller = so_environment().stats_controller();
+		controller.set_distribution_period( chrono::milliseconds( 50 ) );
+		controller.turn_on();
+	}
+
+	void
+	on_quantity(
+		const so_5::stats::messages::quantity< std::size_t > & evt )
+	{
+		namespace stats = so_5::stats;
+
+		if( stats::prefixes::message_delivery() == evt.m_prefix &&
+				stats::suffixes::expired_message_count() == evt.m_suffix )
+		{
+			ensure( expired_count == static_cast< int >( evt.m_value ),
+					"unexpected count of expired messages: " +
+					to_string( evt.m_value ) );
+
+			so_deregister_agent_coop_normally();
+		}
+	}
+};
+
+template< typename Binder_Maker >
+void
+run_test( const char * case_name, Binder_Maker binder_maker )
+{
+	cout << case_name << "..." << flush;
+
+	atomic< unsigned int > traces{ 0u };
+
+	so_5::launch(
+		[&]( so_5::environment_t & env ) {
+			env.introduce_coop( binder_maker( env ),
+				[]( so_5::coop_t & coop ) {
+					coop.make_agent< a_test_t >();
+				} );
+		},
+		[&]( so_5::environment_params_t & params ) {
+			params.message_delivery_tracer(
+					so_5::msg_tracing::tracer_unique_ptr_t{
+							new counting_tracer_t{ traces } } );
+		} );
+
+	ensure( expired_count == static_cast< int >( traces.load() ),
+			"unexpected count of drop_expired traces: " +
+			to_string( traces.load() ) );
+
+	cout << "OK" << endl;
+}
+
+so_5::disp_binder_unique_ptr_t
+make_default_binder( so_5::environment_t & )
+{
+	return so_5::create_default_disp_binder();
+}
+
+so_5::disp_binder_unique_ptr_t
+make_thread_pool_binder( so_5::environment_t & env )
+{
+	return so_5::disp::thread_pool::create_private_disp( env, 2 )->binder(
+			so_5::disp::thread_pool::bind_params_t{} );
+}
+
+so_5::disp_binder_unique_ptr_t
+make_adv_thread_pool_binder( so_5::environment_t & env )
+{
+	return so_5::disp::adv_thread_pool::create_private_disp( env, 2 )->binder(
+			so_5::disp::adv_thread_pool::bind_params_t{} );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				run_test( "one_thread", &make_default_binder );
+				run_test( "thread_pool", &make_thread_pool_binder );
+				run_test( "adv_thread_pool", &make_adv_thread_pool_binder );
+			},
+			20,
+			"send_with_deadline" );
+	}
+	catch( const exception & ex )
+	{
+		cerr << "Error: " << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,115 @@
+/*
+ * A test for repeated transitions between nested states.
+ */
+
+#include <iostream>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+class a_test_t final : public so_5::agent_t
+{
+	state_t st_top_1{ this, "top_1" };
+	state_t st_child_1{ initial_substate_of{ st_top_1 }, "child_1" };
+	state_t st_leaf_1_1{ initial_substate_of{ st_child_1 }, "1" };
+	state_t st_leaf_1_2{ substate_of{ st_child_1 }, "2" };
+	state_t st_child_2{ substate_of{ st_top_1 }, "child_2" };
+	state_t st_leaf_2_1{ initial_substate_of{ st_child_2 }, "1" };
+
+	state_t st_top_2{ this, "top_2" };
+	state_t st_leaf_3_1{ initial_substate_of{ st_top_2 }, "1" };
+
+	void
+	trace( state_t & st, const std::string & prefix )
+	{
+		st.on_enter( [this, prefix] { m_log += "+" + prefix; } );
+		st.on_exit( [this, prefix] { m_log += "-" + prefix; } );
+	}
+
+public :
+	a_test_t( context_t ctx )
+		:	so_5::agent_t{ ctx }
+	{
+		trace( st_top_1, "t1" );
+		trace( st_child_1, "c1" );
+		trace( st_leaf_1_1, "l11" );
+		trace( st_leaf_1_2, "l12" );
+		trace( st_child_2, "c2" );
+		trace( st_leaf_2_1, "l21" );
+		trace( st_top_2, "t2" );
+		trace( st_leaf_3_1, "l31" );
+
+		// Refinement of existing handler.
+		auto old_handler = st_leaf_1_1.on_enter();
+		st_leaf_1_1.on_enter( [this, old_handler] {
+				old_handler();
+				m_log += "!";
+			} );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		this >>= st_top_1;
+		check( "+t1+c1+l11!" );
+
+		const std::string expected =
+				"-l11+l12"
+				"-l12-c1+c2+l21"
+				"-l21-c2-t1+t2+l31"
+				"-l31-t2+t1+c1+l11!";
+
+		for( int i = 0; i != 5; ++i )
+		{
+			this >>= st_leaf_1_2;
+			this >>= st_child_2;
+			this >>= st_top_2;
+			this >>= st_top_1;
+
+			check( expected );
+			ensure( st_leaf_1_1 == so_current_state(),
+					"unexpected current state: " +
+					so_current_state().query_name() );
+		}
+
+		so_deregister_agent_coop_normally();
+	}
+
+private :
+	std::string m_log;
+
+	void
+	check( const std::string & expected )
+	{
+		ensure( expected == m_log, expected + " != " + m_log );
+		m_log.clear();
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				so_5::launch( []( so_5::environment_t & env ) {
+						env.introduce_coop( []( so_5::coop_t & coop ) {
+								coop.make_agent< a_test_t >();
+							} );
+					} );
+			},
+			20,
+			"repeated transitions between nested states" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
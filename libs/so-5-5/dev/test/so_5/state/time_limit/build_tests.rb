@@ -9,4 +9,5 @@ MxxRu::Cpp::composite_target {
 	required_prj "#{path}/reset_limit/prj.ut.rb"
 	required_prj "#{path}/many_switches/prj.ut.rb"
 	required_prj "#{path}/cancel_on_dereg/prj.ut.rb"
+	required_prj "#{path}/reenter/prj.ut.rb"
 }
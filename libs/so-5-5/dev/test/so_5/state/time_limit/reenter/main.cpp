@@ -0,0 +1,124 @@
+/*
+ * A test case for reentering a state with time limit.
+ *
+ * Time limit must be counted from the last enter to the state.
+ */
+
+#include <iostream>
+
+#include <so_5/all.hpp>
+
+#include <various_helpers_1/time_limited_execution.hpp>
+#include <various_helpers_1/ensure.hpp>
+
+using namespace std::chrono;
+
+class a_test_t final : public so_5::agent_t
+{
+	state_t first{ this, "first" };
+	state_t second{ this, "second" };
+	state_t timed_out{ this, "timed_out" };
+
+	struct bounce : public so_5::signal_t {};
+	struct go_back : public so_5::signal_t {};
+	struct check : public so_5::signal_t {};
+
+	const milliseconds m_limit{ 200 };
+	const int m_bounces = 20;
+
+	int m_bounces_passed = 0;
+	int m_timeouts = 0;
+
+	steady_clock::time_point m_entered_at;
+	steady_clock::duration m_passed;
+
+public :
+	a_test_t( context_t ctx )
+		:	so_5::agent_t{ ctx }
+	{
+		first
+			.on_enter( [this] { m_entered_at = steady_clock::now(); } )
+			.time_limit( m_limit, timed_out )
+			.event< bounce >( [this] {
+				this >>= second;
+				so_5::send< bounce >( *this );
+			} );
+
+		second
+			.event< bounce >( [this] {
+				this >>= first;
+				if( ++m_bounces_passed < m_bounces )
+					so_5::send_delayed< bounce >( *this, milliseconds( 20 ) );
+			} )
+			.event< go_back >( [this] {
+				this >>= first;
+			} );
+
+		timed_out
+			.on_enter( [this] {
+				m_passed = steady_clock::now() - m_entered_at;
+				so_5::send< check >( *this );
+			} )
+			.event( &a_test_t::on_timed_out );
+	}
+
+	virtual void
+	so_evt_start() override
+	{
+		this >>= first;
+		so_5::send< bounce >( *this );
+	}
+
+private :
+	void
+	on_timed_out( mhood_t< check > )
+	{
+		ensure_or_die( m_passed >= m_limit,
+				"time limit exceeded too early: " +
+				std::to_string( duration_cast< milliseconds >( m_passed ).count() ) +
+				"ms" );
+
+		++m_timeouts;
+		if( 1 == m_timeouts )
+		{
+			ensure_or_die( m_bounces == m_bounces_passed,
+					"time limit exceeded during bouncing, bounces passed: " +
+					std::to_string( m_bounces_passed ) );
+
+			// Timeout from the timer started for the first state will be
+			// ignored in the second state. But the limit must work after
+			// the next enter to the first state.
+			this >>= first;
+			this >>= second;
+			so_5::send_delayed< go_back >( *this, m_limit * 2 );
+		}
+		else
+			so_deregister_agent_coop_normally();
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				so_5::launch( []( so_5::environment_t & env ) {
+						env.introduce_coop( []( so_5::coop_t & coop ) {
+								coop.make_agent< a_test_t >();
+							} );
+					} );
+			},
+			20,
+			"test for reentering state with time_limit" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}